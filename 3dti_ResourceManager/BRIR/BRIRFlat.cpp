@@ -0,0 +1,145 @@
+/**
+*
+* \brief Functions to handle BRIR in the flat format
+*
+* \date	October 2026
+*
+* \authors 3DI - DIANA Research Group(University of Malaga), in alphabetical order : M.Cuevas - Rodriguez, C.Garre, D.Gonzalez - Toledo, E.J.de la Rubia - Cuestas, L.Molina - Tanco ||
+*Coordinated by, A.Reyes - Lecuona(University of Malaga) and L.Picinali(Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions : (additional authors / contributors can be added here)
+*
+* \b Project : 3DTI(3D - games for TUNing and lEarnINg about hearing aids) ||
+*\b Website : http://3d-tune-in.eu/
+*
+* \b Copyright : University of Malaga and Imperial College London - 2018
+*
+* \b Licence : This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement : This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#include "BRIRFlat.h"
+#include "BRIRCereal.h"
+#include "../Flat/FlatResource.h"
+#include <Common/ErrorHandler.h>
+#include <fstream>
+
+namespace BRIR
+{
+
+//////////////////////////////////////////////////////
+
+	// Write a BRIR table into a flat file, one entry with the impulse response of each virtual speaker and ear
+	static bool WriteFlatTable(const std::string & outputFlat, uint32_t samplingRate, uint32_t irLength, const TBRIRTable & table)
+	{
+		std::vector<TFlatResourceItem> items;
+		items.reserve(table.size());
+		for (auto it = table.begin(); it != table.end(); it++)
+		{
+			if (it->second.size() != irLength)
+			{
+				SET_RESULT(RESULT_ERROR_BADSIZE, "The impulse responses of the BRIR table do not have the length of the BRIR");
+				return false;
+			}
+			TFlatResourceItem item;
+			item.entry.key0 = it->first.vsPosition;
+			item.entry.key1 = it->first.vsChannel;
+			item.entry.leftDelay = 0;
+			item.entry.rightDelay = 0;
+			item.entry.payloadOffset = 0;
+			item.channels.push_back(it->second.data());
+			items.push_back(std::move(item));
+		}
+		return Flat::WriteFlatResource(outputFlat, FLAT_RESOURCE_BRIR, samplingRate, irLength, 0.0f, items);
+	}
+
+//////////////////////////////////////////////////////
+
+	int GetSampleRateFromFlat(const std::string & inputFlat)
+	{
+		Flat::CFlatResource flat;
+		if (!flat.Open(inputFlat, FLAT_RESOURCE_BRIR)) { return -1; }
+		return static_cast<int>(flat.GetHeader().samplingRate);
+	}
+
+//////////////////////////////////////////////////////
+
+	bool CreateFromFlat(const std::string & inputFlat, shared_ptr<Binaural::CEnvironment> environment)
+	{
+		Flat::CFlatResource flat;
+		if (!flat.Open(inputFlat, FLAT_RESOURCE_BRIR)) { return false; }
+
+		const TFlatResourceHeader & header = flat.GetHeader();
+		if (header.channelsPerEntry != 1)
+		{
+			SET_RESULT(RESULT_ERROR_BADSIZE, "The flat BRIR file does not have one channel for each virtual speaker and ear");
+			return false;
+		}
+
+		try
+		{
+			//The impulse responses are copied from the mapped file to the database of the BRIR, which needs its own copy to calculate the partitioned table
+			environment->GetBRIR()->BeginSetup(header.channelLength);
+			for (uint32_t i = 0; i < flat.GetNumberOfEntries(); i++)
+			{
+				const TFlatResourceEntry & entry = flat.GetEntry(i);
+				const float* ir = flat.GetChannel(i, 0);
+				TImpulseResponse newBRIR(ir, ir + header.channelLength);
+				environment->GetBRIR()->AddBRIR(static_cast<VirtualSpeakerPosition>(entry.key0), static_cast<Common::T_ear>(entry.key1), std::move(newBRIR));
+			}
+			return environment->GetBRIR()->EndSetup();
+		}
+		catch (const std::exception& e)
+		{
+			SET_RESULT(RESULT_ERROR_EXCEPTION, e.what());
+			return false;
+		}
+	}
+
+//////////////////////////////////////////////////////
+
+	bool SaveFlat(const std::string & outputFlat, shared_ptr<Binaural::CEnvironment> environment)
+	{
+		if (!environment->GetBRIR()->IsBRIRready())
+		{
+			SET_RESULT(RESULT_ERROR_NOTSET, "The BRIR of the environment has not been loaded, so it can not be written into a flat file");
+			return false;
+		}
+		Binaural::CBRIR* brir = environment->GetBRIR();
+		return WriteFlatTable(outputFlat, environment->GetCoreAudioState().sampleRate, brir->GetBRIRLength(), brir->GetRawBRIRTable());
+	}
+
+//////////////////////////////////////////////////////
+
+	bool Convert3dtiToFlat(const std::string & input3dti, const std::string & outputFlat)
+	{
+		std::ifstream input3dtiStream(input3dti, std::ios::binary);
+		if (!input3dtiStream.is_open())
+		{
+			SET_RESULT(RESULT_ERROR_FILE, "Could not open 3DTI-BRIR file");
+			return false;
+		}
+
+		BRIRDetail_struct brir;
+		try
+		{
+			cereal::PortableBinaryInputArchive archive(input3dtiStream);
+			archive(brir);
+		}
+		catch (const std::exception& e)
+		{
+			SET_RESULT(RESULT_ERROR_EXCEPTION, e.what());
+			return false;
+		}
+		catch (...)
+		{
+			SET_RESULT(RESULT_ERROR_EXCEPTION, "Unknown exception when reading 3DTI-BRIR file");
+			return false;
+		}
+		return WriteFlatTable(outputFlat, brir.samplingRate, brir.irLength, brir.table);
+	}
+
+//////////////////////////////////////////////////////
+}
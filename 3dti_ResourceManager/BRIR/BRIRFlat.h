@@ -0,0 +1,64 @@
+/**
+*
+* \brief Functions to handle BRIR in the flat format
+*
+* \date	October 2026
+*
+* \authors 3DI - DIANA Research Group(University of Malaga), in alphabetical order : M.Cuevas - Rodriguez, C.Garre, D.Gonzalez - Toledo, E.J.de la Rubia - Cuestas, L.Molina - Tanco ||
+*Coordinated by, A.Reyes - Lecuona(University of Malaga) and L.Picinali(Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions : (additional authors / contributors can be added here)
+*
+* \b Project : 3DTI(3D - games for TUNing and lEarnINg about hearing aids) ||
+*\b Website : http://3d-tune-in.eu/
+*
+* \b Copyright : University of Malaga and Imperial College London - 2018
+*
+* \b Licence : This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement : This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#ifndef BRIRFlat_h
+#define BRIRFlat_h
+
+#include <BinauralSpatializer/Environment.h>
+#include <string>
+
+namespace BRIR {
+
+	/** \brief Returns the sample rate in the flat file whose path is inputFlat
+	*	\param [in] inputFlat path of the flat file
+	*   \eh On error, an error code is reported to the error handler.
+	*	\retval sampleRate the sample rate of the file, -1 on error
+	*/
+	int GetSampleRateFromFlat(const std::string & inputFlat);
+
+	/** \brief Loads the data in a flat file as BRIR in environment
+	*	\details The file is mapped into memory and the impulse responses are copied directly from it to the BRIR of the environment, without deserializing them
+	*	\param [in] inputFlat path of the flat file
+	*	\param [in] environment in which the data will be loaded
+	*   \eh On error, an error code is reported to the error handler.
+	*   \retval Returns true on success. False otherwise
+	*/
+	bool CreateFromFlat(const std::string & inputFlat, shared_ptr<Binaural::CEnvironment> environment);
+
+	/** \brief Write the BRIR of an environment into a flat file, so a BRIR loaded from any format (3dti or sofa) can be converted
+	*	\param [in] outputFlat path of the flat file, replaced if it exists
+	*	\param [in] environment environment whose BRIR has been loaded
+	*   \eh On error, an error code is reported to the error handler.
+	*   \retval Returns true on success. False otherwise
+	*/
+	bool SaveFlat(const std::string & outputFlat, shared_ptr<Binaural::CEnvironment> environment);
+
+	/** \brief Convert a 3dti BRIR file into a flat file, without loading it in an environment
+	*	\param [in] input3dti path of the 3dti file
+	*	\param [in] outputFlat path of the flat file, replaced if it exists
+	*   \eh On error, an error code is reported to the error handler.
+	*   \retval Returns true on success. False otherwise
+	*/
+	bool Convert3dtiToFlat(const std::string & input3dti, const std::string & outputFlat);
+}
+
+#endif
@@ -0,0 +1,394 @@
+/**
+* \class CFlatResource
+*
+* \brief Flat binary format of HRTF, BRIR and ILD resources, that can be mapped into memory and read in place
+*
+* \date	October 2026
+*
+* \authors 3DI - DIANA Research Group(University of Malaga), in alphabetical order : M.Cuevas - Rodriguez, C.Garre, D.Gonzalez - Toledo, E.J.de la Rubia - Cuestas, L.Molina - Tanco ||
+*Coordinated by, A.Reyes - Lecuona(University of Malaga) and L.Picinali(Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions : (additional authors / contributors can be added here)
+*
+* \b Project : 3DTI(3D - games for TUNing and lEarnINg about hearing aids) ||
+*\b Website : http://3d-tune-in.eu/
+*
+* \b Copyright : University of Malaga and Imperial College London - 2018
+*
+* \b Licence : This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement : This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#include "FlatResource.h"
+#include <Common/ErrorHandler.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#if defined(_WIN32)
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+static_assert(sizeof(TFlatResourceHeader) == 64, "The header of the flat format has to be 64 bytes");
+static_assert(sizeof(TFlatResourceEntry) == 32, "The entries of the index of the flat format have to be 32 bytes");
+
+namespace Flat
+{
+	// Round up a size in bytes to a multiple of FLAT_RESOURCE_ALIGNMENT
+	static uint64_t AlignSize(uint64_t bytes)
+	{
+		return (bytes + FLAT_RESOURCE_ALIGNMENT - 1) / FLAT_RESOURCE_ALIGNMENT * FLAT_RESOURCE_ALIGNMENT;
+	}
+
+	static bool IsKeyLess(const TFlatResourceEntry & a, const TFlatResourceEntry & b)
+	{
+		return (a.key0 < b.key0) || ((a.key0 == b.key0) && (a.key1 < b.key1));
+	}
+
+	/////////////////////////////
+	// CONSTRUCTOR/DESTRUCTOR  //
+	/////////////////////////////
+	CFlatResource::CFlatResource()
+		:data{ nullptr }, size{ 0 }, header{ nullptr }, entries{ nullptr }
+	{
+	}
+
+	CFlatResource::~CFlatResource()
+	{
+		Close();
+	}
+
+	///////////////////
+	// Public Methods //
+	///////////////////
+
+	// Map a flat file into memory and check its header and index
+	bool CFlatResource::Open(const std::string & fileName, TFlatResourceType resourceType)
+	{
+		Close();
+		if (!Map(fileName)) { return false; }
+
+		if (size < sizeof(TFlatResourceHeader))
+		{
+			Close();
+			SET_RESULT(RESULT_ERROR_INVALID_PARAM, "The file is too short to be a flat resource file");
+			return false;
+		}
+		header = reinterpret_cast<const TFlatResourceHeader*>(data);
+		if (!IsValid(resourceType))
+		{
+			Close();	//The error has been reported by IsValid
+			return false;
+		}
+		entries = reinterpret_cast<const TFlatResourceEntry*>(data + header->indexOffset);
+
+		SET_RESULT(RESULT_OK, "Flat resource file mapped succesfully");
+		return true;
+	}
+
+	// Unmap the file
+	void CFlatResource::Close()
+	{
+		if (data != nullptr)
+		{
+			Unmap();
+		}
+		data = nullptr;
+		size = 0;
+		header = nullptr;
+		entries = nullptr;
+	}
+
+	// Get if a file is mapped
+	bool CFlatResource::IsOpen() const
+	{
+		return entries != nullptr;
+	}
+
+	// Get the header of the mapped file
+	const TFlatResourceHeader & CFlatResource::GetHeader() const
+	{
+		return *header;
+	}
+
+	// Get the number of entries of the index
+	uint32_t CFlatResource::GetNumberOfEntries() const
+	{
+		return IsOpen() ? header->numberOfEntries : 0;
+	}
+
+	// Get one entry of the index
+	const TFlatResourceEntry & CFlatResource::GetEntry(uint32_t index) const
+	{
+		return entries[index];
+	}
+
+	// Find an entry of the index from its keys
+	int CFlatResource::FindEntry(int32_t key0, int32_t key1) const
+	{
+		if (!IsOpen()) { return -1; }
+
+		TFlatResourceEntry key;
+		key.key0 = key0;
+		key.key1 = key1;
+		const TFlatResourceEntry* end = entries + header->numberOfEntries;
+		const TFlatResourceEntry* it = std::lower_bound(entries, end, key, IsKeyLess);
+		if ((it == end) || (it->key0 != key0) || (it->key1 != key1)) { return -1; }
+		return static_cast<int>(it - entries);
+	}
+
+	// Get the data of one channel of one entry
+	const float* CFlatResource::GetChannel(uint32_t index, uint32_t channel) const
+	{
+		return reinterpret_cast<const float*>(data + entries[index].payloadOffset) + static_cast<size_t>(channel) * header->channelStride;
+	}
+
+	////////////////////
+	// Private Methods //
+	////////////////////
+
+#if defined(_WIN32)
+	// Map the whole file into memory, read only
+	bool CFlatResource::Map(const std::string & fileName)
+	{
+		HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			SET_RESULT(RESULT_ERROR_FILE, "Could not open flat resource file");
+			return false;
+		}
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file, &fileSize) || (fileSize.QuadPart == 0))
+		{
+			CloseHandle(file);
+			SET_RESULT(RESULT_ERROR_FILE, "Could not get the size of the flat resource file, or it is empty");
+			return false;
+		}
+		HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		CloseHandle(file);
+		if (mapping == NULL)
+		{
+			SET_RESULT(RESULT_ERROR_FILE, "Could not map flat resource file");
+			return false;
+		}
+		void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);		//The view keeps the mapping alive
+		if (view == NULL)
+		{
+			SET_RESULT(RESULT_ERROR_FILE, "Could not map flat resource file");
+			return false;
+		}
+		data = static_cast<const uint8_t*>(view);
+		size = static_cast<size_t>(fileSize.QuadPart);
+		return true;
+	}
+
+	// Unmap the file
+	void CFlatResource::Unmap()
+	{
+		UnmapViewOfFile(data);
+	}
+#else
+	// Map the whole file into memory, read only
+	bool CFlatResource::Map(const std::string & fileName)
+	{
+		int file = open(fileName.c_str(), O_RDONLY);
+		if (file < 0)
+		{
+			SET_RESULT(RESULT_ERROR_FILE, "Could not open flat resource file");
+			return false;
+		}
+		struct stat fileStatus;
+		if ((fstat(file, &fileStatus) != 0) || (fileStatus.st_size == 0))
+		{
+			close(file);
+			SET_RESULT(RESULT_ERROR_FILE, "Could not get the size of the flat resource file, or it is empty");
+			return false;
+		}
+		void* view = mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_SHARED, file, 0);
+		close(file);		//The mapping keeps the file open
+		if (view == MAP_FAILED)
+		{
+			SET_RESULT(RESULT_ERROR_FILE, "Could not map flat resource file");
+			return false;
+		}
+		data = static_cast<const uint8_t*>(view);
+		size = static_cast<size_t>(fileStatus.st_size);
+		return true;
+	}
+
+	// Unmap the file
+	void CFlatResource::Unmap()
+	{
+		munmap(const_cast<uint8_t*>(data), size);
+	}
+#endif
+
+	// Check the header and the index of the mapped file
+	bool CFlatResource::IsValid(TFlatResourceType resourceType) const
+	{
+		if (std::memcmp(header->formatName, FLAT_RESOURCE_FORMAT_NAME, sizeof(header->formatName)) != 0)
+		{
+			SET_RESULT(RESULT_ERROR_INVALID_PARAM, "Not a flat resource file");
+			return false;
+		}
+		if (header->byteOrderMark != FLAT_RESOURCE_BYTE_ORDER_MARK)
+		{
+			SET_RESULT(RESULT_ERROR_NOTALLOWED, "The flat resource file has been written in a machine with another byte order");
+			return false;
+		}
+		if (header->formatVersion != FLAT_RESOURCE_FORMAT_VERSION)
+		{
+			SET_RESULT(RESULT_ERROR_NOTALLOWED, "The flat resource file has been written with another version of the format");
+			return false;
+		}
+		if (header->resourceType != static_cast<uint32_t>(resourceType))
+		{
+			SET_RESULT(RESULT_ERROR_INVALID_PARAM, "The flat resource file contains another type of resource");
+			return false;
+		}
+		if ((header->flags & ~static_cast<uint32_t>(FLAT_RESOURCE_FLAG_PROCESSED_HRTF)) != 0)
+		{
+			SET_RESULT(RESULT_ERROR_NOTALLOWED, "The flat resource file has flags unknown to this version of the format");
+			return false;
+		}
+		if (header->fileSize != size)
+		{
+			SET_RESULT(RESULT_ERROR_INVALID_PARAM, "The size of the flat resource file is not the one in its header, it may have been truncated");
+			return false;
+		}
+
+		uint64_t channelBytes = static_cast<uint64_t>(header->channelStride) * sizeof(float);
+		if ((header->numberOfEntries == 0) || (header->channelsPerEntry == 0) || (header->channelLength == 0) ||
+			(header->channelStride < header->channelLength) || (channelBytes % FLAT_RESOURCE_ALIGNMENT != 0))
+		{
+			SET_RESULT(RESULT_ERROR_INVALID_PARAM, "The flat resource file has no entries or a wrong channel layout");
+			return false;
+		}
+		uint64_t indexBytes = static_cast<uint64_t>(header->numberOfEntries) * sizeof(TFlatResourceEntry);
+		if ((header->indexOffset < sizeof(TFlatResourceHeader)) || (header->indexOffset % alignof(TFlatResourceEntry) != 0) ||
+			(header->indexOffset > size) || (indexBytes > size - header->indexOffset))
+		{
+			SET_RESULT(RESULT_ERROR_INVALID_PARAM, "The index of the flat resource file is out of the file");
+			return false;
+		}
+
+		//Every payload has to be aligned and inside the file, and the index sorted for FindEntry
+		const TFlatResourceEntry* index = reinterpret_cast<const TFlatResourceEntry*>(data + header->indexOffset);
+		uint64_t entryBytes = channelBytes * header->channelsPerEntry;
+		for (uint32_t i = 0; i < header->numberOfEntries; i++)
+		{
+			if ((index[i].payloadOffset % FLAT_RESOURCE_ALIGNMENT != 0) || (index[i].payloadOffset > size) || (entryBytes > size - index[i].payloadOffset))
+			{
+				SET_RESULT(RESULT_ERROR_INVALID_PARAM, "The payload of an entry of the flat resource file is out of the file or not aligned");
+				return false;
+			}
+			if ((i > 0) && !IsKeyLess(index[i - 1], index[i]))
+			{
+				SET_RESULT(RESULT_ERROR_INVALID_PARAM, "The index of the flat resource file is not sorted or has repeated keys");
+				return false;
+			}
+		}
+		return true;
+	}
+
+	//////////////////////////////////////////////////////
+
+	bool WriteFlatResource(const std::string & fileName, TFlatResourceType resourceType, uint32_t samplingRate, uint32_t channelLength, float distanceOfMeasurement, std::vector<TFlatResourceItem> & items, uint32_t flags)
+	{
+		if (items.empty() || (channelLength == 0))
+		{
+			SET_RESULT(RESULT_ERROR_INVALID_PARAM, "There is no data to write in the flat resource file");
+			return false;
+		}
+		uint32_t channelsPerEntry = static_cast<uint32_t>(items[0].channels.size());
+		for (const TFlatResourceItem & item : items)
+		{
+			if ((item.channels.size() != channelsPerEntry) || (channelsPerEntry == 0))
+			{
+				SET_RESULT(RESULT_ERROR_INVALID_PARAM, "All the entries of a flat resource file need the same number of channels");
+				return false;
+			}
+		}
+		std::sort(items.begin(), items.end(), [](const TFlatResourceItem & a, const TFlatResourceItem & b) { return IsKeyLess(a.entry, b.entry); });
+
+		//Layout: header, index, and the payload of every entry after the index
+		uint64_t channelBytes = AlignSize(static_cast<uint64_t>(channelLength) * sizeof(float));
+		uint64_t entryBytes = channelBytes * channelsPerEntry;
+		uint64_t payloadOffset = AlignSize(sizeof(TFlatResourceHeader) + items.size() * sizeof(TFlatResourceEntry));
+
+		TFlatResourceHeader header;
+		std::memset(&header, 0, sizeof(header));
+		std::memcpy(header.formatName, FLAT_RESOURCE_FORMAT_NAME, sizeof(header.formatName));
+		header.byteOrderMark = FLAT_RESOURCE_BYTE_ORDER_MARK;
+		header.formatVersion = FLAT_RESOURCE_FORMAT_VERSION;
+		header.resourceType = resourceType;
+		header.samplingRate = samplingRate;
+		header.numberOfEntries = static_cast<uint32_t>(items.size());
+		header.channelsPerEntry = channelsPerEntry;
+		header.channelLength = channelLength;
+		header.channelStride = static_cast<uint32_t>(channelBytes / sizeof(float));
+		header.distanceOfMeasurement = distanceOfMeasurement;
+		header.flags = flags;
+		header.indexOffset = sizeof(TFlatResourceHeader);
+		header.fileSize = payloadOffset + items.size() * entryBytes;
+
+		std::vector<TFlatResourceEntry> index(items.size());
+		for (size_t i = 0; i < items.size(); i++)
+		{
+			index[i] = items[i].entry;
+			index[i].payloadOffset = payloadOffset + i * entryBytes;
+		}
+
+		std::string temporaryFile = fileName + ".tmp";
+		{
+			std::ofstream flatStream(temporaryFile, std::ios::binary);
+			if (!flatStream.is_open())
+			{
+				SET_RESULT(RESULT_ERROR_FILE, "Could not create flat resource file");
+				return false;
+			}
+			std::vector<char> padding(static_cast<size_t>(payloadOffset), 0);
+			flatStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			flatStream.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(TFlatResourceEntry));
+			flatStream.write(padding.data(), payloadOffset - sizeof(TFlatResourceHeader) - index.size() * sizeof(TFlatResourceEntry));
+			for (const TFlatResourceItem & item : items)
+			{
+				for (const float* channel : item.channels)
+				{
+					flatStream.write(reinterpret_cast<const char*>(channel), channelLength * sizeof(float));
+					flatStream.write(padding.data(), channelBytes - channelLength * sizeof(float));
+				}
+			}
+			flatStream.close();
+			if (flatStream.fail())
+			{
+				std::remove(temporaryFile.c_str());
+				SET_RESULT(RESULT_ERROR_FILE, "Could not write flat resource file");
+				return false;
+			}
+		}
+
+		//Replace the previous file only once the new one is complete
+		std::remove(fileName.c_str());
+		if (std::rename(temporaryFile.c_str(), fileName.c_str()) != 0)
+		{
+			std::remove(temporaryFile.c_str());
+			SET_RESULT(RESULT_ERROR_FILE, "Could not rename flat resource file");
+			return false;
+		}
+		SET_RESULT(RESULT_OK, "Flat resource file written succesfully");
+		return true;
+	}
+}
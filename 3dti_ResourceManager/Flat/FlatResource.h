@@ -0,0 +1,220 @@
+/**
+* \class CFlatResource
+*
+* \brief Flat binary format of HRTF, BRIR and ILD resources, that can be mapped into memory and read in place
+*
+* \date	October 2026
+*
+* \authors 3DI - DIANA Research Group(University of Malaga), in alphabetical order : M.Cuevas - Rodriguez, C.Garre, D.Gonzalez - Toledo, E.J.de la Rubia - Cuestas, L.Molina - Tanco ||
+*Coordinated by, A.Reyes - Lecuona(University of Malaga) and L.Picinali(Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions : (additional authors / contributors can be added here)
+*
+* \b Project : 3DTI(3D - games for TUNing and lEarnINg about hearing aids) ||
+*\b Website : http://3d-tune-in.eu/
+*
+* \b Copyright : University of Malaga and Imperial College London - 2018
+*
+* \b Licence : This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement : This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#ifndef FlatResource_h
+#define FlatResource_h
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+/** \brief Name of the format, in the first 8 bytes of every flat resource file (not null-terminated)
+*/
+#define FLAT_RESOURCE_FORMAT_NAME "3DTIFLAT"
+
+/** \brief Version of the flat format. It has to be increased whenever the layout of the header, of the index or of the payload changes
+*/
+#define FLAT_RESOURCE_FORMAT_VERSION 1
+
+/** \brief Alignment of the channels of the payload, in bytes, relative to the beginning of the file
+*/
+#define FLAT_RESOURCE_ALIGNMENT 64
+
+/** \brief Value written with the byte order of the machine that wrote the file. The file is read in place, so it is only accepted with the same byte order
+*/
+#define FLAT_RESOURCE_BYTE_ORDER_MARK 0x01020304
+
+/** \brief Type of the resource stored in a flat file
+*/
+enum TFlatResourceType
+{
+	FLAT_RESOURCE_HRTF = 1,		///< HRIRs of both ears for each orientation (.3dti-hrtf)
+	FLAT_RESOURCE_BRIR = 2,		///< Impulse response of each virtual speaker and ear (.3dti-brir)
+	FLAT_RESOURCE_ILD = 3		///< Coefficients of the two biquad filters for each distance and azimuth (.3dti-ild)
+};
+
+/** \brief Flags of the header of a flat file
+*/
+enum TFlatResourceFlags
+{
+	FLAT_RESOURCE_FLAG_PROCESSED_HRTF = 1	///< The HRIRs are the database of CHRTF after EndSetup, without the common delay and with the HRIRs of the poles
+};
+
+/** \brief Header at the beginning of a flat file (64 bytes)
+*	\details The file is: header, index of numberOfEntries TFlatResourceEntry sorted by key, and payload. The payload of each entry
+*	is channelsPerEntry channels of channelLength floats, each of them starting at a multiple of FLAT_RESOURCE_ALIGNMENT bytes
+*	and padded with zeros up to channelStride floats.
+*/
+struct TFlatResourceHeader
+{
+	char formatName[8];				///< FLAT_RESOURCE_FORMAT_NAME
+	uint32_t byteOrderMark;			///< FLAT_RESOURCE_BYTE_ORDER_MARK
+	uint32_t formatVersion;			///< FLAT_RESOURCE_FORMAT_VERSION
+	uint32_t resourceType;			///< TFlatResourceType
+	uint32_t samplingRate;			///< Sample rate of the impulse responses or filters, in Hz
+	uint32_t numberOfEntries;		///< Number of entries of the index
+	uint32_t channelsPerEntry;		///< Number of channels of each entry (2 for HRTF, 1 for BRIR and ILD)
+	uint32_t channelLength;			///< Number of floats of each channel
+	uint32_t channelStride;			///< Distance between the beginnings of two channels, in floats
+	float distanceOfMeasurement;	///< Distance where the HRTF has been measured, in meters (0 for BRIR and ILD)
+	uint32_t flags;					///< Combination of TFlatResourceFlags, zero in the files written before they were defined
+	uint64_t indexOffset;			///< Offset of the index from the beginning of the file, in bytes
+	uint64_t fileSize;				///< Size of the whole file, in bytes
+};
+
+/** \brief Entry of the index of a flat file (32 bytes)
+*	\details HRTF: key0 = azimuth, key1 = elevation, delays of the left and right ear.
+*	BRIR: key0 = VirtualSpeakerPosition, key1 = Common::T_ear, delays 0.
+*	ILD: key0 = distance in millimeters, key1 = azimuth, delays 0.
+*/
+struct TFlatResourceEntry
+{
+	int32_t key0;				///< First key of the entry
+	int32_t key1;				///< Second key of the entry
+	uint64_t leftDelay;			///< Left delay of the HRIR, in number of samples
+	uint64_t rightDelay;		///< Right delay of the HRIR, in number of samples
+	uint64_t payloadOffset;		///< Offset of the first channel from the beginning of the file, in bytes
+};
+
+/** \brief One entry to write with WriteFlatResource, with a pointer to the data of each channel
+*/
+struct TFlatResourceItem
+{
+	TFlatResourceEntry entry;				///< Keys and delays of the entry (payloadOffset is calculated by WriteFlatResource)
+	std::vector<const float*> channels;		///< channelLength floats for each channel
+};
+
+namespace Flat
+{
+	/** \details This class maps a flat resource file into memory, read only, and gives access to its index and to its payload in place,
+	*	without reading nor copying the data. The operating system shares the pages of the file between all the processes that map it.
+	*/
+	class CFlatResource
+	{
+	public:
+
+		/** \brief Default constructor, without any file mapped
+		*   \eh Nothing is reported to the error handler.
+		*/
+		CFlatResource();
+
+		/** \brief Destructor, unmaps the file
+		*   \eh Nothing is reported to the error handler.
+		*/
+		~CFlatResource();
+
+		CFlatResource(const CFlatResource &) = delete;
+		CFlatResource & operator=(const CFlatResource &) = delete;
+
+		/** \brief Map a flat file into memory and check its header and index
+		*	\details The file previously mapped, if any, is unmapped
+		*	\param [in] fileName path of the flat file
+		*	\param [in] resourceType type of resource the file has to contain
+		*	\retval result true if the file has been mapped and it is a valid flat file of that type
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		bool Open(const std::string & fileName, TFlatResourceType resourceType);
+
+		/** \brief Unmap the file. The pointers got from it are not valid any more
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void Close();
+
+		/** \brief Get if a file is mapped
+		*	\retval isOpen true if a valid file has been opened
+		*   \eh Nothing is reported to the error handler.
+		*/
+		bool IsOpen() const;
+
+		/** \brief Get the header of the mapped file
+		*	\retval header header of the file
+		*	\pre IsOpen()
+		*   \eh Nothing is reported to the error handler.
+		*/
+		const TFlatResourceHeader & GetHeader() const;
+
+		/** \brief Get the number of entries of the index
+		*	\retval numberOfEntries number of entries, 0 if no file is mapped
+		*   \eh Nothing is reported to the error handler.
+		*/
+		uint32_t GetNumberOfEntries() const;
+
+		/** \brief Get one entry of the index
+		*	\param [in] index position of the entry, from 0 to GetNumberOfEntries() - 1. Entries are sorted by key0 and then by key1
+		*	\retval entry entry of the index
+		*	\pre IsOpen() and index < GetNumberOfEntries()
+		*   \eh Nothing is reported to the error handler.
+		*/
+		const TFlatResourceEntry & GetEntry(uint32_t index) const;
+
+		/** \brief Find an entry of the index from its keys, with a binary search
+		*	\param [in] key0 first key of the entry
+		*	\param [in] key1 second key of the entry
+		*	\retval index position of the entry, -1 if there is no entry with those keys
+		*   \eh Nothing is reported to the error handler.
+		*/
+		int FindEntry(int32_t key0, int32_t key1) const;
+
+		/** \brief Get the data of one channel of one entry, in place in the mapped file
+		*	\param [in] index position of the entry
+		*	\param [in] channel channel of the entry (for HRTF, 0 left and 1 right)
+		*	\retval data pointer to channelLength floats, aligned to FLAT_RESOURCE_ALIGNMENT bytes. It is valid until the file is closed
+		*	\pre IsOpen(), index < GetNumberOfEntries() and channel < channelsPerEntry
+		*   \eh Nothing is reported to the error handler.
+		*/
+		const float* GetChannel(uint32_t index, uint32_t channel) const;
+
+	private:
+		///////////////
+		// METHODS
+		///////////////
+		bool Map(const std::string & fileName);		// Map the whole file into memory, read only
+		void Unmap();								// Unmap the file
+		bool IsValid(TFlatResourceType resourceType) const;		// Check the header and the index of the mapped file
+
+		///////////////
+		// ATTRIBUTES
+		///////////////
+		const uint8_t* data;					// Beginning of the mapped file
+		size_t size;							// Size of the mapped file, in bytes
+		const TFlatResourceHeader* header;		// Header at the beginning of the mapped file
+		const TFlatResourceEntry* entries;		// Index of the mapped file
+	};
+
+	/** \brief Write a flat resource file
+	*	\details The items are sorted by key0 and key1. The file is written with another name and renamed at the end, so an interrupted write does not leave a broken file
+	*	\param [in] fileName path of the flat file, replaced if it exists
+	*	\param [in] resourceType type of the resource
+	*	\param [in] samplingRate sample rate of the resource, in Hz
+	*	\param [in] channelLength number of floats of each channel
+	*	\param [in] distanceOfMeasurement distance where the HRTF has been measured, 0 for BRIR and ILD
+	*	\param [in] items entries to write, all of them with the same number of channels
+	*	\param [in] flags combination of TFlatResourceFlags
+	*	\retval result true if the file has been written
+	*   \eh On error, an error code is reported to the error handler.
+	*/
+	bool WriteFlatResource(const std::string & fileName, TFlatResourceType resourceType, uint32_t samplingRate, uint32_t channelLength, float distanceOfMeasurement, std::vector<TFlatResourceItem> & items, uint32_t flags = 0);
+}
+
+#endif
@@ -0,0 +1,246 @@
+/**
+*
+* \brief Functions to cache on disk the resampled and partitioned tables of HRTFs
+*
+* \date	October 2026
+*
+* \authors 3DI - DIANA Research Group(University of Malaga), in alphabetical order : M.Cuevas - Rodriguez, C.Garre, D.Gonzalez - Toledo, E.J.de la Rubia - Cuestas, L.Molina - Tanco ||
+*Coordinated by, A.Reyes - Lecuona(University of Malaga) and L.Picinali(Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions : (additional authors / contributors can be added here)
+*
+* \b Project : 3DTI(3D - games for TUNing and lEarnINg about hearing aids) ||
+*\b Website : http://3d-tune-in.eu/
+*
+* \b Copyright : University of Malaga and Imperial College London - 2018
+*
+* \b Licence : This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement : This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#include "HRTFCache.h"
+#include "HRTFCereal.h"
+#include "HRTFFactory.h"
+#include <Common/AlignedAllocator.h>
+#include <Common/ErrorHandler.h>
+#include <cereal/types/string.hpp>
+#include <fstream>
+#include <cstdio>
+#include <vector>
+
+#define HRTF_CACHE_FORMAT_NAME "3DTI_HRTF_CACHE"
+
+namespace HRTF
+{
+
+//////////////////////////////////////////////////////
+
+	// Key of the tables that the core of one listener needs
+	static HRTFCacheKey_struct GetCacheKey(uint64_t sourceHash, shared_ptr<Binaural::CListener> listener)
+	{
+		HRTFCacheKey_struct key;
+		key.formatVersion = HRTF_CACHE_FORMAT_VERSION;
+		key.alignment = Common::SIMD_ALIGNMENT;
+		key.sourceHash = sourceHash;
+		key.sampleRate = listener->GetCoreAudioState().sampleRate;
+		key.bufferSize = listener->GetCoreAudioState().bufferSize;
+		key.resamplingStep = listener->GetHRTFResamplingStep();
+		key.hybridPartitionsPerSegment = listener->IsHybridHRTFConvolutionEnabled() ? listener->GetHybridHRTFPartitionsPerSegment() : 0;
+		return key;
+	}
+
+	static bool IsSameCacheKey(const HRTFCacheKey_struct & a, const HRTFCacheKey_struct & b)
+	{
+		return (a.formatVersion == b.formatVersion) && (a.alignment == b.alignment) && (a.sourceHash == b.sourceHash) && (a.sampleRate == b.sampleRate) &&
+			(a.bufferSize == b.bufferSize) && (a.resamplingStep == b.resamplingStep) && (a.hybridPartitionsPerSegment == b.hybridPartitionsPerSegment);
+	}
+
+	// Write the cache file: name of the format, key, flag of the delays of the sofa file and asset
+	static bool SaveCache(const std::string & cacheFile, uint64_t sourceHash, bool specifiedDelays, shared_ptr<Binaural::CListener> listener)
+	{
+		std::shared_ptr<const Binaural::CHRTFAsset> asset = listener->GetHRTF()->GetHRTFAsset();
+		if (asset == nullptr)
+		{
+			SET_RESULT(RESULT_ERROR_NOTSET, "The HRTF of the listener has not been loaded, so it can not be cached");
+			return false;
+		}
+
+		//The key comes from the asset, which could have been calculated with other parameters than the current ones of the core
+		HRTFCacheKey_struct key = GetCacheKey(sourceHash, listener);
+		key.bufferSize = asset->GetBufferSize();
+		key.resamplingStep = asset->GetResamplingStep();
+		key.hybridPartitionsPerSegment = asset->GetHybridPartitionsPerSegment();
+
+		std::string temporaryFile = cacheFile + ".tmp";
+		try
+		{
+			std::ofstream cacheStream(temporaryFile, std::ios::binary);
+			if (!cacheStream.is_open())
+			{
+				SET_RESULT(RESULT_ERROR_FILE, "Could not create HRTF cache file");
+				return false;
+			}
+			{
+				cereal::PortableBinaryOutputArchive archive(cacheStream);
+				std::string formatName = HRTF_CACHE_FORMAT_NAME;
+				archive(formatName, key, specifiedDelays, *asset);
+			}
+			cacheStream.close();
+			if (cacheStream.fail())
+			{
+				std::remove(temporaryFile.c_str());
+				SET_RESULT(RESULT_ERROR_FILE, "Could not write HRTF cache file");
+				return false;
+			}
+		}
+		catch (const std::exception& e)
+		{
+			std::remove(temporaryFile.c_str());
+			SET_RESULT(RESULT_ERROR_EXCEPTION, e.what());
+			return false;
+		}
+
+		//Replace the previous cache file only once the new one is complete
+		std::remove(cacheFile.c_str());
+		if (std::rename(temporaryFile.c_str(), cacheFile.c_str()) != 0)
+		{
+			std::remove(temporaryFile.c_str());
+			SET_RESULT(RESULT_ERROR_FILE, "Could not rename HRTF cache file");
+			return false;
+		}
+		SET_RESULT(RESULT_OK, "HRTF cache file saved");
+		return true;
+	}
+
+	// Read the cache file, if its key is the expected one, and set its asset in the listener
+	static bool LoadCache(const std::string & cacheFile, uint64_t sourceHash, bool & specifiedDelays, shared_ptr<Binaural::CListener> listener)
+	{
+		std::ifstream cacheStream(cacheFile, std::ios::binary);
+		if (!cacheStream.is_open())
+		{
+			SET_RESULT(RESULT_WARNING, "HRTF cache file not found");
+			return false;
+		}
+
+		try
+		{
+			cereal::PortableBinaryInputArchive archive(cacheStream);
+			std::string formatName;
+			HRTFCacheKey_struct key;
+			archive(formatName, key);
+			if ((formatName != HRTF_CACHE_FORMAT_NAME) || !IsSameCacheKey(key, GetCacheKey(sourceHash, listener)))
+			{
+				SET_RESULT(RESULT_WARNING, "The HRTF cache file has been calculated from another HRTF file, with other parameters or with another version of the format");
+				return false;
+			}
+
+			std::shared_ptr<Binaural::CHRTFAsset> asset = std::make_shared<Binaural::CHRTFAsset>();
+			bool cachedSpecifiedDelays;
+			archive(cachedSpecifiedDelays, *asset);
+			if (asset->IsEmpty())
+			{
+				SET_RESULT(RESULT_WARNING, "The HRTF cache file does not have tables");
+				return false;
+			}
+
+			//The audio thread indexes the tables without checking them, so a corrupted file whose key is right is discarded here
+			if ((static_cast<uint32_t>(asset->GetBufferSize()) != key.bufferSize) || (static_cast<uint32_t>(asset->GetResamplingStep()) != key.resamplingStep) ||
+				(static_cast<uint32_t>(asset->GetHybridPartitionsPerSegment()) != key.hybridPartitionsPerSegment) || !asset->IsValid())
+			{
+				SET_RESULT(RESULT_WARNING, "The tables of the HRTF cache file are not consistent with its key or with each other, it may be corrupted");
+				return false;
+			}
+
+			listener->GetHRTF()->SetHRTFAsset(asset);
+			specifiedDelays = cachedSpecifiedDelays;
+			SET_RESULT(RESULT_OK, "HRTF created from cache file");
+			return true;
+		}
+		catch (const std::exception& e)
+		{
+			//cereal::Exception included, for example if the file has been truncated
+			SET_RESULT(RESULT_WARNING, e.what());
+			return false;
+		}
+		catch (...)
+		{
+			SET_RESULT(RESULT_WARNING, "Unknown exception when loading HRTF cache file");
+			return false;
+		}
+	}
+
+//////////////////////////////////////////////////////
+
+	bool CalculateFileHash(const std::string & fileName, uint64_t & hash)
+	{
+		std::ifstream fileStream(fileName, std::ios::binary);
+		if (!fileStream.is_open())
+		{
+			SET_RESULT(RESULT_ERROR_FILE, "Could not open file to calculate its hash");
+			return false;
+		}
+
+		//64-bit FNV-1a
+		hash = 14695981039346656037ULL;
+		std::vector<char> block(1 << 16);
+		while (fileStream)
+		{
+			fileStream.read(block.data(), block.size());
+			std::streamsize bytesRead = fileStream.gcount();
+			for (std::streamsize i = 0; i < bytesRead; i++)
+			{
+				hash ^= static_cast<unsigned char>(block[i]);
+				hash *= 1099511628211ULL;
+			}
+		}
+		return true;
+	}
+
+//////////////////////////////////////////////////////
+
+	bool SaveHRTFCache(const std::string & cacheFile, uint64_t sourceHash, shared_ptr<Binaural::CListener> listener)
+	{
+		return SaveCache(cacheFile, sourceHash, false, listener);
+	}
+
+//////////////////////////////////////////////////////
+
+	bool LoadHRTFCache(const std::string & cacheFile, uint64_t sourceHash, shared_ptr<Binaural::CListener> listener)
+	{
+		bool specifiedDelays;
+		return LoadCache(cacheFile, sourceHash, specifiedDelays, listener);
+	}
+
+//////////////////////////////////////////////////////
+
+	bool CreateFrom3dtiWithCache(const std::string & input3dti, const std::string & cacheFile, shared_ptr<Binaural::CListener> listener)
+	{
+		uint64_t sourceHash;
+		if (!CalculateFileHash(input3dti, sourceHash)) { return false; }
+
+		bool specifiedDelays;
+		if (LoadCache(cacheFile, sourceHash, specifiedDelays, listener)) { return true; }
+
+		if (!CreateFrom3dti(input3dti, listener)) { return false; }
+		SaveCache(cacheFile, sourceHash, false, listener);		//The HRTF has been loaded even if the cache file can not be written
+		return true;
+	}
+
+//////////////////////////////////////////////////////
+
+	bool CreateFromSofaWithCache(const std::string & sofafile, const std::string & cacheFile, shared_ptr<Binaural::CListener> listener, bool & specifiedDelays)
+	{
+		uint64_t sourceHash;
+		if (!CalculateFileHash(sofafile, sourceHash)) { return false; }
+
+		if (LoadCache(cacheFile, sourceHash, specifiedDelays, listener)) { return true; }
+
+		if (!CreateFromSofa(sofafile, listener, specifiedDelays)) { return false; }
+		SaveCache(cacheFile, sourceHash, specifiedDelays, listener);		//The HRTF has been loaded even if the cache file can not be written
+		return true;
+	}
+
+//////////////////////////////////////////////////////
+}
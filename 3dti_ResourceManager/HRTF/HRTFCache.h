@@ -0,0 +1,104 @@
+/**
+*
+* \brief Functions to cache on disk the resampled and partitioned tables of HRTFs
+*
+* \date	October 2026
+*
+* \authors 3DI - DIANA Research Group(University of Malaga), in alphabetical order : M.Cuevas - Rodriguez, C.Garre, D.Gonzalez - Toledo, E.J.de la Rubia - Cuestas, L.Molina - Tanco ||
+*Coordinated by, A.Reyes - Lecuona(University of Malaga) and L.Picinali(Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions : (additional authors / contributors can be added here)
+*
+* \b Project : 3DTI(3D - games for TUNing and lEarnINg about hearing aids) ||
+*\b Website : http://3d-tune-in.eu/
+*
+* \b Copyright : University of Malaga and Imperial College London - 2018
+*
+* \b Licence : This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement : This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#ifndef HRTFCache_h
+#define HRTFCache_h
+
+#include <BinauralSpatializer/Listener.h>
+#include <BinauralSpatializer/HRTFAsset.h>
+#include <string>
+#include <stdint.h>
+
+/** \brief Version of the format of the cache files. It has to be increased whenever the layout of CHRTFAsset or of its tables changes, so older files are calculated again
+*/
+#define HRTF_CACHE_FORMAT_VERSION 1
+
+/** \brief Parameters the tables of a cache file have been calculated with. A cache file is only loaded if all of them are the same ones
+*/
+struct HRTFCacheKey_struct
+{
+	uint32_t formatVersion;					///< Version of the format of the file (HRTF_CACHE_FORMAT_VERSION)
+	uint32_t alignment;						///< Alignment of the subfilters in the partitioned table, in bytes (Common::SIMD_ALIGNMENT)
+	uint64_t sourceHash;					///< Hash of the content of the HRTF file the tables have been calculated from
+	uint32_t sampleRate;					///< Sample rate of the core
+	uint32_t bufferSize;					///< Buffer size of the core
+	uint32_t resamplingStep;				///< Resampling step of the core, in degrees
+	uint32_t hybridPartitionsPerSegment;	///< Partitions per segment of the hybrid HRTF convolution of the core, 0 if it is disabled
+};
+
+// Serialization function for the key of a cache file
+template <class Archive>
+void serialize(Archive & ar, HRTFCacheKey_struct & key)
+{
+	ar(key.formatVersion, key.alignment, key.sourceHash, key.sampleRate, key.bufferSize, key.resamplingStep, key.hybridPartitionsPerSegment);
+}
+
+namespace HRTF {
+
+	/** \brief Calculate a hash of the whole content of a file (64-bit FNV-1a), to know if a cache file has been calculated from it
+	*	\param [in] fileName path of the file
+	*	\param [out] hash hash of the content of the file
+	*	\retval result true if the file could be read
+	*   \eh On error, an error code is reported to the error handler. */
+	bool CalculateFileHash(const std::string & fileName, uint64_t & hash);
+
+	/** \brief Save the HRTF of a listener, with its resampled and partitioned tables, into a cache file
+	*	\details The file is written with another name and renamed at the end, so an interrupted save does not leave a broken cache file
+	*	\param [in] cacheFile path of the cache file, replaced if it exists
+	*	\param [in] sourceHash hash of the HRTF file the HRTF has been loaded from (see CalculateFileHash)
+	*	\param [in] listener listener whose HRTF has been loaded
+	*	\retval result true if the cache file has been written
+	*   \eh On error, an error code is reported to the error handler. */
+	bool SaveHRTFCache(const std::string & cacheFile, uint64_t sourceHash, shared_ptr<Binaural::CListener> listener);
+
+	/** \brief Load an HRTF from a cache file, without calculating its tables
+	*	\details The cache file is only loaded if it has been calculated from the same HRTF file and with the sample rate, buffer size, resampling step and
+	*	HRTF convolution of the core of the listener. The tables are set with CHRTF::SetHRTFAsset.
+	*	\param [in] cacheFile path of the cache file
+	*	\param [in] sourceHash hash of the HRTF file (see CalculateFileHash)
+	*	\param [out] listener listener affected by the hrtf
+	*	\retval result true if the HRTF has been loaded, false if the cache file does not exist, is not valid or has been calculated with other parameters
+	*   \eh On success, RESULT_OK is reported to the error handler.
+	*       Warnings may be reported to the error handler. */
+	bool LoadHRTFCache(const std::string & cacheFile, uint64_t sourceHash, shared_ptr<Binaural::CListener> listener);
+
+	/** \brief Load HRTF head from 3dti file, using a cache file of its tables
+	*	\details If the cache file is valid for the 3dti file and the core of the listener, the HRTF is loaded from it.
+	*	Otherwise, the HRTF is loaded from the 3dti file and the cache file is written for the next time.
+	*	\param [in] input3dti path of the 3dti file
+	*	\param [in] cacheFile path of the cache file
+	*	\param [out] listener listener affected by the hrtf
+	*   \eh On error, an error code is reported to the error handler. */
+	bool CreateFrom3dtiWithCache(const std::string & input3dti, const std::string & cacheFile, shared_ptr<Binaural::CListener> listener);
+
+	/** \brief Load HRTF head from sofa file, using a cache file of its tables
+	*	\details If the cache file is valid for the sofa file and the core of the listener, the HRTF is loaded from it.
+	*	Otherwise, the HRTF is loaded from the sofa file and the cache file is written for the next time.
+	*	\param [in] sofafile path of the sofa file
+	*	\param [in] cacheFile path of the cache file
+	*	\param [out] listener listener affected by the hrtf
+	*	\param [out] specifiedDelays true if the delays of the HRIRs are specified in the sofa file, as CreateFromSofa
+	*   \eh On error, an error code is reported to the error handler. */
+	bool CreateFromSofaWithCache(const std::string & sofafile, const std::string & cacheFile, shared_ptr<Binaural::CListener> listener, bool & specifiedDelays);
+}
+
+#endif
@@ -0,0 +1,161 @@
+/**
+*
+* \brief Functions to handle HRTFs in the flat format
+*
+* \date	October 2026
+*
+* \authors 3DI - DIANA Research Group(University of Malaga), in alphabetical order : M.Cuevas - Rodriguez, C.Garre, D.Gonzalez - Toledo, E.J.de la Rubia - Cuestas, L.Molina - Tanco ||
+*Coordinated by, A.Reyes - Lecuona(University of Malaga) and L.Picinali(Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions : (additional authors / contributors can be added here)
+*
+* \b Project : 3DTI(3D - games for TUNing and lEarnINg about hearing aids) ||
+*\b Website : http://3d-tune-in.eu/
+*
+* \b Copyright : University of Malaga and Imperial College London - 2018
+*
+* \b Licence : This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement : This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#include "HRTFFlat.h"
+#include "HRTFCereal.h"
+#include "../Flat/FlatResource.h"
+#include <Common/ErrorHandler.h>
+#include <fstream>
+
+namespace HRTF
+{
+
+//////////////////////////////////////////////////////
+
+	// Write an HRTF table into a flat file, one entry with the left and right HRIRs for each orientation
+	static bool WriteFlatTable(const std::string & outputFlat, uint32_t samplingRate, uint32_t hrirLength, float distanceOfMeasurement, const T_HRTFTable & table, uint32_t flags)
+	{
+		std::vector<TFlatResourceItem> items;
+		items.reserve(table.size());
+		for (auto it = table.begin(); it != table.end(); it++)
+		{
+			if ((it->second.leftHRIR.size() != hrirLength) || (it->second.rightHRIR.size() != hrirLength))
+			{
+				SET_RESULT(RESULT_ERROR_BADSIZE, "The HRIRs of the HRTF table do not have the length of the HRTF");
+				return false;
+			}
+			TFlatResourceItem item;
+			item.entry.key0 = it->first.azimuth;
+			item.entry.key1 = it->first.elevation;
+			item.entry.leftDelay = it->second.leftDelay;
+			item.entry.rightDelay = it->second.rightDelay;
+			item.entry.payloadOffset = 0;
+			item.channels.push_back(it->second.leftHRIR.data());
+			item.channels.push_back(it->second.rightHRIR.data());
+			items.push_back(std::move(item));
+		}
+		return Flat::WriteFlatResource(outputFlat, FLAT_RESOURCE_HRTF, samplingRate, hrirLength, distanceOfMeasurement, items, flags);
+	}
+
+//////////////////////////////////////////////////////
+
+	int GetSampleRateFromFlat(const std::string & inputFlat)
+	{
+		Flat::CFlatResource flat;
+		if (!flat.Open(inputFlat, FLAT_RESOURCE_HRTF)) { return -1; }
+		return static_cast<int>(flat.GetHeader().samplingRate);
+	}
+
+//////////////////////////////////////////////////////
+
+	bool CreateFromFlat(const std::string & inputFlat, shared_ptr<Binaural::CListener> listener)
+	{
+		Flat::CFlatResource flat;
+		if (!flat.Open(inputFlat, FLAT_RESOURCE_HRTF)) { return false; }
+
+		const TFlatResourceHeader & header = flat.GetHeader();
+		if (header.channelsPerEntry != 2)
+		{
+			SET_RESULT(RESULT_ERROR_BADSIZE, "The flat HRTF file does not have two channels (left and right) for each orientation");
+			return false;
+		}
+
+		try
+		{
+			//The HRIRs are copied once from the mapped file to the database of the HRTF, which needs its own copy to calculate the resampled tables
+			T_HRTFTable table;
+			table.reserve(flat.GetNumberOfEntries());
+			for (uint32_t i = 0; i < flat.GetNumberOfEntries(); i++)
+			{
+				const TFlatResourceEntry & entry = flat.GetEntry(i);
+				const float* left = flat.GetChannel(i, 0);
+				const float* right = flat.GetChannel(i, 1);
+
+				THRIRStruct & hrir = table[orientation(entry.key0, entry.key1)];
+				hrir.leftDelay = entry.leftDelay;
+				hrir.rightDelay = entry.rightDelay;
+				hrir.leftHRIR.assign(left, left + header.channelLength);
+				hrir.rightHRIR.assign(right, right + header.channelLength);
+			}
+
+			listener->GetHRTF()->BeginSetup(header.channelLength, header.distanceOfMeasurement);
+			listener->GetHRTF()->AddHRTFTable(std::move(table));
+
+			//A database saved by SaveFlat has already been processed, only the resampled tables are calculated
+			if ((header.flags & FLAT_RESOURCE_FLAG_PROCESSED_HRTF) != 0) { listener->GetHRTF()->EndSetupFromProcessedDatabase(); }
+			else { listener->GetHRTF()->EndSetup(); }
+			SET_RESULT(RESULT_OK, "HRTF created from flat file");
+			return true;
+		}
+		catch (const std::exception& e)
+		{
+			SET_RESULT(RESULT_ERROR_EXCEPTION, e.what());
+			return false;
+		}
+	}
+
+//////////////////////////////////////////////////////
+
+	bool SaveFlat(const std::string & outputFlat, shared_ptr<Binaural::CListener> listener)
+	{
+		if (!listener->GetHRTF()->IsHRTFLoaded())
+		{
+			SET_RESULT(RESULT_ERROR_NOTSET, "The HRTF of the listener has not been loaded, so it can not be written into a flat file");
+			return false;
+		}
+		//The database has been processed by EndSetup, so the file is marked to skip that processing when it is loaded
+		Binaural::CHRTF* hrtf = listener->GetHRTF();
+		return WriteFlatTable(outputFlat, listener->GetCoreAudioState().sampleRate, hrtf->GetHRIRLength(), hrtf->GetHRTFDistanceOfMeasurement(), hrtf->GetRawHRTFTable(), FLAT_RESOURCE_FLAG_PROCESSED_HRTF);
+	}
+
+//////////////////////////////////////////////////////
+
+	bool Convert3dtiToFlat(const std::string & input3dti, const std::string & outputFlat)
+	{
+		std::ifstream input3dtiStream(input3dti, std::ios::binary);
+		if (!input3dtiStream.is_open())
+		{
+			SET_RESULT(RESULT_ERROR_FILE, "Could not open 3DTI-HRTF file");
+			return false;
+		}
+
+		HRTFDetail_struct hrtf;
+		try
+		{
+			cereal::PortableBinaryInputArchive archive(input3dtiStream);
+			archive(hrtf);
+		}
+		catch (const std::exception& e)
+		{
+			SET_RESULT(RESULT_ERROR_EXCEPTION, e.what());
+			return false;
+		}
+		catch (...)
+		{
+			SET_RESULT(RESULT_ERROR_EXCEPTION, "Unknown exception when reading 3DTI-HRTF file");
+			return false;
+		}
+		return WriteFlatTable(outputFlat, hrtf.samplingRate, hrtf.hrirLength, hrtf.distanceOfMeasurement, hrtf.table, 0);
+	}
+
+//////////////////////////////////////////////////////
+}
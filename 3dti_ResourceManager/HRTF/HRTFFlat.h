@@ -0,0 +1,61 @@
+/**
+*
+* \brief Functions to handle HRTFs in the flat format
+*
+* \date	October 2026
+*
+* \authors 3DI - DIANA Research Group(University of Malaga), in alphabetical order : M.Cuevas - Rodriguez, C.Garre, D.Gonzalez - Toledo, E.J.de la Rubia - Cuestas, L.Molina - Tanco ||
+*Coordinated by, A.Reyes - Lecuona(University of Malaga) and L.Picinali(Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions : (additional authors / contributors can be added here)
+*
+* \b Project : 3DTI(3D - games for TUNing and lEarnINg about hearing aids) ||
+*\b Website : http://3d-tune-in.eu/
+*
+* \b Copyright : University of Malaga and Imperial College London - 2018
+*
+* \b Licence : This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement : This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#ifndef HRTFFlat_h
+#define HRTFFlat_h
+
+#include <BinauralSpatializer/Listener.h>
+#include <string>
+
+namespace HRTF {
+
+	/** \brief Returns the sample rate in the flat file whose path is inputFlat
+	*	\param [in] inputFlat path of the flat file
+	*   \eh On error, an error code is reported to the error handler.
+	*	\retval sampleRate the sample rate of the file, -1 on error */
+	int GetSampleRateFromFlat(const std::string & inputFlat);
+
+	/** \brief Load HRTF head from flat file
+	*	\details The file is mapped into memory and the HRIRs are copied directly from it to the HRTF of the listener, without deserializing them.
+	*	If the file has been written by SaveFlat, its database has already been processed, so only the resampled tables are calculated (see CHRTF::EndSetupFromProcessedDatabase)
+	*	\param [in] inputFlat path of the flat file
+	*	\param [out] listener listener affected by the hrtf
+	*   \eh On error, an error code is reported to the error handler. */
+	bool CreateFromFlat(const std::string & inputFlat, shared_ptr<Binaural::CListener> listener);
+
+	/** \brief Write the HRTF of a listener into a flat file
+	*	\details The HRTF database of the listener is written, so an HRTF loaded from any format (3dti or sofa) can be converted.
+	*	The database is the one kept by CHRTF after EndSetup, without the common delay of the HRIRs and with the HRIRs of the poles, so the file is marked as processed
+	*	(FLAT_RESOURCE_FLAG_PROCESSED_HRTF) and CreateFromFlat does not process it again. Its sample rate is the one of the core of the listener, the HRIRs are not resampled
+	*	\param [in] outputFlat path of the flat file, replaced if it exists
+	*	\param [in] listener listener whose HRTF has been loaded
+	*   \eh On error, an error code is reported to the error handler. */
+	bool SaveFlat(const std::string & outputFlat, shared_ptr<Binaural::CListener> listener);
+
+	/** \brief Convert a 3dti HRTF file into a flat file, without loading it in a listener
+	*	\param [in] input3dti path of the 3dti file
+	*	\param [in] outputFlat path of the flat file, replaced if it exists
+	*   \eh On error, an error code is reported to the error handler. */
+	bool Convert3dtiToFlat(const std::string & input3dti, const std::string & outputFlat);
+}
+
+#endif
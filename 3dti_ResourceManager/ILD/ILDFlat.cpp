@@ -0,0 +1,138 @@
+/**
+*
+* \brief Functions to handle ILDs in the flat format
+*
+* \date	October 2026
+*
+* \authors 3DI - DIANA Research Group(University of Malaga), in alphabetical order : M.Cuevas - Rodriguez, C.Garre, D.Gonzalez - Toledo, E.J.de la Rubia - Cuestas, L.Molina - Tanco ||
+*Coordinated by, A.Reyes - Lecuona(University of Malaga) and L.Picinali(Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions : (additional authors / contributors can be added here)
+*
+* \b Project : 3DTI(3D - games for TUNing and lEarnINg about hearing aids) ||
+*\b Website : http://3d-tune-in.eu/
+*
+* \b Copyright : University of Malaga and Imperial College London - 2018
+*
+* \b Licence : This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement : This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#include "ILDFlat.h"
+#include "ILDCereal.h"
+#include "../Flat/FlatResource.h"
+#include <Common/ErrorHandler.h>
+#include <algorithm>
+#include <fstream>
+
+#define ILD_FLAT_NUMBER_OF_COEFFICIENTS (sizeof(T_ILD_TwoBiquadFilterCoefs::coefs) / sizeof(float))
+
+namespace ILD
+{
+
+//////////////////////////////////////////////////////
+
+	// Read a flat file into an ILD table, one entry with the coefficients of the two biquad filters for each distance and azimuth
+	static bool ReadFlatTable(const std::string & inputFlat, T_ILD_HashTable & table)
+	{
+		Flat::CFlatResource flat;
+		if (!flat.Open(inputFlat, FLAT_RESOURCE_ILD)) { return false; }
+
+		const TFlatResourceHeader & header = flat.GetHeader();
+		if ((header.channelsPerEntry != 1) || (header.channelLength != ILD_FLAT_NUMBER_OF_COEFFICIENTS))
+		{
+			SET_RESULT(RESULT_ERROR_BADSIZE, "The flat ILD file does not have the coefficients of two biquad filters for each distance and azimuth");
+			return false;
+		}
+
+		table.reserve(flat.GetNumberOfEntries());
+		for (uint32_t i = 0; i < flat.GetNumberOfEntries(); i++)
+		{
+			const TFlatResourceEntry & entry = flat.GetEntry(i);
+			const float* coefs = flat.GetChannel(i, 0);
+			T_ILD_TwoBiquadFilterCoefs filterCoefs;
+			std::copy(coefs, coefs + ILD_FLAT_NUMBER_OF_COEFFICIENTS, filterCoefs.coefs);
+			table.emplace(CILD_Key(entry.key0, entry.key1), filterCoefs);
+		}
+		return true;
+	}
+
+//////////////////////////////////////////////////////
+
+	int GetSampleRateFromFlat(const std::string & inputFlat)
+	{
+		Flat::CFlatResource flat;
+		if (!flat.Open(inputFlat, FLAT_RESOURCE_ILD)) { return -1; }
+		return static_cast<int>(flat.GetHeader().samplingRate);
+	}
+
+//////////////////////////////////////////////////////
+
+	bool CreateFromFlat_ILDNearFieldEffectTable(const std::string & inputFlat, shared_ptr<Binaural::CListener> listener)
+	{
+		T_ILD_HashTable table;
+		if (!ReadFlatTable(inputFlat, table)) { return false; }
+		listener->GetILD()->AddILDNearFieldEffectTable(std::move(table));
+		SET_RESULT(RESULT_OK, "ILD created from flat file");
+		return true;
+	}
+
+//////////////////////////////////////////////////////
+
+	bool CreateFromFlat_ILDSpatializationTable(const std::string & inputFlat, shared_ptr<Binaural::CListener> listener)
+	{
+		T_ILD_HashTable table;
+		if (!ReadFlatTable(inputFlat, table)) { return false; }
+		listener->GetILD()->AddILDSpatializationTable(std::move(table));
+		SET_RESULT(RESULT_OK, "ILD created from flat file");
+		return true;
+	}
+
+//////////////////////////////////////////////////////
+
+	bool Convert3dtiToFlat(const std::string & input3dti, const std::string & outputFlat)
+	{
+		std::ifstream input3dtiStream(input3dti, std::ios::binary);
+		if (!input3dtiStream.is_open())
+		{
+			SET_RESULT(RESULT_ERROR_FILE, "Could not open 3DTI-ILD file");
+			return false;
+		}
+
+		ILDDetail_struct ild;
+		try
+		{
+			cereal::PortableBinaryInputArchive archive(input3dtiStream);
+			archive(ild);
+		}
+		catch (const std::exception& e)
+		{
+			SET_RESULT(RESULT_ERROR_EXCEPTION, e.what());
+			return false;
+		}
+		catch (...)
+		{
+			SET_RESULT(RESULT_ERROR_EXCEPTION, "Unknown exception when reading 3DTI-ILD file");
+			return false;
+		}
+
+		std::vector<TFlatResourceItem> items;
+		items.reserve(ild.table.size());
+		for (auto it = ild.table.begin(); it != ild.table.end(); it++)
+		{
+			TFlatResourceItem item;
+			item.entry.key0 = it->first.distance;
+			item.entry.key1 = it->first.azimuth;
+			item.entry.leftDelay = 0;
+			item.entry.rightDelay = 0;
+			item.entry.payloadOffset = 0;
+			item.channels.push_back(it->second.coefs);
+			items.push_back(std::move(item));
+		}
+		return Flat::WriteFlatResource(outputFlat, FLAT_RESOURCE_ILD, ild.samplingRate, ILD_FLAT_NUMBER_OF_COEFFICIENTS, 0.0f, items);
+	}
+
+//////////////////////////////////////////////////////
+}
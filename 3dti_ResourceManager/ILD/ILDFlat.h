@@ -0,0 +1,63 @@
+/**
+*
+* \brief Functions to handle ILDs in the flat format
+*
+* \date	October 2026
+*
+* \authors 3DI - DIANA Research Group(University of Malaga), in alphabetical order : M.Cuevas - Rodriguez, C.Garre, D.Gonzalez - Toledo, E.J.de la Rubia - Cuestas, L.Molina - Tanco ||
+*Coordinated by, A.Reyes - Lecuona(University of Malaga) and L.Picinali(Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions : (additional authors / contributors can be added here)
+*
+* \b Project : 3DTI(3D - games for TUNing and lEarnINg about hearing aids) ||
+*\b Website : http://3d-tune-in.eu/
+*
+* \b Copyright : University of Malaga and Imperial College London - 2018
+*
+* \b Licence : This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement : This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#ifndef ILDFlat_h
+#define ILDFlat_h
+
+#include <BinauralSpatializer/ILD.h>
+#include <BinauralSpatializer/Listener.h>
+#include <string>
+
+namespace ILD
+{
+	/** \brief Returns the sample rate in the flat file whose path is inputFlat
+	*	\param [in] inputFlat path of the flat file
+	*   \eh On error, an error code is reported to the error handler.
+	*	\retval sampleRate the sample rate of the file, -1 on error
+	*/
+	int GetSampleRateFromFlat(const std::string & inputFlat);
+
+	/** \brief Create the ILD near field effect table of a listener from a flat file
+	*   \details The file is mapped into memory and the coefficients are copied directly from it, without deserializing them
+	*	\param [in] inputFlat path of the flat file
+	*	\param [out] listener listener that is affected by the ILD
+	*   \eh On error, an error code is reported to the error handler.
+	*/
+	bool CreateFromFlat_ILDNearFieldEffectTable(const std::string & inputFlat, shared_ptr<Binaural::CListener> listener);
+
+	/** \brief Create the ILD spatialization table of a listener from a flat file
+	*   \details The file is mapped into memory and the coefficients are copied directly from it, without deserializing them
+	*	\param [in] inputFlat path of the flat file
+	*	\param [out] listener listener that is affected by the spatialization table
+	*   \eh On error, an error code is reported to the error handler.
+	*/
+	bool CreateFromFlat_ILDSpatializationTable(const std::string & inputFlat, shared_ptr<Binaural::CListener> listener);
+
+	/** \brief Convert a 3dti ILD file (near field effect or spatialization table) into a flat file, without loading it in a listener
+	*	\param [in] input3dti path of the 3dti file
+	*	\param [in] outputFlat path of the flat file, replaced if it exists
+	*   \eh On error, an error code is reported to the error handler.
+	*/
+	bool Convert3dtiToFlat(const std::string & input3dti, const std::string & outputFlat);
+}
+
+#endif
@@ -25,5 +25,6 @@
 #include <BinauralSpatializer/Core.h> 
 #include <BinauralSpatializer/Environment.h>
 #include <BinauralSpatializer/Listener.h>
+#include <BinauralSpatializer/HRTFAsset.h>
 
 #endif
\ No newline at end of file
@@ -22,6 +22,7 @@
 */
 
 #include <BinauralSpatializer/BRIR.h>
+#include <algorithm>
 namespace Binaural {
 
 
@@ -41,7 +42,7 @@ namespace Binaural {
 
 			//UPC algorithm init variables
 			BRIRsubfilterLength_time = 2 * bufferSize;
-			BRIRsubfilterLength_frequency = 2 * BRIRsubfilterLength_time;
+			BRIRsubfilterLength_frequency = BRIRsubfilterLength_time + 2;		//Points 0 to N/2 of the spectrum, real and imaginary parts
 			float temp_impulseResponseNumberOfBlocks = (float)BRIRLength / (float)bufferSize;
 			BRIRNumOfSubfilters = static_cast<int>(std::ceil(temp_impulseResponseNumberOfBlocks));
 
@@ -94,6 +95,8 @@ namespace Binaural {
 #ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC
 			t_BRIRFFT = CalculateBRIRFFT_Table();
 #else
+			//The partitions of the tail that are negligible in all the BRIRs are not convolved
+			BRIRNumOfSubfilters = CalculateNumberOfSignificantSubfilters();
 			t_BRIR_partitioned = CalculateBRIRFFT_Table_partitioned();
 #endif 
 			
@@ -125,7 +128,7 @@ namespace Binaural {
 
 			//UPC algorithm init variables
 			BRIRsubfilterLength_time = 2 * bufferSize;
-			BRIRsubfilterLength_frequency = 2 * BRIRsubfilterLength_time;
+			BRIRsubfilterLength_frequency = BRIRsubfilterLength_time + 2;		//Points 0 to N/2 of the spectrum, real and imaginary parts
 			float temp_impulseResponseNumberOfBlocks = (float)BRIRLength / (float)bufferSize;
 			BRIRNumOfSubfilters = static_cast<int>(std::ceil(temp_impulseResponseNumberOfBlocks));
 
@@ -215,6 +218,29 @@ namespace Binaural {
 		return BRIR_ready;
 	}
 
+	void CBRIR::EnableTailTruncation() {
+		enableTailTruncation = true;
+	}
+
+	void CBRIR::DisableTailTruncation() {
+		enableTailTruncation = false;
+	}
+
+	bool CBRIR::IsTailTruncationEnabled() const {
+		return enableTailTruncation;
+	}
+
+	void CBRIR::SetTailTruncationThreshold(float thresholdDB) {
+		ASSERT(thresholdDB < 0.0f, RESULT_ERROR_OUTOFRANGE, "The threshold of the BRIR tail truncation has to be negative (dB relative to the strongest partition)", "");
+		if (thresholdDB < 0.0f) {	//Just in case error handler is off
+			tailTruncationThreshold = thresholdDB;
+		}
+	}
+
+	float CBRIR::GetTailTruncationThreshold() const {
+		return tailTruncationThreshold;
+	}
+
 	// PRIVATE METHODS
 	
 
@@ -248,6 +274,39 @@ namespace Binaural {
 		return newBRIR_Table_Partitioned;	
 	}
 
+	int CBRIR::CalculateNumberOfSignificantSubfilters()
+	{
+		int numberOfBlocks = static_cast<int>(std::ceil((float)BRIRLength / (float)bufferSize));
+		if (!enableTailTruncation || (numberOfBlocks == 0)) { return numberOfBlocks; }
+
+		//Energy of each partition, the highest one among all the BRIRs
+		std::vector<float> blockEnergy(numberOfBlocks, 0.0f);
+		for (auto it = t_BRIR_DataBase.begin(); it != t_BRIR_DataBase.end(); it++)
+		{
+			const TImpulseResponse & BRIR = it->second;
+			for (int block = 0; block < numberOfBlocks; block++)
+			{
+				int end = std::min((block + 1) * bufferSize, (int)BRIR.size());
+				float energy = 0.0f;
+				for (int i = block * bufferSize; i < end; i++) {
+					energy += BRIR[i] * BRIR[i];
+				}
+				blockEnergy[block] = std::max(blockEnergy[block], energy);
+			}
+		}
+
+		float peakEnergy = *std::max_element(blockEnergy.begin(), blockEnergy.end());
+		if (peakEnergy == 0.0f) { return numberOfBlocks; }
+
+		//Keep every partition up to the last one above the threshold
+		float thresholdEnergy = peakEnergy * std::pow(10.0f, tailTruncationThreshold / 10.0f);
+		int numberOfSignificantBlocks = numberOfBlocks;
+		while ((numberOfSignificantBlocks > 1) && (blockEnergy[numberOfSignificantBlocks - 1] < thresholdEnergy)) {
+			numberOfSignificantBlocks--;
+		}
+		return numberOfSignificantBlocks;
+	}
+
 	TImpulseResponse_Partitioned CBRIR::CalculateBRIRFFT_partitioned(const TImpulseResponse & newData_time)
 	{
 		int blockSize = bufferSize;
@@ -257,7 +316,8 @@ namespace Binaural {
 		new_DataFFT_Partitioned.reserve(numberOfBlocks);
 		//Index to go throught the AIR values in time domain
 		int index;
-		for (int i = 0; i < newData_time.size(); i = i + blockSize)
+		//Only the first numberOfBlocks partitions are calculated, the rest of the BRIR may have been truncated
+		for (int i = 0; (i < (int)newData_time.size()) && (new_DataFFT_Partitioned.size() < (size_t)numberOfBlocks); i = i + blockSize)
 		{
 			CMonoBuffer<float> data_FFT_doubleSize;
 			//Resize with double size and zeros to make the zero-padded demanded by the algorithm
@@ -271,7 +331,7 @@ namespace Binaural {
 			}
 			//FFT
 			CMonoBuffer<float> data_FFT;
-			Common::CFprocessor::CalculateFFT(data_FFT_doubleSize, data_FFT);
+			Common::CFprocessor::CalculateFFT_HalfSpectrum(data_FFT_doubleSize, data_FFT);
 			//Prepare struct to return the value
 			new_DataFFT_Partitioned.push_back(data_FFT);
 		}
@@ -31,6 +31,10 @@
 #include <Common/ErrorHandler.h>
 #include <Common/CommonDefinitions.h>
 
+/** \brief Default threshold, in dB relative to the strongest partition, below which the final partitions of the BRIRs are dropped
+*/
+#define DEFAULT_BRIR_TAIL_TRUNCATION_THRESHOLD -90.0f
+
 /** \brief Type definition for virtual speakers in BRIR
 */
 struct TVirtualSpeaker
@@ -95,13 +99,13 @@ namespace Binaural
 		*	\param [in] _ownerEnvironment pointer to environment object
 		*   \eh Nothing is reported to the error handler.
 		*/
-		CBRIR(CEnvironment* _ownerEnvironment) :ownerEnvironment{ _ownerEnvironment }, BRIR_ready{false} {}
+		CBRIR(CEnvironment* _ownerEnvironment) :ownerEnvironment{ _ownerEnvironment }, BRIR_ready{false}, enableTailTruncation{ false }, tailTruncationThreshold{ DEFAULT_BRIR_TAIL_TRUNCATION_THRESHOLD } {}
 
 		/**	\brief Default constructor 
 		*	\details Sets the BRIR data as not ready and the environment object as a null pointer
 		*   \eh Nothing is reported to the error handler.
 		*/
-		CBRIR() :ownerEnvironment{ nullptr }, BRIR_ready{ false } {}
+		CBRIR() :ownerEnvironment{ nullptr }, BRIR_ready{ false }, enableTailTruncation{ false }, tailTruncationThreshold{ DEFAULT_BRIR_TAIL_TRUNCATION_THRESHOLD } {}
 
 		/**	\brief Start a new BRIR configuration.
 		*	\param [in] _BRIRLength integer that indicates the BRIR length
@@ -147,6 +151,7 @@ namespace Binaural
 		int GetBRIRLength_frequency();
 
 		/** \brief Get BRIR sub-filter (after partition) length in frequency domain
+		*	\details Sub-filters are stored as the half spectrum (points 0 to N/2) of an FFT of N = 2 * bufferSize points, so their length is N + 2
 		*   \retval length BRIR sub-filter length in frequency domain
 		*   \eh Nothing is reported to the error handler.
 		*/
@@ -197,6 +202,40 @@ namespace Binaural
 		
 		bool IsIREmpty(const TImpulseResponse_Partitioned& in);
 
+		/** \brief Enable the truncation of the tail of the BRIRs (disabled by default)
+		*	\details When the setup ends, the final partitions whose energy is below the truncation threshold in all the BRIRs are not used, so they are not convolved in each block.
+		*	The reverb is not exactly the same one, since the dropped partitions are not added to it.
+		*	It has to be called before the BRIR setup, or before loading the BRIR.
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void EnableTailTruncation();
+
+		/** \brief Disable the truncation of the tail of the BRIRs, so all the partitions are convolved (by default)
+		*	\details It has to be called before the BRIR setup, or before loading the BRIR.
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void DisableTailTruncation();
+
+		/** \brief Get the flag for the truncation of the tail of the BRIRs
+		*	\retval IsTailTruncationEnabled if true, the tail of the BRIRs is truncated
+		*   \eh Nothing is reported to the error handler.
+		*/
+		bool IsTailTruncationEnabled() const;
+
+		/** \brief Set the threshold of the truncation of the tail of the BRIRs
+		*	\details A partition is negligible when its energy, in all the BRIRs, is below the energy of the strongest partition of the BRIR table by this amount.
+		*	Only the negligible partitions at the end of the BRIRs are dropped. It has to be called before the BRIR setup, or before loading the BRIR.
+		*	\param [in] thresholdDB threshold in dB relative to the strongest partition, for example -90 dB. It has to be negative.
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void SetTailTruncationThreshold(float thresholdDB);
+
+		/** \brief Get the threshold of the truncation of the tail of the BRIRs
+		*	\retval thresholdDB threshold in dB relative to the strongest partition
+		*   \eh Nothing is reported to the error handler.
+		*/
+		float GetTailTruncationThreshold() const;
+
 	private:
 
 		////////////
@@ -206,6 +245,9 @@ namespace Binaural
 		TImpulseResponse				CalculateBRIRFFT(const TImpulseResponse & newData_time);
 		TBRIRTable					CalculateBRIRFFT_Table();
 		TBRIRTablePartitioned		CalculateBRIRFFT_Table_partitioned();
+
+		// Calculate the number of partitions up to the last one that is not negligible in some BRIR
+		int CalculateNumberOfSignificantSubfilters();
 		
 		// Recalculate the BRIR FFT table partitioned or not with a new bufferSize
 		void CalculateNewBRIRTable();
@@ -229,6 +271,8 @@ namespace Binaural
 		int BRIRsubfilterLength_time;		// BRIR subfilter in time domain buffer size 
 		int BRIRsubfilterLength_frequency;	// BRIR subfilter in frequency domain buffer size 
 		int BRIRNumOfSubfilters;			// Number of subfilters of the partitioned BRIR
+		bool enableTailTruncation;			// Drop the negligible partitions at the end of the BRIRs
+		float tailTruncationThreshold;		// Energy, in dB relative to the strongest partition, below which a partition is negligible
 
 		//empty variables
 		TImpulseResponse_Partitioned emptyBRIR_partitioned;
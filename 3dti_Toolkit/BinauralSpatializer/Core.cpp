@@ -25,6 +25,7 @@
 #include <BinauralSpatializer/Environment.h>
 #include <Common/ErrorHandler.h>
 #include <string>
+#include <algorithm>
 
 
 namespace Binaural {
@@ -180,6 +181,8 @@ namespace Binaural {
 		{
 			shared_ptr<CSingleSourceDSP> newSource(new CSingleSourceDSP(this));
 			audioSources.push_back(newSource);
+			mixedSources.reserve(audioSources.size());					//So ProcessAnechoic does not allocate memory
+			frequencyDomainBuses.ReserveInputFFTs(audioSources.size());
 			if(listener->GetHRTF()->IsHRTFLoaded()){ newSource->ResetSourceConvolutionBuffers(listener); }	//If the HRTF has been already loaded, the convolution buffers have to be set
 			
 			SET_RESULT(RESULT_OK, "Single source DSP created succesfully");
@@ -207,6 +210,7 @@ namespace Binaural {
 		{
 			if (*it == source )
 			{
+				source->LeaveFrequencyDomainBuses();		//Its delayed samples are not output by the buses
 				audioSources.erase(it);
 				found = true;
 				break;
@@ -225,6 +229,58 @@ namespace Binaural {
 		{
 			eachSource->ResetSourceConvolutionBuffers(listener);
 		}
+		
+		//Prepare the frequency-domain buses, after the sources have taken back their delayed samples
+		frequencyDomainBuses.Setup(audioState.bufferSize);
+		frequencyDomainBuses.ReserveInputFFTs(audioSources.size());
+	}
+
+	// Process the anechoic spatialization of all the sources, mixing the HRTF convolutions in the frequency domain
+	void CCore::ProcessAnechoic(CMonoBuffer<float> & outLeftBuffer, CMonoBuffer<float> & outRightBuffer)
+	{
+		outLeftBuffer.Fill(audioState.bufferSize, 0.0f);
+		outRightBuffer.Fill(audioState.bufferSize, 0.0f);
+
+		//Take the HRTF loaded in the background, if there is a new one, before checking the buses against it
+		if (listener != nullptr) { listener->GetHRTF()->ApplyPublishedHRTF(); }
+
+		//The buses are only valid while their size matches the HRIR subfilters of the current HRTF
+		bool busReady = (listener != nullptr) && listener->GetHRTF()->IsHRTFLoaded() && frequencyDomainBuses.IsReady(listener->GetHRTF()->GetHRIRSubfilterLength());
+		CFrequencyDomainBuses * buses = busReady ? &frequencyDomainBuses : nullptr;
+
+		//Add the HRTF convolution of each source to the buses, or its output to the output buffers if it can not be mixed in the frequency domain
+		mixedSources.clear();
+		for (auto eachSource : audioSources)
+		{
+			if (eachSource->ProcessAnechoic(sourceLeftBuffer, sourceRightBuffer, buses))
+			{
+				mixedSources.push_back(eachSource.get());
+			}
+			else if ((sourceLeftBuffer.size() == (size_t)audioState.bufferSize) && (sourceRightBuffer.size() == (size_t)audioState.bufferSize))
+			{
+				outLeftBuffer += sourceLeftBuffer;
+				outRightBuffer += sourceRightBuffer;
+			}
+		}
+
+		//The input FFTs of the sources mixed in the buses are calculated at once, and then each source multiplies its own by its HRIRs
+		frequencyDomainBuses.ProcessInputFFTs();
+		for (CSingleSourceDSP* eachSource : mixedSources)
+		{
+			eachSource->ProcessFrequencyDomainBusesConvolution();
+		}
+
+		//One IFFT for each bus, all of them done at once, and the samples delayed from the previous block, even if no source has been mixed in this one
+		frequencyDomainBuses.ProcessOutput(outLeftBuffer, outRightBuffer);
+	}
+
+	// Process the anechoic spatialization of all the sources, mixed in one stereo output
+	void CCore::ProcessAnechoic(CStereoBuffer<float> & outBuffer)
+	{
+		CMonoBuffer<float> outLeftBuffer;
+		CMonoBuffer<float> outRightBuffer;
+		ProcessAnechoic(outLeftBuffer, outRightBuffer);
+		outBuffer.Interlace(outLeftBuffer, outRightBuffer);
 	}
 
 	// Calculate the new coordinates from the source to the listener 
@@ -257,6 +313,61 @@ namespace Binaural {
 		return HRTF_resamplingStep;
 	}
 
+	// Set the number of threads of the HRTF resampling
+	void CCore::SetHRTFResamplingThreads(int numberOfThreads)
+	{
+		ASSERT(numberOfThreads >= 0, RESULT_ERROR_OUTOFRANGE, "Wrong value for the number of HRTF resampling threads; needs to be >=0", "");
+		if (numberOfThreads >= 0)	//Just in case error handler is off
+		{
+			HRTF_resamplingThreads = numberOfThreads;
+		}
+	}
+
+	// Get the number of threads of the HRTF resampling
+	int CCore::GetHRTFResamplingThreads() const
+	{
+		return HRTF_resamplingThreads;
+	}
+
+	// Enable the hybrid HRTF convolution
+	void CCore::EnableHybridHRTFConvolution(int partitionsPerSegment)
+	{
+		ASSERT(partitionsPerSegment >= 1, RESULT_ERROR_OUTOFRANGE, "The hybrid HRTF convolution needs at least one partition per segment", "");
+
+		if (partitionsPerSegment >= 1)	//Just in case error handler is off
+		{
+			if (!enableHybridHRTFConvolution || (partitionsPerSegment != hybridHRTFPartitionsPerSegment))
+			{
+				enableHybridHRTFConvolution = true;
+				hybridHRTFPartitionsPerSegment = partitionsPerSegment;
+				if (listener != nullptr) { listener->CalculateHRTF(); }		//The partitions of the HRTF table depend on the convolution
+			}
+			SET_RESULT(RESULT_OK, "Hybrid HRTF convolution enabled");
+		}
+	}
+
+	// Disable the hybrid HRTF convolution
+	void CCore::DisableHybridHRTFConvolution()
+	{
+		if (enableHybridHRTFConvolution)
+		{
+			enableHybridHRTFConvolution = false;
+			if (listener != nullptr) { listener->CalculateHRTF(); }
+		}
+	}
+
+	// Get if the hybrid HRTF convolution is enabled
+	bool CCore::IsHybridHRTFConvolutionEnabled() const
+	{
+		return enableHybridHRTFConvolution;
+	}
+
+	// Get the number of partitions of each segment of the hybrid HRTF convolution
+	int CCore::GetHybridHRTFPartitionsPerSegment() const
+	{
+		return hybridHRTFPartitionsPerSegment;
+	}
+
 	// Reset HRTF and BRIR when buffer size or HRTF resampling step changes	
 	void CCore::CalculateHRTFandBRIR()
 	{
@@ -23,6 +23,8 @@
 #define _CCORE_H_
 
 #include <BinauralSpatializer/HRTF.h>
+#include <BinauralSpatializer/HybridAnechoicStereo.h>
+#include <BinauralSpatializer/FrequencyDomainBuses.h>
 #include <BinauralSpatializer/BRIR.h>
 #include <Common/Transform.h>
 #include <Common/AudioState.h>
@@ -87,6 +89,49 @@ public:
 	*/
 	int GetHRTFResamplingStep();
 
+	/** \brief Set the number of threads that calculate the HRTF resampled table, when an HRTF is loaded or the resampling step or the buffer size change
+	*	\details Every orientation of the resampled table is calculated independently, so the result is the same with any number of threads
+	*	\details With 0, the number of threads is limited to MAX_AUTOMATIC_RESAMPLING_THREADS, and the table is calculated in the calling thread only if the HRTF replaces another one with the asynchronous setup enabled
+	*	(see CHRTF::EnableAsynchronousHRTFSetup), since the audio thread is running meanwhile
+	*	\param [in] numberOfThreads number of threads, 1 to calculate the table in the calling thread only and 0 (default) to choose it automatically
+	*   \eh On error, an error code is reported to the error handler.
+	*/
+	void SetHRTFResamplingThreads(int numberOfThreads);
+
+	/** \brief Get the number of threads that calculate the HRTF resampled table
+	*	\retval numberOfThreads number of threads, 0 means that it is chosen automatically
+	*   \eh Nothing is reported to the error handler.
+	*/
+	int GetHRTFResamplingThreads() const;
+
+	/** \brief Convolve the sources with the HRTF using the hybrid convolution (CHybridAnechoicStereo) instead of the uniformly partitioned one
+	*	\details The first bufferSize coefficients of the HRIRs are convolved with a direct FIR filter and the rest with partitions of increasing size (2, 4, 8... times bufferSize).
+	*	It needs fewer operations per sample than the uniformly partitioned convolution with small buffers (for example 32 or 64 samples), with the same latency.
+	*	The HRTF table is calculated again with the hybrid layout, if it has been loaded. The outputs of these sources are not mixed in the frequency domain by ProcessAnechoic.
+	*	The HRIRs of moving sources are exact while they change once at most during the input samples convolved together by each segment, and are crossfaded otherwise (see CHybridAnechoicStereo).
+	*	\param [in] partitionsPerSegment number of partitions of each size
+	*   \eh On error, an error code is reported to the error handler.
+	*/
+	void EnableHybridHRTFConvolution(int partitionsPerSegment = DEFAULT_HYBRID_PARTITIONS_PER_SEGMENT);
+
+	/** \brief Convolve the sources with the HRTF using the uniformly partitioned convolution (default)
+	*	\details The HRTF table is calculated again with the uniform layout, if it has been loaded
+	*   \eh Nothing is reported to the error handler.
+	*/
+	void DisableHybridHRTFConvolution();
+
+	/** \brief Get if the hybrid HRTF convolution is enabled
+	*	\retval enabled true if the sources are convolved with the hybrid convolution
+	*   \eh Nothing is reported to the error handler.
+	*/
+	bool IsHybridHRTFConvolutionEnabled() const;
+
+	/** \brief Get the number of partitions of each segment of the hybrid HRTF convolution
+	*	\retval partitionsPerSegment number of partitions of each size
+	*   \eh Nothing is reported to the error handler.
+	*/
+	int GetHybridHRTFPartitionsPerSegment() const;
+
 	/** \brief Get global physical magnitudes
 	*	\retval magnitudes currently set physical magnitudes
 	*   \eh Nothing is reported to the error handler.
@@ -156,6 +201,28 @@ public:
      */
     void RemoveSingleSourceDSP(shared_ptr<CSingleSourceDSP> source);
 
+	/** \brief Process the anechoic spatialization (direct path) of all the sources, mixed in one output
+	*	\details The output is the sum of the outputs of CSingleSourceDSP::ProcessAnechoic of each source, but the HighQuality sources are mixed in the frequency domain,
+	*	with one IFFT for each ear and delay instead of two per source (see CFrequencyDomainBuses). The ITD is applied after the IFFT of each bus, and the gain of the directionality to the spectra.
+	*	The input FFTs of the sources mixed in the buses are calculated all at once, with the batched FFT, and then multiplied by the HRIRs of each source.
+	*	A source is mixed in the buses only in the blocks in which the result is the same as the one of its own processing: when its delays do not change, the gains of its directionality
+	*	do not change since the previous block mixed in the buses and the near field effects are not applied to it. In any other block it is processed on its own, so the result is always
+	*	the same, except for the rounding errors of the floating point operations.
+	*	\param [out] outLeftBuffer output mono buffer with the spatialized audio of all the sources for the left channel
+	*	\param [out] outRightBuffer output mono buffer with the spatialized audio of all the sources for the right channel
+	*	\pre Internal buffer of each source must be updated before any call to this method (See \link CSingleSourceDSP::SetBuffer \endlink)
+	*   \eh On error, an error code is reported to the error handler.
+	*/
+	void ProcessAnechoic(CMonoBuffer<float> & outLeftBuffer, CMonoBuffer<float> & outRightBuffer);
+
+	/** \brief Process the anechoic spatialization (direct path) of all the sources, mixed in one output
+	*	\param [out] outBuffer output stereo buffer with the spatialized audio of all the sources for both channels
+	*	\pre Internal buffer of each source must be updated before any call to this method (See \link CSingleSourceDSP::SetBuffer \endlink)
+	*   \eh On error, an error code is reported to the error handler.
+	*	\sa ProcessAnechoic(CMonoBuffer<float> & outLeftBuffer, CMonoBuffer<float> & outRightBuffer)
+	*/
+	void ProcessAnechoic(CStereoBuffer<float> & outBuffer);
+
 private:
 	// Reset the convolution buffer of each source	
 	void ResetConvolutionBuffers();
@@ -181,6 +248,14 @@ private:
 	Common::TAudioStateStruct audioState;				// Global audio state
 	Common::CMagnitudes magnitudes;						// Physical magnitudes
 	int HRTF_resamplingStep;							// HRTF resampling step in degrees, in order to interpolate the HRTF table from database	
+	int HRTF_resamplingThreads = DEFAULT_RESAMPLING_THREADS;	// Number of threads that calculate the HRTF resampled table, 0 to choose it automatically
+	bool enableHybridHRTFConvolution = false;			// The sources are convolved with the hybrid convolution instead of the UPC
+	int hybridHRTFPartitionsPerSegment = DEFAULT_HYBRID_PARTITIONS_PER_SEGMENT;	// Number of partitions of each size of the hybrid convolution
+
+	CFrequencyDomainBuses frequencyDomainBuses;			// Buses where the HRTF convolution of the sources is mixed in the frequency domain
+	CMonoBuffer<float> sourceLeftBuffer;				// Left output of a source that could not be mixed in the frequency domain
+	CMonoBuffer<float> sourceRightBuffer;				// Right output of a source that could not be mixed in the frequency domain
+	std::vector<CSingleSourceDSP*> mixedSources;		// Sources mixed in the frequency domain in the current block, waiting for their input FFTs
 		
     friend class CEnvironment;							// Friend class definition
 	friend class CListener;								// Friend class definition
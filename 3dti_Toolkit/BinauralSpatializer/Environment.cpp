@@ -37,7 +37,7 @@ CProfilerDataSet dsEnvInvFFT;
 namespace Binaural {
 
 	CEnvironment::CEnvironment(class CCore* _ownerCore)
-		:ownerCore{ _ownerCore }
+		:ownerCore{ _ownerCore }, environmentABIR{ std::make_shared<CABIR>() }
 	{
 		//Create a pointer to the BRIR, where a reference to the enviroment is needed
 		std::unique_ptr<CBRIR> tempBRIR(new CBRIR(this));	
@@ -84,29 +84,11 @@ namespace Binaural {
 				outputLeft.Setup(bufferLength, BRIRLength);
 				outputRight.Setup(bufferLength, BRIRLength);
 #else			//Prepare output buffers to perform UP convolutions in ProcessVirtualAmbisonicReverb			
-				switch(reverberationOrder){
-					case TReverberationOrder::BIDIMENSIONAL:
-						wLeft_UPConvolution. Setup(bufferLength, GetABIR().GetDataBlockLength_freq(), GetABIR().GetDataNumberOfBlocks(), false);
-						wRight_UPConvolution.Setup(bufferLength, GetABIR().GetDataBlockLength_freq(), GetABIR().GetDataNumberOfBlocks(), false);
-						xLeft_UPConvolution. Setup(bufferLength, GetABIR().GetDataBlockLength_freq(), GetABIR().GetDataNumberOfBlocks(), false);
-						xRight_UPConvolution.Setup(bufferLength, GetABIR().GetDataBlockLength_freq(), GetABIR().GetDataNumberOfBlocks(), false);
-						yLeft_UPConvolution. Setup(bufferLength, GetABIR().GetDataBlockLength_freq(), GetABIR().GetDataNumberOfBlocks(), false);
-						yRight_UPConvolution.Setup(bufferLength, GetABIR().GetDataBlockLength_freq(), GetABIR().GetDataNumberOfBlocks(), false);
-						break;
-					case TReverberationOrder::THREEDIMENSIONAL:
-						wLeft_UPConvolution. Setup(bufferLength, GetABIR().GetDataBlockLength_freq(), GetABIR().GetDataNumberOfBlocks(), false);
-						wRight_UPConvolution.Setup(bufferLength, GetABIR().GetDataBlockLength_freq(), GetABIR().GetDataNumberOfBlocks(), false);
-						xLeft_UPConvolution. Setup(bufferLength, GetABIR().GetDataBlockLength_freq(), GetABIR().GetDataNumberOfBlocks(), false);
-						xRight_UPConvolution.Setup(bufferLength, GetABIR().GetDataBlockLength_freq(), GetABIR().GetDataNumberOfBlocks(), false);
-						yLeft_UPConvolution. Setup(bufferLength, GetABIR().GetDataBlockLength_freq(), GetABIR().GetDataNumberOfBlocks(), false);
-						yRight_UPConvolution.Setup(bufferLength, GetABIR().GetDataBlockLength_freq(), GetABIR().GetDataNumberOfBlocks(), false);
-						zLeft_UPConvolution. Setup(bufferLength, GetABIR().GetDataBlockLength_freq(), GetABIR().GetDataNumberOfBlocks(), false);
-						zRight_UPConvolution.Setup(bufferLength, GetABIR().GetDataBlockLength_freq(), GetABIR().GetDataNumberOfBlocks(), false);
-						break;
-					case TReverberationOrder::ADIMENSIONAL:
-						wLeft_UPConvolution. Setup(bufferLength, GetABIR().GetDataBlockLength_freq(), GetABIR().GetDataNumberOfBlocks(), false);
-						wRight_UPConvolution.Setup(bufferLength, GetABIR().GetDataBlockLength_freq(), GetABIR().GetDataNumberOfBlocks(), false);
-						break;
+				if (reverbConvolutionMethod == TReverbConvolutionMethod::NON_UNIFORMLY_PARTITIONED) {
+					SetupNUPConvolution(bufferLength);
+				}
+				else {
+					SetupUPConvolution(bufferLength);
 				}
 #endif
 			}	
@@ -118,44 +100,260 @@ namespace Binaural {
 		return reverberationOrder;
 	}
 
-	void CEnvironment::SetABIRAdimensional(int bufferLength, int blockLengthFreq, int numberOfBlocks)
+	void CEnvironment::SetReverbConvolutionMethod(TReverbConvolutionMethod method)
+	{
+		//The NUPC convolvers process the whole ABIR, so the tail convolved in the worker thread could not be applied
+		if ((method == TReverbConvolutionMethod::NON_UNIFORMLY_PARTITIONED) && enableAsynchronousReverbTail)
+		{
+			SET_RESULT(RESULT_ERROR_NOTALLOWED, "The non-uniformly partitioned convolution can not be used while the asynchronous reverb tail is enabled");
+			return;
+		}
+		reverbConvolutionMethod = method;
+		//The convolvers of the new method have to be prepared with the current ABIR
+		if (environmentABIR->IsInitialized()) { ResetReverbBuffers(); }
+	}
+
+	TReverbConvolutionMethod CEnvironment::GetReverbConvolutionMethod() const
+	{
+		return reverbConvolutionMethod;
+	}
+
+	void CEnvironment::EnableAsynchronousReverbTail(int headNumberOfBlocks, int latencyBlocks)
+	{
+#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_REVERB
+		SET_RESULT(RESULT_ERROR_NOTALLOWED, "The asynchronous reverb tail needs the uniformly partitioned convolution of the reverb");
+		return;
+#endif
+		if (reverbConvolutionMethod != TReverbConvolutionMethod::UNIFORMLY_PARTITIONED)
+		{
+			SET_RESULT(RESULT_ERROR_NOTALLOWED, "The asynchronous reverb tail needs the uniformly partitioned convolution of the reverb");
+			return;
+		}
+
+		ASSERT(latencyBlocks >= 1 && latencyBlocks <= headNumberOfBlocks, RESULT_ERROR_OUTOFRANGE, "The latency of the reverb tail has to be from one block to the number of blocks of the head", "");
+		if ((latencyBlocks >= 1) && (latencyBlocks <= headNumberOfBlocks))	//Just in case error handler is off
+		{
+			enableAsynchronousReverbTail = true;
+			reverbHeadNumberOfBlocks = headNumberOfBlocks;
+			reverbTailLatencyBlocks = latencyBlocks;
+			//The convolvers have to be prepared again with the head and the tail of the current ABIR
+			if (environmentABIR->IsInitialized()) { ResetReverbBuffers(); }
+		}
+	}
+
+	void CEnvironment::DisableAsynchronousReverbTail()
+	{
+		enableAsynchronousReverbTail = false;
+		if (environmentABIR->IsInitialized()) { ResetReverbBuffers(); }
+	}
+
+	bool CEnvironment::IsAsynchronousReverbTailEnabled() const
+	{
+		return enableAsynchronousReverbTail;
+	}
+
+	int CEnvironment::GetNumberOfLateReverbTailBlocks() const
+	{
+#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_REVERB
+		return 0;
+#else
+		return reverbTailConvolution.GetNumberOfLateBlocks();
+#endif
+	}
+
+	void CEnvironment::EnableAsynchronousBRIRSetup(int crossfadeBlocks)
+	{
+		ASSERT(crossfadeBlocks >= 0, RESULT_ERROR_OUTOFRANGE, "The number of blocks of the BRIR crossfade can not be negative", "");
+		if (crossfadeBlocks >= 0)	//Just in case error handler is off
+		{
+			enableAsynchronousBRIRSetup = true;
+			BRIRCrossfadeBlocks = crossfadeBlocks;
+			//The ABIR in use is kept by the publisher, so it is not freed by the audio thread when it is replaced
+			ABIRPublisher.Retain(environmentABIR);
+		}
+	}
+
+	void CEnvironment::DisableAsynchronousBRIRSetup()
+	{
+		ApplyPublishedABIR();
+		enableAsynchronousBRIRSetup = false;
+		previousABIR.reset();
+		BRIRCrossfadeBlocksLeft = 0;
+		ABIRPublisher.Clear();
+	}
+
+	bool CEnvironment::IsAsynchronousBRIRSetupEnabled() const
+	{
+		return enableAsynchronousBRIRSetup;
+	}
+
+	int CEnvironment::GetNumberOfBFormatChannels() const
+	{
+		switch (reverberationOrder) {
+		case TReverberationOrder::BIDIMENSIONAL: return 3;
+		case TReverberationOrder::THREEDIMENSIONAL: return 4;
+		case TReverberationOrder::ADIMENSIONAL: return 1;
+		default: return 1;
+		}
+	}
+
+	void CEnvironment::SetupUPConvolution(int bufferLength)
+	{
+		int numberOfBlocks = GetABIR().GetDataNumberOfBlocks();
+		if (enableAsynchronousReverbTail && (numberOfBlocks > reverbHeadNumberOfBlocks))
+		{
+			//The tail is convolved in the worker thread, with the inputs that it receives from ProcessVirtualAmbisonicReverb
+			reverbTailConvolution.Setup(bufferLength, GetABIR().GetDataBlockLength_freq(), numberOfBlocks, reverbHeadNumberOfBlocks, reverbTailLatencyBlocks, GetNumberOfBFormatChannels());
+			for (int channel = 0; channel < GetNumberOfBFormatChannels(); channel++)
+			{
+				reverbTailConvolution.SetImpulseResponse(channel, GetABIR().GetImpulseResponse_Partitioned((TBFormatChannel)channel, Common::T_ear::LEFT), GetABIR().GetImpulseResponse_Partitioned((TBFormatChannel)channel, Common::T_ear::RIGHT));
+			}
+			reverbTailConvolution.Start();
+			numberOfBlocks = reverbHeadNumberOfBlocks;
+		}
+		else
+		{
+			reverbTailConvolution.Stop();
+		}
+
+		//Only one convolver for all the channels. Each channel has its own delay line of input FFTs, shared by both ears
+		bFormatUPConvolution.Setup(bufferLength, GetABIR().GetDataBlockLength_freq(), numberOfBlocks, GetNumberOfBFormatChannels());
+
+		//The products of all the channels are added in one spectrum per ear, so only one IFFT per ear is done
+		reverbFFTPlan.Setup(2 * bufferLength);
+		reverbLeft_Frequency.assign(GetABIR().GetDataBlockLength_freq(), 0.0f);
+		reverbRight_Frequency.assign(GetABIR().GetDataBlockLength_freq(), 0.0f);
+		reverbIFFT_buffer.assign(2 * 2 * bufferLength, 0.0f);
+		reverbFFTPlan.SetupBatch(2);
+		reverbIFFT_input = { reverbLeft_Frequency.data(), reverbRight_Frequency.data() };
+		reverbIFFT_output = { reverbIFFT_buffer.data(), reverbIFFT_buffer.data() + 2 * bufferLength };
+		reverbInputs.reserve(GetNumberOfBFormatChannels());
+		reverbLeftIRs.reserve(GetNumberOfBFormatChannels());
+		reverbRightIRs.reserve(GetNumberOfBFormatChannels());
+
+		//Used only during the crossfade with the previous ABIR, prepared here so that the crossfade does not allocate memory
+		previousReverbLeft_Frequency.assign(GetABIR().GetDataBlockLength_freq(), 0.0f);
+		previousReverbRight_Frequency.assign(GetABIR().GetDataBlockLength_freq(), 0.0f);
+		previousReverbLeftIRs.reserve(GetNumberOfBFormatChannels());
+		previousReverbRightIRs.reserve(GetNumberOfBFormatChannels());
+
+		//The delay lines start again, so there is nothing to crossfade
+		previousABIR.reset();
+		BRIRCrossfadeBlocksLeft = 0;
+	}
+
+	void CEnvironment::SetupNUPConvolution(int bufferLength)
+	{
+		//The NUPC convolvers already process the tail with few big partitions, so it is not convolved in the worker thread
+		reverbTailConvolution.Stop();
+
+		//The NUPC convolvers calculate their own partitions from the uniform partitions of the ABIR
+		bFormatNUPConvolution.resize(GetNumberOfBFormatChannels());
+		for (int channel = 0; channel < (int)bFormatNUPConvolution.size(); channel++)
+		{
+			bFormatNUPConvolution[channel].Setup(bufferLength, GetABIR().GetImpulseResponse_Partitioned((TBFormatChannel)channel, Common::T_ear::LEFT), GetABIR().GetImpulseResponse_Partitioned((TBFormatChannel)channel, Common::T_ear::RIGHT));
+		}
+	}
+
+	void CEnvironment::ProcessUPConvolution(TBFormatChannel channel, const CMonoBuffer<float> & encoderIn, CMonoBuffer<float> & outBufferLeft, CMonoBuffer<float> & outBufferRight)
+	{
+		if (channel >= bFormatUPConvolution.GetNumberOfChannels())
+		{
+			SET_RESULT(RESULT_ERROR_CASENOTDEFINED, "Attempt to process reverb of a b-format channel that is not used in the current reverberation order");
+			return;
+		}
+		//The tail of all the channels is mixed in the worker thread, so it can not be applied to one encoded channel
+		if (reverbTailConvolution.IsRunning())
+		{
+			SET_RESULT(RESULT_ERROR_NOTALLOWED, "Encoded channels can not be processed while the asynchronous reverb tail is enabled");
+			return;
+		}
+
+		std::fill(reverbLeft_Frequency.begin(), reverbLeft_Frequency.end(), 0.0f);
+		std::fill(reverbRight_Frequency.begin(), reverbRight_Frequency.end(), 0.0f);
+		bFormatUPConvolution.ProcessUPConvolution_withoutIFFT(channel, encoderIn, GetABIR().GetImpulseResponse_Partitioned(channel, Common::T_ear::LEFT), GetABIR().GetImpulseResponse_Partitioned(channel, Common::T_ear::RIGHT), reverbLeft_Frequency, reverbRight_Frequency);
+		ProcessUPConvolutionIFFT(outBufferLeft, outBufferRight);
+	}
+
+	void CEnvironment::ProcessUPConvolution(std::initializer_list<const CMonoBuffer<float>*> bFormatChannels, int numberOfSilencedFrames)
 	{
-		wLeft_UPConvolution.Setup(bufferLength, blockLengthFreq, numberOfBlocks, false);
-		wRight_UPConvolution.Setup(bufferLength, blockLengthFreq, numberOfBlocks, false);
+		//The vectors have been reserved for all the channels, so they are filled without allocating memory
+		reverbInputs.assign(bFormatChannels);
+		reverbLeftIRs.clear();
+		reverbRightIRs.clear();
+		for (int channel = 0; channel < (int)reverbInputs.size(); channel++)
+		{
+			reverbLeftIRs.push_back(&GetABIR().GetImpulseResponse_Partitioned((TBFormatChannel)channel, Common::T_ear::LEFT));
+			reverbRightIRs.push_back(&GetABIR().GetImpulseResponse_Partitioned((TBFormatChannel)channel, Common::T_ear::RIGHT));
+		}
+
+		std::fill(reverbLeft_Frequency.begin(), reverbLeft_Frequency.end(), 0.0f);
+		std::fill(reverbRight_Frequency.begin(), reverbRight_Frequency.end(), 0.0f);
+		if ((previousABIR == nullptr) || (BRIRCrossfadeBlocksLeft <= 0))
+		{
+			bFormatUPConvolution.ProcessUPConvolution_withoutIFFT(reverbInputs, reverbLeftIRs, reverbRightIRs, reverbLeft_Frequency, reverbRight_Frequency, numberOfSilencedFrames);
+			return;
+		}
+
+		//Crossfade with the previous ABIR. Both of them are convolved with the same input FFTs, and their spectra are mixed before the IFFT
+		previousReverbLeftIRs.clear();
+		previousReverbRightIRs.clear();
+		for (int channel = 0; channel < (int)reverbInputs.size(); channel++)
+		{
+			previousReverbLeftIRs.push_back(&previousABIR->GetImpulseResponse_Partitioned((TBFormatChannel)channel, Common::T_ear::LEFT));
+			previousReverbRightIRs.push_back(&previousABIR->GetImpulseResponse_Partitioned((TBFormatChannel)channel, Common::T_ear::RIGHT));
+		}
+		std::fill(previousReverbLeft_Frequency.begin(), previousReverbLeft_Frequency.end(), 0.0f);
+		std::fill(previousReverbRight_Frequency.begin(), previousReverbRight_Frequency.end(), 0.0f);
+		bFormatUPConvolution.ProcessUPConvolution_withoutIFFT(reverbInputs, reverbLeftIRs, reverbRightIRs, reverbLeft_Frequency, reverbRight_Frequency,
+			previousReverbLeftIRs, previousReverbRightIRs, previousReverbLeft_Frequency, previousReverbRight_Frequency, numberOfSilencedFrames);
+
+		float previousWeight = (float)BRIRCrossfadeBlocksLeft / (float)(BRIRCrossfadeBlocks + 1);
+		for (int i = 0; i < (int)reverbLeft_Frequency.size(); i++)
+		{
+			reverbLeft_Frequency[i] = (1.0f - previousWeight) * reverbLeft_Frequency[i] + previousWeight * previousReverbLeft_Frequency[i];
+			reverbRight_Frequency[i] = (1.0f - previousWeight) * reverbRight_Frequency[i] + previousWeight * previousReverbRight_Frequency[i];
+		}
+		BRIRCrossfadeBlocksLeft--;
+		if (BRIRCrossfadeBlocksLeft == 0) { previousABIR.reset(); }		//Not freed here, the publisher keeps it
 	}
 
-	void CEnvironment::SetABIRBidimensional(int bufferLength, int blockLengthFreq, int numberOfBlocks)
+	void CEnvironment::ProcessUPConvolutionIFFT(CMonoBuffer<float> & outBufferLeft, CMonoBuffer<float> & outBufferRight)
 	{
-		wLeft_UPConvolution.Setup(bufferLength, blockLengthFreq, numberOfBlocks, false);
-		wRight_UPConvolution.Setup(bufferLength,blockLengthFreq, numberOfBlocks, false);
-		xLeft_UPConvolution.Setup(bufferLength, blockLengthFreq, numberOfBlocks, false);
-		xRight_UPConvolution.Setup(bufferLength,blockLengthFreq, numberOfBlocks, false);
-		yLeft_UPConvolution.Setup(bufferLength, blockLengthFreq, numberOfBlocks, false);
-		yRight_UPConvolution.Setup(bufferLength,blockLengthFreq, numberOfBlocks, false);
+		//The IFFTs of both ears are done at once, the left one in the first half of the buffer and the right one in the second half
+		int FFTSize = reverbIFFT_buffer.size() / 2;
+		int bufferLength = FFTSize / 2;
+		reverbFFTPlan.CalculateIFFT_HalfSpectrum(reverbIFFT_input, reverbIFFT_output);
+
+		//We are left only with the final half of each result
+		outBufferLeft.assign(reverbIFFT_buffer.begin() + bufferLength, reverbIFFT_buffer.begin() + FFTSize);
+		outBufferRight.assign(reverbIFFT_buffer.begin() + FFTSize + bufferLength, reverbIFFT_buffer.end());
 	}
 
-	void CEnvironment::SetABIRThreedimensional(int bufferLength, int blockLengthFreq, int numberOfBlocks)
+	void CEnvironment::ProcessNUPConvolution(TBFormatChannel channel, const CMonoBuffer<float> & encoderIn, CMonoBuffer<float> & outBufferLeft, CMonoBuffer<float> & outBufferRight)
 	{
-		wLeft_UPConvolution.Setup(bufferLength, blockLengthFreq, numberOfBlocks, false);
-		wRight_UPConvolution.Setup(bufferLength, blockLengthFreq, numberOfBlocks, false);
-		xLeft_UPConvolution.Setup(bufferLength, blockLengthFreq, numberOfBlocks, false);
-		xRight_UPConvolution.Setup(bufferLength, blockLengthFreq, numberOfBlocks, false);
-		yLeft_UPConvolution.Setup(bufferLength, blockLengthFreq, numberOfBlocks, false);
-		yRight_UPConvolution.Setup(bufferLength, blockLengthFreq, numberOfBlocks, false);
-		zLeft_UPConvolution.Setup(bufferLength, blockLengthFreq, numberOfBlocks, false);
-		zRight_UPConvolution.Setup(bufferLength, blockLengthFreq, numberOfBlocks, false);
+		if (channel >= bFormatNUPConvolution.size())
+		{
+			SET_RESULT(RESULT_ERROR_CASENOTDEFINED, "Attempt to process reverb of a b-format channel that is not used in the current reverberation order");
+			return;
+		}
+
+		//The output of each channel is added to the output buffers, so they are cleared before the first one
+		if (outBufferLeft.size() == 0) { outBufferLeft.Fill(encoderIn.size(), 0.0f); }
+		if (outBufferRight.size() == 0) { outBufferRight.Fill(encoderIn.size(), 0.0f); }
+		bFormatNUPConvolution[channel].ProcessNUPConvolution(encoderIn, outBufferLeft, outBufferRight);
 	}
 
 	bool CEnvironment::SetABIR()
 	{
 		if (ownerCore != nullptr)
 		{
-			int bufferLength = ownerCore->GetAudioState().bufferSize;
 			int BRIRLength = environmentBRIR->GetBRIRLength();
 			if (BRIRLength > 0)
 			{			
 
 	#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_REVERB 
+				int bufferLength = ownerCore->GetAudioState().bufferSize;
 				//Configure AIR values (partitions and FFTs)
 				CalculateABIRwithoutPartitions();
 				//Prepare output buffers to perform Basic convolutions			
@@ -164,21 +362,8 @@ namespace Binaural {
 				outputRight.Setup(bufferLength, BRIRLength);
 	#else
 				//Configure AIR values (partitions and FFTs)
-				bool result = CalculateABIRPartitioned();
-				//Prepare output buffers to perform UP convolutions in ProcessVirtualAmbisonicReverb
-				switch (reverberationOrder) {
-					case TReverberationOrder::BIDIMENSIONAL:
-						SetABIRBidimensional(bufferLength, GetABIR().GetDataBlockLength_freq(), GetABIR().GetDataNumberOfBlocks());
-						break;
-					case TReverberationOrder::THREEDIMENSIONAL:
-						SetABIRThreedimensional(bufferLength, GetABIR().GetDataBlockLength_freq(), GetABIR().GetDataNumberOfBlocks());
-						break;
-					case TReverberationOrder::ADIMENSIONAL:
-						SetABIRAdimensional(bufferLength, GetABIR().GetDataBlockLength_freq(), GetABIR().GetDataNumberOfBlocks());
-						break;
-				}
-				
-				return result;
+				//The output buffers to perform UP or NUP convolutions in ProcessVirtualAmbisonicReverb are prepared by ReplaceABIR, unless the ABIR is published to the audio thread
+				return CalculateABIRPartitioned();
 	#endif
 			}
 			else
@@ -293,16 +478,16 @@ namespace Binaural {
 		}
 
 		//Setup AIR class
-		environmentABIR.AddImpulseResponse(TBFormatChannel::W, Common::T_ear::LEFT, std::move(newAIR_W_left));
-		environmentABIR.AddImpulseResponse(TBFormatChannel::W, Common::T_ear::RIGHT, std::move(newAIR_W_right));
-		environmentABIR.AddImpulseResponse(TBFormatChannel::X, Common::T_ear::LEFT, std::move(newAIR_X_left));
-		environmentABIR.AddImpulseResponse(TBFormatChannel::X, Common::T_ear::RIGHT, std::move(newAIR_X_right));
-		environmentABIR.AddImpulseResponse(TBFormatChannel::Y, Common::T_ear::LEFT, std::move(newAIR_Y_left));
-		environmentABIR.AddImpulseResponse(TBFormatChannel::Y, Common::T_ear::RIGHT, std::move(newAIR_Y_right));
+		ABIRInSetup->AddImpulseResponse(TBFormatChannel::W, Common::T_ear::LEFT, std::move(newAIR_W_left));
+		ABIRInSetup->AddImpulseResponse(TBFormatChannel::W, Common::T_ear::RIGHT, std::move(newAIR_W_right));
+		ABIRInSetup->AddImpulseResponse(TBFormatChannel::X, Common::T_ear::LEFT, std::move(newAIR_X_left));
+		ABIRInSetup->AddImpulseResponse(TBFormatChannel::X, Common::T_ear::RIGHT, std::move(newAIR_X_right));
+		ABIRInSetup->AddImpulseResponse(TBFormatChannel::Y, Common::T_ear::LEFT, std::move(newAIR_Y_left));
+		ABIRInSetup->AddImpulseResponse(TBFormatChannel::Y, Common::T_ear::RIGHT, std::move(newAIR_Y_right));
 
 		if (useZAxis) {
-			environmentABIR.AddImpulseResponse(TBFormatChannel::Z, Common::T_ear::LEFT, std::move(newAIR_Z_left));
-			environmentABIR.AddImpulseResponse(TBFormatChannel::Z, Common::T_ear::RIGHT, std::move(newAIR_Z_right));
+			ABIRInSetup->AddImpulseResponse(TBFormatChannel::Z, Common::T_ear::LEFT, std::move(newAIR_Z_left));
+			ABIRInSetup->AddImpulseResponse(TBFormatChannel::Z, Common::T_ear::RIGHT, std::move(newAIR_Z_right));
 		}
 
 		return true;
@@ -375,12 +560,12 @@ namespace Binaural {
 		}
 
 		//Setup AIR class
-		environmentABIR.AddImpulseResponse(TBFormatChannel::W, Common::T_ear::LEFT, std::move(newAIR_W_left));
-		environmentABIR.AddImpulseResponse(TBFormatChannel::W, Common::T_ear::RIGHT, std::move(newAIR_W_right));
-		environmentABIR.AddImpulseResponse(TBFormatChannel::X, Common::T_ear::LEFT, std::move(newAIR_X_left));
-		environmentABIR.AddImpulseResponse(TBFormatChannel::X, Common::T_ear::RIGHT, std::move(newAIR_X_right));
-		environmentABIR.AddImpulseResponse(TBFormatChannel::Y, Common::T_ear::LEFT, std::move(newAIR_Y_left));
-		environmentABIR.AddImpulseResponse(TBFormatChannel::Y, Common::T_ear::RIGHT, std::move(newAIR_Y_right));
+		ABIRInSetup->AddImpulseResponse(TBFormatChannel::W, Common::T_ear::LEFT, std::move(newAIR_W_left));
+		ABIRInSetup->AddImpulseResponse(TBFormatChannel::W, Common::T_ear::RIGHT, std::move(newAIR_W_right));
+		ABIRInSetup->AddImpulseResponse(TBFormatChannel::X, Common::T_ear::LEFT, std::move(newAIR_X_left));
+		ABIRInSetup->AddImpulseResponse(TBFormatChannel::X, Common::T_ear::RIGHT, std::move(newAIR_X_right));
+		ABIRInSetup->AddImpulseResponse(TBFormatChannel::Y, Common::T_ear::LEFT, std::move(newAIR_Y_left));
+		ABIRInSetup->AddImpulseResponse(TBFormatChannel::Y, Common::T_ear::RIGHT, std::move(newAIR_Y_right));
 
 		return true;
 	}
@@ -466,14 +651,14 @@ namespace Binaural {
 		}
 
 		//Setup AIR class
-		environmentABIR.AddImpulseResponse(TBFormatChannel::W, Common::T_ear::LEFT, std::move(newAIR_W_left));
-		environmentABIR.AddImpulseResponse(TBFormatChannel::W, Common::T_ear::RIGHT, std::move(newAIR_W_right));
-		environmentABIR.AddImpulseResponse(TBFormatChannel::X, Common::T_ear::LEFT, std::move(newAIR_X_left));
-		environmentABIR.AddImpulseResponse(TBFormatChannel::X, Common::T_ear::RIGHT, std::move(newAIR_X_right));
-		environmentABIR.AddImpulseResponse(TBFormatChannel::Y, Common::T_ear::LEFT, std::move(newAIR_Y_left));
-		environmentABIR.AddImpulseResponse(TBFormatChannel::Y, Common::T_ear::RIGHT, std::move(newAIR_Y_right));
-		environmentABIR.AddImpulseResponse(TBFormatChannel::Z, Common::T_ear::LEFT, std::move(newAIR_Z_left));
-		environmentABIR.AddImpulseResponse(TBFormatChannel::Z, Common::T_ear::RIGHT, std::move(newAIR_Z_right));
+		ABIRInSetup->AddImpulseResponse(TBFormatChannel::W, Common::T_ear::LEFT, std::move(newAIR_W_left));
+		ABIRInSetup->AddImpulseResponse(TBFormatChannel::W, Common::T_ear::RIGHT, std::move(newAIR_W_right));
+		ABIRInSetup->AddImpulseResponse(TBFormatChannel::X, Common::T_ear::LEFT, std::move(newAIR_X_left));
+		ABIRInSetup->AddImpulseResponse(TBFormatChannel::X, Common::T_ear::RIGHT, std::move(newAIR_X_right));
+		ABIRInSetup->AddImpulseResponse(TBFormatChannel::Y, Common::T_ear::LEFT, std::move(newAIR_Y_left));
+		ABIRInSetup->AddImpulseResponse(TBFormatChannel::Y, Common::T_ear::RIGHT, std::move(newAIR_Y_right));
+		ABIRInSetup->AddImpulseResponse(TBFormatChannel::Z, Common::T_ear::LEFT, std::move(newAIR_Z_left));
+		ABIRInSetup->AddImpulseResponse(TBFormatChannel::Z, Common::T_ear::RIGHT, std::move(newAIR_Z_right));
 
 		return true;
 	}
@@ -481,17 +666,29 @@ namespace Binaural {
 
 	bool CEnvironment::CalculateABIRPartitioned()
 	{
-		environmentABIR.Setup(ownerCore->GetAudioState().bufferSize, environmentBRIR->GetBRIRLength());
+		//The ABIR has as many partitions as the BRIR, whose negligible tail may have been truncated
+		int bufferLength = ownerCore->GetAudioState().bufferSize;
+		//It is calculated in a new ABIR, so the one in use is not modified while it may be convolved
+		ABIRInSetup = std::make_shared<CABIR>();
+		ABIRInSetup->Setup(bufferLength, environmentBRIR->GetBRIRNumberOfSubfilters() * bufferLength);
 
+		bool result;
 		switch (reverberationOrder) {
 		case TReverberationOrder::BIDIMENSIONAL:
-			return CalculateABIRPartitionedBidimensional();
+			result = CalculateABIRPartitionedBidimensional();
+			break;
 		case TReverberationOrder::THREEDIMENSIONAL:
-			return 	CalculateABIRPartitionedThreedimensional();
+			result = CalculateABIRPartitionedThreedimensional();
+			break;
 		case TReverberationOrder::ADIMENSIONAL:
-			return 	CalculateABIRPartitionedAdimensional();
-		default: return false;
+			result = CalculateABIRPartitionedAdimensional();
+			break;
+		default: result = false;
 		}
+
+		if (result) { ReplaceABIR(std::move(ABIRInSetup)); }
+		ABIRInSetup.reset();
+		return result;
 	}
 
 
@@ -533,14 +730,17 @@ namespace Binaural {
 				newAIR_Y_right[j] = westRight[j] - eastRight[j];
 			}
 
-			//Setup AIR class
-			environmentABIR.Setup(ownerCore->GetAudioState().bufferSize, environmentBRIR->GetBRIRLength());
-			environmentABIR.AddImpulseResponse(TBFormatChannel::W, Common::T_ear::LEFT, std::move(newAIR_W_left));
-			environmentABIR.AddImpulseResponse(TBFormatChannel::W, Common::T_ear::RIGHT, std::move(newAIR_W_right));
-			environmentABIR.AddImpulseResponse(TBFormatChannel::X, Common::T_ear::LEFT, std::move(newAIR_X_left));
-			environmentABIR.AddImpulseResponse(TBFormatChannel::X, Common::T_ear::RIGHT, std::move(newAIR_X_right));
-			environmentABIR.AddImpulseResponse(TBFormatChannel::Y, Common::T_ear::LEFT, std::move(newAIR_Y_left));
-			environmentABIR.AddImpulseResponse(TBFormatChannel::Y, Common::T_ear::RIGHT, std::move(newAIR_Y_right));
+			//Setup AIR class. This ABIR is always replaced in this thread, because the convolvers are prepared with it by SetABIR
+			std::shared_ptr<CABIR> newABIR = std::make_shared<CABIR>();
+			newABIR->Setup(ownerCore->GetAudioState().bufferSize, environmentBRIR->GetBRIRLength());
+			newABIR->AddImpulseResponse(TBFormatChannel::W, Common::T_ear::LEFT, std::move(newAIR_W_left));
+			newABIR->AddImpulseResponse(TBFormatChannel::W, Common::T_ear::RIGHT, std::move(newAIR_W_right));
+			newABIR->AddImpulseResponse(TBFormatChannel::X, Common::T_ear::LEFT, std::move(newAIR_X_left));
+			newABIR->AddImpulseResponse(TBFormatChannel::X, Common::T_ear::RIGHT, std::move(newAIR_X_right));
+			newABIR->AddImpulseResponse(TBFormatChannel::Y, Common::T_ear::LEFT, std::move(newAIR_Y_left));
+			newABIR->AddImpulseResponse(TBFormatChannel::Y, Common::T_ear::RIGHT, std::move(newAIR_Y_right));
+			environmentABIR = std::move(newABIR);
+			if (enableAsynchronousBRIRSetup) { ABIRPublisher.Retain(environmentABIR); }
 		}
 		else {
 			if (reverberationOrder == TReverberationOrder::THREEDIMENSIONAL){
@@ -557,20 +757,21 @@ namespace Binaural {
 	// Get ABIR for environment
 	const CABIR& CEnvironment::GetABIR() const
 	{
-		return environmentABIR;
+		return *environmentABIR;
 	}
 
 //////////////////////////////////////////////
 	void CEnvironment::ProcessVirtualAmbisonicReverbAdimensional(CMonoBuffer<float> & outBufferLeft, CMonoBuffer<float> & outBufferRight, int numberOfSilencedFrames)
 	{
 		CMonoBuffer<float> w;	// B-Format data		
+#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_REVERB 
 		CMonoBuffer<float> w_AbirW_left_FFT;
 		CMonoBuffer<float> w_AbirW_right_FFT;
 		CMonoBuffer<float> mixerOutput_left_FFT;
 		CMonoBuffer<float> mixerOutput_right_FFT;
+#endif
 		CMonoBuffer<float> mixerOutput_left;
 		CMonoBuffer<float> mixerOutput_right;
-		CMonoBuffer<float> ouputBuffer_temp;
 
 
 		float WScale = 0.707107f;
@@ -658,7 +859,7 @@ namespace Binaural {
 		///////
 		CMonoBuffer<float> w_FFT;
 		//Make FFT of W		
-		Common::CFprocessor::GetFFT(w, w_FFT, environmentABIR.GetDataLength());
+		Common::CFprocessor::GetFFT(w, w_FFT, environmentABIR->GetDataLength());
 		Common::CFprocessor::ComplexMultiplication(w_FFT, GetABIR().GetImpulseResponse(TBFormatChannel::W, T_ear::LEFT), w_AbirW_left_FFT);
 		Common::CFprocessor::ComplexMultiplication(w_FFT, GetABIR().GetImpulseResponse(TBFormatChannel::W, T_ear::RIGHT), w_AbirW_right_FFT);
 
@@ -667,7 +868,7 @@ namespace Binaural {
 		///////
 		CMonoBuffer<float> x_FFT;
 		//Make FFT of X		
-		Common::CFprocessor::GetFFT(x, x_FFT, environmentABIR.GetDataLength());
+		Common::CFprocessor::GetFFT(x, x_FFT, environmentABIR->GetDataLength());
 		//Complex Product				
 		Common::CFprocessor::ComplexMultiplication(x_FFT, GetABIR().GetImpulseResponse(X, T_ear::LEFT), x_AbirX_left_FFT);
 		Common::CFprocessor::ComplexMultiplication(x_FFT, GetABIR().GetImpulseResponse(X, T_ear::RIGHT), x_AbirX_right_FFT);
@@ -678,16 +879,28 @@ namespace Binaural {
 		CMonoBuffer<float> y_FFT;
 		//TBFormatChannelData abirY = GetABIR().GetChannelData(Y);
 		//Make FFT of Y				
-		Common::CFprocessor::GetFFT(y, y_FFT, environmentABIR.GetDataLength());
+		Common::CFprocessor::GetFFT(y, y_FFT, environmentABIR->GetDataLength());
 		//Complex Product		
 		Common::CFprocessor::ComplexMultiplication(y_FFT, GetABIR().GetImpulseResponse(Y, T_ear::LEFT), y_AbirY_left_FFT);
 		Common::CFprocessor::ComplexMultiplication(y_FFT, GetABIR().GetImpulseResponse(Y, T_ear::RIGHT), y_AbirY_right_FFT);
 #else		
 
-		///Apply UPC algorithm			
-		wLeft_UPConvolution.ProcessUPConvolution_withoutIFFT(w, GetABIR().GetImpulseResponse_Partitioned(TBFormatChannel::W, Common::T_ear::LEFT), w_AbirW_left_FFT, numberOfSilencedFrames);
-		wRight_UPConvolution.ProcessUPConvolution_withoutIFFT(w, GetABIR().GetImpulseResponse_Partitioned(TBFormatChannel::W, Common::T_ear::RIGHT), w_AbirW_right_FFT, numberOfSilencedFrames);
+		if (reverbConvolutionMethod == TReverbConvolutionMethod::NON_UNIFORMLY_PARTITIONED)
+		{
+			///Apply NUPC algorithm, its output is already in time domain
+			ProcessNUPConvolution(TBFormatChannel::W, w, mixerOutput_left, mixerOutput_right);
+		}
+		else
+		{
+			///Apply UPC algorithm. The FFTs of all the channels are done at once, each one shared by both ears, and the products of all the channels are added in the same spectrum of each ear
+			ProcessUPConvolution({ &w }, numberOfSilencedFrames);
 
+			//The tail of the ABIR is convolved in the worker thread with the same inputs
+			if (reverbTailConvolution.IsRunning())
+			{
+				reverbTailConvolution.SetInput(TBFormatChannel::W, w);
+			}
+		}
 #endif
 
 
@@ -703,6 +916,7 @@ namespace Binaural {
 		PROFILER3DTI.RelativeSampleStart(dsEnvInvFFT);
 #endif
 
+#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_REVERB 
 		mixerOutput_left_FFT.SetFromMix({ w_AbirW_left_FFT });
 		mixerOutput_right_FFT.SetFromMix({ w_AbirW_right_FFT });
 
@@ -711,27 +925,20 @@ namespace Binaural {
 		////////////////////////////////////////
 
 		//TODO All this could be parallelized
-
-
-#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_REVERB 
 		outputLeft.CalculateIFFT_OLA(mixerOutput_left_FFT, mixerOutput_left);
 		outputRight.CalculateIFFT_OLA(mixerOutput_right_FFT, mixerOutput_right);
 #else
-		//Left channel
-		Common::CFprocessor::CalculateIFFT(mixerOutput_left_FFT, ouputBuffer_temp);
-		//We are left only with the final half of the result
-		int halfsize = (int)(ouputBuffer_temp.size() * 0.5f);
-
-		CMonoBuffer<float> temp_OutputBlockLeft(ouputBuffer_temp.begin() + halfsize, ouputBuffer_temp.end());
-		mixerOutput_left = std::move(temp_OutputBlockLeft);			//To use in C++11
-
-		//Right channel
-		ouputBuffer_temp.clear();
-		Common::CFprocessor::CalculateIFFT(mixerOutput_right_FFT, ouputBuffer_temp);
-		//We are left only with the final half of the result
-		halfsize = (int)(ouputBuffer_temp.size() * 0.5f);
-		CMonoBuffer<float> temp_OutputBlockRight(ouputBuffer_temp.begin() + halfsize, ouputBuffer_temp.end());
-		mixerOutput_right = std::move(temp_OutputBlockRight);			//To use in C++11
+		////////////////////////////////////////
+		// FFT-1 Going back to the time domain
+		////////////////////////////////////////
+
+		//The channels have already been mixed in the frequency domain by the UPC algorithm, so only one IFFT per ear is needed
+		if (reverbConvolutionMethod == TReverbConvolutionMethod::UNIFORMLY_PARTITIONED)
+		{
+			ProcessUPConvolutionIFFT(mixerOutput_left, mixerOutput_right);
+			//The output of the tail for this block was calculated in advance by the worker thread
+			if (reverbTailConvolution.IsRunning()) { reverbTailConvolution.ProcessTailOutput(mixerOutput_left, mixerOutput_right, numberOfSilencedFrames); }
+		}
 #endif
 
 		//////////////////////////////////////////////
@@ -765,6 +972,7 @@ namespace Binaural {
 	void CEnvironment::ProcessVirtualAmbisonicReverbBidimensional(CMonoBuffer<float> & outBufferLeft, CMonoBuffer<float> & outBufferRight, int numberOfSilencedFrames)
 	{
 		CMonoBuffer<float> w, x, y;	// B-Format data		
+#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_REVERB 
 		CMonoBuffer<float> w_AbirW_left_FFT;
 		CMonoBuffer<float> w_AbirW_right_FFT;
 		CMonoBuffer<float> x_AbirX_left_FFT;
@@ -773,9 +981,9 @@ namespace Binaural {
 		CMonoBuffer<float> y_AbirY_right_FFT;
 		CMonoBuffer<float> mixerOutput_left_FFT;
 		CMonoBuffer<float> mixerOutput_right_FFT;
+#endif
 		CMonoBuffer<float> mixerOutput_left;
 		CMonoBuffer<float> mixerOutput_right;
-		CMonoBuffer<float> ouputBuffer_temp;
 		
 
 		float WScale = 0.707107f;
@@ -879,7 +1087,7 @@ namespace Binaural {
 		///////
 		CMonoBuffer<float> w_FFT;
 		//Make FFT of W		
-		Common::CFprocessor::GetFFT(w, w_FFT, environmentABIR.GetDataLength());
+		Common::CFprocessor::GetFFT(w, w_FFT, environmentABIR->GetDataLength());
 		Common::CFprocessor::ComplexMultiplication(w_FFT, GetABIR().GetImpulseResponse(TBFormatChannel::W, T_ear::LEFT), w_AbirW_left_FFT);
 		Common::CFprocessor::ComplexMultiplication(w_FFT, GetABIR().GetImpulseResponse(TBFormatChannel::W, T_ear::RIGHT), w_AbirW_right_FFT);
 
@@ -888,7 +1096,7 @@ namespace Binaural {
 		///////
 		CMonoBuffer<float> x_FFT;
 		//Make FFT of X		
-		Common::CFprocessor::GetFFT(x, x_FFT, environmentABIR.GetDataLength());
+		Common::CFprocessor::GetFFT(x, x_FFT, environmentABIR->GetDataLength());
 		//Complex Product				
 		Common::CFprocessor::ComplexMultiplication(x_FFT, GetABIR().GetImpulseResponse(X, T_ear::LEFT), x_AbirX_left_FFT);
 		Common::CFprocessor::ComplexMultiplication(x_FFT, GetABIR().GetImpulseResponse(X, T_ear::RIGHT), x_AbirX_right_FFT);
@@ -899,19 +1107,32 @@ namespace Binaural {
 		CMonoBuffer<float> y_FFT;
 		//TBFormatChannelData abirY = GetABIR().GetChannelData(Y);
 		//Make FFT of Y				
-		Common::CFprocessor::GetFFT(y, y_FFT, environmentABIR.GetDataLength());
+		Common::CFprocessor::GetFFT(y, y_FFT, environmentABIR->GetDataLength());
 		//Complex Product		
 		Common::CFprocessor::ComplexMultiplication(y_FFT, GetABIR().GetImpulseResponse(Y, T_ear::LEFT), y_AbirY_left_FFT);
 		Common::CFprocessor::ComplexMultiplication(y_FFT, GetABIR().GetImpulseResponse(Y, T_ear::RIGHT), y_AbirY_right_FFT);
 #else		
 
-		///Apply UPC algorithm			
-		wLeft_UPConvolution.ProcessUPConvolution_withoutIFFT(w, GetABIR().GetImpulseResponse_Partitioned(TBFormatChannel::W, Common::T_ear::LEFT), w_AbirW_left_FFT);
-		wRight_UPConvolution.ProcessUPConvolution_withoutIFFT(w, GetABIR().GetImpulseResponse_Partitioned(TBFormatChannel::W, Common::T_ear::RIGHT), w_AbirW_right_FFT);
-		xLeft_UPConvolution.ProcessUPConvolution_withoutIFFT(x, GetABIR().GetImpulseResponse_Partitioned(X, Common::T_ear::LEFT), x_AbirX_left_FFT);
-		xRight_UPConvolution.ProcessUPConvolution_withoutIFFT(x, GetABIR().GetImpulseResponse_Partitioned(X, Common::T_ear::RIGHT), x_AbirX_right_FFT);
-		yLeft_UPConvolution.ProcessUPConvolution_withoutIFFT(y, GetABIR().GetImpulseResponse_Partitioned(Y, Common::T_ear::LEFT), y_AbirY_left_FFT);
-		yRight_UPConvolution.ProcessUPConvolution_withoutIFFT(y, GetABIR().GetImpulseResponse_Partitioned(Y, Common::T_ear::RIGHT), y_AbirY_right_FFT);
+		if (reverbConvolutionMethod == TReverbConvolutionMethod::NON_UNIFORMLY_PARTITIONED)
+		{
+			///Apply NUPC algorithm, its output is already in time domain
+			ProcessNUPConvolution(TBFormatChannel::W, w, mixerOutput_left, mixerOutput_right);
+			ProcessNUPConvolution(TBFormatChannel::X, x, mixerOutput_left, mixerOutput_right);
+			ProcessNUPConvolution(TBFormatChannel::Y, y, mixerOutput_left, mixerOutput_right);
+		}
+		else
+		{
+			///Apply UPC algorithm. The FFTs of all the channels are done at once, each one shared by both ears, and the products of all the channels are added in the same spectrum of each ear
+			ProcessUPConvolution({ &w, &x, &y });
+
+			//The tail of the ABIR is convolved in the worker thread with the same inputs
+			if (reverbTailConvolution.IsRunning())
+			{
+				reverbTailConvolution.SetInput(TBFormatChannel::W, w);
+				reverbTailConvolution.SetInput(TBFormatChannel::X, x);
+				reverbTailConvolution.SetInput(TBFormatChannel::Y, y);
+			}
+		}
 #endif
 
 
@@ -927,6 +1148,7 @@ namespace Binaural {
 		PROFILER3DTI.RelativeSampleStart(dsEnvInvFFT);
 #endif
 
+#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_REVERB 
 		mixerOutput_left_FFT.SetFromMix({ w_AbirW_left_FFT, x_AbirX_left_FFT, y_AbirY_left_FFT });
 		mixerOutput_right_FFT.SetFromMix({ w_AbirW_right_FFT, x_AbirX_right_FFT, y_AbirY_right_FFT });
 
@@ -935,27 +1157,20 @@ namespace Binaural {
 		////////////////////////////////////////
 
 		//TODO All this could be parallelized
-
-
-#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_REVERB 
 		outputLeft.CalculateIFFT_OLA(mixerOutput_left_FFT, mixerOutput_left);
 		outputRight.CalculateIFFT_OLA(mixerOutput_right_FFT, mixerOutput_right);
 #else
-		//Left channel
-		Common::CFprocessor::CalculateIFFT(mixerOutput_left_FFT, ouputBuffer_temp);
-		//We are left only with the final half of the result
-		int halfsize = (int)(ouputBuffer_temp.size() * 0.5f);
-
-		CMonoBuffer<float> temp_OutputBlockLeft(ouputBuffer_temp.begin() + halfsize, ouputBuffer_temp.end());
-		mixerOutput_left = std::move(temp_OutputBlockLeft);			//To use in C++11
-
-																	//Right channel
-		ouputBuffer_temp.clear();
-		Common::CFprocessor::CalculateIFFT(mixerOutput_right_FFT, ouputBuffer_temp);
-		//We are left only with the final half of the result
-		halfsize = (int)(ouputBuffer_temp.size() * 0.5f);
-		CMonoBuffer<float> temp_OutputBlockRight(ouputBuffer_temp.begin() + halfsize, ouputBuffer_temp.end());
-		mixerOutput_right = std::move(temp_OutputBlockRight);			//To use in C++11
+		////////////////////////////////////////
+		// FFT-1 Going back to the time domain
+		////////////////////////////////////////
+
+		//The channels have already been mixed in the frequency domain by the UPC algorithm, so only one IFFT per ear is needed
+		if (reverbConvolutionMethod == TReverbConvolutionMethod::UNIFORMLY_PARTITIONED)
+		{
+			ProcessUPConvolutionIFFT(mixerOutput_left, mixerOutput_right);
+			//The output of the tail for this block was calculated in advance by the worker thread
+			if (reverbTailConvolution.IsRunning()) { reverbTailConvolution.ProcessTailOutput(mixerOutput_left, mixerOutput_right, numberOfSilencedFrames); }
+		}
 #endif
 
 		//////////////////////////////////////////////
@@ -989,6 +1204,7 @@ namespace Binaural {
 	void CEnvironment::ProcessVirtualAmbisonicReverbThreedimensional(CMonoBuffer<float> & outBufferLeft, CMonoBuffer<float> & outBufferRight, int numberOfSilencedFrames)
 	{
 		CMonoBuffer<float> w, x, y, z;	// B-Format data		
+#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_REVERB 
 		CMonoBuffer<float> w_AbirW_left_FFT;
 		CMonoBuffer<float> w_AbirW_right_FFT;
 		CMonoBuffer<float> x_AbirX_left_FFT;
@@ -999,9 +1215,9 @@ namespace Binaural {
 		CMonoBuffer<float> z_AbirZ_right_FFT;
 		CMonoBuffer<float> mixerOutput_left_FFT;
 		CMonoBuffer<float> mixerOutput_right_FFT;
+#endif
 		CMonoBuffer<float> mixerOutput_left;
 		CMonoBuffer<float> mixerOutput_right;
-		CMonoBuffer<float> ouputBuffer_temp;
 
 		float WScale = 0.707107f;
 
@@ -1106,7 +1322,7 @@ namespace Binaural {
 		///////
 		CMonoBuffer<float> w_FFT;
 		//Make FFT of W		
-		Common::CFprocessor::GetFFT(w, w_FFT, environmentABIR.GetDataLength());
+		Common::CFprocessor::GetFFT(w, w_FFT, environmentABIR->GetDataLength());
 		Common::CFprocessor::ComplexMultiplication(w_FFT, GetABIR().GetImpulseResponse(TBFormatChannel::W, T_ear::LEFT), w_AbirW_left_FFT);
 		Common::CFprocessor::ComplexMultiplication(w_FFT, GetABIR().GetImpulseResponse(TBFormatChannel::W, T_ear::RIGHT), w_AbirW_right_FFT);
 
@@ -1115,7 +1331,7 @@ namespace Binaural {
 		///////
 		CMonoBuffer<float> x_FFT;
 		//Make FFT of X		
-		Common::CFprocessor::GetFFT(x, x_FFT, environmentABIR.GetDataLength());
+		Common::CFprocessor::GetFFT(x, x_FFT, environmentABIR->GetDataLength());
 		//Complex Product				
 		Common::CFprocessor::ComplexMultiplication(x_FFT, GetABIR().GetImpulseResponse(X, T_ear::LEFT), x_AbirX_left_FFT);
 		Common::CFprocessor::ComplexMultiplication(x_FFT, GetABIR().GetImpulseResponse(X, T_ear::RIGHT), x_AbirX_right_FFT);
@@ -1126,22 +1342,34 @@ namespace Binaural {
 		CMonoBuffer<float> y_FFT;
 		//TBFormatChannelData abirY = GetABIR().GetChannelData(Y);
 		//Make FFT of Y				
-		Common::CFprocessor::GetFFT(y, y_FFT, environmentABIR.GetDataLength());
+		Common::CFprocessor::GetFFT(y, y_FFT, environmentABIR->GetDataLength());
 		//Complex Product		
 		Common::CFprocessor::ComplexMultiplication(y_FFT, GetABIR().GetImpulseResponse(Y, T_ear::LEFT), y_AbirY_left_FFT);
 		Common::CFprocessor::ComplexMultiplication(y_FFT, GetABIR().GetImpulseResponse(Y, T_ear::RIGHT), y_AbirY_right_FFT);
 #else		
 
-		///Apply UPC algorithm			
-		wLeft_UPConvolution.ProcessUPConvolution_withoutIFFT(w, GetABIR().GetImpulseResponse_Partitioned(TBFormatChannel::W, Common::T_ear::LEFT), w_AbirW_left_FFT);
-		wRight_UPConvolution.ProcessUPConvolution_withoutIFFT(w, GetABIR().GetImpulseResponse_Partitioned(TBFormatChannel::W, Common::T_ear::RIGHT), w_AbirW_right_FFT);
-		xLeft_UPConvolution.ProcessUPConvolution_withoutIFFT(x, GetABIR().GetImpulseResponse_Partitioned(TBFormatChannel::X, Common::T_ear::LEFT), x_AbirX_left_FFT);
-		xRight_UPConvolution.ProcessUPConvolution_withoutIFFT(x, GetABIR().GetImpulseResponse_Partitioned(TBFormatChannel::X, Common::T_ear::RIGHT), x_AbirX_right_FFT);
-		yLeft_UPConvolution.ProcessUPConvolution_withoutIFFT(y, GetABIR().GetImpulseResponse_Partitioned(TBFormatChannel::Y, Common::T_ear::LEFT), y_AbirY_left_FFT);
-		yRight_UPConvolution.ProcessUPConvolution_withoutIFFT(y, GetABIR().GetImpulseResponse_Partitioned(TBFormatChannel::Y, Common::T_ear::RIGHT), y_AbirY_right_FFT);
-		zLeft_UPConvolution.ProcessUPConvolution_withoutIFFT(z, GetABIR().GetImpulseResponse_Partitioned(TBFormatChannel::Z, Common::T_ear::LEFT), z_AbirZ_left_FFT);
-		zRight_UPConvolution.ProcessUPConvolution_withoutIFFT(z, GetABIR().GetImpulseResponse_Partitioned(TBFormatChannel::Z, Common::T_ear::RIGHT), z_AbirZ_right_FFT);
+		if (reverbConvolutionMethod == TReverbConvolutionMethod::NON_UNIFORMLY_PARTITIONED)
+		{
+			///Apply NUPC algorithm, its output is already in time domain
+			ProcessNUPConvolution(TBFormatChannel::W, w, mixerOutput_left, mixerOutput_right);
+			ProcessNUPConvolution(TBFormatChannel::X, x, mixerOutput_left, mixerOutput_right);
+			ProcessNUPConvolution(TBFormatChannel::Y, y, mixerOutput_left, mixerOutput_right);
+			ProcessNUPConvolution(TBFormatChannel::Z, z, mixerOutput_left, mixerOutput_right);
+		}
+		else
+		{
+			///Apply UPC algorithm. The FFTs of all the channels are done at once, each one shared by both ears, and the products of all the channels are added in the same spectrum of each ear
+			ProcessUPConvolution({ &w, &x, &y, &z });
 
+			//The tail of the ABIR is convolved in the worker thread with the same inputs
+			if (reverbTailConvolution.IsRunning())
+			{
+				reverbTailConvolution.SetInput(TBFormatChannel::W, w);
+				reverbTailConvolution.SetInput(TBFormatChannel::X, x);
+				reverbTailConvolution.SetInput(TBFormatChannel::Y, y);
+				reverbTailConvolution.SetInput(TBFormatChannel::Z, z);
+			}
+		}
 #endif
 
 
@@ -1157,6 +1385,7 @@ namespace Binaural {
 		PROFILER3DTI.RelativeSampleStart(dsEnvInvFFT);
 #endif
 
+#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_REVERB 
 		mixerOutput_left_FFT.SetFromMix({ w_AbirW_left_FFT, x_AbirX_left_FFT, y_AbirY_left_FFT, z_AbirZ_left_FFT });
 		mixerOutput_right_FFT.SetFromMix({ w_AbirW_right_FFT, x_AbirX_right_FFT, y_AbirY_right_FFT, z_AbirZ_right_FFT });
 
@@ -1165,27 +1394,20 @@ namespace Binaural {
 		////////////////////////////////////////
 
 		//TODO All this could be parallelized
-
-
-#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_REVERB 
 		outputLeft.CalculateIFFT_OLA(mixerOutput_left_FFT, mixerOutput_left);
 		outputRight.CalculateIFFT_OLA(mixerOutput_right_FFT, mixerOutput_right);
 #else
-		//Left channel
-		Common::CFprocessor::CalculateIFFT(mixerOutput_left_FFT, ouputBuffer_temp);
-		//We are left only with the final half of the result
-		int halfsize = (int)(ouputBuffer_temp.size() * 0.5f);
-
-		CMonoBuffer<float> temp_OutputBlockLeft(ouputBuffer_temp.begin() + halfsize, ouputBuffer_temp.end());
-		mixerOutput_left = std::move(temp_OutputBlockLeft);			//To use in C++11
-
-																	//Right channel
-		ouputBuffer_temp.clear();
-		Common::CFprocessor::CalculateIFFT(mixerOutput_right_FFT, ouputBuffer_temp);
-		//We are left only with the final half of the result
-		halfsize = (int)(ouputBuffer_temp.size() * 0.5f);
-		CMonoBuffer<float> temp_OutputBlockRight(ouputBuffer_temp.begin() + halfsize, ouputBuffer_temp.end());
-		mixerOutput_right = std::move(temp_OutputBlockRight);			//To use in C++11
+		////////////////////////////////////////
+		// FFT-1 Going back to the time domain
+		////////////////////////////////////////
+
+		//The channels have already been mixed in the frequency domain by the UPC algorithm, so only one IFFT per ear is needed
+		if (reverbConvolutionMethod == TReverbConvolutionMethod::UNIFORMLY_PARTITIONED)
+		{
+			ProcessUPConvolutionIFFT(mixerOutput_left, mixerOutput_right);
+			//The output of the tail for this block was calculated in advance by the worker thread
+			if (reverbTailConvolution.IsRunning()) { reverbTailConvolution.ProcessTailOutput(mixerOutput_left, mixerOutput_right, numberOfSilencedFrames); }
+		}
 #endif
 
 		//////////////////////////////////////////////
@@ -1219,7 +1441,10 @@ namespace Binaural {
 	// Process virtual ambisonic reverb for specified buffers
 	void CEnvironment::ProcessVirtualAmbisonicReverb(CMonoBuffer<float> & outBufferLeft, CMonoBuffer<float> & outBufferRight, int numberOfSilencedFrames)
 	{
-		if (!environmentABIR.IsInitialized())
+		//Take the ABIR calculated in the background, if there is a new one, before convolving this block
+		ApplyPublishedABIR();
+
+		if (!environmentABIR->IsInitialized())
 		{
 			SET_RESULT(RESULT_ERROR_NOTINITIALIZED, "Data is not ready to be processed");
 			return;
@@ -1281,36 +1506,15 @@ namespace Binaural {
 #ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_REVERB 
 
 		//Make FFT and frequency convolution		
-		Common::CFprocessor::GetFFT(encoderIn, channel_FFT, environmentABIR.GetDataLength());
+		Common::CFprocessor::GetFFT(encoderIn, channel_FFT, environmentABIR->GetDataLength());
 		Common::CFprocessor::ComplexMultiplication(channel_FFT, GetABIR().GetImpulseResponse(channel, T_ear::RIGHT), Convolution_right_FFT);
 		Common::CFprocessor::ComplexMultiplication(channel_FFT, GetABIR().GetImpulseResponse(channel, T_ear::LEFT), Convolution_left_FFT);
 		//FFT Inverse
 		outputLeft.CalculateIFFT_OLA(Convolution_left_FFT, leftOutputBuffer);
 		outputRight.CalculateIFFT_OLA(Convolution_right_FFT, rightOutputBuffer);
 #else
-		///UPC Convolution
-		if (channel == TBFormatChannel::W)
-		{
-			wLeft_UPConvolution.ProcessUPConvolution(encoderIn, GetABIR().GetImpulseResponse_Partitioned(TBFormatChannel::W, Common::T_ear::LEFT), leftOutputBuffer);
-			wRight_UPConvolution.ProcessUPConvolution(encoderIn, GetABIR().GetImpulseResponse_Partitioned(TBFormatChannel::W, Common::T_ear::RIGHT), rightOutputBuffer);
-	}
-		else if (channel == TBFormatChannel::X)
-		{
-			xLeft_UPConvolution.ProcessUPConvolution(encoderIn, GetABIR().GetImpulseResponse_Partitioned(X, Common::T_ear::LEFT), leftOutputBuffer);
-			xRight_UPConvolution.ProcessUPConvolution(encoderIn, GetABIR().GetImpulseResponse_Partitioned(X, Common::T_ear::RIGHT), rightOutputBuffer);
-		}
-		else if (channel == TBFormatChannel::Y)
-		{
-			yLeft_UPConvolution.ProcessUPConvolution(encoderIn, GetABIR().GetImpulseResponse_Partitioned(Y, Common::T_ear::LEFT), leftOutputBuffer);
-			yRight_UPConvolution.ProcessUPConvolution(encoderIn, GetABIR().GetImpulseResponse_Partitioned(Y, Common::T_ear::RIGHT), rightOutputBuffer);
-		}
-		else if (channel == TBFormatChannel::Z) {
-			zLeft_UPConvolution.ProcessUPConvolution(encoderIn, GetABIR().GetImpulseResponse_Partitioned(Z, Common::T_ear::LEFT), leftOutputBuffer);
-			zRight_UPConvolution.ProcessUPConvolution(encoderIn, GetABIR().GetImpulseResponse_Partitioned(Z, Common::T_ear::RIGHT), rightOutputBuffer);
-		}
-		else {
-			//Error
-		}
+		///UPC Convolution, only the delay line of this channel is used
+		ProcessUPConvolution(channel, encoderIn, leftOutputBuffer, rightOutputBuffer);
 		// Build Stereo buffer
 		output.FromTwoMonosToStereo(leftOutputBuffer, rightOutputBuffer);
 #endif
@@ -1329,32 +1533,15 @@ namespace Binaural {
 #ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_REVERB 
 
 		//Make FFT and frequency convolution		
-		Common::CFprocessor::GetFFT(encoderIn, channel_FFT, environmentABIR.GetDataLength());
+		Common::CFprocessor::GetFFT(encoderIn, channel_FFT, environmentABIR->GetDataLength());
 		Common::CFprocessor::ComplexMultiplication(channel_FFT, GetABIR().GetImpulseResponse(channel, T_ear::RIGHT), Convolution_right_FFT);
 		Common::CFprocessor::ComplexMultiplication(channel_FFT, GetABIR().GetImpulseResponse(channel, T_ear::LEFT), Convolution_left_FFT);
 		//FFT Inverse
 		outputLeft.CalculateIFFT_OLA(Convolution_left_FFT, leftOutputBuffer);
 		outputRight.CalculateIFFT_OLA(Convolution_right_FFT, rightOutputBuffer);
 #else
-		///UPC Convolution
-		if (channel == TBFormatChannel::W)
-		{
-			wLeft_UPConvolution.ProcessUPConvolution(encoderIn, GetABIR().GetImpulseResponse_Partitioned(TBFormatChannel::W, Common::T_ear::LEFT), leftOutputBuffer);
-			wRight_UPConvolution.ProcessUPConvolution(encoderIn, GetABIR().GetImpulseResponse_Partitioned(TBFormatChannel::W, Common::T_ear::RIGHT), rightOutputBuffer);
-		}
-		else if (channel == TBFormatChannel::X)
-		{
-			xLeft_UPConvolution.ProcessUPConvolution(encoderIn, GetABIR().GetImpulseResponse_Partitioned(X, Common::T_ear::LEFT), leftOutputBuffer);
-			xRight_UPConvolution.ProcessUPConvolution(encoderIn, GetABIR().GetImpulseResponse_Partitioned(X, Common::T_ear::RIGHT), rightOutputBuffer);
-		}
-		else if (channel == TBFormatChannel::Y)
-		{
-			yLeft_UPConvolution.ProcessUPConvolution(encoderIn, GetABIR().GetImpulseResponse_Partitioned(Y, Common::T_ear::LEFT), leftOutputBuffer);
-			yRight_UPConvolution.ProcessUPConvolution(encoderIn, GetABIR().GetImpulseResponse_Partitioned(Y, Common::T_ear::RIGHT), rightOutputBuffer);
-		}
-		else {
-			//Error
-		}
+		///UPC Convolution, only the delay line of this channel is used
+		ProcessUPConvolution(channel, encoderIn, leftOutputBuffer, rightOutputBuffer);
 		// Build Stereo buffer
 		output.FromTwoMonosToStereo(leftOutputBuffer, rightOutputBuffer);
 #endif
@@ -1370,12 +1557,8 @@ namespace Binaural {
 		CMonoBuffer<float> leftOutputBuffer;
 		CMonoBuffer<float> rightOutputBuffer;
 
-		if (channel == TBFormatChannel::W)
-		{
-			wLeft_UPConvolution.ProcessUPConvolution(encoderIn, GetABIR().GetImpulseResponse_Partitioned(TBFormatChannel::W, Common::T_ear::LEFT), leftOutputBuffer);
-			wRight_UPConvolution.ProcessUPConvolution(encoderIn, GetABIR().GetImpulseResponse_Partitioned(TBFormatChannel::W, Common::T_ear::RIGHT), rightOutputBuffer);
-		}
-		else { /* Error */ }
+		///UPC Convolution, only the delay line of this channel is used
+		ProcessUPConvolution(channel, encoderIn, leftOutputBuffer, rightOutputBuffer);
 
 		// Build Stereo buffer
 		output.FromTwoMonosToStereo(leftOutputBuffer, rightOutputBuffer);
@@ -1384,8 +1567,19 @@ namespace Binaural {
 	// Process reverb for one b-format channel encoded with 1st order ambisonics (useful for some wrappers)
 	void CEnvironment::ProcessEncodedChannelReverb(TBFormatChannel channel, CMonoBuffer<float> encoderIn, CMonoBuffer<float> & output)
 	{	
+		//Take the ABIR calculated in the background, if there is a new one. It is not crossfaded in this method
+		ApplyPublishedABIR();
 
 		// error handler: Trust in called methods for setting result
+		if (reverbConvolutionMethod == TReverbConvolutionMethod::NON_UNIFORMLY_PARTITIONED)
+		{
+			CMonoBuffer<float> leftOutputBuffer;
+			CMonoBuffer<float> rightOutputBuffer;
+			ProcessNUPConvolution(channel, encoderIn, leftOutputBuffer, rightOutputBuffer);
+			output.FromTwoMonosToStereo(leftOutputBuffer, rightOutputBuffer);
+			return;
+		}
+
 		switch (reverberationOrder) {
 		case TReverberationOrder::BIDIMENSIONAL:
 			ProcessEncodedChannelReverbBidimensional(channel, encoderIn, output);
@@ -1432,7 +1626,61 @@ namespace Binaural {
 	//brief Reset the BRIR and ARIR tables
 	void CEnvironment::ResetBRIR_ABIR() 
 	{		
-		environmentABIR.Reset();				//Reset ABIR of environment								
+		ABIRPublisher.Clear();								//An ABIR calculated in the background for the previous audio state is discarded
+		environmentABIR = std::make_shared<CABIR>();		//Reset ABIR of environment
+		previousABIR.reset();
+		lastABIR.reset();
+		BRIRCrossfadeBlocksLeft = 0;
+		if (enableAsynchronousBRIRSetup) { ABIRPublisher.Retain(environmentABIR); }
 		environmentBRIR->Reset();				//Reset BRIR of enviroment			
 	}
+
+	// The ABIR in use is replaced here when the BRIR is set up in the same thread as the audio, or when the new one does not fit in the convolvers in use
+	void CEnvironment::ReplaceABIR(std::shared_ptr<const CABIR> newABIR)
+	{
+		//The audio thread only swaps the ABIR, so only one that fits in the convolvers prepared for the last one is published
+		if (enableAsynchronousBRIRSetup && (lastABIR != nullptr) && FitsInConvolvers(*lastABIR, *newABIR)) {
+			lastABIR = newABIR;
+			ABIRPublisher.Publish(std::move(newABIR));
+			return;
+		}
+
+		//The first ABIR, or one of another length, is used at once
+		environmentABIR = std::move(newABIR);
+		lastABIR = environmentABIR;
+		if (enableAsynchronousBRIRSetup) { ABIRPublisher.Retain(environmentABIR); }
+		previousABIR.reset();
+		BRIRCrossfadeBlocksLeft = 0;
+#ifndef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_REVERB
+		int bufferLength = ownerCore->GetAudioState().bufferSize;
+		if (reverbConvolutionMethod == TReverbConvolutionMethod::NON_UNIFORMLY_PARTITIONED) { SetupNUPConvolution(bufferLength); }
+		else { SetupUPConvolution(bufferLength); }
+#endif
+	}
+
+	bool CEnvironment::FitsInConvolvers(const CABIR & currentABIR, const CABIR & newABIR) const
+	{
+#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_REVERB
+		return false;
+#else
+		return currentABIR.IsInitialized() && newABIR.IsInitialized() && (reverbConvolutionMethod == TReverbConvolutionMethod::UNIFORMLY_PARTITIONED) && !reverbTailConvolution.IsRunning() &&
+			(newABIR.GetDataNumberOfBlocks() == currentABIR.GetDataNumberOfBlocks()) && (newABIR.GetDataBlockLength_freq() == currentABIR.GetDataBlockLength_freq()) &&
+			(bFormatUPConvolution.GetNumberOfChannels() == GetNumberOfBFormatChannels()) && (reverbLeft_Frequency.size() == (size_t)newABIR.GetDataBlockLength_freq());
+#endif
+	}
+
+	// Take the new ABIR at the beginning of a block. It never waits for the background setup nor frees the previous ABIR, which is kept by the publisher
+	void CEnvironment::ApplyPublishedABIR()
+	{
+		std::shared_ptr<const CABIR> newABIR;
+		if (!ABIRPublisher.TakePublished(newABIR)) { return; }
+
+		//ReplaceABIR only publishes ABIRs that fit in the convolvers in use, so this only discards an ABIR calculated before a change of the reverb setup
+		if (!FitsInConvolvers(*environmentABIR, *newABIR)) { return; }
+
+		//The convolvers and their delay lines are kept, so the reverb of the previous ABIR is crossfaded with the new one
+		previousABIR = (BRIRCrossfadeBlocks > 0) ? environmentABIR : nullptr;
+		environmentABIR = std::move(newABIR);
+		BRIRCrossfadeBlocksLeft = (previousABIR != nullptr) ? BRIRCrossfadeBlocks : 0;
+	}
 }
\ No newline at end of file
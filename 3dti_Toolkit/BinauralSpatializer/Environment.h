@@ -27,8 +27,11 @@
 #include <BinauralSpatializer/Listener.h>
 #include <Common/Buffer.h>
 #include <Common/Fprocessor.h>
-#include <Common/UPCEnvironment.h>
+#include <Common/UPCEnvironmentMultichannel.h>
+#include <Common/NUPCEnvironment.h>
+#include <Common/UPCEnvironmentAsyncTail.h>
 #include <Common/CommonDefinitions.h>
+#include <Common/AsyncPublisher.h>
 #include <vector>
 #include <memory>
 
@@ -43,8 +46,27 @@ enum VirtualSpeakerPosition {
 	NADIR					///<	SPK  (nadir)
 };
 
+/** \brief Default number of blocks of the ABIR convolved in the audio thread when the reverb tail is convolved in a worker thread
+*/
+#define DEFAULT_REVERB_HEAD_NUMBER_OF_BLOCKS 8
+
+/** \brief Default number of blocks that the reverb tail is calculated in advance by the worker thread
+*/
+#define DEFAULT_REVERB_TAIL_LATENCY_BLOCKS 2
+
+/** \brief Default number of blocks of the crossfade between the reverb of the previous ABIR and the one of a new ABIR calculated in the background
+*/
+#define DEFAULT_BRIR_CROSSFADE_BLOCKS 4
+
 enum TReverberationOrder { ADIMENSIONAL, BIDIMENSIONAL, THREEDIMENSIONAL };
 
+/** \brief Type definition for the algorithm used to convolve the B-format channels with the ABIR
+*/
+enum TReverbConvolutionMethod {
+	UNIFORMLY_PARTITIONED = 0,		///<	All the partitions of the ABIR have the size of the audio buffer (CUPCEnvironmentMultichannel)
+	NON_UNIFORMLY_PARTITIONED		///<	The partitions grow along the ABIR, recommended for long BRIRs (CNUPCEnvironment)
+};
+
 namespace Binaural {
 
     class CCore;
@@ -120,7 +142,7 @@ namespace Binaural {
 		*	\param [in] channel which b-format channel was encoded
 		*	\param [in] encoderIn input buffer with the encoded channel
 		*	\param [out] output output buffer with the processed reverb
-		*   \eh Nothing is reported to the error handler.
+		*   \eh On error, an error code is reported to the error handler. It is not allowed while the asynchronous reverb tail is enabled.
 		*/
 		void ProcessEncodedChannelReverb(TBFormatChannel channel, CMonoBuffer<float> encoderIn, CMonoBuffer<float> & output);
 
@@ -138,6 +160,80 @@ namespace Binaural {
 		*/
 		TReverberationOrder GetReverberationOrder();
 
+		/** \brief Configures the algorithm used to convolve the B-format channels with the ABIR
+		*	\details With UNIFORMLY_PARTITIONED all the partitions have the size of the audio buffer, so every partition is multiplied in every block.
+		*	With NON_UNIFORMLY_PARTITIONED the first partitions have the size of the audio buffer and the next ones are increasingly longer, so the tail
+		*	of long BRIRs is convolved with fewer operations. Both of them have a latency of one buffer.
+		*	The number of silenced frames of ProcessVirtualAmbisonicReverb is only applied by the uniformly partitioned convolution.
+		*	NON_UNIFORMLY_PARTITIONED can not be set while the asynchronous reverb tail is enabled.
+		*	The reverb buffers are reset, so this method should be called when all sources have been stopped.
+		*	\param [in] method TReverbConvolutionMethod enum with the convolution algorithm
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void SetReverbConvolutionMethod(TReverbConvolutionMethod method);
+
+		/** \brief Gets the algorithm used to convolve the B-format channels with the ABIR
+		*	\retval TReverbConvolutionMethod enum with the convolution algorithm
+		*   \eh Nothing is reported to the error handler.
+		*/
+		TReverbConvolutionMethod GetReverbConvolutionMethod() const;
+
+		/** \brief Convolve only the first blocks of the ABIR (head) in the audio thread, and the rest of them (tail) in a worker thread
+		*	\details The output of the tail is calculated latencyBlocks blocks in advance, so the worker thread has that time to do it,
+		*	and the result is added to the output of the head without extra latency. If the worker thread is late, that block is played without tail.
+		*	It needs the uniformly partitioned convolution, so it can not be enabled with NON_UNIFORMLY_PARTITIONED, and it is only applied if the ABIR is longer than the head.
+		*	While it is enabled ProcessEncodedChannelReverb reports an error and does not process the channel, because the tail of all the channels is mixed in the worker thread.
+		*	The reverb buffers are reset, so this method should be called when all sources have been stopped.
+		*	\param [in] headNumberOfBlocks number of blocks of the ABIR convolved in the audio thread
+		*	\param [in] latencyBlocks number of blocks that the tail is calculated in advance, from 1 to headNumberOfBlocks
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void EnableAsynchronousReverbTail(int headNumberOfBlocks = DEFAULT_REVERB_HEAD_NUMBER_OF_BLOCKS, int latencyBlocks = DEFAULT_REVERB_TAIL_LATENCY_BLOCKS);
+
+		/** \brief Convolve all the blocks of the ABIR in the audio thread, stopping the worker thread
+		*	\details The reverb buffers are reset, so this method should be called when all sources have been stopped.
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void DisableAsynchronousReverbTail();
+
+		/** \brief Get the state of the convolution of the reverb tail in a worker thread
+		*	\retval enabled true if it has been enabled
+		*   \eh Nothing is reported to the error handler.
+		*/
+		bool IsAsynchronousReverbTailEnabled() const;
+
+		/** \brief Get the number of blocks played without reverb tail because the worker thread was late, since the ABIR was last set
+		*	\details The late blocks are not reported to the error handler from the audio thread, so this counter can be read from the control thread to choose a longer latency
+		*	\retval numberOfLateBlocks number of blocks played without tail
+		*   \eh Nothing is reported to the error handler.
+		*/
+		int GetNumberOfLateReverbTailBlocks() const;
+
+		/** \brief Calculate the ABIR of every new BRIR without modifying the one in use, so a BRIR can be loaded in a background thread while the reverb is processed
+		*	\details The BRIR setup (BeginSetup, AddBRIR and EndSetup of CBRIR) can be done in another thread. The new ABIR is taken by the audio thread at the beginning
+		*	of the next ProcessVirtualAmbisonicReverb or ProcessEncodedChannelReverb, and until then the previous one keeps on being convolved.
+		*	Only an ABIR with as many partitions as the previous one is published, when the uniformly partitioned convolution is used without the asynchronous reverb tail,
+		*	and the reverb of both ABIRs is crossfaded during crossfadeBlocks blocks. Otherwise the new ABIR replaces the one in use at once and the convolvers are prepared
+		*	again in the thread that sets up the BRIR, as with the background setup disabled, so it needs the audio processing to be stopped.
+		*	Only one thread can set up the BRIR at a time, and the other methods of this class keep on being called from the control thread as before.
+		*	It is not applied when the reverb is convolved without partitions.
+		*	\param [in] crossfadeBlocks number of blocks of the crossfade, 0 to replace the ABIR at once
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void EnableAsynchronousBRIRSetup(int crossfadeBlocks = DEFAULT_BRIR_CROSSFADE_BLOCKS);
+
+		/** \brief Calculate the ABIR of every new BRIR in the thread that sets up the BRIR, replacing the one in use as before
+		*	\details An ABIR calculated in the background that has not been taken yet is taken now, so this method should be called when all sources have been stopped.
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void DisableAsynchronousBRIRSetup();
+
+		/** \brief Get the state of the setup of the BRIR in a background thread
+		*	\retval enabled true if it has been enabled
+		*   \eh Nothing is reported to the error handler.
+		*/
+		bool IsAsynchronousBRIRSetupEnabled() const;
+
 		
 		/** \brief
 		*/
@@ -164,10 +260,26 @@ namespace Binaural {
 		bool CalculateABIRPartitionedBidimensional();
 		bool CalculateABIRPartitionedThreedimensional();
 
-		//Sets ABIR in each reverberation order configuration
-		void SetABIRAdimensional(int bufferLength, int blockLengthFreq, int numberOfBlocks);
-		void SetABIRBidimensional(int bufferLength, int blockLengthFreq, int numberOfBlocks);
-		void SetABIRThreedimensional(int bufferLength, int blockLengthFreq, int numberOfBlocks);
+		//Gets the number of b-format channels used in the current reverberation order (W; W, X and Y; W, X, Y and Z)
+		int GetNumberOfBFormatChannels() const;
+
+		//Prepares the UPC convolver of the channels used in the current reverberation order, and the spectra where they are mixed
+		void SetupUPConvolution(int bufferLength);
+
+		//Prepares the NUPC convolvers of the channels used in the current reverberation order, with the partitions of the ABIR
+		void SetupNUPConvolution(int bufferLength);
+
+		//Convolves only one b-format channel with the ABIR of both ears using the UPC convolver
+		void ProcessUPConvolution(TBFormatChannel channel, const CMonoBuffer<float> & encoderIn, CMonoBuffer<float> & outBufferLeft, CMonoBuffer<float> & outBufferRight);
+
+		//Convolves all the b-format channels of the current reverberation order with the ABIR of both ears using the UPC convolver, with their FFTs done at once, mixing them in the reverb spectra
+		void ProcessUPConvolution(std::initializer_list<const CMonoBuffer<float>*> bFormatChannels, int numberOfSilencedFrames = 0);
+
+		//Goes back to the time domain with the spectra where the UPC convolver has mixed the b-format channels, one IFFT per ear, both of them done at once
+		void ProcessUPConvolutionIFFT(CMonoBuffer<float> & outBufferLeft, CMonoBuffer<float> & outBufferRight);
+
+		//Convolves one b-format channel with the ABIR of both ears using the NUPC convolvers, adding the result to the output buffers
+		void ProcessNUPConvolution(TBFormatChannel channel, const CMonoBuffer<float> & encoderIn, CMonoBuffer<float> & outBufferLeft, CMonoBuffer<float> & outBufferRight);
 
 		// Set ABIR of environment. Create AIR class using ambisonic codification. Also, initialize convolution buffers
 		bool SetABIR();
@@ -177,30 +289,55 @@ namespace Binaural {
 		void ProcessDirectionality(CMonoBuffer<float> &buffer, float directionalityAttenutaion);
 		// Reset BRIR
 		void ResetBRIR_ABIR();
+		// Replace the ABIR in use with a new one and prepare the convolvers, or publish it to the audio thread if the BRIR is set up in the background and it fits in the convolvers in use
+		void ReplaceABIR(std::shared_ptr<const CABIR> newABIR);
+		// Check if an ABIR can be convolved with the convolvers prepared for another one, so the reverb of both can be crossfaded
+		bool FitsInConvolvers(const CABIR & currentABIR, const CABIR & newABIR) const;
+		// Take the ABIR published by the background setup, if there is a new one. Called from the audio thread
+		void ApplyPublishedABIR();
 
 		// ATTRIBUTES
 
 		CCore* ownerCore;									//Owner Core
-		CABIR	environmentABIR;							// ABIR of environment		
+		std::shared_ptr<const CABIR> environmentABIR;		// ABIR of environment, never null, not modified once it is in use
+		std::shared_ptr<CABIR> ABIRInSetup;					// ABIR being calculated from the BRIR, not used by the audio thread until it is complete
+		std::shared_ptr<const CABIR> previousABIR;			// ABIR replaced by the current one, convolved until the crossfade between them finishes
+		std::shared_ptr<const CABIR> lastABIR;				// Last ABIR used or published, only read by the thread that sets up the BRIR
 		std::unique_ptr<CBRIR> environmentBRIR;				// BRIR of the environment
 #ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_REVERB 
         Common::CFprocessor outputLeft;						//Ambisonic Reverb Convolutions
 		Common::CFprocessor outputRight;					//Ambisonic Reverb Convolutions
 #else		
-		Common::CUPCEnvironment wLeft_UPConvolution;		//Buffers to perform Uniformly Partitioned Convolution
-		Common::CUPCEnvironment xLeft_UPConvolution;		//Buffers to perform Uniformly Partitioned Convolution
-		Common::CUPCEnvironment yLeft_UPConvolution;		//Buffers to perform Uniformly Partitioned Convolution
-		Common::CUPCEnvironment zLeft_UPConvolution;		//Buffers to perform Uniformly Partitioned Convolution
-		Common::CUPCEnvironment wRight_UPConvolution;		//Buffers to perform Uniformly Partitioned Convolution
-		Common::CUPCEnvironment xRight_UPConvolution;		//Buffers to perform Uniformly Partitioned Convolution
-		Common::CUPCEnvironment yRight_UPConvolution;		//Buffers to perform Uniformly Partitioned Convolution
-		Common::CUPCEnvironment zRight_UPConvolution;		//Buffers to perform Uniformly Partitioned Convolution
+		Common::CUPCEnvironmentMultichannel bFormatUPConvolution;		//Uniformly Partitioned Convolution of all the b-format channels, with one FFT per channel shared by both ears
+		std::vector<float> reverbLeft_Frequency;						//Half spectrum where the UPC of all the b-format channels is mixed, left ear
+		std::vector<float> reverbRight_Frequency;						//Half spectrum where the UPC of all the b-format channels is mixed, right ear
+		Common::CFFTPlan reverbFFTPlan;									//FFT tables of 2*B points, to do the IFFT of the mixed spectra
+		std::vector<float> reverbIFFT_buffer;							//IFFTs of the mixed spectra, 2*B samples of the left ear followed by 2*B samples of the right ear
+		std::vector<const float*> reverbIFFT_input;						//Mixed spectra of both ears, transformed at once
+		std::vector<float*> reverbIFFT_output;							//Halves of reverbIFFT_buffer where the IFFT of each ear is written
+		std::vector<const CMonoBuffer<float>*> reverbInputs;			//B-format channels convolved at once in the current block
+		std::vector<const TImpulseResponse_Partitioned*> reverbLeftIRs;		//ABIR of each b-format channel convolved in the current block, left ear
+		std::vector<const TImpulseResponse_Partitioned*> reverbRightIRs;	//ABIR of each b-format channel convolved in the current block, right ear
+		std::vector<Common::CNUPCEnvironment> bFormatNUPConvolution;	//Non-Uniformly Partitioned Convolution of each b-format channel, with the ABIR of both ears
+		Common::CUPCEnvironmentAsyncTail reverbTailConvolution;			//Convolution of the tail of the ABIR of all the b-format channels in a worker thread
+		std::vector<float> previousReverbLeft_Frequency;				//Half spectrum where the UPC with the previous ABIR is mixed during the crossfade, left ear
+		std::vector<float> previousReverbRight_Frequency;				//Half spectrum where the UPC with the previous ABIR is mixed during the crossfade, right ear
+		std::vector<const TImpulseResponse_Partitioned*> previousReverbLeftIRs;		//Previous ABIR of each b-format channel convolved during the crossfade, left ear
+		std::vector<const TImpulseResponse_Partitioned*> previousReverbRightIRs;	//Previous ABIR of each b-format channel convolved during the crossfade, right ear
 
 #endif
 		int HADirectionality_LeftChannel_version;			//HA Directionality left version
 		int HADirectionality_RightChannel_version;			//HA Directionality right version
                 
         TReverberationOrder reverberationOrder = TReverberationOrder::BIDIMENSIONAL;
+		TReverbConvolutionMethod reverbConvolutionMethod = TReverbConvolutionMethod::UNIFORMLY_PARTITIONED;
+		bool enableAsynchronousReverbTail = false;						//The tail of the ABIR is convolved in a worker thread
+		int reverbHeadNumberOfBlocks = DEFAULT_REVERB_HEAD_NUMBER_OF_BLOCKS;	//Number of blocks of the ABIR convolved in the audio thread
+		int reverbTailLatencyBlocks = DEFAULT_REVERB_TAIL_LATENCY_BLOCKS;		//Number of blocks that the tail is calculated in advance
+		bool enableAsynchronousBRIRSetup = false;						//The ABIR of a new BRIR is published to the audio thread instead of replacing the one in use
+		int BRIRCrossfadeBlocks = DEFAULT_BRIR_CROSSFADE_BLOCKS;		//Number of blocks of the crossfade between the previous ABIR and the new one
+		int BRIRCrossfadeBlocksLeft = 0;								//Blocks left of the current crossfade
+		Common::CAsyncPublisher<CABIR> ABIRPublisher;					//Hands the ABIRs calculated in the background over to the audio thread
 
 		//int numberOfSilencedFrames = 0;
 		
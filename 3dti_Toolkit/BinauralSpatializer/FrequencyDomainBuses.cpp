@@ -0,0 +1,223 @@
+/**
+* \class CFrequencyDomainBuses
+*
+* \brief Mix of the HRTF convolutions of several sources in the frequency domain, with one bus for each ear and delay
+*
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#include <BinauralSpatializer/FrequencyDomainBuses.h>
+#include <Common/ErrorHandler.h>
+#include <algorithm>
+
+namespace Binaural {
+	/////////////////////////////
+	// CONSTRUCTOR/DESTRUCTOR  //
+	/////////////////////////////
+	CFrequencyDomainBuses::CFrequencyDomainBuses() : bufferSize{ 0 }, setupDone{ false }, numberOfBuses{ 0 }, numberOfReservedFFTs{ 0 }
+	{
+	}
+
+	///////////////////
+	// Public Methods //
+	///////////////////
+
+	//Initialize the buses, removing all the spectra and the delayed samples
+	void CFrequencyDomainBuses::Setup(int _bufferSize)
+	{
+		bufferSize = _bufferSize;
+		FFTPlan.Setup(2 * bufferSize);
+		delayedSamples_Time.assign(2 * bufferSize, 0.0f);
+
+		//The buses are allocated when they are used for the first time, because only a few delays are used at the same time
+		leftBuses.clear();
+		rightBuses.clear();
+		numberOfBuses = 0;
+		IFFT_buffer.clear();
+		IFFT_input.clear();
+		IFFT_output.clear();
+		FFT_input.clear();
+		FFT_output.clear();
+		numberOfReservedFFTs = 0;
+
+		setupDone = true;
+	}
+
+	//Prepare the batched input FFTs for a number of sources
+	void CFrequencyDomainBuses::ReserveInputFFTs(int numberOfSources)
+	{
+		if (!setupDone || numberOfSources <= numberOfReservedFFTs) { return; }
+		numberOfReservedFFTs = numberOfSources;
+		FFT_input.reserve(numberOfReservedFFTs);
+		FFT_output.reserve(numberOfReservedFFTs);
+		FFTPlan.SetupBatch(numberOfReservedFFTs);
+	}
+
+	//Check whether the buses can mix spectra of this size
+	bool CFrequencyDomainBuses::IsReady(int spectrumSize) const
+	{
+		return setupDone && (bufferSize > 0) && (spectrumSize == 2 * bufferSize + 2);
+	}
+
+	//Add the half spectrum of the output of one convolution, multiplied by a gain, to the bus of one ear and delay
+	void CFrequencyDomainBuses::AddSpectrum(Common::T_ear ear, int delay, const std::vector<float> & spectrum, float gain)
+	{
+		ASSERT(IsReady((int)spectrum.size()), RESULT_ERROR_BADSIZE, "The size of the spectrum does not match the size of the buses", "");
+		ASSERT(delay >= 0 && delay < bufferSize, RESULT_ERROR_OUTOFRANGE, "The delay of a frequency-domain bus has to be less than the buffer size", "");
+
+		if (IsReady((int)spectrum.size()) && delay >= 0 && delay < bufferSize)	//Just in case error handler is off
+		{
+			TDelayedBus & bus = GetBus(ear, delay);
+			for (size_t j = 0; j < spectrum.size(); j++) {
+				bus.spectrum[j] += gain * spectrum[j];
+			}
+			bus.mixed = true;
+		}
+	}
+
+	//Add some samples, multiplied by a gain, to the delayed samples of the bus of one ear and delay
+	void CFrequencyDomainBuses::AddDelayedSamples(Common::T_ear ear, int delay, const CMonoBuffer<float> & samples, float gain)
+	{
+		ASSERT(setupDone && delay >= 0 && delay < bufferSize && samples.size() == (size_t)delay, RESULT_ERROR_BADSIZE, "The number of delayed samples has to be the delay of the bus", "");
+
+		if (delay == 0) { return; }
+		if (setupDone && delay > 0 && delay < bufferSize && samples.size() == (size_t)delay)	//Just in case error handler is off
+		{
+			TDelayedBus & bus = GetBus(ear, delay);
+			for (int i = 0; i < delay; i++) {
+				bus.delayedSamples[i] += gain * samples[i];
+			}
+			bus.delayedSamplesPending = true;
+		}
+	}
+
+	//Add the input of one convolution to the FFTs calculated by the next call to ProcessInputFFTs
+	void CFrequencyDomainBuses::AddInputFFT(const float* input_Time, float* output_Frequency)
+	{
+		ASSERT(setupDone && input_Time != nullptr && output_Frequency != nullptr, RESULT_ERROR_NULLPOINTER, "The input FFT of a convolution mixed in the frequency-domain buses needs an input and an output", "");
+		if (setupDone && input_Time != nullptr && output_Frequency != nullptr)	//Just in case error handler is off
+		{
+			FFT_input.push_back(input_Time);
+			FFT_output.push_back(output_Frequency);
+		}
+	}
+
+	//Calculate the FFTs of all the inputs added in this block at once
+	void CFrequencyDomainBuses::ProcessInputFFTs()
+	{
+		if (FFT_input.empty()) { return; }
+		FFTPlan.CalculateFFT_HalfSpectrum(FFT_input, 2 * bufferSize, FFT_output);
+		FFT_input.clear();
+		FFT_output.clear();
+	}
+
+	//Calculate the last samples of the output of one convolution, the ones that are delayed to the next block
+	void CFrequencyDomainBuses::CalculateDelayedSamples(const std::vector<float> & spectrum, int delay, CMonoBuffer<float> & delayedSamples)
+	{
+		ASSERT(IsReady((int)spectrum.size()), RESULT_ERROR_BADSIZE, "The size of the spectrum does not match the size of the buses", "");
+
+		delayedSamples.assign(std::max(delay, 0), 0.0f);
+		if (delay > 0 && delay < bufferSize && IsReady((int)spectrum.size()))	//Just in case error handler is off
+		{
+			//Only the last B samples of the IFFT are significant, and the delayed ones are the last of them
+			FFTPlan.CalculateIFFT_HalfSpectrum(spectrum.data(), delayedSamples_Time.data());
+			std::copy(delayedSamples_Time.end() - delay, delayedSamples_Time.end(), delayedSamples.begin());
+		}
+	}
+
+	//Do the IFFT of the buses mixed in this block and add their delayed output to the output buffers
+	void CFrequencyDomainBuses::ProcessOutput(CMonoBuffer<float> & outLeftBuffer, CMonoBuffer<float> & outRightBuffer)
+	{
+		if (!setupDone || numberOfBuses == 0) { return; }
+		ASSERT(outLeftBuffer.size() == (size_t)bufferSize && outRightBuffer.size() == (size_t)bufferSize, RESULT_ERROR_BADSIZE, "Bad output size, don't match with the size of the buses", "");
+		if (outLeftBuffer.size() != (size_t)bufferSize || outRightBuffer.size() != (size_t)bufferSize) { return; }	//Just in case error handler is off
+
+		//Only one IFFT for each bus in which some source has been mixed, all of them done at once
+		IFFT_input.clear();
+		IFFT_output.clear();
+		for (std::vector<TDelayedBus> * buses : { &leftBuses, &rightBuses }) {
+			for (TDelayedBus & bus : *buses) {
+				if (bus.mixed) {
+					IFFT_output.push_back(IFFT_buffer.data() + IFFT_input.size() * 2 * bufferSize);
+					IFFT_input.push_back(bus.spectrum.data());
+				}
+			}
+		}
+		if (!IFFT_input.empty()) { FFTPlan.CalculateIFFT_HalfSpectrum(IFFT_input, IFFT_output); }
+
+		//In the same order in which they have been transformed
+		float* nextIFFT = IFFT_buffer.data();
+		ProcessDelayedOutput(leftBuses, nextIFFT, outLeftBuffer);
+		ProcessDelayedOutput(rightBuses, nextIFFT, outRightBuffer);
+	}
+
+	/////////////////////
+	// Private Methods //
+	/////////////////////
+
+	//Get the bus of one ear and delay, allocating it the first time it is used
+	CFrequencyDomainBuses::TDelayedBus & CFrequencyDomainBuses::GetBus(Common::T_ear ear, int delay)
+	{
+		std::vector<TDelayedBus> & buses = (ear == Common::T_ear::LEFT) ? leftBuses : rightBuses;
+		if ((size_t)delay >= buses.size()) { buses.resize(delay + 1); }
+
+		TDelayedBus & bus = buses[delay];
+		if (bus.spectrum.empty())
+		{
+			bus.spectrum.assign(2 * bufferSize + 2, 0.0f);
+			bus.delayedSamples.assign(delay, 0.0f);
+
+			//Room for the IFFTs of all the buses, so nothing is allocated while they are used
+			numberOfBuses++;
+			IFFT_buffer.resize(numberOfBuses * 2 * bufferSize);
+			IFFT_input.reserve(numberOfBuses);
+			IFFT_output.reserve(numberOfBuses);
+			FFTPlan.SetupBatch(numberOfBuses);
+		}
+		return bus;
+	}
+
+	//Add the delayed output of the buses of one ear, with their IFFTs starting at nextIFFT
+	void CFrequencyDomainBuses::ProcessDelayedOutput(std::vector<TDelayedBus> & buses, float* & nextIFFT, CMonoBuffer<float> & outBuffer)
+	{
+		for (int delay = 0; delay < (int)buses.size(); delay++)
+		{
+			TDelayedBus & bus = buses[delay];
+
+			//Samples of the previous block
+			if (bus.delayedSamplesPending)
+			{
+				for (int i = 0; i < delay; i++) { outBuffer[i] += bus.delayedSamples[i]; }
+				std::fill(bus.delayedSamples.begin(), bus.delayedSamples.end(), 0.0f);
+				bus.delayedSamplesPending = false;
+			}
+
+			//Samples of this block. As in the UPC convolution, only the last B samples of the IFFT are significant
+			if (bus.mixed)
+			{
+				const float* bus_Time = nextIFFT + bufferSize;
+				for (int i = delay; i < bufferSize; i++) { outBuffer[i] += bus_Time[i - delay]; }
+				std::copy(bus_Time + bufferSize - delay, bus_Time + bufferSize, bus.delayedSamples.begin());
+				bus.delayedSamplesPending = (delay > 0);
+
+				std::fill(bus.spectrum.begin(), bus.spectrum.end(), 0.0f);
+				bus.mixed = false;
+				nextIFFT += 2 * bufferSize;
+			}
+		}
+	}
+}
@@ -0,0 +1,146 @@
+/**
+* \class FrequencyDomainBuses
+*
+* \brief Declaration of CFrequencyDomainBuses class interface.
+* \date	October 2026
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#ifndef _CFREQUENCYDOMAINBUSES_H_
+#define _CFREQUENCYDOMAINBUSES_H_
+
+#include <vector>
+#include <Common/Buffer.h>
+#include <Common/CommonDefinitions.h>
+#include <Common/FFTPlan.h>
+
+namespace Binaural {
+
+	/** \details This class mixes the HRTF convolutions of several sources in the frequency domain, so only one IFFT is done for all the sources that have the same delay in one ear.
+	*	There is one bus for each ear and delay. The spectra added to a bus are transformed at once and then delayed, so the delay of the ITD is applied after the IFFT, as in the processing of each source.
+	*	Each bus keeps the last samples of its output, the ones that will be output at the beginning of the next block, in its own delay line.
+	*	CSingleSourceDSP only mixes a source in the buses in the blocks in which its delays and its gains do not change, and it takes back or gives its delayed samples when it leaves or joins them,
+	*	so the output is the same as the one of its own processing chain (see CCore::ProcessAnechoic).
+	*	The input FFTs of the sources mixed in the buses are also calculated by this class, all of them at once, before the sources multiply them by their HRIRs.
+	*/
+	class CFrequencyDomainBuses
+	{
+	public:
+
+		/** \brief Default constructor
+		*   \eh Nothing is reported to the error handler.
+		*/
+		CFrequencyDomainBuses();
+
+		/** \brief Initialize the buses, removing all the spectra and the delayed samples
+		*	\param [in] _bufferSize size of the audio blocks (B size). The spectra mixed in the buses have 2*B + 2 values
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void Setup(int _bufferSize);
+
+		/** \brief Prepare the batched input FFTs for a number of sources, so they do not allocate memory while the sources are processed
+		*	\param [in] numberOfSources number of sources that can add their input FFT in the same block
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void ReserveInputFFTs(int numberOfSources);
+
+		/** \brief Check whether the buses can mix the output of a convolution
+		*	\param [in] spectrumSize size of the half spectra of the convolution
+		*	\retval ready true if the buses have been set up for spectra of that size
+		*   \eh Nothing is reported to the error handler.
+		*/
+		bool IsReady(int spectrumSize) const;
+
+		/** \brief Add the half spectrum of the output of one convolution, multiplied by a gain, to the bus of one ear and delay
+		*	\param [in] ear ear of the bus
+		*	\param [in] delay delay in samples of the output. It has to be less than the buffer size
+		*	\param [in] spectrum half spectrum of 2*B + 2 values. After the IFFT only the last B samples are significant
+		*	\param [in] gain gain applied to the spectrum
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void AddSpectrum(Common::T_ear ear, int delay, const std::vector<float> & spectrum, float gain);
+
+		/** \brief Add some samples, multiplied by a gain, to the delayed samples of the bus of one ear and delay, the ones that are output at the beginning of the next block
+		*	\param [in] ear ear of the bus
+		*	\param [in] delay delay in samples of the bus. It has to be less than the buffer size
+		*	\param [in] samples delay samples
+		*	\param [in] gain gain applied to the samples. It is -1 to remove samples that were added before
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void AddDelayedSamples(Common::T_ear ear, int delay, const CMonoBuffer<float> & samples, float gain);
+
+		/** \brief Calculate the last samples of the output of one convolution, the ones that are delayed to the next block
+		*	\param [in] spectrum half spectrum of 2*B + 2 values of the output of the convolution
+		*	\param [in] delay number of samples
+		*	\param [out] delayedSamples last delay samples of the IFFT of the spectrum
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void CalculateDelayedSamples(const std::vector<float> & spectrum, int delay, CMonoBuffer<float> & delayedSamples);
+
+		/** \brief Add the input of one convolution to the FFTs calculated by the next call to ProcessInputFFTs
+		*	\param [in] input_Time 2*B samples of the input, which are not modified until the FFT is done
+		*	\param [out] output_Frequency buffer of 2*B + 2 values where the half spectrum of the FFT is written
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void AddInputFFT(const float* input_Time, float* output_Frequency);
+
+		/** \brief Calculate the FFTs of all the inputs added in this block at once
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void ProcessInputFFTs();
+
+		/** \brief Do the IFFT of the buses in which some spectrum has been added in this block and add their delayed output to the output buffers
+		*   \details The IFFTs of all the buses are done at once. The spectra are cleared for the next block.
+		*	\param [in,out] outLeftBuffer left ear buffer of B size where the output is added
+		*	\param [in,out] outRightBuffer right ear buffer of B size where the output is added
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void ProcessOutput(CMonoBuffer<float> & outLeftBuffer, CMonoBuffer<float> & outRightBuffer);
+
+	private:
+		// TYPES
+		struct TDelayedBus {
+			std::vector<float> spectrum;		//Half spectrum where the outputs of the convolutions are mixed
+			std::vector<float> delayedSamples;	//Last samples of the output of the previous block, output at the beginning of the next one
+			bool mixed = false;					//It's true when some spectrum has been added in the current block
+			bool delayedSamplesPending = false;	//It's true when the delayed samples have to be output
+		};
+
+		// METHODS
+		//Get the bus of one ear and delay, allocating it the first time it is used
+		TDelayedBus & GetBus(Common::T_ear ear, int delay);
+
+		//Add the delayed output of the buses of one ear, with their IFFTs starting at nextIFFT
+		void ProcessDelayedOutput(std::vector<TDelayedBus> & buses, float* & nextIFFT, CMonoBuffer<float> & outBuffer);
+
+		// ATTRIBUTES
+		int bufferSize;								//Size of the audio blocks (B)
+		bool setupDone;								//It's true when setup has been called at least once
+		std::vector<TDelayedBus> leftBuses;			//Buses of the left ear, one for each delay
+		std::vector<TDelayedBus> rightBuses;		//Buses of the right ear, one for each delay
+		int numberOfBuses;							//Number of buses that have been allocated, of both ears
+		Common::CFFTPlan FFTPlan;					//FFT tables of 2*B points
+		std::vector<float> IFFT_buffer;				//IFFTs of the buses mixed in the current block, 2*B samples each
+		std::vector<const float*> IFFT_input;		//Spectra of the buses transformed at once
+		std::vector<float*> IFFT_output;			//Parts of IFFT_buffer where the IFFT of each bus is written
+		std::vector<float> delayedSamples_Time;		//IFFT of the output of one convolution, to get its delayed samples
+		std::vector<const float*> FFT_input;		//Inputs of the convolutions whose FFTs are calculated at once in the current block
+		std::vector<float*> FFT_output;				//Slots where the FFT of each input is written
+		int numberOfReservedFFTs;					//Number of inputs that can be transformed at once without allocating memory
+	};
+}
+#endif
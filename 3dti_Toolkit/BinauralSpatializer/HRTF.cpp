@@ -22,38 +22,58 @@
 
 #include <cmath>
 #include <BinauralSpatializer/HRTF.h>
+#include <BinauralSpatializer/HRTFAsset.h>
+#include <BinauralSpatializer/HybridAnechoicStereo.h>
 #include <iostream>
 #include <cfloat>
 #include <fstream>
 #include <ctime>
 #include <list>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <system_error>
+#include <algorithm>
 
 namespace Binaural
 {
+	//CONSTRUCTORS ///////////////////////////////////////////////////////////////////////////////////////
+
+	CHRTF::CHRTF(CListener* _ownerListener)
+		:ownerListener{ _ownerListener }, sphereBorder{ 360.0f }, setupInProgress{ false }, HRTFLoaded{ false }, resamplingThreads{ DEFAULT_RESAMPLING_THREADS }, enableCustomizedITD{ false }, asset{ std::make_shared<CHRTFAsset>() },
+		lastAsset{ asset }, layoutHRIRLength{ 0 }, layoutNumberOfSubfilters{ 0 }, layoutSubfilterLength{ 0 }, layoutHybridPartitionsPerSegment{ 0 }, enableAsynchronousSetup{ false }, HRTFCrossfadeBlocks{ DEFAULT_HRTF_CROSSFADE_BLOCKS }, HRTFVersion{ 0 }
+	{}
+
+	CHRTF::CHRTF()
+		:ownerListener{ nullptr }, sphereBorder{ 360.0f }, setupInProgress{ false }, HRTFLoaded{ false }, resamplingThreads{ DEFAULT_RESAMPLING_THREADS }, enableCustomizedITD{ false }, asset{ std::make_shared<CHRTFAsset>() },
+		lastAsset{ asset }, layoutHRIRLength{ 0 }, layoutNumberOfSubfilters{ 0 }, layoutSubfilterLength{ 0 }, layoutHybridPartitionsPerSegment{ 0 }, enableAsynchronousSetup{ false }, HRTFCrossfadeBlocks{ DEFAULT_HRTF_CROSSFADE_BLOCKS }, HRTFVersion{ 0 }
+	{}
+
 	//PUBLIC METHODS ///////////////////////////////////////////////////////////////////////////////////////
 	
+	int32_t CHRTF::GetHRIRLength() const
+	{
+		return layoutHRIRLength;
+	}
+
 	void CHRTF::BeginSetup(int32_t _HRIRLength, float _distance)
 	{
 		if ((ownerListener != nullptr) && ownerListener->ownerCore!=nullptr)
 		{						
+			//New tables, the ones of the previous HRTF are still used until EndSetup and they may be in use by other listeners
+			assetInSetup = std::make_shared<CHRTFAsset>();
+
 			//Update parameters			
-			HRIRLength = _HRIRLength;
-			distanceOfMeasurement = _distance;
-			bufferSize = ownerListener->GetCoreAudioState().bufferSize;						
-			resamplingStep = ownerListener->GetHRTFResamplingStep();
-			float partitions = (float)HRIRLength / (float)bufferSize;
-			HRIR_partitioned_NumberOfSubfilters = static_cast<int>(std::ceil(partitions));
-
-			//Clear every table			
-			t_HRTF_DataBase.clear();
-			t_HRTF_Resampled_frequency.clear();
-			t_HRTF_Resampled_partitioned.clear();
+			assetInSetup->HRIRLength = _HRIRLength;
+			assetInSetup->distanceOfMeasurement = _distance;
+			assetInSetup->bufferSize = ownerListener->GetCoreAudioState().bufferSize;						
+			assetInSetup->resamplingStep = ownerListener->GetHRTFResamplingStep();
+			resamplingThreads = ownerListener->GetHRTFResamplingThreads();
+			CalculatePartitionLayout();
 
 			//Change class state
 			setupInProgress = true;
-			HRTFLoaded = false;
-
-			sphereBorder = 360.0f;
 
 			SET_RESULT(RESULT_OK, "HRTF Setup started");
 		}
@@ -69,7 +89,7 @@ namespace Binaural
 			int iAzimuth = static_cast<int> (round(azimuth));
 			int iElevation = static_cast<int> (round(elevation));
 
-			auto returnValue = t_HRTF_DataBase.emplace(orientation(iAzimuth, iElevation), std::forward<THRIRStruct>(newHRIR));
+			auto returnValue = assetInSetup->t_HRTF_DataBase.emplace(orientation(iAzimuth, iElevation), std::forward<THRIRStruct>(newHRIR));
 			//Error handler
 			if (returnValue.second) { /*SET_RESULT(RESULT_OK, "HRIR emplaced into t_HRTF_DataBase succesfully"); */ }
 			else { SET_RESULT(RESULT_WARNING, "Error emplacing HRIR in t_HRTF_DataBase map"); }
@@ -79,37 +99,30 @@ namespace Binaural
 	void CHRTF::AddHRTFTable( T_HRTFTable && newTable)
 	{
 		if (setupInProgress) {
-			t_HRTF_DataBase = newTable;
+			assetInSetup->t_HRTF_DataBase = std::move(newTable);
 		}
 	}
 
 	void CHRTF::EndSetup()
 	{
-		if (setupInProgress) {
-			if (!t_HRTF_DataBase.empty())
-			{
-				//Delete the common delay of every HRIR functions of the DataBase Table
-				RemoveCommonDelay_HRTFDataBaseTable();
-
-				//HRTF Resampling methdos
-				CalculateHRIR_InPoles();	//Specific method for LISTEN DataBase
-
-				CalculateResampled_HRTFTable(resamplingStep);
+		FinishSetup(false);
+	}
 
-				//Setup values
-#ifndef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC
-				auto it = t_HRTF_Resampled_partitioned.begin();
-				HRIR_partitioned_SubfilterLength = it->second.leftHRIR_Partitioned[0].size();
-#endif // !USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC
+	void CHRTF::EndSetupFromProcessedDatabase()
+	{
+		FinishSetup(true);
+	}
 
+	void CHRTF::FinishSetup(bool processedDatabase)
+	{
+		if (setupInProgress) {
+			if (!assetInSetup->t_HRTF_DataBase.empty())
+			{
+				CalculateAssetInSetup(processedDatabase);
 				setupInProgress = false;
-				HRTFLoaded = true;
 
-				if (ownerListener != nullptr)
-				{
-					ownerListener->SetHRTFLoaded();		//Report to the listener that the HRTF has been a loaded.
-				}
-				SET_RESULT(RESULT_OK, "HRTF Matrix resample completed succesfully");
+				//The tables are not modified any more, so they can be shared
+				if (ReplaceAsset(std::move(assetInSetup))) { SET_RESULT(RESULT_OK, "HRTF Matrix resample completed succesfully"); }
 			}
 			else
 			{
@@ -120,25 +133,20 @@ namespace Binaural
 	}
 	
 	void CHRTF::CalculateNewHRTFTable() {
-		if (!t_HRTF_DataBase.empty())
-		{
-			//BeginSetup
-			//Update parameters					
-			bufferSize = ownerListener->GetCoreAudioState().bufferSize;
-			resamplingStep = ownerListener->GetHRTFResamplingStep();			
-			float partitions = (float)HRIRLength / (float)bufferSize;
-			HRIR_partitioned_NumberOfSubfilters = static_cast<int>(std::ceil(partitions));
-
-			//Clear every table		
-			t_HRTF_Resampled_frequency.clear();
-			t_HRTF_Resampled_partitioned.clear();
-
-			//Change class state
-			setupInProgress = true;
-			HRTFLoaded = false;
+		//The configuration of the core is changed with the audio processing stopped, so an HRTF published and not adopted yet is the last one loaded
+		std::shared_ptr<const CHRTFAsset> publishedAsset;
+		if (assetPublisher.TakePublished(publishedAsset)) { asset = std::move(publishedAsset); }
 
-			//Calculate Tables
-			EndSetup();
+		if (!asset->t_HRTF_DataBase.empty())
+		{
+			//New tables from the same database, the current ones may be in use by other listeners
+			BeginSetupFromAsset(*asset);
+
+			//Calculate Tables, used at once because the convolution buffers are set up for the new configuration. The database of an asset has already been processed
+			CalculateAssetInSetup(true);
+			setupInProgress = false;
+			SetAssetInUse(std::move(assetInSetup));
+			SET_RESULT(RESULT_OK, "HRTF Matrix resample completed succesfully");
 		}
 	}
 
@@ -148,23 +156,182 @@ namespace Binaural
 		setupInProgress = false;
 		HRTFLoaded = false;
 
-		//Clear every table			
-		t_HRTF_DataBase.clear();
-		t_HRTF_Resampled_frequency.clear();
-		t_HRTF_Resampled_partitioned.clear();
+		//Release the tables, they are freed if no other listener uses them
+		assetInSetup.reset();
+		previousAsset.reset();
+		asset = std::make_shared<CHRTFAsset>();
+		lastAsset = asset;
+		SetLayoutInUse(*asset);
+		HRTFVersion++;
+		assetPublisher.Clear();
+		if (enableAsynchronousSetup) { assetPublisher.Retain(asset); }
+	}
+
+	void CHRTF::BeginSetupFromAsset(const CHRTFAsset & databaseAsset)
+	{
+		assetInSetup = std::make_shared<CHRTFAsset>();
+		assetInSetup->t_HRTF_DataBase = databaseAsset.t_HRTF_DataBase;
+		assetInSetup->HRIRLength = databaseAsset.HRIRLength;
+		assetInSetup->distanceOfMeasurement = databaseAsset.distanceOfMeasurement;
+
+		//Update parameters					
+		assetInSetup->bufferSize = ownerListener->GetCoreAudioState().bufferSize;
+		assetInSetup->resamplingStep = ownerListener->GetHRTFResamplingStep();
+		resamplingThreads = ownerListener->GetHRTFResamplingThreads();
+		CalculatePartitionLayout();
+
+		//Change class state
+		setupInProgress = true;
+	}
+
+	void CHRTF::CalculateAssetInSetup(bool processedDatabase)
+	{
+		if (!processedDatabase)
+		{
+			//Delete the common delay of every HRIR functions of the DataBase Table
+			RemoveCommonDelay_HRTFDataBaseTable();
+
+			//HRTF Resampling methdos
+			CalculateHRIR_InPoles();	//Specific method for LISTEN DataBase
+		}
+
+		CalculateResampled_HRTFTable(assetInSetup->resamplingStep);
 
-		//Update parameters			
-		HRIRLength = 0;
-		bufferSize = 0;
-		resamplingStep = 0;
+		//Setup values
+#ifndef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC
+		assetInSetup->HRIR_partitioned_SubfilterLength = assetInSetup->t_HRTF_Resampled_partitioned.GetSubfilterLength(0);
+#endif // !USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC
+	}
+
+	void CHRTF::SetAssetInUse(std::shared_ptr<const CHRTFAsset> newAsset)
+	{
+		previousAsset.reset();
+		asset = std::move(newAsset);
+		lastAsset = asset;
+		SetLayoutInUse(*asset);
+		if (enableAsynchronousSetup) { assetPublisher.Retain(asset); }		//The audio thread may release it when it adopts the next one
+		HRTFVersion++;
+		HRTFLoaded = true;
+
+		if (ownerListener != nullptr)
+		{
+			ownerListener->SetHRTFLoaded();		//Report to the listener that the HRTF has been a loaded.
+		}
+	}
+
+	void CHRTF::SetLayoutInUse(const CHRTFAsset & _asset)
+	{
+		layoutHRIRLength = _asset.HRIRLength;
+		layoutNumberOfSubfilters = _asset.HRIR_partitioned_NumberOfSubfilters;
+		layoutSubfilterLength = _asset.HRIR_partitioned_SubfilterLength;
+		layoutHybridPartitionsPerSegment = _asset.hybridPartitionsPerSegment;
+	}
+
+	bool CHRTF::ReplaceAsset(std::shared_ptr<const CHRTFAsset> newAsset)
+	{
+		if (!enableAsynchronousSetup || lastAsset->IsEmpty())
+		{
+			//The first HRTF is used at once, as any HRTF with the asynchronous setup disabled
+			SetAssetInUse(std::move(newAsset));
+			return true;
+		}
+
+		//Only an HRTF with the same subfilters as the last one can be adopted by the audio thread, since the convolution buffers are not set up again there.
+		//Another one would be set in use from this thread while the audio thread reads the current one, so the current one is kept
+		if (!HaveSamePartitionLayout(*lastAsset, *newAsset))
+		{
+			SET_RESULT(RESULT_ERROR_NOTALLOWED, "An HRTF with another HRIR length or partition layout can not replace the one in use while the asynchronous HRTF setup is enabled");
+			return false;
+		}
+
+		//The audio thread adopts it at the beginning of its next block, meanwhile it goes on with the HRTF in use
+		lastAsset = newAsset;
+		assetPublisher.Publish(std::move(newAsset));
+		return true;
+	}
+
+	bool CHRTF::HaveSamePartitionLayout(const CHRTFAsset & asset1, const CHRTFAsset & asset2) const
+	{
+		return !asset1.IsEmpty() && !asset2.IsEmpty() && (asset1.HRIRLength == asset2.HRIRLength) && (asset1.bufferSize == asset2.bufferSize) &&
+			(asset1.HRIR_partitioned_NumberOfSubfilters == asset2.HRIR_partitioned_NumberOfSubfilters) && (asset1.HRIR_partitioned_SubfilterLength == asset2.HRIR_partitioned_SubfilterLength) &&
+			(asset1.hybridPartitionsPerSegment == asset2.hybridPartitionsPerSegment) && (asset1.t_HRTF_Resampled_partitioned.GetHRIRLength() == asset2.t_HRTF_Resampled_partitioned.GetHRIRLength());
+	}
+
+	void CHRTF::EnableAsynchronousHRTFSetup(int crossfadeBlocks)
+	{
+		ASSERT(crossfadeBlocks >= 0, RESULT_ERROR_OUTOFRANGE, "The number of blocks of the HRTF crossfade can not be negative", "");
+		if (crossfadeBlocks < 0) { return; }	//Just in case error handler is off
+
+		HRTFCrossfadeBlocks = crossfadeBlocks;
+		enableAsynchronousSetup = true;
+		assetPublisher.Retain(asset);		//The audio thread may release it when it adopts the next one
+	}
+
+	void CHRTF::DisableAsynchronousHRTFSetup()
+	{
+		//With the audio processing stopped, the last HRTF published is used from now on
+		ApplyPublishedHRTF();
+		enableAsynchronousSetup = false;
+		lastAsset = asset;
+		previousAsset.reset();
+		assetPublisher.Clear();
+	}
+
+	bool CHRTF::IsAsynchronousHRTFSetupEnabled() const
+	{
+		return enableAsynchronousSetup;
+	}
+
+	void CHRTF::ApplyPublishedHRTF()
+	{
+		std::shared_ptr<const CHRTFAsset> newAsset;
+		if (!assetPublisher.TakePublished(newAsset)) { return; }
+		if (ownerListener == nullptr) { return; }
+
+		//ReplaceAsset only publishes HRTFs with the partition layout of the one in use, so this only discards an HRTF calculated before a change of the core configuration
+		if (!IsAssetCompatible(*newAsset) || !HaveSamePartitionLayout(*asset, *newAsset)) { return; }
+
+		//The convolution buffers are kept, and the sources crossfade from the previous HRIRs
+		previousAsset = (HRTFCrossfadeBlocks > 0) ? asset : nullptr;
+		asset = std::move(newAsset);
+		HRTFVersion++;
+	}
+
+	uint32_t CHRTF::GetHRTFVersion() const
+	{
+		return HRTFVersion;
+	}
+
+	bool CHRTF::IsPreviousHRTFAvailable() const
+	{
+		return previousAsset != nullptr;
+	}
+
+	int CHRTF::GetHRTFCrossfadeBlocks() const
+	{
+		return HRTFCrossfadeBlocks;
+	}
+
+	bool CHRTF::IsAssetCompatible(const CHRTFAsset & _asset) const
+	{
+		int hybridPartitionsPerSegment = ownerListener->IsHybridHRTFConvolutionEnabled() ? ownerListener->GetHybridHRTFPartitionsPerSegment() : 0;
+		return (_asset.bufferSize == ownerListener->GetCoreAudioState().bufferSize) && (_asset.resamplingStep == ownerListener->GetHRTFResamplingStep()) && (_asset.hybridPartitionsPerSegment == hybridPartitionsPerSegment);
 	}
 
 	const int32_t CHRTF::GetHRIRNumberOfSubfilters() const {
-	return HRIR_partitioned_NumberOfSubfilters;
+	return layoutNumberOfSubfilters;
 	}
 
 	const int32_t CHRTF::GetHRIRSubfilterLength() const {
-	return HRIR_partitioned_SubfilterLength;
+	return layoutSubfilterLength;
+	}
+
+	bool CHRTF::IsHybridPartitioned() const {
+		return layoutHybridPartitionsPerSegment > 0;
+	}
+
+	int CHRTF::GetHybridPartitionsPerSegment() const {
+		return layoutHybridPartitionsPerSegment;
 	}
 
 	//ITD Methods
@@ -204,7 +371,11 @@ namespace Binaural
 
 
 	float CHRTF::GetHRTFDistanceOfMeasurement() {
-		return distanceOfMeasurement;
+		return lastAsset->distanceOfMeasurement;
+	}
+
+	float CHRTF::GetHRTFInUseDistanceOfMeasurement() const {
+		return asset->distanceOfMeasurement;
 	}
 
 
@@ -220,7 +391,7 @@ namespace Binaural
 
 		oneEarHRIR_struct s_HRIR;
 				
-		if (!setupInProgress) 
+		if (!asset->IsEmpty()) 
 		{						
 			if (runTimeInterpolation)
 			{
@@ -233,8 +404,8 @@ namespace Binaural
 				// When elevation is 90 or 270 degrees, the HRIR value is the same one for every azimuth
 				if ((ielevation == 90) || (ielevation == 270)) { iazimuth = 0; }
 
-				auto it = t_HRTF_Resampled_frequency.find(orientation(iazimuth, ielevation));
-				if (it != t_HRTF_Resampled_frequency.end()) 
+				auto it = asset->t_HRTF_Resampled_frequency.find(orientation(iazimuth, ielevation));
+				if (it != asset->t_HRTF_Resampled_frequency.end()) 
 				{
 					if (ear == Common::T_ear::LEFT)
 					{
@@ -263,16 +434,16 @@ namespace Binaural
 			else
 			{
 				//Run time interpolation OFF
-				int nearestAzimuth =	static_cast<int>(round(_azimuth / resamplingStep) * resamplingStep);
-				int nearestElevation =	static_cast<int>(round(_elevation / resamplingStep) * resamplingStep);
+				int nearestAzimuth =	static_cast<int>(round(_azimuth / asset->resamplingStep) * asset->resamplingStep);
+				int nearestElevation =	static_cast<int>(round(_elevation / asset->resamplingStep) * asset->resamplingStep);
 				// HRTF table does not contain data for azimuth = 360, which has the same values as azimuth = 0, for every elevation
 				if (nearestAzimuth == 360)		{ nearestAzimuth = 0; }
 				if (nearestElevation == 360)	{ nearestElevation = 0; }
 				// When elevation is 90 or 270 degrees, the HRIR value is the same one for every azimuth
 				if ((nearestElevation == 90) || (nearestElevation == 270)) { nearestAzimuth = 0; }
 
-				auto it = t_HRTF_Resampled_frequency.find(orientation(nearestAzimuth, nearestElevation));
-				if (it != t_HRTF_Resampled_frequency.end())
+				auto it = asset->t_HRTF_Resampled_frequency.find(orientation(nearestAzimuth, nearestElevation));
+				if (it != asset->t_HRTF_Resampled_frequency.end())
 				{
 					if (ear == Common::T_ear::LEFT)
 					{
@@ -316,79 +487,22 @@ namespace Binaural
 
 		std::vector<CMonoBuffer<float>> newHRIR;
 
-		if (!setupInProgress)
+		if (!asset->IsEmpty())
 		{
-			if (runTimeInterpolation)
+			THRTFInterpolationTriangleStruct triangle;
+			if (FindHRIR_partitioned_Triangle(*asset, _azimuth, _elevation, runTimeInterpolation, triangle))
 			{
-				if (Common::CMagnitudes::AreSame(_azimuth,	sphereBorder, epsilon_sewing))	{_azimuth = 0.0f;	}
-				if (Common::CMagnitudes::AreSame(_elevation, sphereBorder, epsilon_sewing))	{ _elevation = 0.0f;}
-
-				//If we are in the sphere poles, do not perform the interpolation (the HRIR value for this orientations have been calculated with a different method in the resampled methods, because our barycentric interpolation method doesn't work in the poles)
-				int iazimuth = static_cast<int>(round(_azimuth));
-				int ielevation = static_cast<int>(round(_elevation));
-				if ((ielevation == 90) || (ielevation == 270))
-				{
-					//In the sphere poles the azimuth is always 0 degrees
-					iazimuth = 0.0f;
-					auto it = t_HRTF_Resampled_partitioned.find(orientation(iazimuth, ielevation));
-					if (it != t_HRTF_Resampled_partitioned.end())
-					{
-						if (ear == Common::T_ear::LEFT)
-						{
-							newHRIR = it->second.leftHRIR_Partitioned;
-						}
-						else
-						{
-							newHRIR = it->second.rightHRIR_Partitioned;
-						}
-					}
-					else
-					{
-						SET_RESULT(RESULT_WARNING, "Orientations in GetHRIR_partitioned() not found");
-					}
-				}
-
-				else
-				{
-					//Run time interpolation ON
-					newHRIR = GetHRIR_partitioned_InterpolationMethod(ear, _azimuth, _elevation);
-				}
-
+				CalculateHRIR_partitioned_FromTriangle(ear, triangle, newHRIR);
 				return newHRIR;
 			}
 			else
 			{
-				//Run time interpolation OFF
-				int nearestAzimuth = static_cast<int>(round(_azimuth / resamplingStep) * resamplingStep);
-				int nearestElevation = static_cast<int>(round(_elevation / resamplingStep) * resamplingStep);
-				// HRTF table does not contain data for azimuth = 360, which has the same values as azimuth = 0, for every elevation
-				if (nearestAzimuth == 360) { nearestAzimuth = 0; }
-				if (nearestElevation == 360) { nearestElevation = 0; }
-				// When elevation is 90 or 270 degrees, the HRIR value is the same one for every azimuth
-				if ((nearestElevation == 90) || (nearestElevation == 270)) { nearestAzimuth = 0; }
-
-				auto it = t_HRTF_Resampled_partitioned.find(orientation(nearestAzimuth, nearestElevation));
-				if (it != t_HRTF_Resampled_partitioned.end())
-				{
-					if (ear == Common::T_ear::LEFT)
-					{
-						newHRIR = it->second.leftHRIR_Partitioned;
-					}
-					else
-					{
-						newHRIR = it->second.rightHRIR_Partitioned;
-					}
-					return newHRIR;
-				}
-				else
-				{
-					SET_RESULT(RESULT_ERROR_NOTSET, "GetHRIR_partitioned: HRIR not found");
-				}
+				SET_RESULT(RESULT_ERROR_NOTSET, "GetHRIR_partitioned: HRIR not found");
 			}
 		}
 		else
 		{
-			SET_RESULT(RESULT_ERROR_NOTSET, "GetHRIR_partitioned: HRTF Setup in progress return empty");
+			SET_RESULT(RESULT_ERROR_NOTSET, "GetHRIR_partitioned: HRTF not loaded return empty");
 		}
 		SET_RESULT(RESULT_WARNING, "GetHRIR_partitioned return empty");
         return *new std::vector<CMonoBuffer<float>>();
@@ -403,7 +517,7 @@ namespace Binaural
 			SET_RESULT(RESULT_ERROR_NOTALLOWED, "GetHRIRDelay: Attempt to get the delay of the HRIR for a wrong ear (BOTH or NONE)");
 		}
 
-		if (!setupInProgress)
+		if (!asset->IsEmpty())
 		{
 			//Modify delay if customized delay is activate
 			if (enableCustomizedITD)
@@ -412,94 +526,155 @@ namespace Binaural
 			}
 			else
 			{
-				if (runTimeInterpolation)
+				THRTFInterpolationTriangleStruct triangle;
+				if (FindHRIR_partitioned_Triangle(*asset, _azimuthCenter, _elevationCenter, runTimeInterpolation, triangle))
 				{
-					if (Common::CMagnitudes::AreSame(_azimuthCenter, sphereBorder, epsilon_sewing)) { _azimuthCenter = 0.0f; }
-					if (Common::CMagnitudes::AreSame(_elevationCenter, sphereBorder, epsilon_sewing)) { _elevationCenter = 0.0f; }
-
-					//If we are in the sphere poles, do not perform the interpolation (the HRIR value for this orientations have been calculated with a different method in the resampled methods, because our barycentric interpolation method doesn't work in the poles)
-					int iazimuth = static_cast<int>(round(_azimuthCenter));
-					int ielevation = static_cast<int>(round(_elevationCenter));
-					if ((ielevation == 90) || (ielevation == 270))
-					{
-						//In the sphere poles the azimuth is always 0 degrees
-						iazimuth = 0.0f;
-						auto it = t_HRTF_Resampled_partitioned.find(orientation(iazimuth, ielevation));
-						if (it != t_HRTF_Resampled_partitioned.end())
-						{
-							if (ear == Common::T_ear::LEFT)
-							{
-								HRIR_delay = it->second.leftDelay;
-							}
-							else
-							{
-								HRIR_delay = it->second.rightDelay;
-							}
-						}
-						else
-						{
-							SET_RESULT(RESULT_WARNING, "Orientations in GetHRIRDelay() not found");
-						}
-					}
-
-					else
-					{
-						//Run time interpolation ON
-						HRIR_delay = GetHRIRDelayInterpolationMethod(ear, _azimuthCenter, _elevationCenter);
-					}
-
+					HRIR_delay = CalculateHRIRDelayFromTriangle(*asset, ear, triangle);
 					return HRIR_delay;
-
 				}
 				else
 				{
-					//Run time interpolation OFF
-					int nearestAzimuth = static_cast<int>(round(_azimuthCenter / resamplingStep) * resamplingStep);
-					int nearestElevation = static_cast<int>(round(_elevationCenter / resamplingStep) * resamplingStep);
-					// HRTF table does not contain data for azimuth = 360, which has the same values as azimuth = 0, for every elevation
-					if (nearestAzimuth == 360) { nearestAzimuth = 0; }
-					if (nearestElevation == 360) { nearestElevation = 0; }
-					// When elevation is 90 or 270 degrees, the HRIR value is the same one for every azimuth
-					if ((nearestElevation == 90) || (nearestElevation == 270)) { nearestAzimuth = 0; }
-
-					auto it = t_HRTF_Resampled_partitioned.find(orientation(nearestAzimuth, nearestElevation));
-					if (it != t_HRTF_Resampled_partitioned.end())
-					{
-						if (ear == Common::T_ear::LEFT)
-						{
-							HRIR_delay = it->second.leftDelay;
-						}
-						else
-						{
-							HRIR_delay = it->second.rightDelay;
-						}
-
-						return HRIR_delay;
-					}
-					else
-					{
-						SET_RESULT(RESULT_ERROR_NOTSET, "GetHRIRDelay: HRIR not found");
-					}
+					SET_RESULT(RESULT_ERROR_NOTSET, "GetHRIRDelay: HRIR not found");
 				}
 			}
 		}
 		else
 		{
-			SET_RESULT(RESULT_ERROR_NOTSET, "GetHRIRDelay: HRTF Setup in progress return empty");
+			SET_RESULT(RESULT_ERROR_NOTSET, "GetHRIRDelay: HRTF not loaded return empty");
 		}
 		
 		SET_RESULT(RESULT_WARNING, "GetHRIRDelay return delay=0");
 		return HRIR_delay;
 	}//END GetHRIR_partitioned
 
+	void CHRTF::GetHRIR_partitioned_BothEars(float _azimuthLeft, float _elevationLeft, float _azimuthRight, float _elevationRight, float _azimuthCenter, float _elevationCenter, bool runTimeInterpolation, TOneEarHRIRPartitionedStruct & leftHRIR, TOneEarHRIRPartitionedStruct & rightHRIR)
+	{
+		leftHRIR.HRIR_Partitioned.clear();
+		rightHRIR.HRIR_Partitioned.clear();
+		leftHRIR.delay = 0;
+		rightHRIR.delay = 0;
+
+		if (asset->IsEmpty())
+		{
+			SET_RESULT(RESULT_ERROR_NOTSET, "GetHRIR_partitioned_BothEars: HRTF not loaded return empty");
+			return;
+		}
+
+		//HRIRs, with the same triangle for both ears if they have the same direction
+		THRTFInterpolationTriangleStruct leftTriangle, rightTriangle;
+		bool leftFound = FindHRIR_partitioned_Triangle(*asset, _azimuthLeft, _elevationLeft, runTimeInterpolation, leftTriangle);
+		bool rightFound = leftFound;
+		if ((_azimuthRight == _azimuthLeft) && (_elevationRight == _elevationLeft)) { rightTriangle = leftTriangle; }
+		else { rightFound = FindHRIR_partitioned_Triangle(*asset, _azimuthRight, _elevationRight, runTimeInterpolation, rightTriangle); }
+
+		if (leftFound) { CalculateHRIR_partitioned_FromTriangle(Common::T_ear::LEFT, leftTriangle, leftHRIR.HRIR_Partitioned); }
+		else { SET_RESULT(RESULT_ERROR_NOTSET, "GetHRIR_partitioned_BothEars: HRIR of the left ear not found"); }
+		if (rightFound) { CalculateHRIR_partitioned_FromTriangle(Common::T_ear::RIGHT, rightTriangle, rightHRIR.HRIR_Partitioned); }
+		else { SET_RESULT(RESULT_ERROR_NOTSET, "GetHRIR_partitioned_BothEars: HRIR of the right ear not found"); }
+
+		//Delays, with the same triangle for both ears
+		if (enableCustomizedITD)
+		{
+			leftHRIR.delay = GetCustomizedDelay(_azimuthCenter, _elevationCenter, Common::T_ear::LEFT);
+			rightHRIR.delay = GetCustomizedDelay(_azimuthCenter, _elevationCenter, Common::T_ear::RIGHT);
+		}
+		else
+		{
+			THRTFInterpolationTriangleStruct centerTriangle;
+			if (FindHRIR_partitioned_Triangle(*asset, _azimuthCenter, _elevationCenter, runTimeInterpolation, centerTriangle))
+			{
+				leftHRIR.delay = CalculateHRIRDelayFromTriangle(*asset, Common::T_ear::LEFT, centerTriangle);
+				rightHRIR.delay = CalculateHRIRDelayFromTriangle(*asset, Common::T_ear::RIGHT, centerTriangle);
+			}
+			else
+			{
+				SET_RESULT(RESULT_ERROR_NOTSET, "GetHRIR_partitioned_BothEars: HRIR delay not found");
+			}
+		}
+	}//END GetHRIR_partitioned_BothEars
+
+	void CHRTF::GetHRIR_partitioned_BothEars(float _azimuthLeft, float _elevationLeft, float _azimuthRight, float _elevationRight, float _azimuthCenter, float _elevationCenter, bool runTimeInterpolation, Common::CAlignedVector<float> & scratchBuffer, TOneEarHRIRPartitionedView & leftHRIR, TOneEarHRIRPartitionedView & rightHRIR) const
+	{
+		leftHRIR = TOneEarHRIRPartitionedView{ nullptr, nullptr, nullptr, 0, 0 };
+		rightHRIR = TOneEarHRIRPartitionedView{ nullptr, nullptr, nullptr, 0, 0 };
+
+		if (asset->IsEmpty())
+		{
+			SET_RESULT(RESULT_ERROR_NOTSET, "GetHRIR_partitioned_BothEars: HRTF not loaded return empty");
+			return;
+		}
+
+		//Room for the interpolated HRIRs of both ears, allocated only the first time
+		int HRIRLength = asset->t_HRTF_Resampled_partitioned.GetHRIRLength();
+		if (scratchBuffer.size() < 2 * (size_t)HRIRLength) { scratchBuffer.resize(2 * HRIRLength); }
+
+		GetHRIR_partitioned_BothEarsFromAsset(*asset, _azimuthLeft, _elevationLeft, _azimuthRight, _elevationRight, _azimuthCenter, _elevationCenter, runTimeInterpolation, scratchBuffer.data(), leftHRIR, rightHRIR);
+	}//END GetHRIR_partitioned_BothEars
+
+	void CHRTF::GetHRIR_partitioned_BothEars_Crossfaded(float _azimuthLeft, float _elevationLeft, float _azimuthRight, float _elevationRight, float _azimuthCenter, float _elevationCenter, bool runTimeInterpolation, float previousWeight, Common::CAlignedVector<float> & scratchBuffer, TOneEarHRIRPartitionedView & leftHRIR, TOneEarHRIRPartitionedView & rightHRIR) const
+	{
+		if ((previousAsset == nullptr) || (previousWeight <= 0.0f) || asset->IsEmpty())
+		{
+			GetHRIR_partitioned_BothEars(_azimuthLeft, _elevationLeft, _azimuthRight, _elevationRight, _azimuthCenter, _elevationCenter, runTimeInterpolation, scratchBuffer, leftHRIR, rightHRIR);
+			return;
+		}
+
+		//Room for the HRIRs of both ears of the current HRTF, of the previous one and of their mix, allocated only the first time
+		int HRIRLength = asset->t_HRTF_Resampled_partitioned.GetHRIRLength();
+		if (scratchBuffer.size() < 6 * (size_t)HRIRLength) { scratchBuffer.resize(6 * HRIRLength); }
+
+		TOneEarHRIRPartitionedView previousLeftHRIR, previousRightHRIR;
+		GetHRIR_partitioned_BothEarsFromAsset(*asset, _azimuthLeft, _elevationLeft, _azimuthRight, _elevationRight, _azimuthCenter, _elevationCenter, runTimeInterpolation, scratchBuffer.data(), leftHRIR, rightHRIR);
+		GetHRIR_partitioned_BothEarsFromAsset(*previousAsset, _azimuthLeft, _elevationLeft, _azimuthRight, _elevationRight, _azimuthCenter, _elevationCenter, runTimeInterpolation, scratchBuffer.data() + 2 * HRIRLength, previousLeftHRIR, previousRightHRIR);
+
+		CrossfadeHRIR_partitioned(previousLeftHRIR, std::min(previousWeight, 1.0f), scratchBuffer.data() + 4 * HRIRLength, leftHRIR);
+		CrossfadeHRIR_partitioned(previousRightHRIR, std::min(previousWeight, 1.0f), scratchBuffer.data() + 5 * HRIRLength, rightHRIR);
+	}//END GetHRIR_partitioned_BothEars_Crossfaded
+
 	bool CHRTF::IsHRTFLoaded() 
 	{
 		return HRTFLoaded;
 	}
+
+	std::shared_ptr<const CHRTFAsset> CHRTF::GetHRTFAsset() const
+	{
+		if (!HRTFLoaded) { return nullptr; }
+		return lastAsset;
+	}
+
+	void CHRTF::SetHRTFAsset(std::shared_ptr<const CHRTFAsset> newAsset)
+	{
+		ASSERT(newAsset != nullptr, RESULT_ERROR_NULLPOINTER, "Attempt to set a null HRTF asset", "");
+		if (newAsset == nullptr) { return; }	//Just in case error handler is off
+		ASSERT(!newAsset->IsEmpty() && !newAsset->t_HRTF_DataBase.empty(), RESULT_ERROR_NOTSET, "The tables of the HRTF asset have not been calculated", "");
+		if (newAsset->IsEmpty() || newAsset->t_HRTF_DataBase.empty()) { return; }	//Just in case error handler is off
+
+		if ((ownerListener == nullptr) || (ownerListener->ownerCore == nullptr))
+		{
+			SET_RESULT(RESULT_ERROR_NULLPOINTER, "Error in HRTF Set Asset: OwnerCore or OwnerListener are nullPtr");
+			return;
+		}
+
+		assetInSetup.reset();
+		setupInProgress = false;
+
+		if (IsAssetCompatible(*newAsset))
+		{
+			if (ReplaceAsset(std::move(newAsset))) { SET_RESULT(RESULT_OK, "HRTF asset set succesfully"); }
+		}
+		else
+		{
+			//The tables of this listener are calculated again, only the database is the same one
+			BeginSetupFromAsset(*newAsset);
+			CalculateAssetInSetup(true);
+			setupInProgress = false;
+			if (ReplaceAsset(std::move(assetInSetup))) { SET_RESULT(RESULT_WARNING, "The HRTF asset was calculated for another buffer size, resampling step or convolution, so its tables have been calculated again for this listener"); }
+		}
+	}
 	
 	const T_HRTFTable & CHRTF::GetRawHRTFTable() const
 	{
-		return t_HRTF_DataBase;
+		return lastAsset->t_HRTF_DataBase;
 	}
 
 
@@ -517,15 +692,15 @@ namespace Binaural
 		//	NORTHERN HEMOSPHERE POLES (90 degrees elevation ) ____________________________________________________________________________
 		
 		//If HRIR with orientation (0,90) exist in t_HRTF_DataBase
-		auto it90 = t_HRTF_DataBase.find(orientation(0, 90));
-		if (it90 != t_HRTF_DataBase.end())
+		auto it90 = assetInSetup->t_HRTF_DataBase.find(orientation(0, 90));
+		if (it90 != assetInSetup->t_HRTF_DataBase.end())
 		{
 			precalculatedHRIR_90 = it90->second;
 		}
 		else
 		{
-			keys_northenHemisphere.reserve(t_HRTF_DataBase.size());
-			for (auto& it : t_HRTF_DataBase)
+			keys_northenHemisphere.reserve(assetInSetup->t_HRTF_DataBase.size());
+			for (auto& it : assetInSetup->t_HRTF_DataBase)
 			{
 				if (it.first.elevation < 90) { keys_northenHemisphere.push_back(it.first); }
 			}
@@ -550,15 +725,15 @@ namespace Binaural
 		//	SOURTHERN HEMOSPHERE POLES (270 degrees elevation) ____________________________________________________________________________
 		
 		//If HRIR with orientation (0,270) exist in t_HRTF_DataBase
-		if (t_HRTF_DataBase.find(orientation(0, 270)) != t_HRTF_DataBase.end())
+		if (assetInSetup->t_HRTF_DataBase.find(orientation(0, 270)) != assetInSetup->t_HRTF_DataBase.end())
 		{
-			auto it270 = t_HRTF_DataBase.find(orientation(0, 270));
+			auto it270 = assetInSetup->t_HRTF_DataBase.find(orientation(0, 270));
 			precalculatedHRIR_270 = it270->second;
 		}
 		else
 		{
-			keys_southernHemisphere.reserve(t_HRTF_DataBase.size());
-			for (auto& it : t_HRTF_DataBase)
+			keys_southernHemisphere.reserve(assetInSetup->t_HRTF_DataBase.size());
+			for (auto& it : assetInSetup->t_HRTF_DataBase)
 			{
 				if (it.first.elevation > 270) { keys_southernHemisphere.push_back(it.first); }
 			}
@@ -585,13 +760,13 @@ namespace Binaural
 		for (int i = 0; i < 360; i = i + AZIMUTH_STEP)
 		{
 			//Elevation 270 degrees
-			t_HRTF_DataBase.emplace(orientation(i, 270), precalculatedHRIR_270);
+			assetInSetup->t_HRTF_DataBase.emplace(orientation(i, 270), precalculatedHRIR_270);
 			//Elevation 90 degrees
-			t_HRTF_DataBase.emplace(orientation(i, 90), precalculatedHRIR_90);
+			assetInSetup->t_HRTF_DataBase.emplace(orientation(i, 90), precalculatedHRIR_90);
 			//Azimuth 360 degrees
-			auto it0 = t_HRTF_DataBase.find(orientation(0, i));
-			if (it0 != t_HRTF_DataBase.end()) {
-				t_HRTF_DataBase.emplace(orientation(360, i), it0->second);
+			auto it0 = assetInSetup->t_HRTF_DataBase.find(orientation(0, i));
+			if (it0 != assetInSetup->t_HRTF_DataBase.end()) {
+				assetInSetup->t_HRTF_DataBase.emplace(orientation(360, i), it0->second);
 			}
 		}
 	}
@@ -662,8 +837,8 @@ namespace Binaural
 
 		for (int q = 0; q < hemisphereParts.size(); q++)
 		{
-			newHRIR[q].leftHRIR.resize(HRIRLength, 0.0f);
-			newHRIR[q].rightHRIR.resize(HRIRLength, 0.0f);
+			newHRIR[q].leftHRIR.resize(assetInSetup->HRIRLength, 0.0f);
+			newHRIR[q].rightHRIR.resize(assetInSetup->HRIRLength, 0.0f);
 
 			float scaleFactor;
 			if (hemisphereParts[q].size()) 
@@ -677,14 +852,14 @@ namespace Binaural
 
 			for (auto it = hemisphereParts[q].begin(); it != hemisphereParts[q].end(); it++)
 			{
-				auto itHRIR = t_HRTF_DataBase.find(orientation(it->azimuth, it->elevation));
+				auto itHRIR = assetInSetup->t_HRTF_DataBase.find(orientation(it->azimuth, it->elevation));
 
 				//Get the delay
 				newHRIR[q].leftDelay = (newHRIR[q].leftDelay + itHRIR->second.leftDelay);
 				newHRIR[q].rightDelay = (newHRIR[q].rightDelay + itHRIR->second.rightDelay);
 
 				//Get the HRIR
-				for (int i = 0; i < HRIRLength; i++) {
+				for (int i = 0; i < assetInSetup->HRIRLength; i++) {
 					newHRIR[q].leftHRIR[i] = (newHRIR[q].leftHRIR[i] + itHRIR->second.leftHRIR[i]);
 					newHRIR[q].rightHRIR[i] = (newHRIR[q].rightHRIR[i] + itHRIR->second.rightHRIR[i]);
 				}
@@ -697,7 +872,7 @@ namespace Binaural
 			totalDelay_left = totalDelay_left + (scaleFactor * newHRIR[q].leftDelay);
 			totalDelay_right = totalDelay_right + (scaleFactor * newHRIR[q].rightDelay);
 			//HRIR
-			for (int i = 0; i < HRIRLength; i++)
+			for (int i = 0; i < assetInSetup->HRIRLength; i++)
 			{
 				newHRIR[q].leftHRIR[i] = newHRIR[q].leftHRIR[i] * scaleFactor;
 				newHRIR[q].rightHRIR[i] = newHRIR[q].rightHRIR[i] * scaleFactor;
@@ -712,10 +887,10 @@ namespace Binaural
 		calculatedHRIR.rightDelay = static_cast <unsigned long> (round(scaleFactor_final * totalDelay_right));
 
 		//calculate Final HRIR
-		calculatedHRIR.leftHRIR.resize(HRIRLength, 0.0f);
-		calculatedHRIR.rightHRIR.resize(HRIRLength, 0.0f);
+		calculatedHRIR.leftHRIR.resize(assetInSetup->HRIRLength, 0.0f);
+		calculatedHRIR.rightHRIR.resize(assetInSetup->HRIRLength, 0.0f);
 
-		for (int i = 0; i < HRIRLength; i++)
+		for (int i = 0; i < assetInSetup->HRIRLength; i++)
 		{
 			for (int q = 0; q < hemisphereParts.size(); q++)
 			{
@@ -723,7 +898,7 @@ namespace Binaural
 				calculatedHRIR.rightHRIR[i] = calculatedHRIR.rightHRIR[i] + newHRIR[q].rightHRIR[i];
 			}
 		}
-		for (int i = 0; i < HRIRLength; i++)
+		for (int i = 0; i < assetInSetup->HRIRLength; i++)
 		{
 			calculatedHRIR.leftHRIR[i] = calculatedHRIR.leftHRIR[i] * scaleFactor_final;
 			calculatedHRIR.rightHRIR[i] = calculatedHRIR.rightHRIR[i] * scaleFactor_final;
@@ -734,131 +909,174 @@ namespace Binaural
 
 	void CHRTF::CalculateResampled_HRTFTable(int resamplingStep)
 	{
-		THRIRStruct interpolatedHRIR;
+		//Triangulate the orientations of the database once, to find the triangle around each new orientation
+		CalculateDataBaseTriangulation();
 
-		//Resample Interpolation Algorithm
+		//Orientations of the resampled table
+		std::vector<orientation> resampledOrientations;
 		for (int newAzimuth = 0; newAzimuth < 360; newAzimuth = newAzimuth + resamplingStep)
 		{
 			for (int newElevation = 0; newElevation <= 90; newElevation = newElevation + resamplingStep)
 			{
-				auto it = t_HRTF_DataBase.find(orientation(newAzimuth, newElevation));
-				if (it != t_HRTF_DataBase.end())
-				{
-
-		#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC
-					//Fill out interpolated frequency table. IR in frequency domain
-					THRIRStruct temp;
-					Common::CFprocessor::GetFFT(it->second.leftHRIR, temp.leftHRIR, bufferSize);
-					Common::CFprocessor::GetFFT(it->second.rightHRIR, temp.rightHRIR, bufferSize);
-					temp.leftDelay = it->second.leftDelay;
-					temp.rightDelay = it->second.rightDelay;
-					auto returnValue2 = t_HRTF_Resampled_frequency.emplace(orientation(newAzimuth, newElevation), std::forward<THRIRStruct>(temp));
-					//Error handler
-					if (returnValue2.second) { /*SET_RESULT(RESULT_OK, "HRIR emplaced into t_HRTF_Resampled_frequency successfully");*/ }
-					else { SET_RESULT(RESULT_WARNING, "Error emplacing HRIR into t_HRTF_Resampled_frequency table"); }
-		#else
-					//Fill out HRTF partitioned table.IR in frequency domain
-					THRIRPartitionedStruct newHRIR_partitioned;
-					newHRIR_partitioned = SplitAndGetFFT_HRTFData(it->second);
-					auto returnValue3 = t_HRTF_Resampled_partitioned.emplace(orientation(newAzimuth, newElevation), std::forward<THRIRPartitionedStruct>(newHRIR_partitioned));
-					//Error handler
-					if (returnValue3.second) { /*SET_RESULT(RESULT_OK, "HRIR emplaced into t_HRTF_Resampled_partitioned successfully");*/ }
-					else { SET_RESULT(RESULT_WARNING, "Error emplacing HRIR into t_HRTF_Resampled_partitioned table"); }
-		#endif
-				}
-
-				else
-				{
+				resampledOrientations.push_back(orientation(newAzimuth, newElevation));
+			}
+			for (int newElevation = 270; newElevation < 360; newElevation = newElevation + resamplingStep)
+			{
+				resampledOrientations.push_back(orientation(newAzimuth, newElevation));
+			}
+		}
+		int numberOfOrientations = resampledOrientations.size();
+
+		//Every orientation is independent, so the workers share the orientations and each one writes its HRIRs in their own slots, without locking the table
+		std::atomic<int> nextOrientation(0);
+#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC
+		std::vector<THRIRStruct> resampledHRIRs(numberOfOrientations);
+		auto resamplingWorker = [&]() {
+			for (int i = nextOrientation++; i < numberOfOrientations; i = nextOrientation++)
+			{
+				CalculateResampledHRIR(resampledOrientations[i], resampledHRIRs[i]);
+			}
+		};
+#else
+		//The first HRIR gives the size of the subfilters, the same for all the orientations, to allocate the grid
+		THRIRPartitionedStruct firstHRIR_partitioned;
+		CalculateResampledHRIR(resampledOrientations[0], firstHRIR_partitioned);
+		std::vector<int> subfilterLengths;
+		for (const CMonoBuffer<float> & subfilter : firstHRIR_partitioned.leftHRIR_Partitioned)
+		{
+			subfilterLengths.push_back(subfilter.size());
+		}
+		assetInSetup->t_HRTF_Resampled_partitioned.Setup(resamplingStep, subfilterLengths);
+		SetResampledHRIR(resampledOrientations[0], firstHRIR_partitioned);
+		nextOrientation = 1;
 
-					//Get the interpolated HRIR 
-					interpolatedHRIR = CalculateHRIR_offlineMethod(newAzimuth, newElevation);
-
-		#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC
-					//Fill out interpolated frequency table. IR in frequency domain
-					THRIRStruct newHRIR;
-					Common::CFprocessor::GetFFT(interpolatedHRIR.leftHRIR, newHRIR.leftHRIR, bufferSize);
-					Common::CFprocessor::GetFFT(interpolatedHRIR.rightHRIR, newHRIR.rightHRIR, bufferSize);
-					newHRIR.leftDelay = interpolatedHRIR.leftDelay;
-					newHRIR.rightDelay = interpolatedHRIR.rightDelay;
-
-					auto returnValue2 = t_HRTF_Resampled_frequency.emplace(orientation(newAzimuth, newElevation), std::forward<THRIRStruct>(newHRIR));
-					//Error handler
-					if (returnValue2.second) { /*SET_RESULT(RESULT_OK, "HRIR emplaced into t_HRTF_Resampled_frequency successfully");*/ }
-					else { SET_RESULT(RESULT_WARNING, "Error emplacing HRIR into t_HRTF_Resampled_frequency table"); }
-
-		#else
-					//Fill out HRTF partitioned table.IR in frequency domain
-					THRIRPartitionedStruct newHRIR_partitioned;
-					newHRIR_partitioned = SplitAndGetFFT_HRTFData(interpolatedHRIR);
-					auto returnValue1 = t_HRTF_Resampled_partitioned.emplace(orientation(newAzimuth, newElevation), std::forward<THRIRPartitionedStruct>(newHRIR_partitioned));
-					//Error handler
-					if (returnValue1.second) { /*SET_RESULT(RESULT_OK, "HRIR emplaced into t_HRTF_Resampled_partitioned successfully");*/ }
-					else { SET_RESULT(RESULT_WARNING, "Error emplacing HRIR into t_HRTF_Resampled_partitioned table"); }
-		#endif												
-				}
+		auto resamplingWorker = [&]() {
+			THRIRPartitionedStruct newHRIR_partitioned;
+			for (int i = nextOrientation++; i < numberOfOrientations; i = nextOrientation++)
+			{
+				CalculateResampledHRIR(resampledOrientations[i], newHRIR_partitioned);
+				SetResampledHRIR(resampledOrientations[i], newHRIR_partitioned);
 			}
+		};
+#endif
+
+		//An exception of any worker (bad_alloc) stops the others and is thrown again in this thread once all of them have finished, as without threads
+		std::exception_ptr workerException;
+		std::mutex workerExceptionMutex;
+		auto safeResamplingWorker = [&]() {
+			try
+			{
+				resamplingWorker();
+			}
+			catch (...)
+			{
+				std::lock_guard<std::mutex> lock(workerExceptionMutex);
+				if (!workerException) { workerException = std::current_exception(); }
+				nextOrientation = numberOfOrientations;
+			}
+		};
 
-			for (int newElevation = 270; newElevation < 360; newElevation = newElevation + resamplingStep)
+		//0 means one thread for each hardware thread, up to a maximum. While the audio thread is running with the asynchronous setup, only this thread calculates the table, so the audio thread keeps its core
+		int numberOfThreads = resamplingThreads;
+		if (numberOfThreads == 0)
+		{
+			bool audioThreadRunning = enableAsynchronousSetup && !lastAsset->IsEmpty();
+			numberOfThreads = audioThreadRunning ? 1 : std::min(std::max((int)std::thread::hardware_concurrency(), 1), MAX_AUTOMATIC_RESAMPLING_THREADS);
+		}
+		numberOfThreads = std::min(numberOfThreads, numberOfOrientations);
+		std::vector<std::thread> workers;
+		workers.reserve(numberOfThreads);
+		for (int i = 1; i < numberOfThreads; i++)
+		{
+			try
 			{
-				auto it2 = t_HRTF_DataBase.find(orientation(newAzimuth, newElevation));
-				if (it2 != t_HRTF_DataBase.end())
-				{
-		#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC
-
-					//Fill out interpolated frequency table. IR in frequency domain
-					THRIRStruct temp;
-					Common::CFprocessor::GetFFT(it2->second.leftHRIR, temp.leftHRIR, bufferSize);
-					Common::CFprocessor::GetFFT(it2->second.rightHRIR, temp.rightHRIR, bufferSize);
-					temp.leftDelay = it2->second.leftDelay;
-					temp.rightDelay = it2->second.rightDelay;
-					auto returnValue = t_HRTF_Resampled_frequency.emplace(orientation(newAzimuth, newElevation), std::forward<THRIRStruct>(temp));
-					//Error handler
-					if (returnValue.second) { /*SET_RESULT(RESULT_OK, "HRIR emplaced into t_HRTF_Resampled_frequency successfully");*/ }
-					else { SET_RESULT(RESULT_WARNING, "Error emplacing HRIR into t_HRTF_Resampled_frequency table"); }
-		#else
-					//Fill out HRTF partitioned table.IR in frequency domain
-					THRIRPartitionedStruct newHRIR_partitioned;
-					newHRIR_partitioned = SplitAndGetFFT_HRTFData(it2->second);
-					auto returnValue3 = t_HRTF_Resampled_partitioned.emplace(orientation(newAzimuth, newElevation), std::forward<THRIRPartitionedStruct>(newHRIR_partitioned));
-					//Error handler
-					if (returnValue3.second) { /*SET_RESULT(RESULT_OK, "HRIR emplaced into t_HRTF_Resampled_partitioned successfully");*/ }
-					else { SET_RESULT(RESULT_WARNING, "Error emplacing HRIR into t_HRTF_Resampled_partitioned table"); }
-		#endif
-				}
-				else
-				{
-					//Get the interpolated HRIR 
-					interpolatedHRIR = CalculateHRIR_offlineMethod(newAzimuth, newElevation);
-		#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC
-					//Fill out interpolated frequency table. IR in frequency domain
-					THRIRStruct newHRIR;
-					Common::CFprocessor::GetFFT(interpolatedHRIR.leftHRIR, newHRIR.leftHRIR, bufferSize);
-					Common::CFprocessor::GetFFT(interpolatedHRIR.rightHRIR, newHRIR.rightHRIR, bufferSize);
-					newHRIR.leftDelay = interpolatedHRIR.leftDelay;
-					newHRIR.rightDelay = interpolatedHRIR.rightDelay;
-					auto returnValue = t_HRTF_Resampled_frequency.emplace(orientation(newAzimuth, newElevation), std::forward<THRIRStruct>(newHRIR));
-					//Error handler
-					if (returnValue.second) { /*SET_RESULT(RESULT_OK, "HRIR emplaced into t_HRTF_Resampled_frequency successfully");*/ }
-					else { SET_RESULT(RESULT_WARNING, "Error emplacing HRIR into t_HRTF_Resampled_frequency table"); }
-		#else
-					//Fill out HRTF partitioned table.IR in frequency domain
-					THRIRPartitionedStruct newHRIR_partitioned;
-					newHRIR_partitioned = SplitAndGetFFT_HRTFData(interpolatedHRIR);
-					auto returnValue1 = t_HRTF_Resampled_partitioned.emplace(orientation(newAzimuth, newElevation), std::forward<THRIRPartitionedStruct>(newHRIR_partitioned));
-					//Error handler
-					if (returnValue1.second) { /*SET_RESULT(RESULT_OK, "HRIR emplaced into t_HRTF_Resampled_partitioned successfully");*/ }
-					else { SET_RESULT(RESULT_WARNING, "Error emplacing HRIR into t_HRTF_Resampled_partitioned table"); }
-		#endif // 															
-				}
+				workers.emplace_back(safeResamplingWorker);
 			}
+			catch (const std::system_error &)
+			{
+				break;		//The workers already started, and this thread, calculate the rest of the orientations
+			}
+		}
+		safeResamplingWorker();		//This thread is one of the workers
+		for (std::thread & worker : workers)
+		{
+			worker.join();
 		}
+		if (workerException) { std::rethrow_exception(workerException); }
+
+		//Check the table
+		for (int i = 0; i < numberOfOrientations; i++)
+		{
+#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC
+			auto returnValue = assetInSetup->t_HRTF_Resampled_frequency.emplace(resampledOrientations[i], std::move(resampledHRIRs[i]));
+			//Error handler
+			if (returnValue.second) { /*SET_RESULT(RESULT_OK, "HRIR emplaced into t_HRTF_Resampled_frequency successfully");*/ }
+			else { SET_RESULT(RESULT_WARNING, "Error emplacing HRIR into t_HRTF_Resampled_frequency table"); }
+#else
+			int orientationIndex = assetInSetup->t_HRTF_Resampled_partitioned.GetOrientationIndex(resampledOrientations[i].azimuth, resampledOrientations[i].elevation);
+			if (!assetInSetup->t_HRTF_Resampled_partitioned.IsHRIRSet(orientationIndex)) { SET_RESULT(RESULT_WARNING, "Error setting HRIR into t_HRTF_Resampled_partitioned grid"); }
+#endif
+		}
+#ifndef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC
+		//Triangles of the run-time interpolation
+		assetInSetup->t_HRTF_Resampled_interpolationLookup.Setup(assetInSetup->t_HRTF_Resampled_partitioned);
+#endif
 		//SET_RESULT(RESULT_OK, "CalculateResampled_HRTFTable has finished succesfully");
 	}
 
+#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC
+	void CHRTF::CalculateResampledHRIR(orientation newOrientation, THRIRStruct & newHRIR)
+	{
+		auto it = assetInSetup->t_HRTF_DataBase.find(newOrientation);
+		//Copy the HRIR of the database or get the interpolated HRIR
+		THRIRStruct interpolatedHRIR = (it != assetInSetup->t_HRTF_DataBase.end()) ? it->second : CalculateHRIR_offlineMethod(newOrientation.azimuth, newOrientation.elevation);
+
+		//Fill out interpolated frequency table. IR in frequency domain
+		Common::CFprocessor::GetFFT(interpolatedHRIR.leftHRIR, newHRIR.leftHRIR, assetInSetup->bufferSize);
+		Common::CFprocessor::GetFFT(interpolatedHRIR.rightHRIR, newHRIR.rightHRIR, assetInSetup->bufferSize);
+		newHRIR.leftDelay = interpolatedHRIR.leftDelay;
+		newHRIR.rightDelay = interpolatedHRIR.rightDelay;
+	}
+#else
+	void CHRTF::CalculateResampledHRIR(orientation newOrientation, THRIRPartitionedStruct & newHRIR_partitioned)
+	{
+		auto it = assetInSetup->t_HRTF_DataBase.find(newOrientation);
+		if (it != assetInSetup->t_HRTF_DataBase.end())
+		{
+			//Fill out HRTF partitioned table.IR in frequency domain
+			newHRIR_partitioned = SplitAndGetFFT_HRTFData(it->second);
+		}
+		else
+		{
+			//Get the interpolated HRIR 
+			THRIRStruct interpolatedHRIR = CalculateHRIR_offlineMethod(newOrientation.azimuth, newOrientation.elevation);
+			newHRIR_partitioned = SplitAndGetFFT_HRTFData(interpolatedHRIR);
+		}
+	}
+
+	void CHRTF::SetResampledHRIR(orientation newOrientation, const THRIRPartitionedStruct & newHRIR_partitioned)
+	{
+		int orientationIndex = assetInSetup->t_HRTF_Resampled_partitioned.GetOrientationIndex(newOrientation.azimuth, newOrientation.elevation);
+		assetInSetup->t_HRTF_Resampled_partitioned.SetHRIR(orientationIndex, Common::T_ear::LEFT, newHRIR_partitioned.leftHRIR_Partitioned, newHRIR_partitioned.leftDelay);
+		assetInSetup->t_HRTF_Resampled_partitioned.SetHRIR(orientationIndex, Common::T_ear::RIGHT, newHRIR_partitioned.rightHRIR_Partitioned, newHRIR_partitioned.rightDelay);
+	}
+#endif
+
 	THRIRPartitionedStruct CHRTF::SplitAndGetFFT_HRTFData(const THRIRStruct & newData_time)
 	{
-		int blockSize = bufferSize;
-		int numberOfBlocks = HRIR_partitioned_NumberOfSubfilters;
+		if (assetInSetup->hybridPartitionsPerSegment > 0)
+		{
+			//FIR filter followed by partitions of increasing size, for the hybrid convolution
+			THRIRPartitionedStruct new_DataHybrid_Partitioned;
+			CHybridAnechoicStereo::CalculateHRIR_Partitioned(newData_time.leftHRIR, assetInSetup->bufferSize, assetInSetup->HRIRLength, assetInSetup->hybridPartitionsPerSegment, new_DataHybrid_Partitioned.leftHRIR_Partitioned);
+			CHybridAnechoicStereo::CalculateHRIR_Partitioned(newData_time.rightHRIR, assetInSetup->bufferSize, assetInSetup->HRIRLength, assetInSetup->hybridPartitionsPerSegment, new_DataHybrid_Partitioned.rightHRIR_Partitioned);
+			new_DataHybrid_Partitioned.leftDelay = newData_time.leftDelay;
+			new_DataHybrid_Partitioned.rightDelay = newData_time.rightDelay;
+			return new_DataHybrid_Partitioned;
+		}
+
+		int blockSize = assetInSetup->bufferSize;
+		int numberOfBlocks = assetInSetup->HRIR_partitioned_NumberOfSubfilters;
 		int data_time_size = newData_time.leftHRIR.size();
 
 		THRIRPartitionedStruct new_DataFFT_Partitioned;
@@ -882,8 +1100,8 @@ namespace Binaural
 			}
 			//FFT
 			CMonoBuffer<float> left_data_FFT, right_data_FFT;
-			Common::CFprocessor::CalculateFFT(left_data_FFT_doubleSize, left_data_FFT);
-			Common::CFprocessor::CalculateFFT(right_data_FFT_doubleSize, right_data_FFT);
+			Common::CFprocessor::CalculateFFT_HalfSpectrum(left_data_FFT_doubleSize, left_data_FFT);
+			Common::CFprocessor::CalculateFFT_HalfSpectrum(right_data_FFT_doubleSize, right_data_FFT);
 			//Prepare struct to return the value
 			new_DataFFT_Partitioned.leftHRIR_Partitioned.push_back(left_data_FFT);
 			new_DataFFT_Partitioned.rightHRIR_Partitioned.push_back(right_data_FFT);
@@ -895,9 +1113,47 @@ namespace Binaural
 		return new_DataFFT_Partitioned;
 		}
 
+	void CHRTF::CalculatePartitionLayout()
+	{
+		assetInSetup->hybridPartitionsPerSegment = ownerListener->IsHybridHRTFConvolutionEnabled() ? ownerListener->GetHybridHRTFPartitionsPerSegment() : 0;
+		if (assetInSetup->hybridPartitionsPerSegment > 0)
+		{
+			assetInSetup->HRIR_partitioned_NumberOfSubfilters = CHybridAnechoicStereo::GetNumberOfSubfilters(assetInSetup->bufferSize, assetInSetup->HRIRLength, assetInSetup->hybridPartitionsPerSegment);
+		}
+		else
+		{
+			float partitions = (float)assetInSetup->HRIRLength / (float)assetInSetup->bufferSize;
+			assetInSetup->HRIR_partitioned_NumberOfSubfilters = static_cast<int>(std::ceil(partitions));
+		}
+	}
+
+	void CHRTF::CalculateDataBaseTriangulation()
+	{
+		dataBaseTriangulation.BeginSetup();
+		dataBaseTriangulationVertices.clear();
+		dataBaseTriangulationVertices.reserve(assetInSetup->t_HRTF_DataBase.size());
+		for (auto it = assetInSetup->t_HRTF_DataBase.begin(); it != assetInSetup->t_HRTF_DataBase.end(); ++it)
+		{
+			dataBaseTriangulation.AddVertex(it->first.azimuth, it->first.elevation);
+			dataBaseTriangulationVertices.push_back(it->first);
+		}
+		dataBaseTriangulation.EndSetup();
+	}
+
 	THRIRStruct CHRTF::CalculateHRIR_offlineMethod(int newAzimuth, int newElevation) 
 	{
-		THRIRStruct newHRIR;	
+		// Find the triangle of the database triangulation around the orientation of interest
+		TSphericalTriangleStruct triangle;
+		if (dataBaseTriangulation.FindTriangle(newAzimuth, newElevation, triangle))
+		{
+			TBarycentricCoordinatesStruct barycentricCoordinates;
+			barycentricCoordinates.alpha = triangle.alpha;
+			barycentricCoordinates.beta = triangle.beta;
+			barycentricCoordinates.gamma = triangle.gamma;
+			return CalculateHRIR_FromDataBase(barycentricCoordinates, dataBaseTriangulationVertices[triangle.vertexA], dataBaseTriangulationVertices[triangle.vertexB], dataBaseTriangulationVertices[triangle.vertexC]);
+		}
+
+		// The orientations of the database do not surround the listener, search the triangle among the nearest orientations
 		// Get a list sorted by distances to the orientation of interest
 		std::list<T_PairDistanceOrientation> sortedList = GetSortedDistancesList(newAzimuth, newElevation);
 
@@ -933,31 +1189,7 @@ namespace Binaural
 
 							if (barycentricCoordinates.alpha >= 0.0f && barycentricCoordinates.beta >= 0.0f && barycentricCoordinates.gamma >= 0.0f) {
 								// Calculate the new HRIR with the barycentric coorfinates
-								auto it0 = t_HRTF_DataBase.find(orientation(mygroup[i].azimuth, mygroup[i].elevation));
-								auto it1 = t_HRTF_DataBase.find(orientation(mygroup[j].azimuth, mygroup[j].elevation));
-								auto it2 = t_HRTF_DataBase.find(orientation(mygroup[k].azimuth, mygroup[k].elevation));
-
-								if (it0 != t_HRTF_DataBase.end() && it1 != t_HRTF_DataBase.end() && it2 != t_HRTF_DataBase.end()) {
-
-									//FIXME!!! another way to initialize?
-									newHRIR = it0->second;
-									//END FIXME
-
-									for (int i = 0; i < HRIRLength; i++) {
-										newHRIR.leftHRIR[i] = barycentricCoordinates.alpha * it0->second.leftHRIR[i] + barycentricCoordinates.beta * it1->second.leftHRIR[i] + barycentricCoordinates.gamma * it2->second.leftHRIR[i];
-										newHRIR.rightHRIR[i] = barycentricCoordinates.alpha * it0->second.rightHRIR[i] + barycentricCoordinates.beta * it1->second.rightHRIR[i] + barycentricCoordinates.gamma * it2->second.rightHRIR[i];
-									}
-
-									// Calculate delay
-									newHRIR.leftDelay = barycentricCoordinates.alpha * it0->second.leftDelay + barycentricCoordinates.beta * it1->second.leftDelay + barycentricCoordinates.gamma * it2->second.leftDelay;
-									newHRIR.rightDelay = barycentricCoordinates.alpha * it0->second.rightDelay + barycentricCoordinates.beta * it1->second.rightDelay + barycentricCoordinates.gamma * it2->second.rightDelay;
-									//SET_RESULT(RESULT_OK, "HRIR calculated with interpolation method succesfully");
-									return newHRIR;
-								}
-								else {
-									SET_RESULT(RESULT_WARNING, "GetHRIR_InterpolationMethod return empty because HRIR with a specific orientation was not found");
-									return emptyHRIR;
-								}
+								return CalculateHRIR_FromDataBase(barycentricCoordinates, mygroup[i], mygroup[j], mygroup[k]);
 							}
 						}
 					}
@@ -974,6 +1206,36 @@ namespace Binaural
 
 	}
 
+	THRIRStruct CHRTF::CalculateHRIR_FromDataBase(const TBarycentricCoordinatesStruct & barycentricCoordinates, orientation orientation_pto1, orientation orientation_pto2, orientation orientation_pto3)
+	{
+		THRIRStruct newHRIR;
+		auto it0 = assetInSetup->t_HRTF_DataBase.find(orientation_pto1);
+		auto it1 = assetInSetup->t_HRTF_DataBase.find(orientation_pto2);
+		auto it2 = assetInSetup->t_HRTF_DataBase.find(orientation_pto3);
+
+		if (it0 != assetInSetup->t_HRTF_DataBase.end() && it1 != assetInSetup->t_HRTF_DataBase.end() && it2 != assetInSetup->t_HRTF_DataBase.end()) {
+
+			//FIXME!!! another way to initialize?
+			newHRIR = it0->second;
+			//END FIXME
+
+			for (int i = 0; i < assetInSetup->HRIRLength; i++) {
+				newHRIR.leftHRIR[i] = barycentricCoordinates.alpha * it0->second.leftHRIR[i] + barycentricCoordinates.beta * it1->second.leftHRIR[i] + barycentricCoordinates.gamma * it2->second.leftHRIR[i];
+				newHRIR.rightHRIR[i] = barycentricCoordinates.alpha * it0->second.rightHRIR[i] + barycentricCoordinates.beta * it1->second.rightHRIR[i] + barycentricCoordinates.gamma * it2->second.rightHRIR[i];
+			}
+
+			// Calculate delay
+			newHRIR.leftDelay = barycentricCoordinates.alpha * it0->second.leftDelay + barycentricCoordinates.beta * it1->second.leftDelay + barycentricCoordinates.gamma * it2->second.leftDelay;
+			newHRIR.rightDelay = barycentricCoordinates.alpha * it0->second.rightDelay + barycentricCoordinates.beta * it1->second.rightDelay + barycentricCoordinates.gamma * it2->second.rightDelay;
+			//SET_RESULT(RESULT_OK, "HRIR calculated with interpolation method succesfully");
+			return newHRIR;
+		}
+		else {
+			SET_RESULT(RESULT_WARNING, "GetHRIR_InterpolationMethod return empty because HRIR with a specific orientation was not found");
+			return emptyHRIR;
+		}
+	}
+
 	float CHRTF::TransformAzimuth(float azimuthOrientationOfInterest, float originalAzimuth) 
 	{
 		float azimuth;
@@ -1004,7 +1266,7 @@ namespace Binaural
 		std::list<T_PairDistanceOrientation> sortedList;
 
 		// Algorithm to calculate the three shortest distances between the point (newAzimuth, newelevation) and all the points in the HRTF table (t)
-		for (auto it = t_HRTF_DataBase.begin(); it != t_HRTF_DataBase.end(); ++it)
+		for (auto it = assetInSetup->t_HRTF_DataBase.begin(); it != assetInSetup->t_HRTF_DataBase.end(); ++it)
 		{
 			distance = CalculateDistance_HaversineFormula(newAzimuth, newElevation, it->first.azimuth, it->first.elevation);
 
@@ -1083,17 +1345,17 @@ namespace Binaural
 		orientation orientation_ptoA, orientation_ptoB, orientation_ptoC, orientation_ptoD, orientation_ptoP;
 
 		//Calculate the quadrant points A, B, C and D and the middle quadrant point P
-		orientation_ptoC.azimuth = trunc(azimuth / resamplingStep) * resamplingStep;
-		orientation_ptoC.elevation = trunc(elevation / resamplingStep)*resamplingStep;
+		orientation_ptoC.azimuth = trunc(azimuth / asset->resamplingStep) * asset->resamplingStep;
+		orientation_ptoC.elevation = trunc(elevation / asset->resamplingStep)*asset->resamplingStep;
 		orientation_ptoA.azimuth = orientation_ptoC.azimuth;
-		orientation_ptoA.elevation = orientation_ptoC.elevation + resamplingStep;
-		orientation_ptoB.azimuth = orientation_ptoC.azimuth + resamplingStep;
-		orientation_ptoB.elevation = orientation_ptoC.elevation + resamplingStep;
-		orientation_ptoD.azimuth = orientation_ptoC.azimuth + resamplingStep;
+		orientation_ptoA.elevation = orientation_ptoC.elevation + asset->resamplingStep;
+		orientation_ptoB.azimuth = orientation_ptoC.azimuth + asset->resamplingStep;
+		orientation_ptoB.elevation = orientation_ptoC.elevation + asset->resamplingStep;
+		orientation_ptoD.azimuth = orientation_ptoC.azimuth + asset->resamplingStep;
 		orientation_ptoD.elevation = orientation_ptoC.elevation;
-		orientation_ptoP.azimuth = orientation_ptoC.azimuth + (resamplingStep * 0.5f);
-		float azimuth_ptoP = orientation_ptoC.azimuth + (resamplingStep * 0.5f);
-		float elevation_ptoP = orientation_ptoC.elevation + (resamplingStep * 0.5f);
+		orientation_ptoP.azimuth = orientation_ptoC.azimuth + (asset->resamplingStep * 0.5f);
+		float azimuth_ptoP = orientation_ptoC.azimuth + (asset->resamplingStep * 0.5f);
+		float elevation_ptoP = orientation_ptoC.elevation + (asset->resamplingStep * 0.5f);
 
 		//Depend on the quadrant where the point of interest is situated obtain the Barycentric coordinates and the HRIR of the orientation of interest (azimuth, elevation)
 		if (azimuth >= azimuth_ptoP)
@@ -1130,59 +1392,6 @@ namespace Binaural
 		return newHRIR;
 	}
 
-	const std::vector<CMonoBuffer<float>> CHRTF::GetHRIR_partitioned_InterpolationMethod(Common::T_ear ear, float _azimuth, float _elevation) const
-	{
-		std::vector<CMonoBuffer<float>> newHRIR;
-		TBarycentricCoordinatesStruct barycentricCoordinates;
-		orientation orientation_ptoA, orientation_ptoB, orientation_ptoC, orientation_ptoD, orientation_ptoP;
-
-		//Calculate the quadrant points A, B, C and D and the middle quadrant point P
-		orientation_ptoC.azimuth = trunc(_azimuth / resamplingStep) * resamplingStep;
-		orientation_ptoC.elevation = trunc(_elevation / resamplingStep)*resamplingStep;
-		orientation_ptoA.azimuth = orientation_ptoC.azimuth;
-		orientation_ptoA.elevation = orientation_ptoC.elevation + resamplingStep;
-		orientation_ptoB.azimuth = orientation_ptoC.azimuth + resamplingStep;
-		orientation_ptoB.elevation = orientation_ptoC.elevation + resamplingStep;
-		orientation_ptoD.azimuth = orientation_ptoC.azimuth + resamplingStep;
-		orientation_ptoD.elevation = orientation_ptoC.elevation;
-		orientation_ptoP.azimuth = orientation_ptoC.azimuth + (resamplingStep * 0.5f);
-		float azimuth_ptoP = orientation_ptoC.azimuth + (resamplingStep * 0.5f);
-		float elevation_ptoP = orientation_ptoC.elevation + (resamplingStep * 0.5f);
-
-		//Depend on the quadrant where the point of interest is situated obtain the Barycentric coordinates and the HRIR of the orientation of interest (azimuth, elevation)
-		if (_azimuth >= azimuth_ptoP)
-		{
-			if (_elevation >= elevation_ptoP)
-			{
-				//Second quadrant
-				barycentricCoordinates = GetBarycentricCoordinates(_azimuth, _elevation, orientation_ptoA.azimuth, orientation_ptoA.elevation, orientation_ptoB.azimuth, orientation_ptoB.elevation, orientation_ptoD.azimuth, orientation_ptoD.elevation);
-				newHRIR = CalculateHRIR_partitioned_FromBarycentricCoordinates(ear, barycentricCoordinates, orientation_ptoA, orientation_ptoB, orientation_ptoD);
-			}
-			else if (_elevation < elevation_ptoP)
-			{
-				//Forth quadrant
-				barycentricCoordinates = GetBarycentricCoordinates(_azimuth, _elevation, orientation_ptoB.azimuth, orientation_ptoB.elevation, orientation_ptoC.azimuth, orientation_ptoC.elevation, orientation_ptoD.azimuth, orientation_ptoD.elevation);
-				newHRIR = CalculateHRIR_partitioned_FromBarycentricCoordinates(ear, barycentricCoordinates, orientation_ptoB, orientation_ptoC, orientation_ptoD);
-			}
-		}
-		else if (_azimuth < azimuth_ptoP)
-		{
-			if (_elevation >= elevation_ptoP)
-			{
-				//First quadrant
-				barycentricCoordinates = GetBarycentricCoordinates(_azimuth, _elevation, orientation_ptoA.azimuth, orientation_ptoA.elevation, orientation_ptoB.azimuth, orientation_ptoB.elevation, orientation_ptoC.azimuth, orientation_ptoC.elevation);
-				newHRIR = CalculateHRIR_partitioned_FromBarycentricCoordinates(ear, barycentricCoordinates, orientation_ptoA, orientation_ptoB, orientation_ptoC);
-			}
-			else if (_elevation < elevation_ptoP) {
-				//Third quadrant
-				barycentricCoordinates = GetBarycentricCoordinates(_azimuth, _elevation, orientation_ptoA.azimuth, orientation_ptoA.elevation, orientation_ptoC.azimuth, orientation_ptoC.elevation, orientation_ptoD.azimuth, orientation_ptoD.elevation);
-				newHRIR = CalculateHRIR_partitioned_FromBarycentricCoordinates(ear, barycentricCoordinates, orientation_ptoA, orientation_ptoC, orientation_ptoD);
-			}
-		}
-		//SET_RESULT(RESULT_OK, "GetHRIR_partitioned_InterpolationMethod completed succesfully");
-		return newHRIR;
-		}
-
 	const oneEarHRIR_struct CHRTF::CalculateHRIRFromBarycentricCoordinates(Common::T_ear ear, TBarycentricCoordinatesStruct barycentricCoordinates, orientation orientation_pto1, orientation orientation_pto2, orientation orientation_pto3)const
 	{
 		oneEarHRIR_struct newHRIR;
@@ -1199,11 +1408,11 @@ namespace Binaural
 			if (orientation_pto2.elevation == 360) { orientation_pto2.elevation = 0; }
 			if (orientation_pto3.elevation == 360) { orientation_pto3.elevation = 0; }		
 			// Find the HRIR for the specific orientations
-			auto it1 = t_HRTF_Resampled_frequency.find(orientation(orientation_pto1.azimuth, orientation_pto1.elevation));
-			auto it2 = t_HRTF_Resampled_frequency.find(orientation(orientation_pto2.azimuth, orientation_pto2.elevation));
-			auto it3 = t_HRTF_Resampled_frequency.find(orientation(orientation_pto3.azimuth, orientation_pto3.elevation));
+			auto it1 = asset->t_HRTF_Resampled_frequency.find(orientation(orientation_pto1.azimuth, orientation_pto1.elevation));
+			auto it2 = asset->t_HRTF_Resampled_frequency.find(orientation(orientation_pto2.azimuth, orientation_pto2.elevation));
+			auto it3 = asset->t_HRTF_Resampled_frequency.find(orientation(orientation_pto3.azimuth, orientation_pto3.elevation));
 
-			if (it1 != t_HRTF_Resampled_frequency.end() && it2 != t_HRTF_Resampled_frequency.end() && it3 != t_HRTF_Resampled_frequency.end())
+			if (it1 != asset->t_HRTF_Resampled_frequency.end() && it2 != asset->t_HRTF_Resampled_frequency.end() && it3 != asset->t_HRTF_Resampled_frequency.end())
 			{
 				size = it1->second.leftHRIR.size();
 				newHRIR.HRIR.resize(size, 0.0f);
@@ -1241,188 +1450,187 @@ namespace Binaural
 		return newHRIR;
 	}
 
-	const std::vector<CMonoBuffer<float>> CHRTF::CalculateHRIR_partitioned_FromBarycentricCoordinates(Common::T_ear ear, TBarycentricCoordinatesStruct barycentricCoordinates, orientation orientation_pto1, orientation orientation_pto2, orientation orientation_pto3)const
+	bool CHRTF::FindHRIR_partitioned_Triangle(const CHRTFAsset & _asset, float _azimuth, float _elevation, bool runTimeInterpolation, THRTFInterpolationTriangleStruct & triangle) const
 	{
-		std::vector<CMonoBuffer<float>> newHRIR;
-
-		if (barycentricCoordinates.alpha >= 0.0f && barycentricCoordinates.beta >= 0.0f && barycentricCoordinates.gamma >= 0.0f)
+		int orientationIndex;
+		if (runTimeInterpolation)
 		{
-			// HRTF table does not contain data for azimuth = 360, which has the same values as azimuth = 0, for every elevation
-			if (orientation_pto1.azimuth == 360) { orientation_pto1.azimuth = 0; }
-			if (orientation_pto2.azimuth == 360) { orientation_pto2.azimuth = 0; }
-			if (orientation_pto3.azimuth == 360) { orientation_pto3.azimuth = 0; }
-			if (orientation_pto1.elevation == 360) { orientation_pto1.elevation = 0; }
-			if (orientation_pto2.elevation == 360) { orientation_pto2.elevation = 0; }
-			if (orientation_pto3.elevation == 360) { orientation_pto3.elevation = 0; }
-
-			// Find the HRIR for the given orientations
-			auto it1 = t_HRTF_Resampled_partitioned.find(orientation(orientation_pto1.azimuth, orientation_pto1.elevation));
-			auto it2 = t_HRTF_Resampled_partitioned.find(orientation(orientation_pto2.azimuth, orientation_pto2.elevation));
-			auto it3 = t_HRTF_Resampled_partitioned.find(orientation(orientation_pto3.azimuth, orientation_pto3.elevation));
+			if (Common::CMagnitudes::AreSame(_azimuth, sphereBorder, epsilon_sewing)) { _azimuth = 0.0f; }
+			if (Common::CMagnitudes::AreSame(_elevation, sphereBorder, epsilon_sewing)) { _elevation = 0.0f; }
 
-			if (it1 != t_HRTF_Resampled_partitioned.end() && it2 != t_HRTF_Resampled_partitioned.end() && it3 != t_HRTF_Resampled_partitioned.end())
+			//If we are in the sphere poles, do not perform the interpolation (the HRIR value for this orientations have been calculated with a different method in the resampled methods, because our barycentric interpolation method doesn't work in the poles)
+			int ielevation = static_cast<int>(round(_elevation));
+			if ((ielevation == 90) || (ielevation == 270))
+			{
+				//In the sphere poles the azimuth is always 0 degrees
+				orientationIndex = _asset.t_HRTF_Resampled_partitioned.GetOrientationIndex(0, ielevation);
+			}
+			else
 			{
-				int subfilterLength = HRIR_partitioned_SubfilterLength;
-				newHRIR.resize(HRIR_partitioned_NumberOfSubfilters);
+				//Run time interpolation ON
+				return _asset.t_HRTF_Resampled_interpolationLookup.FindTriangle(_azimuth, _elevation, triangle);
+			}
+		}
+		else
+		{
+			//Run time interpolation OFF
+			int nearestAzimuth = static_cast<int>(round(_azimuth / _asset.resamplingStep) * _asset.resamplingStep);
+			int nearestElevation = static_cast<int>(round(_elevation / _asset.resamplingStep) * _asset.resamplingStep);
+			// HRTF table does not contain data for azimuth = 360, which has the same values as azimuth = 0, for every elevation
+			if (nearestAzimuth == 360) { nearestAzimuth = 0; }
+			if (nearestElevation == 360) { nearestElevation = 0; }
+			// When elevation is 90 or 270 degrees, the HRIR value is the same one for every azimuth
+			if ((nearestElevation == 90) || (nearestElevation == 270)) { nearestAzimuth = 0; }
+			orientationIndex = _asset.t_HRTF_Resampled_partitioned.GetOrientationIndex(nearestAzimuth, nearestElevation);
+		}
 
-				if (ear == Common::T_ear::LEFT)
-				{
-					for (int subfilterID = 0; subfilterID < HRIR_partitioned_NumberOfSubfilters; subfilterID++) 
-					{
-						newHRIR[subfilterID].resize(subfilterLength);
-						for (int i = 0; i < subfilterLength; i++) 
-						{
-							newHRIR[subfilterID][i] = barycentricCoordinates.alpha * it1->second.leftHRIR_Partitioned[subfilterID][i] + barycentricCoordinates.beta * it2->second.leftHRIR_Partitioned[subfilterID][i] + barycentricCoordinates.gamma * it3->second.leftHRIR_Partitioned[subfilterID][i];
-						}
-					}
-				}
+		//One orientation, with all the weight
+		if (!_asset.t_HRTF_Resampled_partitioned.IsHRIRSet(orientationIndex)) { return false; }
+		triangle.orientationA = orientationIndex;
+		triangle.orientationB = orientationIndex;
+		triangle.orientationC = orientationIndex;
+		triangle.alpha = 1.0f;
+		triangle.beta = 0.0f;
+		triangle.gamma = 0.0f;
+		return true;
+	}
 
-				else if (ear == Common::T_ear::RIGHT)
-				{
-					for (int subfilterID = 0; subfilterID < HRIR_partitioned_NumberOfSubfilters; subfilterID++)
-					{
-						newHRIR[subfilterID].resize(subfilterLength, 0.0f);
-						for (int i = 0; i < subfilterLength; i++) 
-						{
-							newHRIR[subfilterID][i] = barycentricCoordinates.alpha * it1->second.rightHRIR_Partitioned[subfilterID][i] + barycentricCoordinates.beta * it2->second.rightHRIR_Partitioned[subfilterID][i] + barycentricCoordinates.gamma * it3->second.rightHRIR_Partitioned[subfilterID][i];
-						}
-					}
-				}
+	void CHRTF::CalculateHRIR_partitioned_FromTriangle(Common::T_ear ear, const THRTFInterpolationTriangleStruct & triangle, std::vector<CMonoBuffer<float>> & newHRIR) const
+	{
+		if (ear != Common::T_ear::LEFT && ear != Common::T_ear::RIGHT)
+		{
+			SET_RESULT(RESULT_WARNING, "Ear Type for calculating HRIR from Barycentric Coordinates is not valid");
+			newHRIR.clear();
+			return;
+		}
 
-				else {
-					SET_RESULT(RESULT_WARNING, "Ear Type for calculating HRIR from Barycentric Coordinates is not valid");
-				}
+		//Only one orientation, copy its HRIR
+		if (triangle.beta == 0.0f && triangle.gamma == 0.0f && triangle.alpha == 1.0f)
+		{
+			asset->t_HRTF_Resampled_partitioned.GetHRIR_Partitioned(triangle.orientationA, ear, newHRIR);
+			return;
+		}
 
-				//SET_RESULT(RESULT_OK, "CalculateHRIRFromBarycentricCoordinates completed succesfully");
-			}
-			else {
-				SET_RESULT(RESULT_WARNING, "Orientations in CalculateHRIR_partitioned_FromBarycentricCoordinates not found");
+		//The subfilters of the hybrid layout have different sizes
+		newHRIR.resize(asset->HRIR_partitioned_NumberOfSubfilters);
+		for (int subfilterID = 0; subfilterID < asset->HRIR_partitioned_NumberOfSubfilters; subfilterID++)
+		{
+			int subfilterLength = asset->t_HRTF_Resampled_partitioned.GetSubfilterLength(subfilterID);
+			const float* subfilter1 = asset->t_HRTF_Resampled_partitioned.GetSubfilter(triangle.orientationA, ear, subfilterID);
+			const float* subfilter2 = asset->t_HRTF_Resampled_partitioned.GetSubfilter(triangle.orientationB, ear, subfilterID);
+			const float* subfilter3 = asset->t_HRTF_Resampled_partitioned.GetSubfilter(triangle.orientationC, ear, subfilterID);
+			newHRIR[subfilterID].resize(subfilterLength);
+			for (int i = 0; i < subfilterLength; i++)
+			{
+				newHRIR[subfilterID][i] = triangle.alpha * subfilter1[i] + triangle.beta * subfilter2[i] + triangle.gamma * subfilter3[i];
 			}
 		}
-		else {
-			SET_RESULT(RESULT_WARNING, "No Barycentric coordinates Triangle in CalculateHRIR_partitioned_FromBarycentricCoordinates");
+		//SET_RESULT(RESULT_OK, "CalculateHRIR_partitioned_FromTriangle completed succesfully");
+	}
+
+	void CHRTF::GetHRIR_partitioned_ViewFromTriangle(const CHRTFAsset & _asset, Common::T_ear ear, const THRTFInterpolationTriangleStruct & triangle, float* scratchHRIR, TOneEarHRIRPartitionedView & view) const
+	{
+		//Only one orientation, the view points to the table
+		if (triangle.beta == 0.0f && triangle.gamma == 0.0f && triangle.alpha == 1.0f)
+		{
+			_asset.t_HRTF_Resampled_partitioned.GetHRIR_PartitionedView(triangle.orientationA, ear, view);
+			return;
 		}
 
-		return newHRIR;
+		_asset.t_HRTF_Resampled_partitioned.CalculateWeightedHRIR(triangle.orientationA, triangle.orientationB, triangle.orientationC, ear, triangle.alpha, triangle.beta, triangle.gamma, scratchHRIR);
+		_asset.t_HRTF_Resampled_partitioned.GetPartitionedView(scratchHRIR, 0, view);
 	}
-	
-	const float CHRTF::GetHRIRDelayInterpolationMethod(Common::T_ear ear, float _azimuth, float _elevation) const
+
+	uint64_t CHRTF::CalculateHRIRDelayFromTriangle(const CHRTFAsset & _asset, Common::T_ear ear, const THRTFInterpolationTriangleStruct & triangle) const
 	{
-		float newHRIRDelay;
-		TBarycentricCoordinatesStruct barycentricCoordinates;
-		orientation orientation_ptoA, orientation_ptoB, orientation_ptoC, orientation_ptoD, orientation_ptoP;
+		if (ear != Common::T_ear::LEFT && ear != Common::T_ear::RIGHT)
+		{
+			SET_RESULT(RESULT_WARNING, "Ear Type for calculating HRIR Delay from Barycentric Coordinates is not valid");
+			return 0;
+		}
 
-		//Calculate the quadrant points A, B, C and D and the middle quadrant point P
-		orientation_ptoC.azimuth = trunc(_azimuth / resamplingStep) * resamplingStep;
-		orientation_ptoC.elevation = trunc(_elevation / resamplingStep)*resamplingStep;
-		orientation_ptoA.azimuth = orientation_ptoC.azimuth;
-		orientation_ptoA.elevation = orientation_ptoC.elevation + resamplingStep;
-		orientation_ptoB.azimuth = orientation_ptoC.azimuth + resamplingStep;
-		orientation_ptoB.elevation = orientation_ptoC.elevation + resamplingStep;
-		orientation_ptoD.azimuth = orientation_ptoC.azimuth + resamplingStep;
-		orientation_ptoD.elevation = orientation_ptoC.elevation;
-		orientation_ptoP.azimuth = orientation_ptoC.azimuth + (resamplingStep * 0.5f);
-		float azimuth_ptoP = orientation_ptoC.azimuth + (resamplingStep * 0.5f);
-		float elevation_ptoP = orientation_ptoC.elevation + (resamplingStep * 0.5f);
+		//Only one orientation, copy its delay
+		if (triangle.beta == 0.0f && triangle.gamma == 0.0f && triangle.alpha == 1.0f)
+		{
+			return _asset.t_HRTF_Resampled_partitioned.GetDelay(triangle.orientationA, ear);
+		}
+		return static_cast <uint64_t> (round(triangle.alpha * _asset.t_HRTF_Resampled_partitioned.GetDelay(triangle.orientationA, ear) + triangle.beta * _asset.t_HRTF_Resampled_partitioned.GetDelay(triangle.orientationB, ear) + triangle.gamma * _asset.t_HRTF_Resampled_partitioned.GetDelay(triangle.orientationC, ear)));
+	}
 
-		//Depend on the quadrant where the point of interest is situated obtain the Barycentric coordinates and the HRIR of the orientation of interest (azimuth, elevation)
-		if (_azimuth >= azimuth_ptoP)
+	void CHRTF::GetHRIR_partitioned_BothEarsFromAsset(const CHRTFAsset & _asset, float _azimuthLeft, float _elevationLeft, float _azimuthRight, float _elevationRight, float _azimuthCenter, float _elevationCenter, bool runTimeInterpolation, float* scratchHRIRs, TOneEarHRIRPartitionedView & leftHRIR, TOneEarHRIRPartitionedView & rightHRIR) const
+	{
+		leftHRIR = TOneEarHRIRPartitionedView{ nullptr, nullptr, nullptr, 0, 0 };
+		rightHRIR = TOneEarHRIRPartitionedView{ nullptr, nullptr, nullptr, 0, 0 };
+		int HRIRLength = _asset.t_HRTF_Resampled_partitioned.GetHRIRLength();
+
+		//HRIRs, with the same triangle for both ears if they have the same direction
+		THRTFInterpolationTriangleStruct leftTriangle, rightTriangle;
+		bool leftFound = FindHRIR_partitioned_Triangle(_asset, _azimuthLeft, _elevationLeft, runTimeInterpolation, leftTriangle);
+		bool rightFound = leftFound;
+		if ((_azimuthRight == _azimuthLeft) && (_elevationRight == _elevationLeft)) { rightTriangle = leftTriangle; }
+		else { rightFound = FindHRIR_partitioned_Triangle(_asset, _azimuthRight, _elevationRight, runTimeInterpolation, rightTriangle); }
+
+		if (leftFound) { GetHRIR_partitioned_ViewFromTriangle(_asset, Common::T_ear::LEFT, leftTriangle, scratchHRIRs, leftHRIR); }
+		else { SET_RESULT(RESULT_ERROR_NOTSET, "GetHRIR_partitioned_BothEars: HRIR of the left ear not found"); }
+		if (rightFound) { GetHRIR_partitioned_ViewFromTriangle(_asset, Common::T_ear::RIGHT, rightTriangle, scratchHRIRs + HRIRLength, rightHRIR); }
+		else { SET_RESULT(RESULT_ERROR_NOTSET, "GetHRIR_partitioned_BothEars: HRIR of the right ear not found"); }
+
+		//Delays, with the same triangle for both ears
+		leftHRIR.delay = 0;
+		rightHRIR.delay = 0;
+		if (enableCustomizedITD)
 		{
-			if (_elevation >= elevation_ptoP)
-			{
-				//Second quadrant
-				barycentricCoordinates = GetBarycentricCoordinates(_azimuth, _elevation, orientation_ptoA.azimuth, orientation_ptoA.elevation, orientation_ptoB.azimuth, orientation_ptoB.elevation, orientation_ptoD.azimuth, orientation_ptoD.elevation);
-				newHRIRDelay = CalculateHRIRDelayFromBarycentricCoordinates(ear, barycentricCoordinates, orientation_ptoA, orientation_ptoB, orientation_ptoD);
-			}
-			else if (_elevation < elevation_ptoP)
-			{
-				//Forth quadrant
-				barycentricCoordinates = GetBarycentricCoordinates(_azimuth, _elevation, orientation_ptoB.azimuth, orientation_ptoB.elevation, orientation_ptoC.azimuth, orientation_ptoC.elevation, orientation_ptoD.azimuth, orientation_ptoD.elevation);
-				newHRIRDelay = CalculateHRIRDelayFromBarycentricCoordinates(ear, barycentricCoordinates, orientation_ptoB, orientation_ptoC, orientation_ptoD);
-			}
+			leftHRIR.delay = GetCustomizedDelay(_azimuthCenter, _elevationCenter, Common::T_ear::LEFT);
+			rightHRIR.delay = GetCustomizedDelay(_azimuthCenter, _elevationCenter, Common::T_ear::RIGHT);
 		}
-		else if (_azimuth < azimuth_ptoP)
+		else
 		{
-			if (_elevation >= elevation_ptoP)
+			THRTFInterpolationTriangleStruct centerTriangle;
+			if (FindHRIR_partitioned_Triangle(_asset, _azimuthCenter, _elevationCenter, runTimeInterpolation, centerTriangle))
 			{
-				//First quadrant
-				barycentricCoordinates = GetBarycentricCoordinates(_azimuth, _elevation, orientation_ptoA.azimuth, orientation_ptoA.elevation, orientation_ptoB.azimuth, orientation_ptoB.elevation, orientation_ptoC.azimuth, orientation_ptoC.elevation);
-				newHRIRDelay = CalculateHRIRDelayFromBarycentricCoordinates(ear, barycentricCoordinates, orientation_ptoA, orientation_ptoB, orientation_ptoC);
+				leftHRIR.delay = CalculateHRIRDelayFromTriangle(_asset, Common::T_ear::LEFT, centerTriangle);
+				rightHRIR.delay = CalculateHRIRDelayFromTriangle(_asset, Common::T_ear::RIGHT, centerTriangle);
 			}
-			else if (_elevation < elevation_ptoP) {
-				//Third quadrant
-				barycentricCoordinates = GetBarycentricCoordinates(_azimuth, _elevation, orientation_ptoA.azimuth, orientation_ptoA.elevation, orientation_ptoC.azimuth, orientation_ptoC.elevation, orientation_ptoD.azimuth, orientation_ptoD.elevation);
-				newHRIRDelay = CalculateHRIRDelayFromBarycentricCoordinates(ear, barycentricCoordinates, orientation_ptoA, orientation_ptoC, orientation_ptoD);
+			else
+			{
+				SET_RESULT(RESULT_ERROR_NOTSET, "GetHRIR_partitioned_BothEars: HRIR delay not found");
 			}
 		}
-		//SET_RESULT(RESULT_OK, "GetHRIR_partitioned_InterpolationMethod completed succesfully");
-		return newHRIRDelay;
 	}
-	
-	const float CHRTF::CalculateHRIRDelayFromBarycentricCoordinates(Common::T_ear ear, TBarycentricCoordinatesStruct barycentricCoordinates, orientation orientation_pto1, orientation orientation_pto2, orientation orientation_pto3)const
+
+	void CHRTF::CrossfadeHRIR_partitioned(const TOneEarHRIRPartitionedView & previousHRIR, float previousWeight, float* crossfadedHRIR, TOneEarHRIRPartitionedView & HRIR) const
 	{
-		float newHRIRDelay=0.0f;
+		//Both HRTFs have the same partition layout, otherwise the previous one is not kept
+		if ((HRIR.numberOfSubfilters == 0) || (previousHRIR.numberOfSubfilters != HRIR.numberOfSubfilters)) { return; }
 
-		if (barycentricCoordinates.alpha >= 0.0f && barycentricCoordinates.beta >= 0.0f && barycentricCoordinates.gamma >= 0.0f)
+		float currentWeight = 1.0f - previousWeight;
+		for (int subfilterID = 0; subfilterID < HRIR.numberOfSubfilters; subfilterID++)
 		{
-			// HRTF table does not contain data for azimuth = 360, which has the same values as azimuth = 0, for every elevation
-			if (orientation_pto1.azimuth == 360) { orientation_pto1.azimuth = 0; }
-			if (orientation_pto2.azimuth == 360) { orientation_pto2.azimuth = 0; }
-			if (orientation_pto3.azimuth == 360) { orientation_pto3.azimuth = 0; }
-			if (orientation_pto1.elevation == 360) { orientation_pto1.elevation = 0; }
-			if (orientation_pto2.elevation == 360) { orientation_pto2.elevation = 0; }
-			if (orientation_pto3.elevation == 360) { orientation_pto3.elevation = 0; }
-
-			// Find the HRIR for the given orientations
-			auto it1 = t_HRTF_Resampled_partitioned.find(orientation(orientation_pto1.azimuth, orientation_pto1.elevation));
-			auto it2 = t_HRTF_Resampled_partitioned.find(orientation(orientation_pto2.azimuth, orientation_pto2.elevation));
-			auto it3 = t_HRTF_Resampled_partitioned.find(orientation(orientation_pto3.azimuth, orientation_pto3.elevation));
-
-			if (it1 != t_HRTF_Resampled_partitioned.end() && it2 != t_HRTF_Resampled_partitioned.end() && it3 != t_HRTF_Resampled_partitioned.end())
+			const float* currentSubfilter = HRIR.HRIR + HRIR.subfilterOffsets[subfilterID];
+			const float* previousSubfilter = previousHRIR.HRIR + previousHRIR.subfilterOffsets[subfilterID];
+			float* crossfadedSubfilter = crossfadedHRIR + HRIR.subfilterOffsets[subfilterID];
+			for (int i = 0; i < HRIR.subfilterLengths[subfilterID]; i++)
 			{
-
-				if (ear == Common::T_ear::LEFT)
-				{
-					newHRIRDelay = static_cast <unsigned long> (round(barycentricCoordinates.alpha * it1->second.leftDelay + barycentricCoordinates.beta * it2->second.leftDelay + barycentricCoordinates.gamma * it3->second.leftDelay));
-				}
-
-				else if (ear == Common::T_ear::RIGHT)
-				{
-					newHRIRDelay = static_cast <unsigned long> (round(barycentricCoordinates.alpha * it1->second.rightDelay + barycentricCoordinates.beta * it2->second.rightDelay + barycentricCoordinates.gamma * it3->second.rightDelay));
-				}
-
-				else {
-					SET_RESULT(RESULT_WARNING, "Ear Type for calculating HRIR Delay from Barycentric Coordinates is not valid");
-				}
-
-				//SET_RESULT(RESULT_OK, "CalculateHRIRFromBarycentricCoordinates completed succesfully");
+				crossfadedSubfilter[i] = currentWeight * currentSubfilter[i] + previousWeight * previousSubfilter[i];
 			}
-			else {
-				SET_RESULT(RESULT_WARNING, "Orientations in CalculateHRIRDelayFromBarycentricCoordinates not found");
-			}
-		}
-		else {
-			SET_RESULT(RESULT_WARNING, "No Barycentric coordinates Triangle in CalculateHRIRDelayFromBarycentricCoordinates");
 		}
-
-		return newHRIRDelay;
+		uint64_t delay = static_cast<uint64_t>(round(currentWeight * HRIR.delay + previousWeight * previousHRIR.delay));
+		asset->t_HRTF_Resampled_partitioned.GetPartitionedView(crossfadedHRIR, delay, HRIR);
 	}
 
 	
-
-	
 	//   ITD Methods    
 	
 	void CHRTF::RemoveCommonDelay_HRTFDataBaseTable() 
 	{
 		//1. Init the minumun value with the fist value of the table
-		auto it0 = t_HRTF_DataBase.begin();
+		auto it0 = assetInSetup->t_HRTF_DataBase.begin();
 		unsigned long minimumDelayLeft = it0->second.leftDelay;		//Vrbl to store the minumun delay value for left ear
 		unsigned long minimumDelayRight = it0->second.rightDelay;	//Vrbl to store the minumun delay value for right ear
 
 		//2. Find the common delay
 		//Scan the whole table looking for the minimum delay for left and right ears
-		for (auto it = t_HRTF_DataBase.begin(); it != t_HRTF_DataBase.end(); it++) {
+		for (auto it = assetInSetup->t_HRTF_DataBase.begin(); it != assetInSetup->t_HRTF_DataBase.end(); it++) {
 			//Left ear
 			if (it->second.leftDelay < minimumDelayLeft) {
 				minimumDelayLeft = it->second.leftDelay;
@@ -1438,7 +1646,7 @@ namespace Binaural
 		//The common delay of each canal have been calculated and subtracted separately in order to correct the asymmetry of the measurement
 		if (minimumDelayRight != 0 || minimumDelayLeft != 0) 
 		{
-			for (auto it = t_HRTF_DataBase.begin(); it != t_HRTF_DataBase.end(); it++)
+			for (auto it = assetInSetup->t_HRTF_DataBase.begin(); it != assetInSetup->t_HRTF_DataBase.end(); it++)
 			{
 				it->second.leftDelay = it->second.leftDelay - minimumDelayLeft;		//Left ear
 				it->second.rightDelay = it->second.rightDelay - minimumDelayRight;	//Right ear
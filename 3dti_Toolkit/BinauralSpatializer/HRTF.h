@@ -30,12 +30,18 @@
 #include <utility>
 #include <list>
 #include <cstdint>
+#include <memory>
+#include <atomic>
 #include <BinauralSpatializer/Listener.h>
+#include <BinauralSpatializer/SphericalTriangulation.h>
+#include <BinauralSpatializer/HRTFPartitionedGrid.h>
+#include <BinauralSpatializer/HRTFInterpolationLookup.h>
 #include <Common/Buffer.h>
 #include <Common/ErrorHandler.h>
 #include <Common/Fprocessor.h>
 #include <Common/Magnitudes.h>
 #include <Common/CommonDefinitions.h>
+#include <Common/AsyncPublisher.h>
 
 
 #ifndef PI 
@@ -44,10 +50,19 @@
 #ifndef DEFAULT_RESAMPLING_STEP
 #define DEFAULT_RESAMPLING_STEP 5
 #endif
+#ifndef DEFAULT_RESAMPLING_THREADS
+#define DEFAULT_RESAMPLING_THREADS 0		// 0 means that it is chosen automatically (see SetHRTFResamplingThreads in CCore)
+#endif
+#ifndef MAX_AUTOMATIC_RESAMPLING_THREADS
+#define MAX_AUTOMATIC_RESAMPLING_THREADS 8	// Maximum number of threads used when the number of resampling threads is 0
+#endif
 
 #ifndef DEFAULT_HRTF_MEASURED_DISTANCE
 #define DEFAULT_HRTF_MEASURED_DISTANCE 1.95f
 #endif
+#ifndef DEFAULT_HRTF_CROSSFADE_BLOCKS
+#define DEFAULT_HRTF_CROSSFADE_BLOCKS 4		// Blocks of the crossfade from the previous HRTF to a new one loaded in the background
+#endif
 
 #define MAX_DISTANCE_BETWEEN_ELEVATIONS 5
 #define NUMBER_OF_PARTS 4 
@@ -86,8 +101,8 @@ struct THRIRStruct {
 struct THRIRPartitionedStruct {
 	uint64_t leftDelay;				///< Left delay, in number of samples
 	uint64_t rightDelay;			///< Right delay, in number of samples
-	std::vector<CMonoBuffer<float>> leftHRIR_Partitioned;	///< Left partitioned impulse response data
-	std::vector<CMonoBuffer<float>> rightHRIR_Partitioned;	///< Right partitioned impulse response data
+	std::vector<CMonoBuffer<float>> leftHRIR_Partitioned;	///< Left partitioned impulse response data, half spectrum (points 0 to N/2) of each subfilter
+	std::vector<CMonoBuffer<float>> rightHRIR_Partitioned;	///< Right partitioned impulse response data, half spectrum (points 0 to N/2) of each subfilter
 };
 
 /** \brief Type definition for an impulse response with the ITD removed and stored in a specific struct field
@@ -145,6 +160,7 @@ namespace Binaural
 {
 	class CCore;
 	class CListener;
+	class CHRTFAsset;
 
 	/** \details This class gets impulse response data to compose HRTFs and implements different algorithms to interpolate the HRIR functions.
 	*/
@@ -157,28 +173,22 @@ namespace Binaural
 		*	\details By default, customized ITD is switched off and resampling step is set to 5 degrees
 		*   \eh Nothing is reported to the error handler.
 		*/
-		CHRTF(CListener* _ownerListener) 	
-			:ownerListener{ _ownerListener }, enableCustomizedITD{ false }, resamplingStep{ DEFAULT_RESAMPLING_STEP }, HRIRLength{ 0 }, HRTFLoaded{ false }, setupInProgress{ false }, distanceOfMeasurement { DEFAULT_HRTF_MEASURED_DISTANCE }
-		{}
+		CHRTF(CListener* _ownerListener);
 
 		/** \brief Default Constructor
 		*	\details By default, customized ITD is switched off, resampling step is set to 5 degrees and listener is a null pointer
 		*   \eh Nothing is reported to the error handler.
 		*/
-		CHRTF()
-			:ownerListener{ nullptr }, enableCustomizedITD{ false }, resamplingStep{ DEFAULT_RESAMPLING_STEP }, HRIRLength{ 0 }, HRTFLoaded{ false }, setupInProgress{ false }, distanceOfMeasurement{ DEFAULT_HRTF_MEASURED_DISTANCE }
-		{}
+		CHRTF();
 
 		/** \brief Get size of each HRIR buffer
 		*	\retval size number of samples of each HRIR buffer for one ear
 		*   \eh Nothing is reported to the error handler.
 		*/
-		int32_t GetHRIRLength() const
-		{
-			return HRIRLength;
-		}
+		int32_t GetHRIRLength() const;
 
 		/** \brief Start a new HRTF configuration
+		*	\details The new HRTF is built apart from the one in use, which is still used by the audio processing until EndSetup
 		*	\param [in] _HRIRLength buffer size of the HRIR to be added		
 		*   \eh On success, RESULT_OK is reported to the error handler.
 		*       On error, an error code is reported to the error handler.
@@ -199,12 +209,22 @@ namespace Binaural
 		*/
 		void AddHRIR(float azimuth, float elevation, THRIRStruct && newHRIR);
 
-		/** \brief Stop the HRTF configuration		
+		/** \brief Stop the HRTF configuration, calculating the resampled tables of the new HRTF
+		*	\details The new HRTF replaces the one in use at once, or it is published to the audio thread if the asynchronous setup has been enabled (see EnableAsynchronousHRTFSetup).
+		*	In that case, an HRTF with another partition layout than the one in use is rejected
 		*   \eh On success, RESULT_OK is reported to the error handler.
 		*       On error, an error code is reported to the error handler.
 		*/
 		void EndSetup();
 
+		/** \brief Stop the HRTF configuration of a database that has already been processed, calculating only the resampled tables of the new HRTF
+		*	\details The database has to be the one of an HRTF after EndSetup (see GetRawHRTFTable), without the common delay and with the HRIRs of the poles,
+		*	for example the one saved into a flat file, so those steps are skipped. Otherwise it is the same as EndSetup
+		*   \eh On success, RESULT_OK is reported to the error handler.
+		*       On error, an error code is reported to the error handler.
+		*/
+		void EndSetupFromProcessedDatabase();
+
 		/** \brief Switch on ITD customization in accordance with the listener head radius
 		*   \eh Nothing is reported to the error handler.
 		*/
@@ -254,6 +274,60 @@ namespace Binaural
 		*/
 		float GetHRIRDelay(Common::T_ear ear, float _azimuthCenter, float _elevationCenter, bool runTimeInterpolation);
 
+		/** \brief Get the partitioned HRIRs and the delays of both ears in one call
+		*	\details The HRIR of each ear is got in the direction of that ear and both delays in the direction of the head center, as GetHRIR_partitioned and GetHRIRDelay do.
+		*	The orientations of the resampled table around each direction are found once, for both ears if they have the same direction, and for both delays.
+		*	\param [in] _azimuthLeft azimuth angle from the source and the listener left ear in degrees
+		*	\param [in] _elevationLeft elevation angle from the source and the listener left ear in degrees
+		*	\param [in] _azimuthRight azimuth angle from the source and the listener right ear in degrees
+		*	\param [in] _elevationRight elevation angle from the source and the listener right ear in degrees
+		*	\param [in] _azimuthCenter azimuth angle from the source and the listener head center in degrees
+		*	\param [in] _elevationCenter elevation angle from the source and the listener head center in degrees
+		*	\param [in] runTimeInterpolation switch run-time interpolation
+		*	\param [out] leftHRIR partitioned HRIR and delay of the left ear
+		*	\param [out] rightHRIR partitioned HRIR and delay of the right ear
+		*   \eh On error, an error code is reported to the error handler.
+		*       Warnings may be reported to the error handler.
+		*/
+		void GetHRIR_partitioned_BothEars(float _azimuthLeft, float _elevationLeft, float _azimuthRight, float _elevationRight, float _azimuthCenter, float _elevationCenter, bool runTimeInterpolation, TOneEarHRIRPartitionedStruct & leftHRIR, TOneEarHRIRPartitionedStruct & rightHRIR);
+
+		/** \brief Get read-only views of the partitioned HRIRs and the delays of both ears, without copying them nor allocating memory
+		*	\details The HRIRs and delays are the same ones as GetHRIR_partitioned_BothEars. The view of an HRIR that is not interpolated points to the resampled table,
+		*	and an interpolated HRIR is calculated into the buffer of the caller. The views are valid until the HRTF changes or the buffer is used again.
+		*	\param [in] _azimuthLeft azimuth angle from the source and the listener left ear in degrees
+		*	\param [in] _elevationLeft elevation angle from the source and the listener left ear in degrees
+		*	\param [in] _azimuthRight azimuth angle from the source and the listener right ear in degrees
+		*	\param [in] _elevationRight elevation angle from the source and the listener right ear in degrees
+		*	\param [in] _azimuthCenter azimuth angle from the source and the listener head center in degrees
+		*	\param [in] _elevationCenter elevation angle from the source and the listener head center in degrees
+		*	\param [in] runTimeInterpolation switch run-time interpolation
+		*	\param [in,out] scratchBuffer buffer of the caller for the interpolated HRIRs of both ears. It is only resized if it is smaller than needed, so memory is only allocated in the first call
+		*	\param [out] leftHRIR view of the partitioned HRIR and delay of the left ear, without subfilters if it is not found
+		*	\param [out] rightHRIR view of the partitioned HRIR and delay of the right ear, without subfilters if it is not found
+		*   \eh On error, an error code is reported to the error handler.
+		*       Warnings may be reported to the error handler.
+		*/
+		void GetHRIR_partitioned_BothEars(float _azimuthLeft, float _elevationLeft, float _azimuthRight, float _elevationRight, float _azimuthCenter, float _elevationCenter, bool runTimeInterpolation, Common::CAlignedVector<float> & scratchBuffer, TOneEarHRIRPartitionedView & leftHRIR, TOneEarHRIRPartitionedView & rightHRIR) const;
+
+		/** \brief Get read-only views of the partitioned HRIRs and the delays of both ears mixed from the previous HRTF and the current one, during the crossfade after a new HRTF has been adopted
+		*	\details The HRIRs and the delays of both HRTFs are got as GetHRIR_partitioned_BothEars does and mixed with linear weights into the buffer of the caller.
+		*	If the previous HRTF is not available (see IsPreviousHRTFAvailable), the views of the current one are returned.
+		*	\param [in] _azimuthLeft azimuth angle from the source and the listener left ear in degrees
+		*	\param [in] _elevationLeft elevation angle from the source and the listener left ear in degrees
+		*	\param [in] _azimuthRight azimuth angle from the source and the listener right ear in degrees
+		*	\param [in] _elevationRight elevation angle from the source and the listener right ear in degrees
+		*	\param [in] _azimuthCenter azimuth angle from the source and the listener head center in degrees
+		*	\param [in] _elevationCenter elevation angle from the source and the listener head center in degrees
+		*	\param [in] runTimeInterpolation switch run-time interpolation
+		*	\param [in] previousWeight weight of the previous HRTF, from 0 to 1. The current one has the rest
+		*	\param [in,out] scratchBuffer buffer of the caller for the HRIRs of both HRTFs and their mix. It is only resized if it is smaller than needed, so memory is only allocated in the first call
+		*	\param [out] leftHRIR view of the partitioned HRIR and delay of the left ear, without subfilters if it is not found
+		*	\param [out] rightHRIR view of the partitioned HRIR and delay of the right ear, without subfilters if it is not found
+		*   \eh On error, an error code is reported to the error handler.
+		*       Warnings may be reported to the error handler.
+		*/
+		void GetHRIR_partitioned_BothEars_Crossfaded(float _azimuthLeft, float _elevationLeft, float _azimuthRight, float _elevationRight, float _azimuthCenter, float _elevationCenter, bool runTimeInterpolation, float previousWeight, Common::CAlignedVector<float> & scratchBuffer, TOneEarHRIRPartitionedView & leftHRIR, TOneEarHRIRPartitionedView & rightHRIR) const;
+
 		/** \brief	Get the number of subfilters (blocks) in which the HRIR has been partitioned
 		*	\retval n Number of HRIR subfilters
 		*   \eh Nothing is reported to the error handler.
@@ -261,11 +335,26 @@ namespace Binaural
 		const int32_t GetHRIRNumberOfSubfilters() const;
 
 		/** \brief	Get the size of subfilters (blocks) in which the HRIR has been partitioned, every subfilter has the same size
+		*	\details Subfilters are stored in frequency domain as the half spectrum (points 0 to N/2) of an FFT of N = 2 * bufferSize points, so their size is N + 2.
+		*	With the hybrid layout, the size of the first subfilter (the FIR filter in time domain, bufferSize coefficients) is returned.
 		*	\retval size Size of HRIR subfilters
 		*   \eh Nothing is reported to the error handler.
 		*/
 		const int32_t GetHRIRSubfilterLength() const;
 
+		/** \brief	Get if the HRIRs have been partitioned with the hybrid layout of CHybridAnechoicStereo, instead of uniformly
+		*	\details The layout is chosen by the owner core when the table is calculated (see CCore::EnableHybridHRTFConvolution)
+		*	\retval hybrid true if the subfilters are the FIR filter of the first bufferSize coefficients followed by partitions of increasing size
+		*   \eh Nothing is reported to the error handler.
+		*/
+		bool IsHybridPartitioned() const;
+
+		/** \brief	Get the number of partitions of each segment of the hybrid layout
+		*	\retval partitionsPerSegment number of partitions of each segment, 0 if the HRIRs have been partitioned uniformly
+		*   \eh Nothing is reported to the error handler.
+		*/
+		int GetHybridPartitionsPerSegment() const;
+
 		/** \brief	Get if the HRTF has been loaded
 		*	\retval isLoadead bool var that is true if the HRTF has been loaded
 		*   \eh Nothing is reported to the error handler.
@@ -292,6 +381,84 @@ namespace Binaural
 		*   \eh Nothing is reported to the error handler.
 		*/
 		float GetHRTFDistanceOfMeasurement();
+
+		/** \brief	Get the distance where the HRTF used by the audio thread has been measured
+		*	\details With the asynchronous setup enabled, it is not the one of the last HRTF loaded until the audio thread adopts it (see ApplyPublishedHRTF),
+		*	so this is the one to call from the audio thread
+		*   \return distance of the speakers structure to calculate the HRTF in use
+		*   \eh Nothing is reported to the error handler.
+		*/
+		float GetHRTFInUseDistanceOfMeasurement() const;
+
+		/** \brief Get the data of the loaded HRTF, to share it with other listeners
+		*	\details The asset is not modified after it has been set up, so it can be passed to SetHRTFAsset of listeners of this core or other cores,
+		*	which then use the same tables without copying them. With the asynchronous setup enabled, it is the last HRTF loaded, even if the audio thread has not adopted it yet.
+		*	\retval asset shared pointer to the HRTF data, nullptr if the HRTF has not been loaded
+		*   \eh Nothing is reported to the error handler.
+		*/
+		std::shared_ptr<const CHRTFAsset> GetHRTFAsset() const;
+
+		/** \brief Use the data of an HRTF already loaded by another listener, instead of loading it again
+		*	\details The customized ITD and the head radius are still those of this listener. If the asset has been calculated for a different buffer size,
+		*	resampling step or partition layout than the ones of the owner core, its resampled tables are calculated again from its database for this listener only.
+		*	\param [in] newAsset data of the HRTF, got from GetHRTFAsset of another listener
+		*   \eh On success, RESULT_OK is reported to the error handler.
+		*       On error, an error code is reported to the error handler.
+		*       Warnings may be reported to the error handler.
+		*/
+		void SetHRTFAsset(std::shared_ptr<const CHRTFAsset> newAsset);
+
+		/** \brief Load the next HRTFs in a background thread, without interrupting the audio processing
+		*	\details BeginSetup, AddHRIR and EndSetup (or SetHRTFAsset) can then be called from a thread other than the audio thread. The new tables are built apart
+		*	and published when they are ready, and the audio thread adopts them at the beginning of its next block (see ApplyPublishedHRTF), meanwhile it renders with the previous HRTF.
+		*	Only an HRTF with the same partition layout (HRIR length and subfilters) as the previous one is published: the convolution buffers are kept and each source crossfades
+		*	from the previous HRIRs to the new ones during crossfadeBlocks blocks. An HRTF with another partition layout is rejected with an error and the one in use is kept;
+		*	to load it, disable the asynchronous setup with the audio processing stopped. The first HRTF replaces the one in use at once and sets up the convolution buffers,
+		*	as with the asynchronous setup disabled, so it needs the audio processing to be stopped.
+		*	The tables that are not used any more are freed by the thread that publishes the next HRTF, never by the audio thread.
+		*	Changes of the owner core configuration (buffer size, resampling step, partition layout) still calculate the tables at once, so they need the audio processing to be stopped.
+		*	\param [in] crossfadeBlocks number of blocks of the crossfade, 0 to switch to the new HRIRs in one block
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void EnableAsynchronousHRTFSetup(int crossfadeBlocks = DEFAULT_HRTF_CROSSFADE_BLOCKS);
+
+		/** \brief Replace the HRTF in use at once in EndSetup and SetHRTFAsset, as by default
+		*	\details An HRTF published and not adopted yet is adopted now, so this should be called when the audio processing is stopped.
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void DisableAsynchronousHRTFSetup();
+
+		/** \brief Get whether the new HRTFs are published to the audio thread instead of replacing the one in use at once
+		*	\retval enabled true if the asynchronous setup has been enabled
+		*   \eh Nothing is reported to the error handler.
+		*/
+		bool IsAsynchronousHRTFSetupEnabled() const;
+
+		/** \brief Adopt the last HRTF published by EndSetup or SetHRTFAsset with the asynchronous setup enabled, if there is one
+		*	\details Called from the audio thread at the beginning of each block by CCore::ProcessAnechoic and CSingleSourceDSP::ProcessAnechoic. It does not wait for the thread that publishes
+		*	nor free memory, and it keeps the convolution buffers, since only HRTFs with the partition layout of the one in use are published.
+		*	An HRTF calculated for another buffer size, resampling step or partition layout than the ones of the owner core is discarded.
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void ApplyPublishedHRTF();
+
+		/** \brief Get the number of times that the HRTF in use has been replaced, so the sources can detect when their HRIRs have to be got again
+		*	\retval version number of HRTFs adopted
+		*   \eh Nothing is reported to the error handler.
+		*/
+		uint32_t GetHRTFVersion() const;
+
+		/** \brief Get whether the tables of the HRTF used before the current one are kept to crossfade from them
+		*	\retval available true if the last HRTF has been adopted with the asynchronous setup, crossfade blocks and the same partition layout as the previous one
+		*   \eh Nothing is reported to the error handler.
+		*/
+		bool IsPreviousHRTFAvailable() const;
+
+		/** \brief Get the number of blocks of the crossfade from the previous HRTF to a new one
+		*	\retval crossfadeBlocks number of blocks, 0 if there is no crossfade
+		*   \eh Nothing is reported to the error handler.
+		*/
+		int GetHRTFCrossfadeBlocks() const;
 		
 
 	private:
@@ -299,28 +466,40 @@ namespace Binaural
 		// ATTRIBUTES
 		///////////////
 		CListener* ownerListener;						// owner Listener
-		int32_t HRIRLength;								// HRIR vector length
-		int32_t bufferSize;								// Input signal buffer size
 		//int32_t sampleRate;							// Sample Rate		
-		int32_t HRIR_partitioned_NumberOfSubfilters;	// Number of subfilters (blocks) for the UPC algorithm
-		int32_t HRIR_partitioned_SubfilterLength;		// Size of one HRIR subfilter
-		float distanceOfMeasurement;					//Distance where the HRIR have been measurement
 
 		float sphereBorder;						// Define spheere "sewing"
 		float epsilon_sewing = 0.001f;
 
 		bool setupInProgress;						// Variable that indicates the HRTF add and resample algorithm are in process
-		bool HRTFLoaded;							// Variable that indicates if the HRTF has been loaded correctly
+		std::atomic<bool> HRTFLoaded;				// Variable that indicates if the HRTF has been loaded correctly
 		bool bInterpolatedResampleTable;			// If true: calculate the HRTF resample matrix with interpolation
-		int resamplingStep; 						// HRTF Resample table step (azimuth and elevation)
+		int resamplingThreads;						// Number of threads that calculate the resampled table, 0 to choose it automatically
 		bool enableCustomizedITD;					// Indicate the use of a customized delay
 
 
 
-		// HRTF tables			
-		T_HRTFTable				t_HRTF_DataBase;
-		T_HRTFTable				t_HRTF_Resampled_frequency;
-		T_HRTFPartitionedTable	t_HRTF_Resampled_partitioned;
+		// HRTF tables and their parameters, which can be shared with other listeners
+		std::shared_ptr<const CHRTFAsset>	asset;			// Data of the loaded HRTF, never null
+		std::shared_ptr<CHRTFAsset>			assetInSetup;	// Data of the HRTF between BeginSetup and EndSetup, not shared yet
+		std::shared_ptr<const CHRTFAsset>	previousAsset;	// Data of the HRTF used before the current one, kept by the audio thread to crossfade from it
+		std::shared_ptr<const CHRTFAsset>	lastAsset;		// Data of the last HRTF used or published, never null and only read by the thread that loads the HRTFs, the same as asset if the asynchronous setup is disabled
+
+		// Partition layout of the HRTF in use, the same for every HRTF published to the audio thread, so both threads can read it
+		int32_t layoutHRIRLength;
+		int32_t layoutNumberOfSubfilters;
+		int32_t layoutSubfilterLength;
+		int layoutHybridPartitionsPerSegment;
+
+		// Setup in a background thread
+		bool enableAsynchronousSetup;							// The new HRTFs are published to the audio thread instead of replacing the one in use
+		int HRTFCrossfadeBlocks;								// Number of blocks of the crossfade from the previous HRTF to a new one
+		std::atomic<uint32_t> HRTFVersion;						// Number of times that the HRTF in use has been replaced
+		Common::CAsyncPublisher<CHRTFAsset> assetPublisher;		// New HRTFs waiting for the audio thread, and the ones it may release
+
+		// Triangulation of the orientations of t_HRTF_DataBase, to find the triangle around each orientation of the resampled tables
+		CSphericalTriangulation		dataBaseTriangulation;
+		std::vector<orientation>	dataBaseTriangulationVertices;		// Orientation of each vertex of the triangulation
 
 		// Empty object to return in some methods
 		THRIRStruct						emptyHRIR;
@@ -344,10 +523,24 @@ namespace Binaural
 		//param resamplingStep	HRTF resample matrix step for both azimuth and elevation
 		void CalculateResampled_HRTFTable(int resamplingStep);
 
+		//	Calculate the HRIR of one orientation of the resampled table, copied from the database or interpolated, and split it in subfilters. Called by several threads at once
+		//param newOrientation	orientation of the resampled table
+#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC
+		void CalculateResampledHRIR(orientation newOrientation, THRIRStruct & newHRIR);
+#else
+		void CalculateResampledHRIR(orientation newOrientation, THRIRPartitionedStruct & newHRIR_partitioned);
+
+		//	Copy the HRIRs of one orientation into its slot of the resampled grid. Called by several threads at once
+		void SetResampledHRIR(orientation newOrientation, const THRIRPartitionedStruct & newHRIR_partitioned);
+#endif
+
 		//	Split the input HRIR data in subfilters and get the FFT to apply the UPC algorithm
 		//param	newData_time	HRIR value in time domain
 		THRIRPartitionedStruct SplitAndGetFFT_HRTFData(const THRIRStruct & newData_time);
 
+		//	Choose the layout of the partitioned table, uniform or hybrid depending on the owner core, and calculate its number of subfilters
+		void CalculatePartitionLayout();
+
 		//		Calculate the distance between two points [(azimuth1, elevation1) and (azimuth2, elevation2)] using the Haversine formula
 		//return	float	the distance value
 		float CalculateDistance_HaversineFormula(float azimuth1, float elevation1, float azimuth2, float elevation2);
@@ -357,6 +550,12 @@ namespace Binaural
 		//param newElevation	elevation of the orientation of interest (the one whose HRIR will be calculated)
 		THRIRStruct CalculateHRIR_offlineMethod(int newAzimuth, int newElevation);
 
+		//	Triangulate the orientations of the database table, once before calculating the resampled tables
+		void CalculateDataBaseTriangulation();
+
+		//	Calculate the HRIR of the database table in one orientation from the barycentric coordinates of the three orientations of a triangle around it
+		THRIRStruct CalculateHRIR_FromDataBase(const TBarycentricCoordinatesStruct & barycentricCoordinates, orientation orientation_pto1, orientation orientation_pto2, orientation orientation_pto3);
+
 		//		Calculate the barycentric coordinates of three vertex [(x1,y1), (x2,y2), (x3,y3)] and the orientation of interest (x,y)
 		const TBarycentricCoordinatesStruct GetBarycentricCoordinates(float newAzimuth, float newElevation, float x1, float y1, float x2, float y2, float x3, float y3) const;
 
@@ -377,20 +576,28 @@ namespace Binaural
 		//	Get HRIR from resample table using a barycentric interpolation of the three nearest orientation.
 		const oneEarHRIR_struct GetHRIR_InterpolationMethod(Common::T_ear ear, int azimuth, int elevation) const;
 
-		//	Calculate from resample table HRIR subfilters using a barycentric interpolation of the three nearest orientation.
-		const std::vector<CMonoBuffer<float>> GetHRIR_partitioned_InterpolationMethod(Common::T_ear ear, float _azimuth, float _elevation) const;
-
 		//	Calculate HRIR using a barycentric coordinates of the three nearest orientation.
 		const oneEarHRIR_struct CalculateHRIRFromBarycentricCoordinates(Common::T_ear ear, TBarycentricCoordinatesStruct barycentricCoordinates, orientation orientation_pto1, orientation orientation_pto2, orientation orientation_pto3) const;
 
-		//	Calculate HRIR subfilters using a barycentric coordinates of the three nearest orientation.
-		const std::vector<CMonoBuffer<float>> CalculateHRIR_partitioned_FromBarycentricCoordinates(Common::T_ear ear, TBarycentricCoordinatesStruct barycentricCoordinates, orientation orientation_pto1, orientation orientation_pto2, orientation orientation_pto3)const;
+		//	Find the orientations of the partitioned resampled table of one asset, the current one or the previous one, and their weights to get the HRIR of one direction:
+		//	the three orientations around it with run-time interpolation, or the nearest one without it
+		//return	false if the orientations are not in the table
+		bool FindHRIR_partitioned_Triangle(const CHRTFAsset & _asset, float _azimuth, float _elevation, bool runTimeInterpolation, THRTFInterpolationTriangleStruct & triangle) const;
 
-		//	Calculate HRIR DELAY using intepolation of the three nearest orientation, in number of samples
-		const float GetHRIRDelayInterpolationMethod(Common::T_ear ear, float _azimuth, float _elevation) const;
-		
-		//	Calculate HRIR DELAY using a barycentric coordinates of the three nearest orientation, in number of samples
-		const float CalculateHRIRDelayFromBarycentricCoordinates(Common::T_ear ear, TBarycentricCoordinatesStruct barycentricCoordinates, orientation orientation_pto1, orientation orientation_pto2, orientation orientation_pto3)const;
+		//	Calculate HRIR subfilters of one ear using the barycentric coordinates of the three orientations of one triangle of the partitioned resampled table
+		void CalculateHRIR_partitioned_FromTriangle(Common::T_ear ear, const THRTFInterpolationTriangleStruct & triangle, std::vector<CMonoBuffer<float>> & newHRIR) const;
+
+		//	Get a view of the HRIR subfilters of one ear from one triangle of the partitioned resampled table of one asset, calculating them into scratchHRIR if they have to be interpolated
+		void GetHRIR_partitioned_ViewFromTriangle(const CHRTFAsset & _asset, Common::T_ear ear, const THRTFInterpolationTriangleStruct & triangle, float* scratchHRIR, TOneEarHRIRPartitionedView & view) const;
+
+		//	Calculate HRIR DELAY of one ear using the barycentric coordinates of the three orientations of one triangle of the partitioned resampled table of one asset, in number of samples
+		uint64_t CalculateHRIRDelayFromTriangle(const CHRTFAsset & _asset, Common::T_ear ear, const THRTFInterpolationTriangleStruct & triangle) const;
+
+		//	Get the views of the HRIRs and the delays of both ears from the tables of one asset, interpolating them into scratchHRIRs (room for both ears)
+		void GetHRIR_partitioned_BothEarsFromAsset(const CHRTFAsset & _asset, float _azimuthLeft, float _elevationLeft, float _azimuthRight, float _elevationRight, float _azimuthCenter, float _elevationCenter, bool runTimeInterpolation, float* scratchHRIRs, TOneEarHRIRPartitionedView & leftHRIR, TOneEarHRIRPartitionedView & rightHRIR) const;
+
+		//	Mix the HRIR of one ear of the previous HRTF into the view of the current one, writing the result into crossfadedHRIR with the layout of the current table
+		void CrossfadeHRIR_partitioned(const TOneEarHRIRPartitionedView & previousHRIR, float previousWeight, float* crossfadedHRIR, TOneEarHRIRPartitionedView & HRIR) const;
 		
 		//		Calculate and remove the common delay of every HRIR functions of the DataBase Table. Off line Method, called from EndSetUp()
 		void RemoveCommonDelay_HRTFDataBaseTable();
@@ -407,6 +614,30 @@ namespace Binaural
 		// Reset HRTF
 		void Reset();
 
+		// Check if the tables of one asset have been calculated with the buffer size, resampling step and partition layout of the owner core
+		bool IsAssetCompatible(const CHRTFAsset & _asset) const;
+
+		// Check if the partitioned HRIRs of two assets have the same subfilters, so the convolution buffers set up for one of them are valid for the other one
+		bool HaveSamePartitionLayout(const CHRTFAsset & asset1, const CHRTFAsset & asset2) const;
+
+		// Keep the partition layout of the asset in use, which is only replaced with the audio processing stopped
+		void SetLayoutInUse(const CHRTFAsset & _asset);
+
+		// Start the setup of a new asset with the database of another one, to calculate its tables for the current configuration of the owner core
+		void BeginSetupFromAsset(const CHRTFAsset & databaseAsset);
+
+		// Finish the setup of the asset in setup and replace the HRTF in use with it, processing its database first if it has not been processed yet
+		void FinishSetup(bool processedDatabase);
+
+		// Calculate the resampled tables of the asset in setup from its database. The common delay and the poles are skipped if the database has already been processed
+		void CalculateAssetInSetup(bool processedDatabase);
+
+		// Replace the HRTF in use at once with a new one, setting up the convolution buffers
+		void SetAssetInUse(std::shared_ptr<const CHRTFAsset> newAsset);
+
+		// Replace the HRTF in use with a new one, at once or through the audio thread if the asynchronous setup has been enabled. It returns false if the new one has been rejected
+		bool ReplaceAsset(std::shared_ptr<const CHRTFAsset> newAsset);
+
 
 		friend class CListener;
 	};
@@ -0,0 +1,112 @@
+/**
+* \class CHRTFAsset
+*
+* \brief Definition of CHRTFAsset class.
+* \date	October 2026
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#include <BinauralSpatializer/HRTFAsset.h>
+#include <BinauralSpatializer/HybridAnechoicStereo.h>
+#include <cmath>
+
+namespace Binaural {
+	/////////////////////////////
+	// CONSTRUCTOR/DESTRUCTOR  //
+	/////////////////////////////
+	CHRTFAsset::CHRTFAsset()
+		:HRIRLength{ 0 }, bufferSize{ 0 }, HRIR_partitioned_NumberOfSubfilters{ 0 }, HRIR_partitioned_SubfilterLength{ 0 }, hybridPartitionsPerSegment{ 0 },
+		distanceOfMeasurement{ DEFAULT_HRTF_MEASURED_DISTANCE }, resamplingStep{ DEFAULT_RESAMPLING_STEP }
+	{
+	}
+
+	///////////////////
+	// Public Methods //
+	///////////////////
+
+	//Get if the tables of the asset have not been calculated
+	bool CHRTFAsset::IsEmpty() const
+	{
+#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC
+		return t_HRTF_Resampled_frequency.empty();
+#else
+		return t_HRTF_Resampled_partitioned.IsEmpty();
+#endif
+	}
+
+	//Check that the tables of the asset are consistent with each other and with its parameters
+	bool CHRTFAsset::IsValid() const
+	{
+		if (IsEmpty() || (HRIRLength <= 0) || (bufferSize <= 0) || (resamplingStep <= 0) || (hybridPartitionsPerSegment < 0)) { return false; }
+
+#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC
+		return true;
+#else
+		//The same partition layout that CHRTF calculates for the buffer size and the HRIR length
+		int numberOfSubfilters;
+		if (hybridPartitionsPerSegment > 0)
+		{
+			numberOfSubfilters = CHybridAnechoicStereo::GetNumberOfSubfilters(bufferSize, HRIRLength, hybridPartitionsPerSegment);
+		}
+		else
+		{
+			numberOfSubfilters = static_cast<int>(std::ceil((float)HRIRLength / (float)bufferSize));
+		}
+
+		return t_HRTF_Resampled_partitioned.IsValid() && (t_HRTF_Resampled_partitioned.GetResamplingStep() == resamplingStep) &&
+			(HRIR_partitioned_NumberOfSubfilters == numberOfSubfilters) && (t_HRTF_Resampled_partitioned.GetNumberOfSubfilters() == numberOfSubfilters) &&
+			(t_HRTF_Resampled_partitioned.GetSubfilterLength(0) == HRIR_partitioned_SubfilterLength) &&
+			t_HRTF_Resampled_interpolationLookup.IsValid(t_HRTF_Resampled_partitioned);
+#endif
+	}
+
+	//Get size of each HRIR buffer of the database
+	int32_t CHRTFAsset::GetHRIRLength() const
+	{
+		return HRIRLength;
+	}
+
+	//Get the buffer size the resampled tables have been partitioned for
+	int32_t CHRTFAsset::GetBufferSize() const
+	{
+		return bufferSize;
+	}
+
+	//Get the step of the resampled tables
+	int CHRTFAsset::GetResamplingStep() const
+	{
+		return resamplingStep;
+	}
+
+	//Get the number of partitions of each segment of the hybrid layout
+	int CHRTFAsset::GetHybridPartitionsPerSegment() const
+	{
+		return hybridPartitionsPerSegment;
+	}
+
+	//Get the distance where the HRTF has been measured
+	float CHRTFAsset::GetHRTFDistanceOfMeasurement() const
+	{
+		return distanceOfMeasurement;
+	}
+
+	//Get raw HRTF table
+	const T_HRTFTable & CHRTFAsset::GetRawHRTFTable() const
+	{
+		return t_HRTF_DataBase;
+	}
+}
@@ -0,0 +1,131 @@
+/**
+* \class CHRTFAsset
+*
+* \brief Declaration of CHRTFAsset class interface.
+* \date	October 2026
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#ifndef _CHRTFASSET_H_
+#define _CHRTFASSET_H_
+
+#include <BinauralSpatializer/HRTF.h>
+#include <BinauralSpatializer/HRTFPartitionedGrid.h>
+#include <BinauralSpatializer/HRTFInterpolationLookup.h>
+
+namespace Binaural {
+
+	/** \details This class holds the data of one HRTF that does not depend on the listener: the database table and the resampled tables calculated from it,
+	*	with the buffer size, resampling step and partition layout they have been calculated for.
+	*	\details An asset is filled by CHRTF between BeginSetup and EndSetup and it is not modified after that, so it is held by reference-counted pointers to const
+	*	and several listeners, of the same core or of different cores, can share it (see CHRTF::GetHRTFAsset and CHRTF::SetHRTFAsset). The memory is freed
+	*	when the last listener that uses it loads another HRTF or is destroyed. The state of each listener (customized ITD, head radius) is kept by its CHRTF.
+	*/
+	class CHRTFAsset
+	{
+
+	public:
+
+		/** \brief Default constructor, with empty tables
+		*   \eh Nothing is reported to the error handler.
+		*/
+		CHRTFAsset();
+
+		/** \brief Get if the tables of the asset have not been calculated
+		*	\retval isEmpty true if the asset has not been set up
+		*   \eh Nothing is reported to the error handler.
+		*/
+		bool IsEmpty() const;
+
+		/** \brief Check that the tables of the asset are consistent with each other and with its buffer size, resampling step and partition layout
+		*	\details An asset loaded from a cache file (see HRTFCache.h of the resource manager) has to be checked before setting it in a listener,
+		*	since the audio thread indexes its tables without checking them again
+		*	\retval isValid true if the tables have been calculated and all their sizes and indices are consistent
+		*   \eh Nothing is reported to the error handler.
+		*/
+		bool IsValid() const;
+
+		/** \brief Get size of each HRIR buffer of the database
+		*	\retval size number of samples of each HRIR buffer for one ear
+		*   \eh Nothing is reported to the error handler.
+		*/
+		int32_t GetHRIRLength() const;
+
+		/** \brief Get the buffer size the resampled tables have been partitioned for
+		*	\retval bufferSize input signal buffer size
+		*   \eh Nothing is reported to the error handler.
+		*/
+		int32_t GetBufferSize() const;
+
+		/** \brief Get the step of the resampled tables
+		*	\retval resamplingStep step for both azimuth and elevation, in degrees
+		*   \eh Nothing is reported to the error handler.
+		*/
+		int GetResamplingStep() const;
+
+		/** \brief	Get the number of partitions of each segment of the hybrid layout
+		*	\retval partitionsPerSegment number of partitions of each segment, 0 if the HRIRs have been partitioned uniformly
+		*   \eh Nothing is reported to the error handler.
+		*/
+		int GetHybridPartitionsPerSegment() const;
+
+		/** \brief	Get the distance where the HRTF has been measured
+		*   \return distance of the speakers structure to calculate the HRTF
+		*   \eh Nothing is reported to the error handler.
+		*/
+		float GetHRTFDistanceOfMeasurement() const;
+
+		/** \brief Get raw HRTF table
+		*	\retval table raw HRTF table
+		*   \eh Nothing is reported to the error handler.
+		*/
+		const T_HRTFTable & GetRawHRTFTable() const;
+
+		/** \brief Save or load the whole asset with an archive of the cereal library, to cache it on disk (see HRTFCache.h of the resource manager)
+		*	\details A loaded asset can be set in a listener with CHRTF::SetHRTFAsset, without calculating its tables again
+		*	\param [in,out] ar archive
+		*   \eh Nothing is reported to the error handler.
+		*/
+		template <class Archive>
+		void serialize(Archive & ar)
+		{
+			ar(HRIRLength, bufferSize, HRIR_partitioned_NumberOfSubfilters, HRIR_partitioned_SubfilterLength, hybridPartitionsPerSegment, distanceOfMeasurement, resamplingStep,
+				t_HRTF_DataBase, t_HRTF_Resampled_frequency, t_HRTF_Resampled_partitioned, t_HRTF_Resampled_interpolationLookup);
+		}
+
+	private:
+		///////////////
+		// ATTRIBUTES
+		///////////////
+		int32_t HRIRLength;								// HRIR vector length
+		int32_t bufferSize;								// Input signal buffer size
+		int32_t HRIR_partitioned_NumberOfSubfilters;	// Number of subfilters (blocks) for the UPC algorithm
+		int32_t HRIR_partitioned_SubfilterLength;		// Size of one HRIR subfilter
+		int hybridPartitionsPerSegment;					// Partitions per segment of the hybrid layout of the partitioned table, 0 if it is partitioned uniformly
+		float distanceOfMeasurement;					// Distance where the HRIR have been measurement
+		int resamplingStep;								// HRTF Resample table step (azimuth and elevation)
+
+		// HRTF tables
+		T_HRTFTable				t_HRTF_DataBase;
+		T_HRTFTable				t_HRTF_Resampled_frequency;
+		CHRTFPartitionedGrid	t_HRTF_Resampled_partitioned;		// Partitioned HRIRs of the regular grid of the resampled table, indexed by azimuth and elevation
+		CHRTFInterpolationLookup	t_HRTF_Resampled_interpolationLookup;	// Triangle of t_HRTF_Resampled_partitioned around each direction, for the run-time interpolation
+
+		friend class CHRTF;		// CHRTF fills the asset during its setup and reads it in run time
+	};
+}
+#endif
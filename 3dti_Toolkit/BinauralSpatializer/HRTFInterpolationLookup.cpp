@@ -0,0 +1,217 @@
+/**
+* \class CHRTFInterpolationLookup
+*
+* \brief Definition of CHRTFInterpolationLookup class.
+* \date	October 2026
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#include <BinauralSpatializer/HRTFInterpolationLookup.h>
+#include <Common/ErrorHandler.h>
+#include <algorithm>
+#include <cmath>
+
+namespace Binaural {
+	/////////////////////////////
+	// CONSTRUCTOR/DESTRUCTOR  //
+	/////////////////////////////
+	CHRTFInterpolationLookup::CHRTFInterpolationLookup() : numberOfAzimuthCells{ 0 }, numberOfUpperElevationCells{ 0 }
+	{
+	}
+
+	///////////////////
+	// Public Methods //
+	///////////////////
+
+	//Calculate the triangle of every cell for one grid
+	void CHRTFInterpolationLookup::Setup(const CHRTFPartitionedGrid & grid)
+	{
+		int resamplingStep = grid.GetResamplingStep();
+		ASSERT(resamplingStep > 0, RESULT_ERROR_NOTSET, "The HRTF grid of the interpolation lookup has not been set up", "");
+
+		Clear();
+		if (resamplingStep > 0)	//Just in case error handler is off
+		{
+			numberOfAzimuthCells = 360 * DEFAULT_HRTF_INTERPOLATION_CELLS_PER_DEGREE;
+			numberOfUpperElevationCells = 90 * DEFAULT_HRTF_INTERPOLATION_CELLS_PER_DEGREE;
+			int numberOfElevationCells = 2 * numberOfUpperElevationCells;
+			cellTriangles.resize(numberOfAzimuthCells * numberOfElevationCells);
+
+			//Each triangle is calculated once, the first time one cell inside it is found
+			int numberOfSquares = (360 + resamplingStep - 1) / resamplingStep;
+			std::vector<int32_t> squareTriangles(4 * numberOfSquares * numberOfSquares, -2);		//-2 if it has not been calculated yet
+
+			for (int azimuthCell = 0; azimuthCell < numberOfAzimuthCells; azimuthCell++)
+			{
+				float azimuth = (azimuthCell + 0.5f) / DEFAULT_HRTF_INTERPOLATION_CELLS_PER_DEGREE;		//Centre of the cell
+				int squareAzimuth = static_cast<int>(azimuth / resamplingStep);
+				bool rightHalf = azimuth >= squareAzimuth * resamplingStep + resamplingStep * 0.5f;
+
+				for (int elevationCell = 0; elevationCell < numberOfElevationCells; elevationCell++)
+				{
+					float elevation;
+					if (elevationCell < numberOfUpperElevationCells) { elevation = (elevationCell + 0.5f) / DEFAULT_HRTF_INTERPOLATION_CELLS_PER_DEGREE; }
+					else { elevation = 270.0f + (elevationCell - numberOfUpperElevationCells + 0.5f) / DEFAULT_HRTF_INTERPOLATION_CELLS_PER_DEGREE; }
+					int squareElevation = static_cast<int>(elevation / resamplingStep);
+					bool upperHalf = elevation >= squareElevation * resamplingStep + resamplingStep * 0.5f;
+
+					int32_t & squareTriangle = squareTriangles[4 * (squareAzimuth * numberOfSquares + squareElevation) + 2 * rightHalf + upperHalf];
+					if (squareTriangle == -2)
+					{
+						TTriangle newTriangle;
+						if (CalculateTriangle(grid, squareAzimuth, squareElevation, rightHalf, upperHalf, newTriangle))
+						{
+							squareTriangle = triangles.size();
+							triangles.push_back(newTriangle);
+						}
+						else
+						{
+							squareTriangle = -1;
+						}
+					}
+					cellTriangles[azimuthCell * numberOfElevationCells + elevationCell] = squareTriangle;
+				}
+			}
+			SET_RESULT(RESULT_OK, "HRTF interpolation lookup calculated succesfully");
+		}
+	}
+
+	//Free the memory of the lookup
+	void CHRTFInterpolationLookup::Clear()
+	{
+		numberOfAzimuthCells = 0;
+		numberOfUpperElevationCells = 0;
+		std::vector<TTriangle>().swap(triangles);
+		std::vector<int32_t>().swap(cellTriangles);
+	}
+
+	//Get if the lookup can be used
+	bool CHRTFInterpolationLookup::IsReady() const
+	{
+		return !cellTriangles.empty();
+	}
+
+	//Check that the lookup is consistent with one grid
+	bool CHRTFInterpolationLookup::IsValid(const CHRTFPartitionedGrid & grid) const
+	{
+		if ((numberOfAzimuthCells != 360 * DEFAULT_HRTF_INTERPOLATION_CELLS_PER_DEGREE) || (numberOfUpperElevationCells != 90 * DEFAULT_HRTF_INTERPOLATION_CELLS_PER_DEGREE) ||
+			(cellTriangles.size() != 2 * (size_t)numberOfAzimuthCells * numberOfUpperElevationCells))
+		{
+			return false;
+		}
+
+		for (int32_t triangleIndex : cellTriangles)
+		{
+			if ((triangleIndex < -1) || (triangleIndex >= (int64_t)triangles.size())) { return false; }
+		}
+
+		int numberOfOrientations = grid.GetNumberOfOrientations();
+		for (const TTriangle & triangle : triangles)
+		{
+			for (int vertex = 0; vertex < 3; vertex++)
+			{
+				if ((triangle.orientation[vertex] < 0) || (triangle.orientation[vertex] >= numberOfOrientations)) { return false; }
+			}
+		}
+		return true;
+	}
+
+	//Find the three orientations of the grid around one direction and their weights
+	bool CHRTFInterpolationLookup::FindTriangle(float azimuth, float elevation, THRTFInterpolationTriangleStruct & triangle) const
+	{
+		if (cellTriangles.empty() || (azimuth < 0.0f) || (azimuth >= 360.0f)) { return false; }
+
+		int azimuthCell = std::min(static_cast<int>(azimuth * DEFAULT_HRTF_INTERPOLATION_CELLS_PER_DEGREE), numberOfAzimuthCells - 1);
+		int elevationCell;
+		if ((elevation >= 0.0f) && (elevation < 90.0f))
+		{
+			elevationCell = std::min(static_cast<int>(elevation * DEFAULT_HRTF_INTERPOLATION_CELLS_PER_DEGREE), numberOfUpperElevationCells - 1);
+		}
+		else if ((elevation >= 270.0f) && (elevation < 360.0f))
+		{
+			elevationCell = numberOfUpperElevationCells + std::min(static_cast<int>((elevation - 270.0f) * DEFAULT_HRTF_INTERPOLATION_CELLS_PER_DEGREE), numberOfUpperElevationCells - 1);
+		}
+		else
+		{
+			return false;
+		}
+
+		int32_t triangleIndex = cellTriangles[azimuthCell * 2 * numberOfUpperElevationCells + elevationCell];
+		if (triangleIndex < 0) { return false; }
+
+		const TTriangle & cellTriangle = triangles[triangleIndex];
+		triangle.orientationA = cellTriangle.orientation[0];
+		triangle.orientationB = cellTriangle.orientation[1];
+		triangle.orientationC = cellTriangle.orientation[2];
+
+		//Barycentric coordinates, truncated to three decimals as CHRTF does
+		float azimuthIncrement = azimuth - cellTriangle.azimuth3;
+		float elevationIncrement = elevation - cellTriangle.elevation3;
+		triangle.alpha = (cellTriangle.alphaAzimuth * azimuthIncrement + cellTriangle.alphaElevation * elevationIncrement) / cellTriangle.denominator;
+		triangle.alpha = std::trunc(1000 * triangle.alpha) / 1000;
+		triangle.beta = (cellTriangle.betaAzimuth * azimuthIncrement + cellTriangle.betaElevation * elevationIncrement) / cellTriangle.denominator;
+		triangle.beta = std::trunc(1000 * triangle.beta) / 1000;
+		triangle.gamma = 1.0f - triangle.alpha - triangle.beta;
+		triangle.gamma = std::trunc(1000 * triangle.gamma) / 1000;
+		return true;
+	}
+
+	///////////////////
+	// Private Methods //
+	///////////////////
+
+	//Calculate the triangle of one quadrant of one square of the grid
+	bool CHRTFInterpolationLookup::CalculateTriangle(const CHRTFPartitionedGrid & grid, int squareAzimuth, int squareElevation, bool rightHalf, bool upperHalf, TTriangle & triangle)
+	{
+		int resamplingStep = grid.GetResamplingStep();
+
+		//Corners of the square: A (upper left), B (upper right), C (lower left) and D (lower right)
+		int azimuthC = squareAzimuth * resamplingStep;
+		int elevationC = squareElevation * resamplingStep;
+		int cornerAzimuth[4] = { azimuthC, azimuthC + resamplingStep, azimuthC, azimuthC + resamplingStep };
+		int cornerElevation[4] = { elevationC + resamplingStep, elevationC + resamplingStep, elevationC, elevationC };
+
+		//Vertices of the triangle of each quadrant
+		int corners[3];
+		if (rightHalf && upperHalf)		{ corners[0] = 0; corners[1] = 1; corners[2] = 3; }		//A, B, D
+		else if (rightHalf)				{ corners[0] = 1; corners[1] = 2; corners[2] = 3; }		//B, C, D
+		else if (upperHalf)				{ corners[0] = 0; corners[1] = 1; corners[2] = 2; }		//A, B, C
+		else							{ corners[0] = 0; corners[1] = 2; corners[2] = 3; }		//A, C, D
+
+		float x[3], y[3];
+		for (int i = 0; i < 3; i++)
+		{
+			x[i] = cornerAzimuth[corners[i]];
+			y[i] = cornerElevation[corners[i]];
+
+			// The grid does not contain data for azimuth = 360 nor elevation = 360, which have the same values as 0
+			int azimuth = (cornerAzimuth[corners[i]] == 360) ? 0 : cornerAzimuth[corners[i]];
+			int elevation = (cornerElevation[corners[i]] == 360) ? 0 : cornerElevation[corners[i]];
+			triangle.orientation[i] = grid.GetOrientationIndex(azimuth, elevation);
+			if (!grid.IsHRIRSet(triangle.orientation[i])) { return false; }
+		}
+
+		triangle.azimuth3 = x[2];
+		triangle.elevation3 = y[2];
+		triangle.alphaAzimuth = y[1] - y[2];
+		triangle.alphaElevation = x[2] - x[1];
+		triangle.betaAzimuth = y[2] - y[0];
+		triangle.betaElevation = x[0] - x[2];
+		triangle.denominator = (y[1] - y[2]) * (x[0] - x[2]) + (x[2] - x[1]) * (y[0] - y[2]);
+		return true;
+	}
+}
@@ -0,0 +1,144 @@
+/**
+* \class CHRTFInterpolationLookup
+*
+* \brief Declaration of CHRTFInterpolationLookup class interface.
+* \date	October 2026
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#ifndef _CHRTFINTERPOLATIONLOOKUP_H_
+#define _CHRTFINTERPOLATIONLOOKUP_H_
+
+#include <vector>
+#include <cstdint>
+#include <BinauralSpatializer/HRTFPartitionedGrid.h>
+
+#ifndef DEFAULT_HRTF_INTERPOLATION_CELLS_PER_DEGREE
+#define DEFAULT_HRTF_INTERPOLATION_CELLS_PER_DEGREE 2		// Cells of 0.5 degrees
+#endif
+
+namespace Binaural {
+
+	/** \brief Type definition for a triangle of orientations of the HRTF grid and the weights of each one to get the HRIR of a direction inside it
+	*/
+	struct THRTFInterpolationTriangleStruct {
+		int orientationA;	///< Position of the first orientation in the grid
+		int orientationB;	///< Position of the second orientation in the grid
+		int orientationC;	///< Position of the third orientation in the grid
+		float alpha;		///< Weight of the first orientation (barycentric coordinate)
+		float beta;			///< Weight of the second orientation
+		float gamma;		///< Weight of the third orientation
+	};
+
+	/** \details This class finds the three orientations of the HRTF grid around any direction, to interpolate its HRIR in run time, and their barycentric coordinates.
+	*	\details The triangles are those of the run-time interpolation of CHRTF: each square of the grid is split in four triangles, and the one of the quadrant of the square
+	*	that contains the direction is used. The sphere is divided in cells of a fraction of degree, small enough to be inside one triangle for any integer step of the grid,
+	*	and the triangle of each cell is calculated once, when the lookup is set up. Each triangle keeps the terms of its barycentric coordinates that do not depend on the direction,
+	*	so finding the triangle of a direction and its weights only needs one access to the table and a few operations. The weights are the same ones that
+	*	CHRTF calculates from the three orientations.
+	*/
+	class CHRTFInterpolationLookup
+	{
+
+	public:
+
+		/** \brief Default constructor
+		*   \eh Nothing is reported to the error handler.
+		*/
+		CHRTFInterpolationLookup();
+
+		/** \brief Calculate the triangle of every cell for one grid, once all its HRIRs have been set
+		*	\param [in] grid HRTF grid whose orientations are interpolated
+		*   \eh On success, RESULT_OK is reported to the error handler.
+		*       On error, an error code is reported to the error handler.
+		*/
+		void Setup(const CHRTFPartitionedGrid & grid);
+
+		/** \brief Free the memory of the lookup
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void Clear();
+
+		/** \brief Get if the lookup has been set up and can be used
+		*	\retval ready true if the lookup can be used to find triangles
+		*   \eh Nothing is reported to the error handler.
+		*/
+		bool IsReady() const;
+
+		/** \brief Check that the lookup is consistent with one grid, for example after loading both from a cache file
+		*	\details The number of cells has to be the one of DEFAULT_HRTF_INTERPOLATION_CELLS_PER_DEGREE, the triangle of every cell has to be one of the lookup
+		*	and the vertices of every triangle have to be orientations of the grid
+		*	\param [in] grid HRTF grid whose orientations are interpolated
+		*	\retval isValid true if the lookup has been set up and all its indices are in range
+		*   \eh Nothing is reported to the error handler.
+		*/
+		bool IsValid(const CHRTFPartitionedGrid & grid) const;
+
+		/** \brief Find the three orientations of the grid around one direction and their weights
+		*	\param [in] azimuth azimuth in degrees, from 0 to 360 (not included)
+		*	\param [in] elevation elevation in degrees, from 0 to 90 (not included) or from 270 to 360 (not included)
+		*	\param [out] triangle orientations of the triangle and barycentric coordinates of the direction
+		*	\retval found false if the direction is out of range or any orientation of its triangle is not in the grid
+		*   \eh Nothing is reported to the error handler.
+		*/
+		bool FindTriangle(float azimuth, float elevation, THRTFInterpolationTriangleStruct & triangle) const;
+
+		/** \brief Save or load the whole lookup with an archive of the cereal library, to cache it on disk (see HRTFCache.h of the resource manager)
+		*	\param [in,out] ar archive
+		*   \eh Nothing is reported to the error handler.
+		*/
+		template <class Archive>
+		void serialize(Archive & ar)
+		{
+			ar(numberOfAzimuthCells, numberOfUpperElevationCells, triangles, cellTriangles);
+		}
+
+	private:
+		// Triangle of the grid, with the terms of its barycentric coordinates relative to its third vertex (x1, y1), (x2, y2), (x3, y3)
+		struct TTriangle {
+			int orientation[3];			//Positions of the vertices in the grid
+			float azimuth3;				//Azimuth of the third vertex (x3)
+			float elevation3;			//Elevation of the third vertex (y3)
+			float alphaAzimuth;			//y2 - y3
+			float alphaElevation;		//x3 - x2
+			float betaAzimuth;			//y3 - y1
+			float betaElevation;		//x1 - x3
+			float denominator;			//(y2 - y3) * (x1 - x3) + (x3 - x2) * (y1 - y3)
+
+			template <class Archive>
+			void serialize(Archive & ar)
+			{
+				ar(orientation[0], orientation[1], orientation[2], azimuth3, elevation3, alphaAzimuth, alphaElevation, betaAzimuth, betaElevation, denominator);
+			}
+		};
+
+		///////////////
+		// ATTRIBUTES
+		///////////////
+		int numberOfAzimuthCells;				//Number of cells from 0 to 360 degrees of azimuth
+		int numberOfUpperElevationCells;		//Number of cells from 0 to 90 degrees of elevation, the rest of them go from 270 to 360 degrees
+		std::vector<TTriangle> triangles;		//Triangles of the grid whose vertices have HRIRs
+		std::vector<int32_t> cellTriangles;		//Triangle of each cell, -1 if it can not be interpolated
+
+		///////////////
+		// METHODS
+		///////////////
+		//Calculate the triangle of one square of the grid and one quadrant of the square, as the run-time interpolation of CHRTF does. Returns false if any vertex has not HRIR
+		static bool CalculateTriangle(const CHRTFPartitionedGrid & grid, int squareAzimuth, int squareElevation, bool rightHalf, bool upperHalf, TTriangle & triangle);
+	};
+}
+#endif
@@ -0,0 +1,245 @@
+/**
+* \class CHRTFPartitionedGrid
+*
+* \brief Definition of CHRTFPartitionedGrid class.
+* \date	October 2026
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#include <BinauralSpatializer/HRTFPartitionedGrid.h>
+#include <Common/ErrorHandler.h>
+#include <algorithm>
+
+namespace Binaural {
+	/////////////////////////////
+	// CONSTRUCTOR/DESTRUCTOR  //
+	/////////////////////////////
+	CHRTFPartitionedGrid::CHRTFPartitionedGrid() : resamplingStep{ 0 }, numberOfAzimuths{ 0 }, numberOfUpperElevations{ 0 }, numberOfElevations{ 0 }, HRIRLength{ 0 }
+	{
+	}
+
+	///////////////////
+	// Public Methods //
+	///////////////////
+
+	//Allocate the memory of the whole grid
+	void CHRTFPartitionedGrid::Setup(int _resamplingStep, const std::vector<int> & _subfilterLengths)
+	{
+		ASSERT(_resamplingStep > 0, RESULT_ERROR_OUTOFRANGE, "The step of the HRTF grid has to be greater than 0", "");
+		ASSERT(!_subfilterLengths.empty(), RESULT_ERROR_BADSIZE, "The HRIRs of the HRTF grid need at least one subfilter", "");
+
+		Clear();
+		if ((_resamplingStep > 0) && !_subfilterLengths.empty())	//Just in case error handler is off
+		{
+			resamplingStep = _resamplingStep;
+			numberOfAzimuths = (360 + resamplingStep - 1) / resamplingStep;
+			numberOfUpperElevations = 90 / resamplingStep + 1;
+			numberOfElevations = numberOfUpperElevations + (90 + resamplingStep - 1) / resamplingStep;
+
+			subfilterLengths = _subfilterLengths;
+			subfilterOffsets.resize(subfilterLengths.size());
+			HRIRLength = 0;
+			for (size_t i = 0; i < subfilterLengths.size(); i++)
+			{
+				subfilterOffsets[i] = HRIRLength;
+				HRIRLength += Common::CalculateAlignedLength(subfilterLengths[i]);
+			}
+
+			int numberOfOrientations = numberOfAzimuths * numberOfElevations;
+			HRIRs.assign(2 * (size_t)numberOfOrientations * HRIRLength, 0.0f);
+			delays.assign(2 * numberOfOrientations, 0);
+			HRIRSet.assign(2 * numberOfOrientations, 0);
+			SET_RESULT(RESULT_OK, "HRTF grid allocated succesfully");
+		}
+	}
+
+	//Free the memory of the grid
+	void CHRTFPartitionedGrid::Clear()
+	{
+		resamplingStep = 0;
+		numberOfAzimuths = 0;
+		numberOfUpperElevations = 0;
+		numberOfElevations = 0;
+		HRIRLength = 0;
+		subfilterLengths.clear();
+		subfilterOffsets.clear();
+		Common::CAlignedVector<float>().swap(HRIRs);
+		std::vector<uint64_t>().swap(delays);
+		std::vector<uint8_t>().swap(HRIRSet);
+	}
+
+	//Get if the memory of the grid has been allocated
+	bool CHRTFPartitionedGrid::IsEmpty() const
+	{
+		return HRIRSet.empty();
+	}
+
+	//Check that the sizes of the grid are consistent with each other
+	bool CHRTFPartitionedGrid::IsValid() const
+	{
+		if ((resamplingStep <= 0) || (numberOfAzimuths != (360 + resamplingStep - 1) / resamplingStep) || (numberOfUpperElevations != 90 / resamplingStep + 1) ||
+			(numberOfElevations != numberOfUpperElevations + (90 + resamplingStep - 1) / resamplingStep))
+		{
+			return false;
+		}
+
+		if (subfilterLengths.empty() || (subfilterOffsets.size() != subfilterLengths.size())) { return false; }
+		int64_t alignedLength = 0;		//Not an int, so that a corrupted size can not overflow it
+		for (size_t i = 0; i < subfilterLengths.size(); i++)
+		{
+			if ((subfilterLengths[i] <= 0) || (subfilterOffsets[i] != alignedLength)) { return false; }
+			alignedLength += Common::CalculateAlignedLength(subfilterLengths[i]);
+		}
+		if (HRIRLength != alignedLength) { return false; }
+
+		size_t numberOfHRIRs = 2 * (size_t)GetNumberOfOrientations();
+		return (HRIRs.size() == numberOfHRIRs * HRIRLength) && (delays.size() == numberOfHRIRs) && (HRIRSet.size() == numberOfHRIRs);
+	}
+
+	//Get the number of orientations of the grid
+	int CHRTFPartitionedGrid::GetNumberOfOrientations() const
+	{
+		return numberOfAzimuths * numberOfElevations;
+	}
+
+	//Get the step of the grid
+	int CHRTFPartitionedGrid::GetResamplingStep() const
+	{
+		return resamplingStep;
+	}
+
+	//Get the position of one orientation in the grid
+	int CHRTFPartitionedGrid::GetOrientationIndex(int azimuth, int elevation) const
+	{
+		if ((resamplingStep <= 0) || (azimuth < 0) || (azimuth >= 360) || (azimuth % resamplingStep != 0)) { return -1; }
+
+		int elevationIndex;
+		if ((elevation >= 0) && (elevation <= 90) && (elevation % resamplingStep == 0))
+		{
+			elevationIndex = elevation / resamplingStep;
+		}
+		else if ((elevation >= 270) && (elevation < 360) && ((elevation - 270) % resamplingStep == 0))
+		{
+			elevationIndex = numberOfUpperElevations + (elevation - 270) / resamplingStep;
+		}
+		else
+		{
+			return -1;
+		}
+		return (azimuth / resamplingStep) * numberOfElevations + elevationIndex;
+	}
+
+	//Copy the partitioned HRIR of one ear and one orientation into the grid
+	void CHRTFPartitionedGrid::SetHRIR(int orientationIndex, Common::T_ear ear, const std::vector<CMonoBuffer<float>> & HRIR_Partitioned, uint64_t delay)
+	{
+		ASSERT((orientationIndex >= 0) && (orientationIndex < GetNumberOfOrientations()), RESULT_ERROR_OUTOFRANGE, "Orientation out of the HRTF grid", "");
+		ASSERT((ear == Common::T_ear::LEFT) || (ear == Common::T_ear::RIGHT), RESULT_ERROR_NOTALLOWED, "Attempt to set the HRIR of a wrong ear (BOTH or NONE) in the HRTF grid", "");
+		ASSERT(HRIR_Partitioned.size() == subfilterLengths.size(), RESULT_ERROR_BADSIZE, "The HRIR has a different number of subfilters than the HRTF grid", "");
+
+		if ((orientationIndex >= 0) && (orientationIndex < GetNumberOfOrientations()) && ((ear == Common::T_ear::LEFT) || (ear == Common::T_ear::RIGHT)) && (HRIR_Partitioned.size() == subfilterLengths.size()))	//Just in case error handler is off
+		{
+			size_t position = 2 * orientationIndex + ear;
+			float* HRIR = HRIRs.data() + position * HRIRLength;
+			for (size_t i = 0; i < subfilterLengths.size(); i++)
+			{
+				ASSERT(HRIR_Partitioned[i].size() == (size_t)subfilterLengths[i], RESULT_ERROR_BADSIZE, "The subfilters of the HRIR have different sizes than the ones of the HRTF grid", "");
+				if (HRIR_Partitioned[i].size() != (size_t)subfilterLengths[i]) { return; }	//Just in case error handler is off
+				std::copy(HRIR_Partitioned[i].begin(), HRIR_Partitioned[i].end(), HRIR + subfilterOffsets[i]);
+			}
+			delays[position] = delay;
+			HRIRSet[position] = 1;
+		}
+	}
+
+	//Get if the HRIRs of both ears of one orientation have been set
+	bool CHRTFPartitionedGrid::IsHRIRSet(int orientationIndex) const
+	{
+		if ((orientationIndex < 0) || (orientationIndex >= GetNumberOfOrientations())) { return false; }
+		return (HRIRSet[2 * orientationIndex] != 0) && (HRIRSet[2 * orientationIndex + 1] != 0);
+	}
+
+	//Get one subfilter of the HRIR of one ear and one orientation
+	const float* CHRTFPartitionedGrid::GetSubfilter(int orientationIndex, Common::T_ear ear, int subfilter) const
+	{
+		return HRIRs.data() + (2 * (size_t)orientationIndex + ear) * HRIRLength + subfilterOffsets[subfilter];
+	}
+
+	//Get the delay of the HRIR of one ear and one orientation
+	uint64_t CHRTFPartitionedGrid::GetDelay(int orientationIndex, Common::T_ear ear) const
+	{
+		return delays[2 * orientationIndex + ear];
+	}
+
+	//Copy the partitioned HRIR of one ear and one orientation out of the grid
+	void CHRTFPartitionedGrid::GetHRIR_Partitioned(int orientationIndex, Common::T_ear ear, std::vector<CMonoBuffer<float>> & HRIR_Partitioned) const
+	{
+		HRIR_Partitioned.resize(subfilterLengths.size());
+		for (int i = 0; i < (int)subfilterLengths.size(); i++)
+		{
+			const float* subfilterData = GetSubfilter(orientationIndex, ear, i);
+			HRIR_Partitioned[i].assign(subfilterData, subfilterData + subfilterLengths[i]);
+		}
+	}
+
+	//Get a view of the partitioned HRIR of one ear and one orientation
+	void CHRTFPartitionedGrid::GetHRIR_PartitionedView(int orientationIndex, Common::T_ear ear, TOneEarHRIRPartitionedView & view) const
+	{
+		size_t position = 2 * (size_t)orientationIndex + ear;
+		GetPartitionedView(HRIRs.data() + position * HRIRLength, delays[position], view);
+	}
+
+	//Get a view of an HRIR with the layout of the grid
+	void CHRTFPartitionedGrid::GetPartitionedView(const float* HRIR, uint64_t delay, TOneEarHRIRPartitionedView & view) const
+	{
+		view.HRIR = HRIR;
+		view.subfilterOffsets = subfilterOffsets.data();
+		view.subfilterLengths = subfilterLengths.data();
+		view.numberOfSubfilters = subfilterLengths.size();
+		view.delay = delay;
+	}
+
+	//Calculate the weighted sum of the HRIRs of one ear and three orientations
+	void CHRTFPartitionedGrid::CalculateWeightedHRIR(int orientationA, int orientationB, int orientationC, Common::T_ear ear, float alpha, float beta, float gamma, float* outHRIR) const
+	{
+		//The whole HRIR at once, the gaps between subfilters are zeros
+		const float* HRIR_A = HRIRs.data() + (2 * (size_t)orientationA + ear) * HRIRLength;
+		const float* HRIR_B = HRIRs.data() + (2 * (size_t)orientationB + ear) * HRIRLength;
+		const float* HRIR_C = HRIRs.data() + (2 * (size_t)orientationC + ear) * HRIRLength;
+		for (int i = 0; i < HRIRLength; i++)
+		{
+			outHRIR[i] = alpha * HRIR_A[i] + beta * HRIR_B[i] + gamma * HRIR_C[i];
+		}
+	}
+
+	//Get the number of values of the HRIR of one ear
+	int CHRTFPartitionedGrid::GetHRIRLength() const
+	{
+		return HRIRLength;
+	}
+
+	//Get the number of subfilters of each HRIR
+	int CHRTFPartitionedGrid::GetNumberOfSubfilters() const
+	{
+		return subfilterLengths.size();
+	}
+
+	//Get the size of one subfilter of the HRIRs
+	int CHRTFPartitionedGrid::GetSubfilterLength(int subfilter) const
+	{
+		return subfilterLengths[subfilter];
+	}
+}
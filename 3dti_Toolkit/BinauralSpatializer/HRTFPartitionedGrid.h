@@ -0,0 +1,223 @@
+/**
+* \class CHRTFPartitionedGrid
+*
+* \brief Declaration of CHRTFPartitionedGrid class interface.
+* \date	October 2026
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#ifndef _CHRTFPARTITIONEDGRID_H_
+#define _CHRTFPARTITIONEDGRID_H_
+
+#include <vector>
+#include <cstdint>
+#include <Common/Buffer.h>
+#include <Common/AlignedAllocator.h>
+#include <Common/CommonDefinitions.h>
+
+namespace Binaural {
+
+	/** \brief Type definition for a read-only view of the partitioned HRIR of one ear, whose subfilters are stored by another object in one buffer with the layout of CHRTFPartitionedGrid
+	*/
+	struct TOneEarHRIRPartitionedView {
+		const float* HRIR;				///< First value of the HRIR, nullptr if there is not HRIR
+		const int* subfilterOffsets;	///< Position of each subfilter from the first value of the HRIR
+		const int* subfilterLengths;	///< Size of each subfilter
+		int numberOfSubfilters;			///< Number of subfilters, 0 if there is not HRIR
+		uint64_t delay;					///< Delay, in number of samples
+	};
+
+	/** \details This class stores the partitioned HRIRs of both ears for every orientation of the regular grid of the HRTF resampled table,
+	*	in one contiguous buffer aligned to 64 bytes, indexed by the position of the orientation in the grid.
+	*	\details The grid has every azimuth from 0 to 360 degrees (not included) and every elevation from 0 to 90 degrees and from 270 to 360 degrees (not included), with the resampling step.
+	*	The position of one orientation is calculated from its azimuth and elevation, without searching it, and the HRIRs of neighbour orientations are close in memory.
+	*	All the HRIRs have the same subfilters, with the same sizes, and every subfilter starts aligned.
+	*/
+	class CHRTFPartitionedGrid
+	{
+
+	public:
+
+		/** \brief Default constructor
+		*   \eh Nothing is reported to the error handler.
+		*/
+		CHRTFPartitionedGrid();
+
+		/** \brief Allocate the memory of the whole grid. The HRIRs of every orientation have to be set later with SetHRIR
+		*	\param [in] _resamplingStep step of the grid in degrees, for both azimuth and elevation
+		*	\param [in] _subfilterLengths size of each subfilter of the partitioned HRIRs
+		*   \eh On success, RESULT_OK is reported to the error handler.
+		*       On error, an error code is reported to the error handler.
+		*/
+		void Setup(int _resamplingStep, const std::vector<int> & _subfilterLengths);
+
+		/** \brief Free the memory of the grid
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void Clear();
+
+		/** \brief Get if the memory of the grid has been allocated
+		*	\retval isEmpty true if the grid has not been set up
+		*   \eh Nothing is reported to the error handler.
+		*/
+		bool IsEmpty() const;
+
+		/** \brief Check that the sizes of the grid are consistent with each other, for example after loading it from a cache file
+		*	\details The number of azimuths and elevations has to be the one of the step, the offsets of the subfilters have to be the aligned sums of their sizes
+		*	and the buffers of the HRIRs, delays and set flags have to have the size of every orientation and both ears
+		*	\retval isValid true if the grid has been set up and all its sizes are consistent
+		*   \eh Nothing is reported to the error handler.
+		*/
+		bool IsValid() const;
+
+		/** \brief Get the number of orientations of the grid
+		*	\retval numberOfOrientations number of orientations
+		*   \eh Nothing is reported to the error handler.
+		*/
+		int GetNumberOfOrientations() const;
+
+		/** \brief Get the step of the grid
+		*	\retval resamplingStep step in degrees, for both azimuth and elevation, 0 if the grid has not been set up
+		*   \eh Nothing is reported to the error handler.
+		*/
+		int GetResamplingStep() const;
+
+		/** \brief Get the position of one orientation in the grid
+		*	\param [in] azimuth azimuth in degrees, a multiple of the resampling step from 0 to 360 (not included)
+		*	\param [in] elevation elevation in degrees, a multiple of the resampling step from 0 to 90, or 270 plus a multiple of the resampling step up to 360 (not included)
+		*	\retval orientationIndex position of the orientation, -1 if it is not in the grid
+		*   \eh Nothing is reported to the error handler.
+		*/
+		int GetOrientationIndex(int azimuth, int elevation) const;
+
+		/** \brief Copy the partitioned HRIR of one ear and one orientation into the grid. Several threads can set different orientations at once
+		*	\param [in] orientationIndex position of the orientation in the grid
+		*	\param [in] ear ear of the HRIR (LEFT or RIGHT)
+		*	\param [in] HRIR_Partitioned subfilters of the HRIR, with the sizes given in the setup
+		*	\param [in] delay delay of the HRIR, in number of samples
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void SetHRIR(int orientationIndex, Common::T_ear ear, const std::vector<CMonoBuffer<float>> & HRIR_Partitioned, uint64_t delay);
+
+		/** \brief Get if the HRIRs of both ears of one orientation have been set
+		*	\param [in] orientationIndex position of the orientation in the grid
+		*	\retval isSet true if both HRIRs have been set
+		*   \eh Nothing is reported to the error handler.
+		*/
+		bool IsHRIRSet(int orientationIndex) const;
+
+		/** \brief Get one subfilter of the HRIR of one ear and one orientation, without copying it
+		*	\param [in] orientationIndex position of the orientation in the grid
+		*	\param [in] ear ear of the HRIR (LEFT or RIGHT)
+		*	\param [in] subfilter index of the subfilter
+		*	\retval subfilterData pointer to the first value of the subfilter, aligned to 64 bytes
+		*   \eh Nothing is reported to the error handler.
+		*/
+		const float* GetSubfilter(int orientationIndex, Common::T_ear ear, int subfilter) const;
+
+		/** \brief Get the delay of the HRIR of one ear and one orientation
+		*	\param [in] orientationIndex position of the orientation in the grid
+		*	\param [in] ear ear of the HRIR (LEFT or RIGHT)
+		*	\retval delay delay in number of samples
+		*   \eh Nothing is reported to the error handler.
+		*/
+		uint64_t GetDelay(int orientationIndex, Common::T_ear ear) const;
+
+		/** \brief Copy the partitioned HRIR of one ear and one orientation out of the grid
+		*	\param [in] orientationIndex position of the orientation in the grid
+		*	\param [in] ear ear of the HRIR (LEFT or RIGHT)
+		*	\param [out] HRIR_Partitioned subfilters of the HRIR
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void GetHRIR_Partitioned(int orientationIndex, Common::T_ear ear, std::vector<CMonoBuffer<float>> & HRIR_Partitioned) const;
+
+		/** \brief Get a read-only view of the partitioned HRIR of one ear and one orientation, without copying it
+		*	\details The view points to the memory of the grid, so it is valid until the grid is set up again or cleared
+		*	\param [in] orientationIndex position of the orientation in the grid
+		*	\param [in] ear ear of the HRIR (LEFT or RIGHT)
+		*	\param [out] view subfilters and delay of the HRIR
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void GetHRIR_PartitionedView(int orientationIndex, Common::T_ear ear, TOneEarHRIRPartitionedView & view) const;
+
+		/** \brief Get a read-only view of an HRIR stored out of the grid with its layout, for example the one calculated by CalculateWeightedHRIR
+		*	\param [in] HRIR first value of the HRIR, with GetHRIRLength values
+		*	\param [in] delay delay of the HRIR, in number of samples
+		*	\param [out] view subfilters and delay of the HRIR
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void GetPartitionedView(const float* HRIR, uint64_t delay, TOneEarHRIRPartitionedView & view) const;
+
+		/** \brief Calculate the weighted sum of the HRIRs of one ear and three orientations, with the layout of the grid
+		*	\param [in] orientationA position of the first orientation in the grid
+		*	\param [in] orientationB position of the second orientation in the grid
+		*	\param [in] orientationC position of the third orientation in the grid
+		*	\param [in] ear ear of the HRIRs (LEFT or RIGHT)
+		*	\param [in] alpha weight of the first orientation
+		*	\param [in] beta weight of the second orientation
+		*	\param [in] gamma weight of the third orientation
+		*	\param [out] outHRIR first value of the result, with room for GetHRIRLength values
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void CalculateWeightedHRIR(int orientationA, int orientationB, int orientationC, Common::T_ear ear, float alpha, float beta, float gamma, float* outHRIR) const;
+
+		/** \brief Get the number of values of the HRIR of one ear in the grid, with all its subfilters and the gaps that keep them aligned
+		*	\retval HRIRLength number of values
+		*   \eh Nothing is reported to the error handler.
+		*/
+		int GetHRIRLength() const;
+
+		/** \brief Get the number of subfilters of each HRIR
+		*	\retval numberOfSubfilters number of subfilters
+		*   \eh Nothing is reported to the error handler.
+		*/
+		int GetNumberOfSubfilters() const;
+
+		/** \brief Get the size of one subfilter of the HRIRs
+		*	\param [in] subfilter index of the subfilter
+		*	\retval subfilterLength number of values of the subfilter
+		*   \eh Nothing is reported to the error handler.
+		*/
+		int GetSubfilterLength(int subfilter) const;
+
+		/** \brief Save or load the whole grid with an archive of the cereal library, to cache it on disk (see HRTFCache.h of the resource manager)
+		*	\param [in,out] ar archive
+		*   \eh Nothing is reported to the error handler.
+		*/
+		template <class Archive>
+		void serialize(Archive & ar)
+		{
+			ar(resamplingStep, numberOfAzimuths, numberOfUpperElevations, numberOfElevations, subfilterLengths, subfilterOffsets, HRIRLength, HRIRs, delays, HRIRSet);
+		}
+
+	private:
+		///////////////
+		// ATTRIBUTES
+		///////////////
+		int resamplingStep;							//Step of the grid in degrees
+		int numberOfAzimuths;						//Number of azimuths, from 0 to 360 degrees
+		int numberOfUpperElevations;				//Number of elevations from 0 to 90 degrees
+		int numberOfElevations;						//Number of elevations of each azimuth, from 0 to 90 and from 270 to 360 degrees
+		std::vector<int> subfilterLengths;			//Size of each subfilter
+		std::vector<int> subfilterOffsets;			//Position of each subfilter in the HRIR of one ear, rounded up to keep every one aligned
+		int HRIRLength;								//Distance between the HRIRs of two ears in the buffer
+		Common::CAlignedVector<float> HRIRs;		//Subfilters of the HRIRs of both ears of every orientation, first the left ear one and then the right ear one
+		std::vector<uint64_t> delays;				//Delays of both ears of every orientation
+		std::vector<uint8_t> HRIRSet;				//For both ears of every orientation, 1 if its HRIR has been set (not a vector of bool, so several threads can set different elements)
+	};
+}
+#endif
@@ -0,0 +1,456 @@
+/**
+* \class CHybridAnechoicStereo
+*
+* \brief Hybrid convolution of one input signal with the impulse responses of both ears, direct FIR filter followed by partitions of increasing size
+* \date	October 2026
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#include <BinauralSpatializer/HybridAnechoicStereo.h>
+#include <Common/ErrorHandler.h>
+#include <algorithm>
+#include <cstring>
+
+namespace Binaural {
+	/////////////////////////////
+	// CONSTRUCTOR/DESTRUCTOR  //
+	/////////////////////////////
+	CHybridAnechoicStereo::CHybridAnechoicStereo() : inputSize{ 0 }, HRIRLength{ 0 }, numberOfSubfilters{ 0 }, setupDone{ false }
+	{
+	}
+
+	///////////////////
+	// Public Methods //
+	///////////////////
+
+	//Initialize the class and allocate memory
+	void CHybridAnechoicStereo::Setup(int _inputSize, int _HRIRLength, int _partitionsPerSegment)
+	{
+		ASSERT((_inputSize > 0) && ((_inputSize & (_inputSize - 1)) == 0), RESULT_ERROR_BADSIZE, "Input size of the hybrid convolver has to be a power of two", "");
+		ASSERT(_partitionsPerSegment >= 1, RESULT_ERROR_OUTOFRANGE, "The hybrid convolver needs at least one partition per segment", "");
+
+		setupDone = false;
+		segments.clear();
+
+		if ((_inputSize > 0) && ((_inputSize & (_inputSize - 1)) == 0) && (_partitionsPerSegment >= 1))	//Just in case error handler is off
+		{
+			inputSize = _inputSize;
+			HRIRLength = _HRIRLength;
+			numberOfSubfilters = GetNumberOfSubfilters(inputSize, HRIRLength, _partitionsPerSegment);
+			directOutput_buffer.assign(2 * 2 * inputSize, 0.0f);
+			leftIR_subfilters.reserve(numberOfSubfilters);
+			rightIR_subfilters.reserve(numberOfSubfilters);
+			leftIR_subfilterLengths.reserve(numberOfSubfilters);
+			rightIR_subfilterLengths.reserve(numberOfSubfilters);
+
+			CalculateSegments(inputSize, HRIRLength, _partitionsPerSegment, segments);
+			for (TSegment & segment : segments)
+			{
+				int L = segment.partitionSize;
+				segment.subfilterLength = 2 * L + 2;
+				segment.slotLength = Common::CalculateAlignedLength(segment.subfilterLength);
+				segment.FFTPlan.Setup(2 * L);
+				segment.FFTPlan.SetupBatch(2);
+				segment.inBuffer_Time_dobleSize.assign(2 * L, 0.0f);
+				segment.inBuffer_Frequency.assign(segment.subfilterLength, 0.0f);
+				segment.storageOutputFFT_buffer.assign(2 * segment.numberOfPartitions * segment.slotLength, 0.0f);
+				segment.storageOutputFFT_head = 0;
+				segment.outputIFFT_buffer.assign(2 * 2 * L, 0.0f);
+				segment.productIR.reserve(segment.numberOfPartitions);
+				segment.productOutputFFT.reserve(segment.numberOfPartitions);
+				segment.IFFT_input.assign(2, nullptr);
+				segment.IFFT_output = { segment.outputIFFT_buffer.data(), segment.outputIFFT_buffer.data() + 2 * L };
+
+				//Room for the copies of the HRIR and the input split by HRIR, so nothing is allocated when the HRIR changes
+				segment.storedIR.assign(2 * segment.numberOfPartitions * segment.subfilterLength, 0.0f);
+				segment.storedIR_partitions.clear();
+				for (int i = 0; i < 2 * segment.numberOfPartitions; i++) { segment.storedIR_partitions.push_back(segment.storedIR.data() + i * segment.subfilterLength); }
+				segment.storedIRValid = false;
+				segment.changedIR.assign(segment.storedIR.size(), 0.0f);
+				segment.changePhase = -1;
+				segment.repeatedChange = false;
+				segment.inBuffer_Time_storedIR.assign(2 * L, 0.0f);
+				segment.inBuffer_Time_currentIR.assign(2 * L, 0.0f);
+				segment.inBuffer_Frequency_storedIR.assign(segment.subfilterLength, 0.0f);
+				segment.FFT_input = { segment.inBuffer_Time_storedIR.data(), segment.inBuffer_Time_currentIR.data() };
+				segment.FFT_output = { segment.inBuffer_Frequency_storedIR.data(), segment.inBuffer_Frequency.data() };
+			}
+
+			//The outputs of each segment are added offset - L + B samples ahead of the current output and are 2*L samples long, the last segment is the one that reaches further
+			storageOutput_length = segments.empty() ? inputSize : segments.back().offset + segments.back().partitionSize + inputSize;
+			storageOutput_buffer.assign(2 * storageOutput_length, 0.0f);
+			storageOutput_head = 0;
+			blockCounter = 0;
+
+			setupDone = true;
+			SET_RESULT(RESULT_OK, "Hybrid convolver successfully set");
+		}
+	}//Setup
+
+	//Make the hybrid convolution of the input signal with the impulse responses of both ears
+	void CHybridAnechoicStereo::ProcessHybridConvolution(const CMonoBuffer<float>& inBuffer_Time, const TOneEarHRIRPartitionedStruct & leftIR, const TOneEarHRIRPartitionedStruct & rightIR, CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer)
+	{
+		GetSubfilters(leftIR.HRIR_Partitioned, leftIR_subfilters, leftIR_subfilterLengths);
+		GetSubfilters(rightIR.HRIR_Partitioned, rightIR_subfilters, rightIR_subfilterLengths);
+		ProcessHybridConvolution(inBuffer_Time, outLeftBuffer, outRightBuffer);
+	}
+
+	//Make the hybrid convolution of the input signal with the impulse responses of both ears, given as read-only views
+	void CHybridAnechoicStereo::ProcessHybridConvolution(const CMonoBuffer<float>& inBuffer_Time, const TOneEarHRIRPartitionedView & leftIR, const TOneEarHRIRPartitionedView & rightIR, CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer)
+	{
+		GetSubfilters(leftIR, leftIR_subfilters, leftIR_subfilterLengths);
+		GetSubfilters(rightIR, rightIR_subfilters, rightIR_subfilterLengths);
+		ProcessHybridConvolution(inBuffer_Time, outLeftBuffer, outRightBuffer);
+	}
+
+	//Split one HRIR in the FIR filter and the half spectra of the partitions of every segment
+	void CHybridAnechoicStereo::CalculateHRIR_Partitioned(const CMonoBuffer<float>& HRIR_Time, int inputSize, int HRIRLength, int partitionsPerSegment, std::vector<CMonoBuffer<float>>& HRIR_Partitioned)
+	{
+		ASSERT((inputSize > 0) && (partitionsPerSegment >= 1), RESULT_ERROR_BADSIZE, "Bad input size or number of partitions per segment to split the HRIR for the hybrid convolution", "");
+
+		HRIR_Partitioned.clear();
+		if ((inputSize > 0) && (partitionsPerSegment >= 1))	//Just in case error handler is off
+		{
+			HRIR_Partitioned.reserve(GetNumberOfSubfilters(inputSize, HRIRLength, partitionsPerSegment));
+
+			//FIR filter, the samples beyond the end of the HRIR are zeros
+			int end = std::min(inputSize, (int)HRIR_Time.size());
+			CMonoBuffer<float> directFilter(inputSize, 0.0f);
+			std::copy(HRIR_Time.begin(), HRIR_Time.begin() + end, directFilter.begin());
+			HRIR_Partitioned.push_back(std::move(directFilter));
+
+			//Each partition is extended with L zeros before the FFT
+			std::vector<TSegment> segments;
+			CalculateSegments(inputSize, HRIRLength, partitionsPerSegment, segments);
+			for (const TSegment & segment : segments)
+			{
+				int L = segment.partitionSize;
+				std::vector<float> partition_Time(2 * L);
+				for (int i = 0; i < segment.numberOfPartitions; i++)
+				{
+					int begin = std::min(segment.offset + i * L, (int)HRIR_Time.size());
+					end = std::min(begin + L, (int)HRIR_Time.size());
+					std::fill(partition_Time.begin(), partition_Time.end(), 0.0f);
+					std::copy(HRIR_Time.begin() + begin, HRIR_Time.begin() + end, partition_Time.begin());
+
+					CMonoBuffer<float> partition_Frequency;
+					Common::CFprocessor::CalculateFFT_HalfSpectrum(partition_Time, partition_Frequency);
+					HRIR_Partitioned.push_back(std::move(partition_Frequency));
+				}
+			}
+		}
+	}
+
+	//Number of elements of one HRIR in the hybrid layout
+	int CHybridAnechoicStereo::GetNumberOfSubfilters(int inputSize, int HRIRLength, int partitionsPerSegment)
+	{
+		std::vector<TSegment> segments;
+		CalculateSegments(inputSize, HRIRLength, partitionsPerSegment, segments);
+		int numberOfSubfilters = 1;
+		for (const TSegment & segment : segments) { numberOfSubfilters += segment.numberOfPartitions; }
+		return numberOfSubfilters;
+	}
+
+	/////////////////////
+	// Private Methods //
+	/////////////////////
+
+	//The first segment starts after the FIR filter. A segment with partitions of L samples starts, at least, L - B samples after the beginning of the HRIR,
+	//so the output of any L consecutive input samples is ready when the first of them has to be played, wherever they begin
+	void CHybridAnechoicStereo::CalculateSegments(int inputSize, int HRIRLength, int partitionsPerSegment, std::vector<TSegment>& segments)
+	{
+		segments.clear();
+		if ((inputSize <= 0) || (partitionsPerSegment < 1)) { return; }
+
+		int offset = inputSize;
+		int firstSubfilter = 1;
+		int partitionSize = 2 * inputSize;
+		while (offset < HRIRLength)
+		{
+			TSegment newSegment;
+			newSegment.partitionSize = partitionSize;
+			newSegment.numberOfPartitions = std::min(partitionsPerSegment, (HRIRLength - offset + partitionSize - 1) / partitionSize);
+			newSegment.firstSubfilter = firstSubfilter;
+			newSegment.offset = offset;
+			newSegment.period = partitionSize / inputSize;
+			newSegment.phaseShift = newSegment.period / 2;
+			segments.push_back(std::move(newSegment));
+
+			offset += segments.back().numberOfPartitions * partitionSize;
+			firstSubfilter += segments.back().numberOfPartitions;
+			partitionSize *= 2;
+		}
+	}
+
+	//Keep the data and the size of the subfilters of one HRIR
+	void CHybridAnechoicStereo::GetSubfilters(const std::vector<CMonoBuffer<float>> & IR, std::vector<const float*> & subfilters, std::vector<int> & subfilterLengths)
+	{
+		subfilters.clear();
+		subfilterLengths.clear();
+		for (const CMonoBuffer<float> & subfilter : IR)
+		{
+			subfilters.push_back(subfilter.data());
+			subfilterLengths.push_back(subfilter.size());
+		}
+	}
+
+	//Keep the data and the size of the subfilters of the view of one HRIR
+	void CHybridAnechoicStereo::GetSubfilters(const TOneEarHRIRPartitionedView & IR, std::vector<const float*> & subfilters, std::vector<int> & subfilterLengths)
+	{
+		subfilters.clear();
+		subfilterLengths.clear();
+		for (int i = 0; i < IR.numberOfSubfilters; i++)
+		{
+			subfilters.push_back(IR.HRIR + IR.subfilterOffsets[i]);
+			subfilterLengths.push_back(IR.subfilterLengths[i]);
+		}
+	}
+
+	//Make the hybrid convolution of the input signal with the subfilters kept in leftIR_subfilters and rightIR_subfilters
+	void CHybridAnechoicStereo::ProcessHybridConvolution(const CMonoBuffer<float>& inBuffer_Time, CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer)
+	{
+		ASSERT(setupDone, RESULT_ERROR_NOTINITIALIZED, "The hybrid convolver has not been set up", "");
+		ASSERT(inBuffer_Time.size() == (size_t)inputSize, RESULT_ERROR_BADSIZE, "Bad input size, don't match with the size setting up in the setup method", "");
+		ASSERT(IsHybridLayout(), RESULT_ERROR_BADSIZE, "The HRIRs don't have the hybrid layout of the hybrid convolver", "");
+
+		outLeftBuffer.assign(inputSize, 0.0f);
+		outRightBuffer.assign(inputSize, 0.0f);
+
+		if (setupDone && (inBuffer_Time.size() == (size_t)inputSize) && IsHybridLayout())	//Just in case error handler is off
+		{
+			//First B coefficients, in time domain
+			ProcessDirectConvolution(inBuffer_Time, outLeftBuffer, outRightBuffer);
+
+			//Rest of the HRIR, each segment when it has received L new samples. The L samples of each segment are shifted half its period,
+			//so the segment k is only convolved in the blocks whose number plus one has k trailing zeros, and no two segments are convolved in the same block
+			for (TSegment & segment : segments)
+			{
+				//Store the input block in the first half of the time buffer of the segment, after the blocks already received
+				int phase = (blockCounter + segment.phaseShift) % segment.period;
+				std::copy(inBuffer_Time.begin(), inBuffer_Time.end(), segment.inBuffer_Time_dobleSize.begin() + phase * inputSize);
+				ProcessHRIRChanges(segment, phase);
+
+				if (phase == segment.period - 1) { ProcessSegment(segment); }
+			}
+			blockCounter++;
+			if (segments.empty() || (blockCounter == segments.back().period)) { blockCounter = 0; }
+
+			//Take the outputs of the segments for the current block from the ring buffers and leave their place free for the outputs to come
+			float* leftOutput = storageOutput_buffer.data() + storageOutput_head;
+			float* rightOutput = leftOutput + storageOutput_length;
+			for (int i = 0; i < inputSize; i++)
+			{
+				outLeftBuffer[i] += leftOutput[i];
+				outRightBuffer[i] += rightOutput[i];
+			}
+			std::fill(leftOutput, leftOutput + inputSize, 0.0f);
+			std::fill(rightOutput, rightOutput + inputSize, 0.0f);
+			storageOutput_head += inputSize;
+			if (storageOutput_head == storageOutput_length) { storageOutput_head = 0; }
+		}
+	}
+
+	//Linear convolution of the input block with the FIR filter of each ear. The first B samples are the output of this block, and the rest are kept for the next one
+	void CHybridAnechoicStereo::ProcessDirectConvolution(const CMonoBuffer<float>& inBuffer_Time, CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer)
+	{
+		for (int ear = 0; ear < 2; ear++)
+		{
+			const float* directFilter = (ear == 0) ? leftIR_subfilters[0] : rightIR_subfilters[0];
+			int directFilterLength = (ear == 0) ? leftIR_subfilterLengths[0] : rightIR_subfilterLengths[0];
+			CMonoBuffer<float>& outBuffer = (ear == 0) ? outLeftBuffer : outRightBuffer;
+			float* directOutput = directOutput_buffer.data() + ear * 2 * inputSize;
+
+			Common::CFprocessor::ProcessDirectConvolution(inBuffer_Time.data(), inputSize, directFilter, directFilterLength, directOutput);
+			std::copy(directOutput, directOutput + inputSize, outBuffer.begin());
+			std::copy(directOutput + inputSize, directOutput + 2 * inputSize, directOutput);
+			std::fill(directOutput + inputSize, directOutput + 2 * inputSize, 0.0f);
+		}
+	}
+
+	//The FIR filter has B coefficients and every partition has the size of the half spectrum of its segment
+	bool CHybridAnechoicStereo::IsHybridLayout() const
+	{
+		if ((leftIR_subfilterLengths.size() != (size_t)numberOfSubfilters) || (rightIR_subfilterLengths.size() != (size_t)numberOfSubfilters)) { return false; }
+		if ((leftIR_subfilterLengths[0] != inputSize) || (rightIR_subfilterLengths[0] != inputSize)) { return false; }
+		for (const TSegment & segment : segments)
+		{
+			for (int i = segment.firstSubfilter; i < segment.firstSubfilter + segment.numberOfPartitions; i++)
+			{
+				if ((leftIR_subfilterLengths[i] != segment.subfilterLength) || (rightIR_subfilterLengths[i] != segment.subfilterLength)) { return false; }
+			}
+		}
+		return true;
+	}
+
+	//Each input block has to be convolved with the HRIR received with it. Only the first change in the L samples of the segment is noted, and then whether it changes again
+	void CHybridAnechoicStereo::ProcessHRIRChanges(TSegment & segment, int phase)
+	{
+		if (!segment.storedIRValid)
+		{
+			//The samples received before the first HRIR are zeros
+			StoreHRIR(segment, segment.storedIR);
+			segment.storedIRValid = true;
+		}
+		else if (segment.changePhase < 0)
+		{
+			if (!IsStoredHRIR(segment, segment.storedIR))
+			{
+				segment.changePhase = phase;
+				StoreHRIR(segment, segment.changedIR);
+			}
+		}
+		else if (!segment.repeatedChange)
+		{
+			segment.repeatedChange = !IsStoredHRIR(segment, segment.changedIR);
+		}
+	}
+
+	//Get the partitions of one segment of the current HRIR of one ear
+	const float* const* CHybridAnechoicStereo::GetPartitions(const TSegment & segment, Common::T_ear ear) const
+	{
+		const std::vector<const float*> & subfilters = (ear == Common::T_ear::LEFT) ? leftIR_subfilters : rightIR_subfilters;
+		return subfilters.data() + segment.firstSubfilter;
+	}
+
+	//Compare the partitions of one segment of the current HRIR of both ears with a copy
+	bool CHybridAnechoicStereo::IsStoredHRIR(const TSegment & segment, const std::vector<float> & stored) const
+	{
+		const float* storedPartition = stored.data();
+		for (Common::T_ear ear : { Common::T_ear::LEFT, Common::T_ear::RIGHT })
+		{
+			const float* const* partitions = GetPartitions(segment, ear);
+			for (int i = 0; i < segment.numberOfPartitions; i++)
+			{
+				if (std::memcmp(partitions[i], storedPartition, segment.subfilterLength * sizeof(float)) != 0) { return false; }
+				storedPartition += segment.subfilterLength;
+			}
+		}
+		return true;
+	}
+
+	//Copy the partitions of one segment of the current HRIR of both ears
+	void CHybridAnechoicStereo::StoreHRIR(const TSegment & segment, std::vector<float> & stored) const
+	{
+		float* storedPartition = stored.data();
+		for (Common::T_ear ear : { Common::T_ear::LEFT, Common::T_ear::RIGHT })
+		{
+			const float* const* partitions = GetPartitions(segment, ear);
+			for (int i = 0; i < segment.numberOfPartitions; i++)
+			{
+				std::copy(partitions[i], partitions[i] + segment.subfilterLength, storedPartition);
+				storedPartition += segment.subfilterLength;
+			}
+		}
+	}
+
+	//Overlap-add convolution of the last L input samples with the partitions of one segment. Each input sample is transformed only once,
+	//so every block is convolved with its own HRIR, also the last samples of its output, which are played during the next L samples
+	void CHybridAnechoicStereo::ProcessSegment(TSegment & segment)
+	{
+		int L = segment.partitionSize;
+
+		if (segment.changePhase < 0)
+		{
+			//FFT of the last L samples followed by L zeros, shared by both ears
+			segment.FFTPlan.CalculateFFT_HalfSpectrum(segment.inBuffer_Time_dobleSize.data(), segment.inBuffer_Time_dobleSize.size(), segment.inBuffer_Frequency.data());
+		}
+		else
+		{
+			//The blocks received before the HRIR changed are convolved with the copy of the previous one
+			ProcessSegmentInputFFT_SplitByHRIR(segment);
+			ProcessSegmentMultiplyAccumulate(segment, segment.inBuffer_Frequency_storedIR.data(), segment.storedIR_partitions.data(), Common::T_ear::LEFT);
+			ProcessSegmentMultiplyAccumulate(segment, segment.inBuffer_Frequency_storedIR.data(), segment.storedIR_partitions.data() + segment.numberOfPartitions, Common::T_ear::RIGHT);
+
+			//The current HRIR is the one of the last block, the previous one for the next L samples
+			StoreHRIR(segment, segment.storedIR);
+			segment.changePhase = -1;
+			segment.repeatedChange = false;
+		}
+		ProcessSegmentMultiplyAccumulate(segment, segment.inBuffer_Frequency.data(), GetPartitions(segment, Common::T_ear::LEFT), Common::T_ear::LEFT);
+		ProcessSegmentMultiplyAccumulate(segment, segment.inBuffer_Frequency.data(), GetPartitions(segment, Common::T_ear::RIGHT), Common::T_ear::RIGHT);
+
+		//IFFT of the current output of both ears at once. It is the output of the L samples that have just been received, and the 2*L samples of the result
+		//have to be played offset samples later, that is, from offset - L + B samples after the first sample of the current output block
+		segment.IFFT_input[0] = GetOutputFFT(segment, 0, Common::T_ear::LEFT);
+		segment.IFFT_input[1] = GetOutputFFT(segment, 0, Common::T_ear::RIGHT);
+		segment.FFTPlan.CalculateIFFT_HalfSpectrum(segment.IFFT_input, segment.IFFT_output);
+		for (int ear = 0; ear < 2; ear++)
+		{
+			const float* segmentOutput = segment.IFFT_output[ear];
+			float* storageOutput = storageOutput_buffer.data() + ear * storageOutput_length;
+			int position = storageOutput_head + segment.offset - L + inputSize;
+			if (position >= storageOutput_length) { position -= storageOutput_length; }
+			for (int i = 0; i < 2 * L; i++)
+			{
+				storageOutput[position] += segmentOutput[i];
+				position++;
+				if (position == storageOutput_length) { position = 0; }
+			}
+		}
+
+		//Clear the spectra that have just been played and move the head waiting for the next L input samples
+		float* leftOutputFFT = GetOutputFFT(segment, 0, Common::T_ear::LEFT);
+		float* rightOutputFFT = GetOutputFFT(segment, 0, Common::T_ear::RIGHT);
+		std::fill(leftOutputFFT, leftOutputFFT + segment.subfilterLength, 0.0f);
+		std::fill(rightOutputFFT, rightOutputFFT + segment.subfilterLength, 0.0f);
+		segment.storageOutputFFT_head++;
+		if (segment.storageOutputFFT_head == segment.numberOfPartitions) { segment.storageOutputFFT_head = 0; }
+	}
+
+	//If the HRIR has changed again, the blocks received after the first change are crossfaded linearly from the copy to the HRIR of the current block.
+	//The second half of both parts is always zero
+	void CHybridAnechoicStereo::ProcessSegmentInputFFT_SplitByHRIR(TSegment & segment)
+	{
+		const std::vector<float> & input = segment.inBuffer_Time_dobleSize;
+		for (int phase = 0; phase < segment.period; phase++)
+		{
+			float storedIRWeight = 0.0f;
+			if (phase < segment.changePhase) { storedIRWeight = 1.0f; }
+			else if (segment.repeatedChange) { storedIRWeight = 1.0f - (float)(phase - segment.changePhase + 1) / (float)(segment.period - segment.changePhase); }
+
+			int begin = phase * inputSize;
+			for (int i = begin; i < begin + inputSize; i++)
+			{
+				segment.inBuffer_Time_storedIR[i] = storedIRWeight * input[i];
+				segment.inBuffer_Time_currentIR[i] = input[i] - segment.inBuffer_Time_storedIR[i];
+			}
+		}
+		segment.FFTPlan.CalculateFFT_HalfSpectrum(segment.FFT_input, 2 * segment.partitionSize, segment.FFT_output);
+	}
+
+	//The product with the partition i has to appear i blocks of L samples later
+	void CHybridAnechoicStereo::ProcessSegmentMultiplyAccumulate(TSegment & segment, const float* input_Frequency, const float* const* partitions, Common::T_ear ear)
+	{
+		segment.productIR.clear();
+		segment.productOutputFFT.clear();
+		for (int i = 0; i < segment.numberOfPartitions; i++)
+		{
+			segment.productIR.push_back(partitions[i]);
+			segment.productOutputFFT.push_back(GetOutputFFT(segment, i, ear));
+		}
+		Common::CFprocessor::ProcessComplexMultiplyAccumulate(input_Frequency, segment.productIR, segment.productOutputFFT, segment.subfilterLength);
+	}
+
+	//Get the spectrum of the output of one segment and one ear that is delay blocks of L samples later than the current one
+	float* CHybridAnechoicStereo::GetOutputFFT(TSegment & segment, int delay, Common::T_ear ear)
+	{
+		int slot = segment.storageOutputFFT_head + delay;
+		if (slot >= segment.numberOfPartitions) { slot -= segment.numberOfPartitions; }
+		if (ear == Common::T_ear::RIGHT) { slot += segment.numberOfPartitions; }
+		return segment.storageOutputFFT_buffer.data() + slot * segment.slotLength;
+	}
+}
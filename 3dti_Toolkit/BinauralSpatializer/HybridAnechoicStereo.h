@@ -0,0 +1,213 @@
+/**
+* \class CHybridAnechoicStereo
+*
+* \brief Declaration of CHybridAnechoicStereo class interface.
+* \date	October 2026
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#ifndef _CHYBRIDANECHOICSTEREO_H_
+#define _CHYBRIDANECHOICSTEREO_H_
+
+#include <vector>
+#include <Common/Fprocessor.h>
+#include <Common/FFTPlan.h>
+#include <Common/Buffer.h>
+#include <Common/AlignedAllocator.h>
+#include <BinauralSpatializer/HRTF.h>
+
+/** \brief Default number of partitions of each segment of the hybrid HRTF convolution
+*/
+#define DEFAULT_HYBRID_PARTITIONS_PER_SEGMENT 2
+
+namespace Binaural {
+
+	/** \details This class implements a hybrid convolution of one input signal with the impulse responses of both ears, for the anechoic path,
+	*	designed for small input buffers (B), where the uniformly partitioned convolution needs many FFTs per sample.
+	*	The first B coefficients of the HRIR are convolved with a direct FIR filter in time domain. The rest of the HRIR is split in segments of partitions of the same size,
+	*	and the partitions of each segment are twice as long as the ones of the previous segment (2B, 4B, 8B...). Each segment is convolved in the frequency domain
+	*	only when it has received as many input samples as its partition size, and the input FFT of each segment is shared by both ears.
+	*	The output of every block includes the convolution of the samples of that same block, so the latency is the same as the one of the UPC algorithm.
+	*	The blocks in which the segments are convolved are interleaved, so at most one segment is transformed in each block. The cost of each block is not constant, though:
+	*	every L/B blocks, the block that convolves the segment of the largest partitions also calculates one FFT and two IFFTs of 2L points, which the UPC algorithm would split
+	*	in FFTs of 2B points over L/B blocks. The average cost is much lower, but the worst block is more expensive than a block of the UPC algorithm when the HRIR is long.
+	*	\details The HRIRs are given in the hybrid layout calculated by CalculateHRIR_Partitioned: first the B coefficients of the FIR filter in time domain,
+	*	then the half spectrum of each partition, in the same order as in the HRIR. As in the UPC method with memory, each input block has to be convolved with the HRIR received with it.
+	*	The FIR filter does so in every block, but each segment convolves L/B blocks at once, with the overlap-add method, so every input sample is transformed only once.
+	*	Each segment keeps a copy of its partitions of the HRIR used for its last block and notes the first block in which the HRIR changes. Then, the blocks received before the change
+	*	are convolved with the copy and the rest with the HRIR of the current block, which costs one more FFT and one more product for each partition.
+	*	The result is exact when the HRIR changes once at most in the L/B blocks of the segment. If it changes again, as it happens with a source that moves in every block,
+	*	the blocks received after the first change are crossfaded from the copy to the HRIR of the current block, approximating the intermediate HRIRs by their interpolation.
+	*	\details Gardner, W. G. (1995). Efficient convolution without input-output delay. Journal of the Audio Engineering Society, 43(3), 127-136.
+	*/
+	class CHybridAnechoicStereo
+	{
+
+	public:
+
+		/** \brief Default constructor
+		*   \eh Nothing is reported to the error handler.
+		*/
+		CHybridAnechoicStereo();
+
+		/** \brief Initialize the class and allocate memory.
+		*	\param [in] _inputSize size of the input signal buffer (B size). It has to be a power of two.
+		*	\param [in] _HRIRLength length of the HRIRs in time domain
+		*	\param [in] _partitionsPerSegment number of partitions of each segment of the frequency-domain part
+		*   \eh On success, RESULT_OK is reported to the error handler.
+		*       On error, an error code is reported to the error handler.
+		*/
+		void Setup(int _inputSize, int _HRIRLength, int _partitionsPerSegment = DEFAULT_HYBRID_PARTITIONS_PER_SEGMENT);
+
+		/** \brief Process the hybrid convolution of the input signal with the impulse responses of both ears
+		*	\param [in] inBuffer_Time input signal buffer of B size
+		*	\param [in] leftIR left ear HRIR in the hybrid layout returned by CalculateHRIR_Partitioned
+		*	\param [in] rightIR right ear HRIR in the hybrid layout returned by CalculateHRIR_Partitioned
+		*	\param [out] outLeftBuffer left ear output signal of B size
+		*	\param [out] outRightBuffer right ear output signal of B size
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void ProcessHybridConvolution(const CMonoBuffer<float>& inBuffer_Time, const TOneEarHRIRPartitionedStruct & leftIR, const TOneEarHRIRPartitionedStruct & rightIR, CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer);
+
+		/** \brief Process the hybrid convolution of the input signal with the impulse responses of both ears, given as read-only views
+		*	\details The views have to stay valid until the method returns, they are not kept for the next blocks
+		*	\param [in] inBuffer_Time input signal buffer of B size
+		*	\param [in] leftIR view of the left ear HRIR in the hybrid layout
+		*	\param [in] rightIR view of the right ear HRIR in the hybrid layout
+		*	\param [out] outLeftBuffer left ear output signal of B size
+		*	\param [out] outRightBuffer right ear output signal of B size
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void ProcessHybridConvolution(const CMonoBuffer<float>& inBuffer_Time, const TOneEarHRIRPartitionedView & leftIR, const TOneEarHRIRPartitionedView & rightIR, CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer);
+
+		/** \brief Split one HRIR in the hybrid layout used by this class
+		*	\details The first element has the first B coefficients of the HRIR, in time domain. Each one of the next elements is the half spectrum of one partition of L samples
+		*	(the FFT of the partition followed by L zeros, 2*L + 2 values), with L = 2B for the first segment, 4B for the second one, and so on.
+		*	\param [in] HRIR_Time HRIR in time domain
+		*	\param [in] inputSize size of the input signal buffer (B size)
+		*	\param [in] HRIRLength length of all the HRIRs of the HRTF. HRIR_Time is extended with zeros up to this length
+		*	\param [in] partitionsPerSegment number of partitions of each segment of the frequency-domain part
+		*	\param [out] HRIR_Partitioned HRIR in the hybrid layout
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		static void CalculateHRIR_Partitioned(const CMonoBuffer<float>& HRIR_Time, int inputSize, int HRIRLength, int partitionsPerSegment, std::vector<CMonoBuffer<float>>& HRIR_Partitioned);
+
+		/** \brief Get the number of elements of the HRIRs in the hybrid layout, the FIR filter and all the partitions
+		*	\param [in] inputSize size of the input signal buffer (B size)
+		*	\param [in] HRIRLength length of the HRIRs in time domain
+		*	\param [in] partitionsPerSegment number of partitions of each segment of the frequency-domain part
+		*	\retval numberOfSubfilters number of elements of each HRIR
+		*   \eh Nothing is reported to the error handler.
+		*/
+		static int GetNumberOfSubfilters(int inputSize, int HRIRLength, int partitionsPerSegment);
+
+	private:
+		// Data of one segment of partitions of the same size
+		struct TSegment {
+			int partitionSize;								//Size of the partitions of this segment (L), a multiple of B
+			int numberOfPartitions;							//Number of partitions of this segment
+			int firstSubfilter;								//Position in the HRIR of the half spectrum of the first partition of this segment
+			int offset;										//Position in the time-domain HRIR of the first sample of this segment
+			int period;										//Number of input blocks needed to complete L samples (L / B)
+			int phaseShift;									//Number of blocks that the L samples of this segment are shifted, so it is not convolved in the same block as the other segments
+			int subfilterLength;							//Size of the half spectrum of the FFT of 2*L points, 2*L + 2
+			int slotLength;									//Distance between two output spectra, rounded up to keep every one aligned
+			Common::CFFTPlan FFTPlan;						//FFT tables of 2*L points
+			std::vector<float> inBuffer_Time_dobleSize;		//Last L input samples followed by L zeros
+			std::vector<float> inBuffer_Frequency;			//FFT of inBuffer_Time_dobleSize, shared by both ears
+			std::vector<float> storedIR;					//Copy of the partitions of both ears of the HRIR used for the last input block, first the left ear ones and then the right ear ones
+			std::vector<const float*> storedIR_partitions;	//Partitions of storedIR, the left ear ones followed by the right ear ones
+			bool storedIRValid;								//It's false until the first HRIR has been copied in storedIR
+			std::vector<float> changedIR;					//Copy of the partitions of both ears of the HRIR of the block in which it has changed, to know if it changes again
+			int changePhase;								//Position in the L samples of the first block received with an HRIR different from storedIR, -1 if it has not changed
+			bool repeatedChange;							//It's true when the HRIR has changed again after changePhase
+			std::vector<float> inBuffer_Time_storedIR;		//Part of inBuffer_Time_dobleSize convolved with storedIR
+			std::vector<float> inBuffer_Time_currentIR;		//Part of inBuffer_Time_dobleSize convolved with the HRIR of the current block
+			std::vector<float> inBuffer_Frequency_storedIR;	//FFT of inBuffer_Time_storedIR
+			std::vector<const float*> FFT_input;			//Parts of the input with different HRIRs, transformed at once
+			std::vector<float*> FFT_output;					//Spectra of the parts of the input with different HRIRs
+			Common::CAlignedVector<float> storageOutputFFT_buffer;	//Spectra of the next outputs of this segment, one slot for each partition, first the left ear ones and then the right ear ones
+			int storageOutputFFT_head;						//Slot with the spectrum of the current output. The output i blocks of L samples later is accumulated in the slot (head + i) % number of partitions
+			std::vector<float> outputIFFT_buffer;			//IFFT of the current output spectra, 2*L samples of the left ear followed by 2*L samples of the right ear
+			std::vector<const float*> productIR;			//Subfilters multiplied in each block
+			std::vector<float*> productOutputFFT;			//Output spectra where the products of each block are accumulated
+			std::vector<const float*> IFFT_input;			//Current output spectra of both ears, transformed at once
+			std::vector<float*> IFFT_output;				//Halves of outputIFFT_buffer where the IFFT of each ear is written
+		};
+
+		///////////////
+		// ATTRIBUTES
+		///////////////
+		int inputSize;									//Size of the inputs buffer (B)
+		int HRIRLength;									//Length of the HRIRs in time domain
+		int numberOfSubfilters;							//Number of elements of each HRIR, the FIR filter and all the partitions
+		bool setupDone;
+
+		std::vector<float> directOutput_buffer;			//Outputs of the FIR filter, 2*B samples of the left ear followed by 2*B samples of the right ear. The second half of each one is the tail of the current block, to be added to the next one
+		std::vector<TSegment> segments;					//Segments of the frequency-domain part of the HRIR, with partitions of increasing size
+		std::vector<float> storageOutput_buffer;		//Ring buffers where every segment adds its outputs, in time domain, at the position where they have to be played. First the left ear one and then the right ear one
+		int storageOutput_length;						//Length of the ring buffer of each ear
+		int storageOutput_head;							//Position in the ring buffers of the output of the current block
+		int blockCounter;								//Number of input blocks processed, modulo the period of the last segment
+		std::vector<const float*> leftIR_subfilters;	//Subfilters of the left ear HRIR of the current block
+		std::vector<const float*> rightIR_subfilters;	//Subfilters of the right ear HRIR of the current block
+		std::vector<int> leftIR_subfilterLengths;		//Size of each subfilter of the left ear HRIR of the current block
+		std::vector<int> rightIR_subfilterLengths;		//Size of each subfilter of the right ear HRIR of the current block
+
+		///////////////
+		// METHODS
+		///////////////
+		//Calculate the partition size and the number of partitions of each segment
+		static void CalculateSegments(int inputSize, int HRIRLength, int partitionsPerSegment, std::vector<TSegment>& segments);
+
+		//Keep the data and the size of the subfilters of one HRIR, from its buffers or from its view
+		static void GetSubfilters(const std::vector<CMonoBuffer<float>> & IR, std::vector<const float*> & subfilters, std::vector<int> & subfilterLengths);
+		static void GetSubfilters(const TOneEarHRIRPartitionedView & IR, std::vector<const float*> & subfilters, std::vector<int> & subfilterLengths);
+
+		//Convolution of the public methods, with the subfilters kept in leftIR_subfilters and rightIR_subfilters
+		void ProcessHybridConvolution(const CMonoBuffer<float>& inBuffer_Time, CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer);
+
+		//Convolve the input block with the FIR filter of each ear and add the results to the outputs
+		void ProcessDirectConvolution(const CMonoBuffer<float>& inBuffer_Time, CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer);
+
+		//Check that the subfilters of both ears have the sizes of the hybrid layout
+		bool IsHybridLayout() const;
+
+		//Compare the partitions of one segment of the current HRIR with the copies of storedIR and changedIR, to know in which blocks it changes
+		void ProcessHRIRChanges(TSegment & segment, int phase);
+
+		//Get the partitions of one segment of the current HRIR of one ear
+		const float* const* GetPartitions(const TSegment & segment, Common::T_ear ear) const;
+
+		//Compare the partitions of one segment of the current HRIR of both ears with a copy, or copy them
+		bool IsStoredHRIR(const TSegment & segment, const std::vector<float> & stored) const;
+		void StoreHRIR(const TSegment & segment, std::vector<float> & stored) const;
+
+		//Convolve the last L input samples with the partitions of one segment of both ears and add the results to the output ring buffers
+		void ProcessSegment(TSegment & segment);
+
+		//Split the last L input samples of one segment in the blocks received before the HRIR changed and the rest, and calculate the FFT of both parts
+		void ProcessSegmentInputFFT_SplitByHRIR(TSegment & segment);
+
+		//Multiply one input FFT of one segment by its partitions of one ear, adding each product to the spectrum of the output in which it has to appear
+		void ProcessSegmentMultiplyAccumulate(TSegment & segment, const float* input_Frequency, const float* const* partitions, Common::T_ear ear);
+
+		//Get the spectrum of the output of one segment and one ear that is delay blocks of L samples later than the current one
+		float* GetOutputFFT(TSegment & segment, int delay, Common::T_ear ear);
+	};
+}
+#endif
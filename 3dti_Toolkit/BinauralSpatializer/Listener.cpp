@@ -308,6 +308,21 @@ namespace Binaural
 		return ownerCore->GetHRTFResamplingStep();
 	}
 
+	int CListener::GetHRTFResamplingThreads() const
+	{
+		return ownerCore->GetHRTFResamplingThreads();
+	}
+
+	bool CListener::IsHybridHRTFConvolutionEnabled() const
+	{
+		return ownerCore->IsHybridHRTFConvolutionEnabled();
+	}
+
+	int CListener::GetHybridHRTFPartitionsPerSegment() const
+	{
+		return ownerCore->GetHybridHRTFPartitionsPerSegment();
+	}
+
 	//Reset HRTF
 	void CListener::ResetHRTF() {
 		listenerHRTF->Reset();		
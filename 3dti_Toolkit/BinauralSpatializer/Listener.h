@@ -199,6 +199,24 @@ class CHRTF;
 		*   \eh Nothing is reported to the error handler.
 		*/
 		int GetHRTFResamplingStep() const;
+
+		/** \brief Get from owner core the number of threads that calculate the HRTF resampled table
+		*	\retval numberOfThreads number of threads, 0 means that it is chosen automatically
+		*   \eh Nothing is reported to the error handler.
+		*/
+		int GetHRTFResamplingThreads() const;
+
+		/** \brief Get from owner core if the HRTF has to be partitioned for the hybrid convolution
+		*	\retval enabled true if the hybrid HRTF convolution is enabled in the owner core
+		*   \eh Nothing is reported to the error handler.
+		*/
+		bool IsHybridHRTFConvolutionEnabled() const;
+
+		/** \brief Get from owner core the number of partitions of each segment of the hybrid HRTF convolution
+		*	\retval partitionsPerSegment number of partitions of each segment
+		*   \eh Nothing is reported to the error handler.
+		*/
+		int GetHybridHRTFPartitionsPerSegment() const;
 		
 	private:
 		// Set the notification that a new HRTF has been loaded into CHRTF class				
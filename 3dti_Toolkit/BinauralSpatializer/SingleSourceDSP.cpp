@@ -22,6 +22,8 @@
 */
 #include <BinauralSpatializer/SingleSourceDSP.h>
 #include <Common/ErrorHandler.h>
+#include <algorithm>
+#include <cmath>
 
 //#define USE_PROFILER_SingleSourceDSP
 #ifdef USE_PROFILER_SingleSourceDSP
@@ -39,9 +41,19 @@ namespace Binaural {
 
 	//Constructor called from CCore class
 	CSingleSourceDSP::CSingleSourceDSP(CCore* _ownerCore)
-		:ownerCore{ _ownerCore }, enableInterpolation{ true }, enableFarDistanceEffect{ true }, enableDistanceAttenuationAnechoic{ true }, attenuationSmooth{ true }, 
+		:ownerCore{ _ownerCore }, enableHRIRReuse{ true }, HRIRReuseTolerance{ DEFAULT_HRIR_REUSE_TOLERANCE }, HRIRReuseHits{ 0 }, HRIRReuseMisses{ 0 }, HRTFVersion{ 0 }, HRTFCrossfadeBlocksLeft{ 0 },
+		enableInterpolation{ true }, enableFarDistanceEffect{ true }, enableDistanceAttenuationAnechoic{ true }, attenuationSmooth{ true }, 
 		enableNearFieldEffect{ true },	spatializationMode{ TSpatializationMode::HighQuality}
 	{
+		reusedHRIR.valid = false;
+		frequencyDomainBuses = nullptr;
+		busLeftDelay = 0;
+		busRightDelay = 0;
+		busLeftGain = 1.0f;
+		busRightGain = 1.0f;
+		busLeftHRIR = TOneEarHRIRPartitionedView();
+		busRightHRIR = TOneEarHRIRPartitionedView();
+
 		// TO THINK: our initial idea was not to use error handler in constructors. Should this this an exception to the rule?
 		//if (owner == NULL)
 		//	SET_RESULT(RESULT_ERROR_NULLPOINTER, "3DTI Toolkit Core not created");
@@ -176,6 +188,32 @@ namespace Binaural {
 	///Get the flag for HRTF interpolation method
 	bool CSingleSourceDSP::IsInterpolationEnabled() { return enableInterpolation; }
 
+	///Enable the reuse of the HRIRs of the previous blocks
+	void CSingleSourceDSP::EnableHRIRReuse() { enableHRIRReuse = true; }
+	///Disable the reuse of the HRIRs of the previous blocks
+	void CSingleSourceDSP::DisableHRIRReuse() { enableHRIRReuse = false; reusedHRIR.valid = false; }
+	///Get the flag for the reuse of the HRIRs of the previous blocks
+	bool CSingleSourceDSP::IsHRIRReuseEnabled() const { return enableHRIRReuse; }
+
+	///Set the angular tolerance to reuse the HRIRs of the previous blocks
+	void CSingleSourceDSP::SetHRIRReuseTolerance(float toleranceDegrees)
+	{
+		ASSERT(toleranceDegrees >= 0.0f, RESULT_ERROR_OUTOFRANGE, "The tolerance to reuse the HRIRs can not be negative", "");
+		if (toleranceDegrees >= 0.0f)	//Just in case error handler is off
+		{
+			HRIRReuseTolerance = toleranceDegrees;
+		}
+	}
+	///Get the angular tolerance to reuse the HRIRs of the previous blocks
+	float CSingleSourceDSP::GetHRIRReuseTolerance() const { return HRIRReuseTolerance; }
+
+	///Get the number of blocks with reused HRIRs
+	uint64_t CSingleSourceDSP::GetHRIRReuseHits() const { return HRIRReuseHits; }
+	///Get the number of blocks with HRIRs got from the HRTF
+	uint64_t CSingleSourceDSP::GetHRIRReuseMisses() const { return HRIRReuseMisses; }
+	///Set to 0 the counters of the HRIR reuse
+	void CSingleSourceDSP::ResetHRIRReuseCounters() { HRIRReuseHits = 0; HRIRReuseMisses = 0; }
+
 	///Enable anechoic process for this source	
 	void CSingleSourceDSP::EnableAnechoicProcess() { enableAnechoic = true; }
 	///Disable anechoic process for this source	
@@ -266,8 +304,15 @@ namespace Binaural {
 	// Process data from input buffer to generate anechoic spatialization (direct path). Overloaded: using internal buffer
 	void CSingleSourceDSP::ProcessAnechoic(CMonoBuffer<float> &outLeftBuffer, CMonoBuffer<float> &outRightBuffer)
 	{
+		ProcessAnechoic(outLeftBuffer, outRightBuffer, nullptr);
+	}
+
+	// Process data from internal buffer to generate anechoic spatialization (direct path), mixing the HRTF convolution in the frequency-domain buses when they are given
+	bool CSingleSourceDSP::ProcessAnechoic(CMonoBuffer<float> &outLeftBuffer, CMonoBuffer<float> &outRightBuffer, CFrequencyDomainBuses * buses)
+	{
+		bool mixedToBus = false;
 		if (readyForAnechoic) {			
-			CMonoBuffer<float> inBuffer;			
+			CMonoBuffer<float> & inBuffer = anechoicInputBuffer;			//Kept from one block to the next, to not allocate it every time
 			Common::CVector3 effectiveSourcePosition;															
 			Common::CTransform listenerTransform = ownerCore->GetListener()->GetListenerTransform();
 			
@@ -277,9 +322,9 @@ namespace Binaural {
 				
 				effectiveSourceTransform.SetPosition(effectiveSourcePosition);
 				CalculateEffectiveSourceCoordinates();
-				ProcessAnechoic(inBuffer, outLeftBuffer, outRightBuffer, effectiveVectorToListener, effectiveDistanceToListener, effectiveLeftElevation, effectiveLeftAzimuth, effectiveRightElevation, effectiveRightAzimuth, effectiveCenterElevation, effectiveCenterAzimuth, effectiveInterauralAzimuth);
+				mixedToBus = ProcessAnechoic(inBuffer, outLeftBuffer, outRightBuffer, effectiveVectorToListener, effectiveDistanceToListener, effectiveLeftElevation, effectiveLeftAzimuth, effectiveRightElevation, effectiveRightAzimuth, effectiveCenterElevation, effectiveCenterAzimuth, effectiveInterauralAzimuth, buses);
 			} else {				
-				ProcessAnechoic(inBuffer, outLeftBuffer, outRightBuffer, currentVectorToListener, currentDistanceToListener, currentLeftElevation, currentLeftAzimuth, currentRightElevation, currentRightAzimuth, currentCenterElevation, currentCenterAzimuth, currentInterauralAzimuth);
+				mixedToBus = ProcessAnechoic(inBuffer, outLeftBuffer, outRightBuffer, currentVectorToListener, currentDistanceToListener, currentLeftElevation, currentLeftAzimuth, currentRightElevation, currentRightAzimuth, currentCenterElevation, currentCenterAzimuth, currentInterauralAzimuth, buses);
 			}						
 		}
 		else
@@ -288,6 +333,7 @@ namespace Binaural {
 			outLeftBuffer.Fill(ownerCore->GetAudioState().bufferSize, 0.0f);
 			outRightBuffer.Fill(ownerCore->GetAudioState().bufferSize, 0.0f);
 		}
+		return mixedToBus;
 	}
 	// Process data from input buffer to generate anechoic spatialization (direct path). Overloaded: using internal buffer
 	void CSingleSourceDSP::ProcessAnechoic(CStereoBuffer<float> & outBuffer)
@@ -303,18 +349,26 @@ namespace Binaural {
 		ProcessAnechoic(_inBuffer, outLeftBuffer, outRightBuffer, currentVectorToListener, currentDistanceToListener, currentLeftElevation, currentLeftAzimuth, currentRightElevation, currentRightAzimuth, currentCenterElevation, currentCenterAzimuth, currentInterauralAzimuth);
 	}
 
-	void CSingleSourceDSP::ProcessAnechoic(const CMonoBuffer<float> & _inBuffer, CMonoBuffer<float> &outLeftBuffer, CMonoBuffer<float> &outRightBuffer, Common::CVector3 & vectorToListener, float & distanceToListener, float & leftElevation, float & leftAzimuth, float & rightElevation, float & rightAzimuth, float & centerElevation, float & centerAzimuth, float & interauralAzimuth)
+	bool CSingleSourceDSP::ProcessAnechoic(const CMonoBuffer<float> & _inBuffer, CMonoBuffer<float> &outLeftBuffer, CMonoBuffer<float> &outRightBuffer, Common::CVector3 & vectorToListener, float & distanceToListener, float & leftElevation, float & leftAzimuth, float & rightElevation, float & rightAzimuth, float & centerElevation, float & centerAzimuth, float & interauralAzimuth, CFrequencyDomainBuses * buses)
 	{
 		ASSERT(_inBuffer.size() == ownerCore->GetAudioState().bufferSize, RESULT_ERROR_BADSIZE, "InBuffer size has to be equal to the input size indicated by the Core::SetAudioState method", "");
 		
+		bool mixedToBus = false;
+
+		//The delayed samples kept by the buses are taken back before any processing of the source on its own
+		if ((buses == nullptr) || !enableAnechoic || (spatializationMode != TSpatializationMode::HighQuality)) { LeaveFrequencyDomainBuses(); }
+
 		// Check process flag
 		if (!enableAnechoic)
 		{
 			outLeftBuffer.Fill(ownerCore->GetAudioState().bufferSize, 0.0f);
 			outRightBuffer.Fill(ownerCore->GetAudioState().bufferSize, 0.0f);
-			return;
+			return mixedToBus;
 		}
 
+		//Take the HRTF loaded in the background, if there is a new one, before getting any HRIR of this block. With the buses, CCore has already taken it for all the sources
+		if (buses == nullptr) { ownerCore->GetListener()->GetHRTF()->ApplyPublishedHRTF(); }
+
 		#ifdef USE_PROFILER_SingleSourceDSP
 			PROFILER3DTI.RelativeSampleStart(dsSSDSPTransform);
 		#endif
@@ -329,14 +383,16 @@ namespace Binaural {
 		
 		if (_inBuffer.size() == ownerCore->GetAudioState().bufferSize)
 		{
-			CMonoBuffer<float> inBuffer = _inBuffer; //We have to copy input buffer to a new buffer because the distance effects methods work changing the input buffer				
+			CMonoBuffer<float> & inBuffer = anechoicProcessBuffer;
+			inBuffer = _inBuffer; //We have to copy input buffer to a new buffer because the distance effects methods work changing the input buffer				
 			
 			//Check if the source is in the same position as the listener head. If yes, do not apply spatialization
 			if (distanceToListener <= ownerCore->GetListener()->GetHeadRadius())
 			{
+				LeaveFrequencyDomainBuses();
 				outLeftBuffer = inBuffer;
 				outRightBuffer = inBuffer;
-				return;
+				return mixedToBus;
 			}
 													 
 			//Apply Far distance effect
@@ -347,8 +403,16 @@ namespace Binaural {
 			
 			//Apply Spatialization
 			if( spatializationMode == TSpatializationMode::HighQuality ) {
-				ProcessHRTF(inBuffer, outLeftBuffer, outRightBuffer, leftAzimuth, leftElevation, rightAzimuth, rightElevation, centerAzimuth, centerElevation);		// Apply HRTF spatialization effect
-				ProcessNearFieldEffect(outLeftBuffer, outRightBuffer, distanceToListener, interauralAzimuth );									// Apply Near field effects (ILD)		
+				if (buses != nullptr) {
+					// Add the HRTF convolution to the frequency-domain buses if the output is the same, otherwise apply HRTF spatialization effect
+					mixedToBus = ProcessHRTF_withoutIFFT(inBuffer, *buses, outLeftBuffer, outRightBuffer, leftAzimuth, leftElevation, rightAzimuth, rightElevation, centerAzimuth, centerElevation, distanceToListener, vectorToListener.GetAngleToForwardAxisRadians());
+				}
+				else {
+					ProcessHRTF(inBuffer, outLeftBuffer, outRightBuffer, leftAzimuth, leftElevation, rightAzimuth, rightElevation, centerAzimuth, centerElevation);		// Apply HRTF spatialization effect
+				}
+				if (!mixedToBus) {
+					ProcessNearFieldEffect(outLeftBuffer, outRightBuffer, distanceToListener, interauralAzimuth);									// Apply Near field effects (ILD)		
+				}
 			}
 			else if (spatializationMode == TSpatializationMode::HighPerformance)
 			{
@@ -365,8 +429,10 @@ namespace Binaural {
 			}
 			
 			// Apply the directionality to simulate the hearing aid device
-			float angleToForwardAxisRadians = vectorToListener.GetAngleToForwardAxisRadians();  //angle that this vector keeps with the forward axis
-			ProcessDirectionality(outLeftBuffer, outRightBuffer, angleToForwardAxisRadians);
+			if (!mixedToBus) {
+				float angleToForwardAxisRadians = vectorToListener.GetAngleToForwardAxisRadians();  //angle that this vector keeps with the forward axis
+				ProcessDirectionality(outLeftBuffer, outRightBuffer, angleToForwardAxisRadians);
+			}
 
 			readyForAnechoic = false;	// Mark the buffer as already used for anechoic process
 
@@ -374,6 +440,7 @@ namespace Binaural {
 			WATCH(WV_ANECHOIC_OUTPUT_LEFT, outLeftBuffer, CMonoBuffer<float>);
 			WATCH(WV_ANECHOIC_OUTPUT_RIGHT, outRightBuffer, CMonoBuffer<float>);
 		}
+		return mixedToBus;
 	}
 	// Process data from input buffer to generate anechoic spatialization (direct path)
 	void CSingleSourceDSP::ProcessAnechoic(const CMonoBuffer<float> & inBuffer, CStereoBuffer<float> & outBuffer)
@@ -386,16 +453,17 @@ namespace Binaural {
 
 	/// Calculates the parameters derived from the source and listener position, starting from the current source position.
 	void CSingleSourceDSP::CalculateCurrentSourceCoordinates() {
-		CalculateSourceCoordinates(currentSourceTransform, currentVectorToListener, currentDistanceToListener, currentLeftElevation, currentLeftAzimuth, currentRightElevation, currentRightAzimuth, currentCenterElevation, currentCenterAzimuth, currentInterauralAzimuth);
+		CalculateSourceCoordinates(currentSourceTransform, ownerCore->GetListener()->GetHRTF()->GetHRTFDistanceOfMeasurement(), currentVectorToListener, currentDistanceToListener, currentLeftElevation, currentLeftAzimuth, currentRightElevation, currentRightAzimuth, currentCenterElevation, currentCenterAzimuth, currentInterauralAzimuth);
 	}
 	
 	// Calculates the parameters derived from the source and listener position, starting from the effective source position.
+	// Called from the audio thread, so it projects on the sphere of the HRTF in use.
 	void CSingleSourceDSP::CalculateEffectiveSourceCoordinates() {
-		CalculateSourceCoordinates(effectiveSourceTransform, effectiveVectorToListener, effectiveDistanceToListener, effectiveLeftElevation, effectiveLeftAzimuth, effectiveRightElevation, effectiveRightAzimuth, effectiveCenterElevation, effectiveCenterAzimuth, effectiveInterauralAzimuth);
+		CalculateSourceCoordinates(effectiveSourceTransform, ownerCore->GetListener()->GetHRTF()->GetHRTFInUseDistanceOfMeasurement(), effectiveVectorToListener, effectiveDistanceToListener, effectiveLeftElevation, effectiveLeftAzimuth, effectiveRightElevation, effectiveRightAzimuth, effectiveCenterElevation, effectiveCenterAzimuth, effectiveInterauralAzimuth);
 	}
 
 	/// Calculates the parameters derived from the source and listener position
-	void CSingleSourceDSP::CalculateSourceCoordinates(Common::CTransform _sourceTransform, Common::CVector3 & _vectorToListener, float & _distanceToListener, float & leftElevation, float & leftAzimuth, float & rightElevation, float & rightAzimuth, float & centerElevation, float & centerAzimuth, float & interauralAzimuth)
+	void CSingleSourceDSP::CalculateSourceCoordinates(Common::CTransform _sourceTransform, float HRTFDistanceOfMeasurement, Common::CVector3 & _vectorToListener, float & _distanceToListener, float & leftElevation, float & leftAzimuth, float & rightElevation, float & rightAzimuth, float & centerElevation, float & centerAzimuth, float & interauralAzimuth)
 	{
 
 		//Get azimuth and elevation between listener and source
@@ -410,8 +478,8 @@ namespace Binaural {
 
 		Common::CVector3 leftVectorTo = ownerCore->GetListener()->GetListenerEarTransform(Common::T_ear::LEFT).GetVectorTo(_sourceTransform);
 		Common::CVector3 rightVectorTo = ownerCore->GetListener()->GetListenerEarTransform(Common::T_ear::RIGHT).GetVectorTo(_sourceTransform);
-		Common::CVector3 leftVectorTo_sphereProjection =	GetSphereProjectionPosition(leftVectorTo, ownerCore->GetListener()->GetListenerEarLocalPosition(Common::T_ear::LEFT), ownerCore->GetListener()->GetHRTF()->GetHRTFDistanceOfMeasurement());
-		Common::CVector3 rightVectorTo_sphereProjection =	GetSphereProjectionPosition(rightVectorTo, ownerCore->GetListener()->GetListenerEarLocalPosition(Common::T_ear::RIGHT), ownerCore->GetListener()->GetHRTF()->GetHRTFDistanceOfMeasurement());
+		Common::CVector3 leftVectorTo_sphereProjection =	GetSphereProjectionPosition(leftVectorTo, ownerCore->GetListener()->GetListenerEarLocalPosition(Common::T_ear::LEFT), HRTFDistanceOfMeasurement);
+		Common::CVector3 rightVectorTo_sphereProjection =	GetSphereProjectionPosition(rightVectorTo, ownerCore->GetListener()->GetListenerEarLocalPosition(Common::T_ear::RIGHT), HRTFDistanceOfMeasurement);
 
 		leftElevation = leftVectorTo_sphereProjection.GetElevationDegrees();	//Get left elevation
 		if (!Common::CMagnitudes::AreSame(ELEVATION_SINGULAR_POINT_UP, leftElevation, EPSILON) && !Common::CMagnitudes::AreSame(ELEVATION_SINGULAR_POINT_DOWN, leftElevation, EPSILON)) 
@@ -524,10 +592,6 @@ namespace Binaural {
 		else
 			PROFILER3DTI.RelativeSampleStart(dsSSDSPGetHRIRNoInterpolated);
 #endif			
-		//Make FFT-1 of the output (two channels)	
-		CMonoBuffer<float> leftChannel_withoutDelay;
-		CMonoBuffer<float> rightChannel_withoutDelay;
-
 		if ((ownerCore->GetListener()->GetHRTF()->IsHRTFLoaded()) && (inBuffer.size() == ownerCore->GetAudioState().bufferSize))
 		{
 
@@ -559,21 +623,20 @@ namespace Binaural {
 			Common::CFprocessor::ComplexMultiplication(inBuffer_Frequency, leftHRIR_Frequency.HRIR, leftChannel_Frequency);
 			Common::CFprocessor::ComplexMultiplication(inBuffer_Frequency, rightHRIR_Frequency.HRIR, rightChannel_Frequency);
 
+			//Make FFT-1 of the output (two channels), in buffers kept from one block to the next
+			CMonoBuffer<float> & leftChannel_withoutDelay = leftChannelConvolutionBuffer;
+			CMonoBuffer<float> & rightChannel_withoutDelay = rightChannelConvolutionBuffer;
 			outputLeft.CalculateIFFT_OLA(leftChannel_Frequency, leftChannel_withoutDelay);
 			outputRight.CalculateIFFT_OLA(rightChannel_Frequency, rightChannel_withoutDelay);
 
 #else   //USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC
 
 			//Get the HRIR, with different orientation for both ears
-			TOneEarHRIRPartitionedStruct  leftHRIR_partitioned;
-			TOneEarHRIRPartitionedStruct  rightHRIR_partitioned;
-
-			leftHRIR_partitioned.HRIR_Partitioned = ownerCore->GetListener()->GetHRTF()->GetHRIR_partitioned(Common::T_ear::LEFT, leftAzimuth, leftElevation, enableInterpolation);
-			rightHRIR_partitioned.HRIR_Partitioned = ownerCore->GetListener()->GetHRTF()->GetHRIR_partitioned(Common::T_ear::RIGHT, rightAzimuth, rightElevation, enableInterpolation);
+			TOneEarHRIRPartitionedView  leftHRIR_partitioned;
+			TOneEarHRIRPartitionedView  rightHRIR_partitioned;
 
-			//Get delay
-			leftHRIR_partitioned.delay = ownerCore->GetListener()->GetHRTF()->GetHRIRDelay(Common::T_ear::LEFT, centerAzimuth, centerElevation, enableInterpolation);
-			rightHRIR_partitioned.delay = ownerCore->GetListener()->GetHRTF()->GetHRIRDelay(Common::T_ear::RIGHT, centerAzimuth, centerElevation, enableInterpolation);
+			//Get views of the HRIRs and the delays of both ears at once, or reuse the ones of the previous blocks
+			GetHRIR_partitioned(leftAzimuth, leftElevation, rightAzimuth, rightElevation, centerAzimuth, centerElevation, leftHRIR_partitioned, rightHRIR_partitioned);
 
 #ifdef USE_PROFILER_SingleSourceDSP
 			if (enableInterpolation)
@@ -585,24 +648,208 @@ namespace Binaural {
 			PROFILER3DTI.RelativeSampleStart(dsSSDSPFreqConvolver);
 #endif
 
+			ProcessHRTF(inBuffer, leftHRIR_partitioned, rightHRIR_partitioned, outLeftBuffer, outRightBuffer);
+
+#endif // !USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC		
+		}
+	}
+
+	void CSingleSourceDSP::ProcessHRTF(CMonoBuffer<float> &inBuffer, const TOneEarHRIRPartitionedView & leftHRIR_partitioned, const TOneEarHRIRPartitionedView & rightHRIR_partitioned, CMonoBuffer<float> &outLeftBuffer, CMonoBuffer<float> &outRightBuffer)
+	{
+#ifndef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC
+		//Output of the convolution, in buffers kept from one block to the next
+		CMonoBuffer<float> & leftChannel_withoutDelay = leftChannelConvolutionBuffer;
+		CMonoBuffer<float> & rightChannel_withoutDelay = rightChannelConvolutionBuffer;
+
+		if (ownerCore->GetListener()->GetHRTF()->IsHybridPartitioned())
+		{
+			//Direct FIR filter for the first partition and FFT partitions of increasing size for the rest
+			outputHybridConvolution.ProcessHybridConvolution(inBuffer, leftHRIR_partitioned, rightHRIR_partitioned, leftChannel_withoutDelay, rightChannel_withoutDelay);
+		}
+		else
+		{
 #ifdef USE_UPC_WITHOUT_MEMORY
-			//UPC algorithm without memory
-			outputLeftUPConvolution.ProcessUPConvolution(inBuffer, leftHRIR_partitioned, leftChannel_withoutDelay);
-			outputRightUPConvolution.ProcessUPConvolution(inBuffer, rightHRIR_partitioned, rightChannel_withoutDelay);
+			//UPC algorithm without memory, one input FFT for both ears
+			outputUPConvolution.ProcessUPConvolution(inBuffer, leftHRIR_partitioned, rightHRIR_partitioned, leftChannel_withoutDelay, rightChannel_withoutDelay);
 #else
-			//UPC algorothm with memory
-			outputLeftUPConvolution.ProcessUPConvolutionWithMemory(inBuffer, leftHRIR_partitioned, leftChannel_withoutDelay);
-			outputRightUPConvolution.ProcessUPConvolutionWithMemory(inBuffer, rightHRIR_partitioned, rightChannel_withoutDelay);
+			//UPC algorothm with memory, one input FFT for both ears
+			outputUPConvolution.ProcessUPConvolutionWithMemory(inBuffer, leftHRIR_partitioned, rightHRIR_partitioned, leftChannel_withoutDelay, rightChannel_withoutDelay);
 #endif
+		}
 
-#endif // !USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC		
+		ProcessAddDelay_ExpansionMethod(leftChannel_withoutDelay, outLeftBuffer, leftChannelDelayBuffer, leftHRIR_partitioned.delay);
+		ProcessAddDelay_ExpansionMethod(rightChannel_withoutDelay, outRightBuffer, rightChannelDelayBuffer, rightHRIR_partitioned.delay);
+#endif // !USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC
+	}
+	
+	bool CSingleSourceDSP::ProcessHRTF_withoutIFFT(CMonoBuffer<float> &inBuffer, CFrequencyDomainBuses &buses, CMonoBuffer<float> &outLeftBuffer, CMonoBuffer<float> &outRightBuffer, float leftAzimuth, float leftElevation, float rightAzimuth, float rightElevation, float centerAzimuth, float centerElevation, float distance, float angleToForwardAxisRadians)
+	{
+#ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC
+		ProcessHRTF(inBuffer, outLeftBuffer, outRightBuffer, leftAzimuth, leftElevation, rightAzimuth, rightElevation, centerAzimuth, centerElevation);		//Only the UPC convolution can be mixed in the frequency domain
+		return false;
+#else
+		CHRTF* hrtf = ownerCore->GetListener()->GetHRTF();
+		int bufferSize = ownerCore->GetAudioState().bufferSize;
+		if (!hrtf->IsHRTFLoaded() || (inBuffer.size() != (size_t)bufferSize) || hrtf->IsHybridPartitioned() || !buses.IsReady(hrtf->GetHRIRSubfilterLength()) ||
+			((frequencyDomainBuses != nullptr) && (frequencyDomainBuses != &buses)))
+		{
+			//The segments of the hybrid convolution have different FFT sizes
+			LeaveFrequencyDomainBuses();
+			ProcessHRTF(inBuffer, outLeftBuffer, outRightBuffer, leftAzimuth, leftElevation, rightAzimuth, rightElevation, centerAzimuth, centerElevation);
+			return false;
+		}
 
-			ProcessAddDelay_ExpansionMethod(leftChannel_withoutDelay, outLeftBuffer, leftChannelDelayBuffer, leftHRIR_partitioned.delay);
-			ProcessAddDelay_ExpansionMethod(rightChannel_withoutDelay, outRightBuffer, rightChannelDelayBuffer, rightHRIR_partitioned.delay);
+		//Get the HRIR, with different orientation for both ears
+		TOneEarHRIRPartitionedView  leftHRIR_partitioned;
+		TOneEarHRIRPartitionedView  rightHRIR_partitioned;
+
+		//Get views of the HRIRs and the delays of both ears at once, or reuse the ones of the previous blocks
+		GetHRIR_partitioned(leftAzimuth, leftElevation, rightAzimuth, rightElevation, centerAzimuth, centerElevation, leftHRIR_partitioned, rightHRIR_partitioned);
+
+		//The buses apply a constant delay and gain to the output of the convolution, after the IFFT. It is the same as the processing of the source on its own only if
+		//the delays do not change (the expansion method is only a delay then), the gains of the directionality do not change while the source is in the buses
+		//(they are applied to whole blocks, including the delayed samples of the previous one) and the near field filters are not applied
+		int leftDelay = (int)leftHRIR_partitioned.delay;
+		int rightDelay = (int)rightHRIR_partitioned.delay;
+		float leftGain = GetDirectionalityGain(Common::T_ear::LEFT, angleToForwardAxisRadians);
+		float rightGain = GetDirectionalityGain(Common::T_ear::RIGHT, angleToForwardAxisRadians);
+		bool inBuses = (frequencyDomainBuses != nullptr);
+		int lastLeftDelay = inBuses ? busLeftDelay : (int)leftChannelDelayBuffer.size();
+		int lastRightDelay = inBuses ? busRightDelay : (int)rightChannelDelayBuffer.size();
+		bool nearFieldEffect = IsNearFieldEffectEnabled() && (distance <= DISTANCE_MODEL_THRESHOLD_NEAR);
+		if (nearFieldEffect || (leftDelay != lastLeftDelay) || (rightDelay != lastRightDelay) || (leftDelay >= bufferSize) || (rightDelay >= bufferSize) ||
+			(inBuses && ((leftGain != busLeftGain) || (rightGain != busRightGain))))
+		{
+			LeaveFrequencyDomainBuses();
+			ProcessHRTF(inBuffer, leftHRIR_partitioned, rightHRIR_partitioned, outLeftBuffer, outRightBuffer);
+			return false;
+		}
 
+		//The same convolution and delay line as ProcessHRTF, with one input FFT for both ears, but it is calculated by the buses together with the ones of the other sources.
+		//The HRIRs are kept until then, the HRTF is not replaced until the next block
+		const float* inBuffer_dobleSize;
+		float* inBuffer_Frequency;
+		outputUPConvolution.PrepareInputFFT(inBuffer, inBuffer_dobleSize, inBuffer_Frequency);
+		buses.AddInputFFT(inBuffer_dobleSize, inBuffer_Frequency);
+		busLeftHRIR = leftHRIR_partitioned;
+		busRightHRIR = rightHRIR_partitioned;
+
+		//The samples delayed from the previous block processed on its own are output now by the buses, with the gain that the directionality applies to this block
+		if (!inBuses)
+		{
+			buses.AddDelayedSamples(Common::T_ear::LEFT, lastLeftDelay, leftChannelDelayBuffer, leftGain);
+			buses.AddDelayedSamples(Common::T_ear::RIGHT, lastRightDelay, rightChannelDelayBuffer, rightGain);
+			frequencyDomainBuses = &buses;
 		}
+		busLeftDelay = leftDelay;
+		busRightDelay = rightDelay;
+		busLeftGain = leftGain;
+		busRightGain = rightGain;
+		return true;
+#endif // USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC
 	}
-	
+
+	// Called by CCore once the buses have calculated the input FFTs of all the sources. The spectra of the outputs are kept, in case the source leaves the buses in the next block
+	void CSingleSourceDSP::ProcessFrequencyDomainBusesConvolution()
+	{
+#ifndef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_ANECHOIC
+		if (frequencyDomainBuses == nullptr) { return; }
+
+		std::fill(leftChannel_Frequency.begin(), leftChannel_Frequency.end(), 0.0f);
+		std::fill(rightChannel_Frequency.begin(), rightChannel_Frequency.end(), 0.0f);
+#ifdef USE_UPC_WITHOUT_MEMORY
+		outputUPConvolution.ProcessUPConvolution_withoutIFFT(busLeftHRIR, busRightHRIR, leftChannel_Frequency, rightChannel_Frequency);
+#else
+		outputUPConvolution.ProcessUPConvolutionWithMemory_withoutIFFT(busLeftHRIR, busRightHRIR, leftChannel_Frequency, rightChannel_Frequency);
+#endif
+		frequencyDomainBuses->AddSpectrum(Common::T_ear::LEFT, busLeftDelay, leftChannel_Frequency, busLeftGain);
+		frequencyDomainBuses->AddSpectrum(Common::T_ear::RIGHT, busRightDelay, rightChannel_Frequency, busRightGain);
+#endif
+	}
+
+	// The delayed samples of the last block mixed in the buses have not been output yet. They are calculated again from its spectra and moved from the buses to the delay buffers
+	void CSingleSourceDSP::LeaveFrequencyDomainBuses()
+	{
+		if (frequencyDomainBuses == nullptr) { return; }
+
+		frequencyDomainBuses->CalculateDelayedSamples(leftChannel_Frequency, busLeftDelay, leftChannelDelayBuffer);
+		frequencyDomainBuses->CalculateDelayedSamples(rightChannel_Frequency, busRightDelay, rightChannelDelayBuffer);
+		frequencyDomainBuses->AddDelayedSamples(Common::T_ear::LEFT, busLeftDelay, leftChannelDelayBuffer, -busLeftGain);
+		frequencyDomainBuses->AddDelayedSamples(Common::T_ear::RIGHT, busRightDelay, rightChannelDelayBuffer, -busRightGain);
+		frequencyDomainBuses = nullptr;
+	}
+
+	// Get the gain of the directionality of one ear, the one that ProcessDirectionality applies
+	float CSingleSourceDSP::GetDirectionalityGain(Common::T_ear ear, float angleToForwardAxisRadians) const
+	{
+		if (!ownerCore->GetListener()->IsDirectionalityEnabled(ear)) { return 1.0f; }
+		return ownerCore->GetListener()->CalculateDirectionalityLinearAttenuation(ownerCore->GetListener()->GetAnechoicDirectionalityLinearAttenuation(ear), angleToForwardAxisRadians);
+	}
+
+	// Get the views of the HRIRs and the delays of both ears, reusing the ones of the previous blocks if nothing has changed beyond the tolerance
+	void CSingleSourceDSP::GetHRIR_partitioned(float leftAzimuth, float leftElevation, float rightAzimuth, float rightElevation, float centerAzimuth, float centerElevation, TOneEarHRIRPartitionedView & leftHRIR, TOneEarHRIRPartitionedView & rightHRIR)
+	{
+		shared_ptr<CListener> listener = ownerCore->GetListener();
+		bool customizedITD = listener->IsCustomizedITDEnabled();
+		float headRadius = listener->GetHeadRadius();
+
+		//A new HRTF has been taken, the HRIRs of the previous one are crossfaded with the new ones during the next blocks
+		CHRTF* hrtf = listener->GetHRTF();
+		if (hrtf->GetHRTFVersion() != HRTFVersion)
+		{
+			HRTFVersion = hrtf->GetHRTFVersion();
+			HRTFCrossfadeBlocksLeft = hrtf->IsPreviousHRTFAvailable() ? hrtf->GetHRTFCrossfadeBlocks() : 0;
+			reusedHRIR.valid = false;
+		}
+		if (HRTFCrossfadeBlocksLeft > 0)
+		{
+			float previousWeight = (float)HRTFCrossfadeBlocksLeft / (float)(hrtf->GetHRTFCrossfadeBlocks() + 1);
+			hrtf->GetHRIR_partitioned_BothEars_Crossfaded(leftAzimuth, leftElevation, rightAzimuth, rightElevation, centerAzimuth, centerElevation, enableInterpolation, previousWeight, HRIR_scratchBuffer, leftHRIR, rightHRIR);
+			HRTFCrossfadeBlocksLeft--;
+			HRIRReuseMisses++;
+			reusedHRIR.valid = false;		//They change in every block of the crossfade
+			return;
+		}
+
+		if (enableHRIRReuse && reusedHRIR.valid && (reusedHRIR.interpolation == enableInterpolation) &&
+			(reusedHRIR.customizedITD == customizedITD) && (reusedHRIR.headRadius == headRadius) &&
+			IsInsideHRIRReuseTolerance(leftAzimuth, reusedHRIR.leftAzimuth) && IsInsideHRIRReuseTolerance(leftElevation, reusedHRIR.leftElevation) &&
+			IsInsideHRIRReuseTolerance(rightAzimuth, reusedHRIR.rightAzimuth) && IsInsideHRIRReuseTolerance(rightElevation, reusedHRIR.rightElevation) &&
+			IsInsideHRIRReuseTolerance(centerAzimuth, reusedHRIR.centerAzimuth) && IsInsideHRIRReuseTolerance(centerElevation, reusedHRIR.centerElevation))
+		{
+			leftHRIR = reusedHRIR.leftHRIR;
+			rightHRIR = reusedHRIR.rightHRIR;
+			HRIRReuseHits++;
+			return;
+		}
+
+		//Interpolated in the scratch buffer, without allocating memory
+		hrtf->GetHRIR_partitioned_BothEars(leftAzimuth, leftElevation, rightAzimuth, rightElevation, centerAzimuth, centerElevation, enableInterpolation, HRIR_scratchBuffer, leftHRIR, rightHRIR);
+		HRIRReuseMisses++;
+
+		//Keep them for the next blocks. The scratch buffer is not used again while they are reused
+		reusedHRIR.valid = enableHRIRReuse && (leftHRIR.numberOfSubfilters > 0) && (rightHRIR.numberOfSubfilters > 0);
+		reusedHRIR.leftAzimuth = leftAzimuth;
+		reusedHRIR.leftElevation = leftElevation;
+		reusedHRIR.rightAzimuth = rightAzimuth;
+		reusedHRIR.rightElevation = rightElevation;
+		reusedHRIR.centerAzimuth = centerAzimuth;
+		reusedHRIR.centerElevation = centerElevation;
+		reusedHRIR.interpolation = enableInterpolation;
+		reusedHRIR.customizedITD = customizedITD;
+		reusedHRIR.headRadius = headRadius;
+		reusedHRIR.leftHRIR = leftHRIR;
+		reusedHRIR.rightHRIR = rightHRIR;
+	}
+
+	// The angles are compared around the circle, so 359.9 and 0.1 degrees are 0.2 degrees away
+	bool CSingleSourceDSP::IsInsideHRIRReuseTolerance(float angle, float reusedAngle) const
+	{
+		if (angle == reusedAngle) { return true; }
+		float difference = std::fabs(angle - reusedAngle);
+		return std::min(difference, 360.0f - difference) <= HRIRReuseTolerance;
+	}
+
 	void CSingleSourceDSP::ProccesILDSpatializationAndAddITD(CMonoBuffer<float> &leftBuffer, CMonoBuffer<float> &rightBuffer, float distance, float interauralAzimuth, float leftAzimuth, float leftElevation, float rightAzimuth, float rightElevation)
 	{
 				
@@ -763,20 +1010,17 @@ namespace Binaural {
 			//if newDelay!=0 fill out the delay buffer
 			else
 			{
-				//Fill delay buffer 			
-				CMonoBuffer<float> temp;
-				temp.reserve(newDelay);
+				//Fill delay buffer. Its old samples are already in the output, so it is overwritten keeping its memory
+				delayBuffer.resize(newDelay);
 				for (int i = 0; i < newDelay - 1; i++)
 				{
 					int j = int(position);
 					float rest = position - j;
-					temp.push_back(input[j] * (1 - rest) + input[j + 1] * rest);
+					delayBuffer[i] = input[j] * (1 - rest) + input[j + 1] * rest;
 					position += compressionFactor;
 				}
 				//Last element of the delay buffer that must be addressed in a special way
-				temp.push_back(input[input.size() - 1]);
-				//delayBuffer.swap(temp);				//To use in C++03
-				delayBuffer = std::move(temp);			//To use in C++11
+				delayBuffer[newDelay - 1] = input[input.size() - 1];
 			}
 		}
 	}//End ProcessAddDelay_ExpansionMethod
@@ -791,15 +1035,28 @@ namespace Binaural {
 			leftChannelDelayBuffer.clear();
 			rightChannelDelayBuffer.clear();
 		#else
-			int numOfSubfilters = listener->GetHRTF()->GetHRIRNumberOfSubfilters();
-			int subfilterLength = listener->GetHRTF()->GetHRIRSubfilterLength();
-			outputLeftUPConvolution.Setup(ownerCore->GetAudioState().bufferSize, subfilterLength, numOfSubfilters, true);
-			outputRightUPConvolution.Setup(ownerCore->GetAudioState().bufferSize, subfilterLength, numOfSubfilters, true);
+			if (listener->GetHRTF()->IsHybridPartitioned())
+			{
+				outputHybridConvolution.Setup(ownerCore->GetAudioState().bufferSize, listener->GetHRTF()->GetHRIRLength(), listener->GetHRTF()->GetHybridPartitionsPerSegment());
+			}
+			else
+			{
+				int numOfSubfilters = listener->GetHRTF()->GetHRIRNumberOfSubfilters();
+				int subfilterLength = listener->GetHRTF()->GetHRIRSubfilterLength();
+				outputUPConvolution.Setup(ownerCore->GetAudioState().bufferSize, subfilterLength, numOfSubfilters, true);
+			}
+			//Remove the delayed samples of the source from the frequency-domain buses, and prepare the spectra that are mixed in them
+			LeaveFrequencyDomainBuses();
+			leftChannel_Frequency.assign(listener->GetHRTF()->GetHRIRSubfilterLength(), 0.0f);
+			rightChannel_Frequency.assign(listener->GetHRTF()->GetHRIRSubfilterLength(), 0.0f);
 			//Init buffer to store delay to be used in the ProcessAddDelay_ExpansionMethod method
 			leftChannelDelayBuffer.clear();
 			rightChannelDelayBuffer.clear();
 		#endif
 			channelToListener.Reset();
+			reusedHRIR.valid = false;		//The HRIRs may point to the table of the previous HRTF
+			HRTFVersion = listener->GetHRTF()->GetHRTFVersion();		//The convolution starts again, there is nothing to crossfade
+			HRTFCrossfadeBlocksLeft = 0;
 	}
 	
 	
@@ -33,6 +33,9 @@
 #include <BinauralSpatializer/ILD.h>
 #include <Common/FarDistanceEffects.h>
 #include <BinauralSpatializer/UPCAnechoic.h>
+#include <BinauralSpatializer/UPCAnechoicStereo.h>
+#include <BinauralSpatializer/HybridAnechoicStereo.h>
+#include <BinauralSpatializer/FrequencyDomainBuses.h>
 #include <Common/FiltersChain.h>
 #include <Common/Waveguide.h>
 
@@ -41,6 +44,12 @@
 #define ELEVATION_SINGULAR_POINT_UP 90.0
 #define ELEVATION_SINGULAR_POINT_DOWN 270.0
 
+/** \brief Default angular tolerance, in degrees, to reuse the HRIRs of the previous block. With 0, they are only reused if the directions have not changed at all
+*/
+#ifndef DEFAULT_HRIR_REUSE_TOLERANCE
+#define DEFAULT_HRIR_REUSE_TOLERANCE 0.0f
+#endif
+
 namespace Binaural {
 	
 	/** Type definition for Spatialization Modes
@@ -129,6 +138,54 @@ namespace Binaural {
 		*/
 		bool IsInterpolationEnabled();
 
+		/** \brief Enable the reuse of the HRIRs of the previous blocks while the source and the listener do not move beyond the tolerance
+		*   \details The HRIRs and delays of both ears are kept with the directions of the ears and the head center for which they were got,
+		*	and they are used again, without getting nor interpolating them, while no direction has changed more than the tolerance. This is the default behaviour
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void EnableHRIRReuse();
+
+		/** \brief Disable the reuse of the HRIRs of the previous blocks, so they are got from the HRTF in every block
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void DisableHRIRReuse();
+
+		/** \brief Get the flag for the reuse of the HRIRs of the previous blocks
+		*	\retval HRIRReuseEnabled if true, the HRIRs are reused while the directions do not change beyond the tolerance
+		*   \eh Nothing is reported to the error handler.
+		*/
+		bool IsHRIRReuseEnabled() const;
+
+		/** \brief Set the angular tolerance to reuse the HRIRs of the previous blocks
+		*	\details The azimuths and elevations of both ears and the head center are compared with the ones of the HRIRs being reused
+		*	\param [in] toleranceDegrees maximum change of each angle, in degrees, to keep reusing the HRIRs. With 0, only the same directions reuse them
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void SetHRIRReuseTolerance(float toleranceDegrees);
+
+		/** \brief Get the angular tolerance to reuse the HRIRs of the previous blocks
+		*	\retval toleranceDegrees maximum change of each angle, in degrees
+		*   \eh Nothing is reported to the error handler.
+		*/
+		float GetHRIRReuseTolerance() const;
+
+		/** \brief Get the number of blocks whose HRIRs have been reused since the counters were reset
+		*	\retval hits number of blocks with reused HRIRs
+		*   \eh Nothing is reported to the error handler.
+		*/
+		uint64_t GetHRIRReuseHits() const;
+
+		/** \brief Get the number of blocks whose HRIRs have been got from the HRTF since the counters were reset
+		*	\retval misses number of blocks with new HRIRs
+		*   \eh Nothing is reported to the error handler.
+		*/
+		uint64_t GetHRIRReuseMisses() const;
+
+		/** \brief Set to 0 the counters of reused and new HRIRs
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void ResetHRIRReuseCounters();
+
 		/** \brief Enable anechoic spatialization process for this source
 		*   \eh Nothing is reported to the error handler.
 		*/
@@ -349,10 +406,29 @@ namespace Binaural {
 		const float & GetCurrentDistanceSourceListener() const;
 
 
-		void ProcessAnechoic(const CMonoBuffer<float> & _inBuffer, CMonoBuffer<float> &outLeftBuffer, CMonoBuffer<float> &outRightBuffer, Common::CVector3 & vectorToListener, float & distanceToListener, float & leftElevation, float & leftAzimuth, float & rightElevation, float & rightAzimuth, float & centerElevation, float & centerAzimuth, float & interauralAzimuth);
+		// Process data from internal buffer. If the buses are not null, the HRTF convolution is added to them in the frequency domain when the result is the same, see CCore::ProcessAnechoic.
+		// Returns true if it was done, and then the convolution is finished by ProcessFrequencyDomainBusesConvolution once the buses have calculated the input FFTs
+		bool ProcessAnechoic(CMonoBuffer<float> &outLeftBuffer, CMonoBuffer<float> &outRightBuffer, CFrequencyDomainBuses * buses);
+
+		bool ProcessAnechoic(const CMonoBuffer<float> & _inBuffer, CMonoBuffer<float> &outLeftBuffer, CMonoBuffer<float> &outRightBuffer, Common::CVector3 & vectorToListener, float & distanceToListener, float & leftElevation, float & leftAzimuth, float & rightElevation, float & rightAzimuth, float & centerElevation, float & centerAzimuth, float & interauralAzimuth, CFrequencyDomainBuses * buses = nullptr);
 
 		// Make the spatialization using HRTF convolution
 		void ProcessHRTF(CMonoBuffer<float> &inBuffer, CMonoBuffer<float> &outLeftBuffer, CMonoBuffer<float> &outRightBuffer, float leftAzimuth, float leftElevation, float rightAzimuth, float rightElevation, float _azCenter, float _elCenter);
+		// Make the HRTF convolution with the HRIRs already got and apply the ITD to its output
+		void ProcessHRTF(CMonoBuffer<float> &inBuffer, const TOneEarHRIRPartitionedView & leftHRIR, const TOneEarHRIRPartitionedView & rightHRIR, CMonoBuffer<float> &outLeftBuffer, CMonoBuffer<float> &outRightBuffer);
+		// Get the views of the HRIRs and the delays of both ears, reusing the ones of the previous blocks if the directions have not changed beyond the tolerance
+		void GetHRIR_partitioned(float leftAzimuth, float leftElevation, float rightAzimuth, float rightElevation, float centerAzimuth, float centerElevation, TOneEarHRIRPartitionedView & leftHRIR, TOneEarHRIRPartitionedView & rightHRIR);
+		// Get if one angle, in degrees, is the same as another one within the tolerance of the HRIR reuse
+		bool IsInsideHRIRReuseTolerance(float angle, float reusedAngle) const;
+		// Make the spatialization using HRTF convolution, adding the half spectrum of the output to the buses of its delays with the gain of the directionality if the result is the same as ProcessHRTF followed by the near field effects and the directionality.
+		// Returns true if it was done: the input FFT is added to the ones calculated by the buses and the HRIRs are kept for ProcessFrequencyDomainBusesConvolution. Otherwise, the output of ProcessHRTF is returned
+		bool ProcessHRTF_withoutIFFT(CMonoBuffer<float> &inBuffer, CFrequencyDomainBuses &buses, CMonoBuffer<float> &outLeftBuffer, CMonoBuffer<float> &outRightBuffer, float leftAzimuth, float leftElevation, float rightAzimuth, float rightElevation, float _azCenter, float _elCenter, float distance, float angleToForwardAxisRadians);
+		// Multiply the input FFT calculated by the buses by the HRIRs kept by ProcessHRTF_withoutIFFT, and add the spectra of the output to the buses
+		void ProcessFrequencyDomainBusesConvolution();
+		// Take back from the buses the delayed samples of the last block mixed in them, so the source is processed on its own again
+		void LeaveFrequencyDomainBuses();
+		// Get the gain of the directionality of one ear, 1 if it is disabled
+		float GetDirectionalityGain(Common::T_ear ear, float angleToForwardAxisRadians) const;
 		/// Make the spatialization using a ILD aproach				
 		void ProccesILDSpatializationAndAddITD(CMonoBuffer<float> &leftBuffer, CMonoBuffer<float> &rightBuffer, float distance, float interauralAzimuth, float leftAzimuth, float leftElevation, float rightAzimuth, float rightElevation);
 		void ProcessILDSpatialization(CMonoBuffer<float> &leftBuffer, CMonoBuffer<float> &rightBuffer, float distance_m, float azimuth);		
@@ -386,7 +462,7 @@ namespace Binaural {
 		/// Calculates the parameters derived from the source and listener position, starting from the effective source position.
 		void CalculateEffectiveSourceCoordinates();
 		/// Calculates the parameters derived from the source and listener position
-		void CalculateSourceCoordinates(Common::CTransform _sourceTransform, Common::CVector3 & _vectorToListener, float & _distanceToListener, float & leftElevation, float & leftAzimuth, float & rightElevation, float & rightAzimuth, float & centerElevation, float & centerAzimuth, float & interauralAzimuth);
+		void CalculateSourceCoordinates(Common::CTransform _sourceTransform, float HRTFDistanceOfMeasurement, Common::CVector3 & _vectorToListener, float & _distanceToListener, float & leftElevation, float & leftAzimuth, float & rightElevation, float & rightAzimuth, float & centerElevation, float & centerAzimuth, float & interauralAzimuth);
 
 
 		///////////////
@@ -402,12 +478,51 @@ namespace Binaural {
 		Common::CFconvolver outputLeft;   						// Object to make the inverse fft of the left channel
 		Common::CFconvolver outputRight;						// Object to make the inverse fft of the rigth channel
 	#else
-		Binaural::CUPCAnechoic outputLeftUPConvolution;		// Object to make the inverse fft of the left channel with the UPC method
-		Binaural::CUPCAnechoic outputRightUPConvolution;	// Object to make the inverse fft of the rigth channel with the UPC method
+		Binaural::CUPCAnechoicStereo outputUPConvolution;	// Object to make the convolution of both channels with the UPC method, sharing the input FFTs
+		Binaural::CHybridAnechoicStereo outputHybridConvolution;	// Object to make the convolution of both channels with the hybrid method, when the HRTF has the hybrid layout
 	#endif							
 		
 		CMonoBuffer<float> leftChannelDelayBuffer;			// To store the delay of the left channel of the expansion method
 		CMonoBuffer<float> rightChannelDelayBuffer;			// To store the delay of the right channel of the expansion method
+		CMonoBuffer<float> anechoicInputBuffer;				// Input of the anechoic path taken from the waveguide, kept to not allocate it in every block
+		CMonoBuffer<float> anechoicProcessBuffer;			// Copy of the input of the anechoic path modified by the distance effects, kept to not allocate it in every block
+		CMonoBuffer<float> leftChannelConvolutionBuffer;	// Left channel between the HRTF convolution and the delay, kept to not allocate it in every block
+		CMonoBuffer<float> rightChannelConvolutionBuffer;	// Right channel between the HRTF convolution and the delay, kept to not allocate it in every block
+		Common::CAlignedVector<float> HRIR_scratchBuffer;	// Interpolated HRIRs of both ears of the current block, viewed by the convolution
+
+		// While the source is mixed in the frequency-domain buses, its delayed samples are kept by the buses instead of leftChannelDelayBuffer and rightChannelDelayBuffer
+		CFrequencyDomainBuses* frequencyDomainBuses;		// Buses in which the last block was mixed, nullptr if it was processed by the source
+		int busLeftDelay;									// Left ear delay of the last block mixed in the buses
+		int busRightDelay;									// Right ear delay of the last block mixed in the buses
+		float busLeftGain;									// Left ear gain of the directionality of the last block mixed in the buses
+		float busRightGain;									// Right ear gain of the directionality of the last block mixed in the buses
+		TOneEarHRIRPartitionedView busLeftHRIR;				// Left ear HRIR of the block mixed in the buses, until its input FFT has been calculated
+		TOneEarHRIRPartitionedView busRightHRIR;			// Right ear HRIR of the block mixed in the buses, until its input FFT has been calculated
+		std::vector<float> leftChannel_Frequency;			// Half spectrum of the left ear HRTF convolution of the last block mixed in the buses
+		std::vector<float> rightChannel_Frequency;			// Half spectrum of the right ear HRTF convolution of the last block mixed in the buses
+
+		// HRIRs of both ears that are reused while the directions for which they were got do not change beyond the tolerance
+		struct TReusedHRIR {
+			bool valid;								// The HRIRs can be reused, they are not valid after the HRTF is loaded again
+			float leftAzimuth;						// Left ear's azimuth of the HRIRs
+			float leftElevation;					// Left ear's elevation of the HRIRs
+			float rightAzimuth;						// Right ear's azimuth of the HRIRs
+			float rightElevation;					// Right ear's elevation of the HRIRs
+			float centerAzimuth;					// Azimuth from the center of the head of the delays
+			float centerElevation;					// Elevation from the center of the head of the delays
+			bool interpolation;						// Run-time interpolation of the HRIRs
+			bool customizedITD;						// Customized ITD of the delays
+			float headRadius;						// Head radius of the customized ITD
+			TOneEarHRIRPartitionedView leftHRIR;	// View of the left ear HRIR and its delay, pointing to the HRTF table or to HRIR_scratchBuffer
+			TOneEarHRIRPartitionedView rightHRIR;	// View of the right ear HRIR and its delay, pointing to the HRTF table or to HRIR_scratchBuffer
+		};
+		TReusedHRIR reusedHRIR;					// HRIRs of the previous blocks
+		bool enableHRIRReuse;					// Enables/Disables the reuse of the HRIRs of the previous blocks
+		float HRIRReuseTolerance;				// Maximum change of the angles, in degrees, to reuse the HRIRs
+		uint64_t HRIRReuseHits;					// Number of blocks with reused HRIRs
+		uint64_t HRIRReuseMisses;				// Number of blocks with HRIRs got from the HRTF
+		uint32_t HRTFVersion;					// Version of the HRTF of the HRIRs of the previous block, to know when a new one has been taken
+		int HRTFCrossfadeBlocksLeft;			// Blocks left of the crossfade between the previous HRTF and the new one
 					
 		Common::CDistanceAttenuator distanceAttenuatorAnechoic;	// Computes the attenuation for far and medium distances		
 		Common::CDistanceAttenuator distanceAttenuatorReverb;	// Computes the attenuation for far and medium distances			
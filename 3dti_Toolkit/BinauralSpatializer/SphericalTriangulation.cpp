@@ -0,0 +1,404 @@
+/**
+* \class CSphericalTriangulation
+*
+* \brief Definition of CSphericalTriangulation class.
+* \date	October 2026
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <BinauralSpatializer/SphericalTriangulation.h>
+#include <Common/ErrorHandler.h>
+#include <unordered_map>
+#include <algorithm>
+
+// Tolerance of the geometric tests, for directions on the unit sphere
+#define TRIANGULATION_EPSILON 1e-12
+// Minimum distance between two different directions on the unit sphere
+#define TRIANGULATION_SAME_DIRECTION_DISTANCE 1e-6
+// Maximum volume of the tetrahedron of four directions that are considered in the same plane, when choosing between the two diagonals of a quadrilateral
+#define TRIANGULATION_COPLANAR_VOLUME 1e-9
+
+namespace Binaural {
+	/////////////////////////////
+	// CONSTRUCTOR/DESTRUCTOR  //
+	/////////////////////////////
+	CSphericalTriangulation::CSphericalTriangulation() : ready{ false }
+	{
+	}
+
+	///////////////////
+	// Public Methods //
+	///////////////////
+
+	//Start a new triangulation
+	void CSphericalTriangulation::BeginSetup()
+	{
+		points.clear();
+		uniqueVertex.clear();
+		triangles.clear();
+		ready = false;
+	}
+
+	//Add one direction to the triangulation
+	void CSphericalTriangulation::AddVertex(float azimuth, float elevation)
+	{
+		TPoint newPoint = ToCartesian(azimuth, elevation);
+
+		//Directions that are already in the triangulation point to the first one
+		int unique = (int)points.size();
+		for (int i = 0; i < (int)points.size(); i++)
+		{
+			double dx = points[i].x - newPoint.x;
+			double dy = points[i].y - newPoint.y;
+			double dz = points[i].z - newPoint.z;
+			if (dx * dx + dy * dy + dz * dz < TRIANGULATION_SAME_DIRECTION_DISTANCE * TRIANGULATION_SAME_DIRECTION_DISTANCE)
+			{
+				unique = uniqueVertex[i];
+				break;
+			}
+		}
+		points.push_back(newPoint);
+		uniqueVertex.push_back(unique);
+	}
+
+	//Calculate the triangulation of all the added directions
+	void CSphericalTriangulation::EndSetup()
+	{
+		triangles.clear();
+		ready = false;
+
+		std::vector<int> vertices;
+		for (int i = 0; i < (int)points.size(); i++)
+		{
+			if (uniqueVertex[i] == i) { vertices.push_back(i); }
+		}
+
+		if (!CalculateConvexHull(vertices))
+		{
+			triangles.clear();
+			SET_RESULT(RESULT_WARNING, "The directions of the spherical triangulation are in the same plane, it can not be used");
+			return;
+		}
+		CalculateNeighbours();
+		if (!IsOriginInside())
+		{
+			triangles.clear();
+			SET_RESULT(RESULT_WARNING, "The directions of the spherical triangulation do not surround the listener, it can not be used");
+			return;
+		}
+
+		ready = true;
+		SET_RESULT(RESULT_OK, "Spherical triangulation calculated succesfully");
+	}
+
+	//Get if the triangulation can be used
+	bool CSphericalTriangulation::IsReady() const
+	{
+		return ready;
+	}
+
+	//Get the number of triangles of the triangulation
+	int CSphericalTriangulation::GetNumberOfTriangles() const
+	{
+		return ready ? (int)triangles.size() : 0;
+	}
+
+	//Find the triangle that contains one direction
+	bool CSphericalTriangulation::FindTriangle(float azimuth, float elevation, TSphericalTriangleStruct & triangle) const
+	{
+		if (!ready) { return false; }
+
+		TPoint direction = ToCartesian(azimuth, elevation);
+
+		//Walk from one triangle to the neighbour on the other side of the edge that has the direction out of the triangle
+		int current = 0;
+		int outerEdge;
+		for (int step = 0; step < (int)triangles.size(); step++)
+		{
+			if (GetBarycentricCoordinates(direction, triangles[current], triangle, outerEdge))
+			{
+				ChooseNearestVerticesDiagonal(direction, current, triangle);
+				return true;
+			}
+			current = triangles[current].neighbour[outerEdge];
+		}
+
+		//The walk may go round in circles when there are more than three directions in the same plane, check all the triangles
+		for (int t = 0; t < (int)triangles.size(); t++)
+		{
+			if (GetBarycentricCoordinates(direction, triangles[t], triangle, outerEdge))
+			{
+				ChooseNearestVerticesDiagonal(direction, t, triangle);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	///////////////////
+	// Private Methods //
+	///////////////////
+
+	//Calculate the convex hull of the different directions
+	bool CSphericalTriangulation::CalculateConvexHull(const std::vector<int> & vertices)
+	{
+		if (vertices.size() < 4) { return false; }
+
+		//Initial tetrahedron: the first vertex, the furthest one from it, the furthest one from the line of both and the furthest one from the plane of the three
+		int v0 = vertices[0];
+		int v1 = -1, v2 = -1, v3 = -1;
+		double maxValue = 0.0;
+		for (int v : vertices)
+		{
+			double dx = points[v].x - points[v0].x;
+			double dy = points[v].y - points[v0].y;
+			double dz = points[v].z - points[v0].z;
+			double distance = dx * dx + dy * dy + dz * dz;
+			if (distance > maxValue) { maxValue = distance; v1 = v; }
+		}
+		maxValue = 0.0;
+		for (int v : vertices)
+		{
+			TPoint u = { points[v1].x - points[v0].x, points[v1].y - points[v0].y, points[v1].z - points[v0].z };
+			TPoint w = { points[v].x - points[v0].x, points[v].y - points[v0].y, points[v].z - points[v0].z };
+			TPoint cross = { u.y * w.z - u.z * w.y, u.z * w.x - u.x * w.z, u.x * w.y - u.y * w.x };
+			double area = cross.x * cross.x + cross.y * cross.y + cross.z * cross.z;
+			if (area > maxValue) { maxValue = area; v2 = v; }
+		}
+		if (v1 < 0 || v2 < 0) { return false; }
+		maxValue = TRIANGULATION_EPSILON;
+		for (int v : vertices)
+		{
+			double volume = std::fabs(Orientation(points[v0], points[v1], points[v2], points[v]));
+			if (volume > maxValue) { maxValue = volume; v3 = v; }
+		}
+		if (v3 < 0) { return false; }
+
+		//Faces of the tetrahedron, with the fourth vertex behind each one
+		std::vector<TTriangle> hull;
+		int tetrahedron[4] = { v0, v1, v2, v3 };
+		for (int i = 0; i < 4; i++)
+		{
+			TTriangle face;
+			face.vertex[0] = tetrahedron[i];
+			face.vertex[1] = tetrahedron[(i + 1) % 4];
+			face.vertex[2] = tetrahedron[(i + 2) % 4];
+			int opposite = tetrahedron[(i + 3) % 4];
+			if (Orientation(points[face.vertex[0]], points[face.vertex[1]], points[face.vertex[2]], points[opposite]) > 0.0)
+			{
+				std::swap(face.vertex[1], face.vertex[2]);
+			}
+			hull.push_back(face);
+		}
+
+		//Add the rest of the vertices, replacing the faces in front of each one by a fan of faces from the vertex to the border (horizon) of those faces
+		std::vector<bool> visible;
+		std::unordered_map<long long, int> visibleEdges;
+		std::vector<TTriangle> newHull;
+		long long numberOfPoints = (long long)points.size();
+		for (int v : vertices)
+		{
+			if (v == v0 || v == v1 || v == v2 || v == v3) { continue; }
+
+			visible.assign(hull.size(), false);
+			visibleEdges.clear();
+			bool anyVisible = false;
+			for (int f = 0; f < (int)hull.size(); f++)
+			{
+				const TTriangle & face = hull[f];
+				if (Orientation(points[face.vertex[0]], points[face.vertex[1]], points[face.vertex[2]], points[v]) > TRIANGULATION_EPSILON)
+				{
+					visible[f] = true;
+					anyVisible = true;
+					for (int e = 0; e < 3; e++)
+					{
+						visibleEdges.emplace(face.vertex[e] * numberOfPoints + face.vertex[(e + 1) % 3], f);
+					}
+				}
+			}
+			if (!anyVisible) { continue; }		//Inside the hull, only possible because of rounding errors
+
+			newHull.clear();
+			for (int f = 0; f < (int)hull.size(); f++)
+			{
+				if (!visible[f]) { newHull.push_back(hull[f]); continue; }
+				for (int e = 0; e < 3; e++)
+				{
+					int a = hull[f].vertex[e];
+					int b = hull[f].vertex[(e + 1) % 3];
+					if (visibleEdges.find(b * numberOfPoints + a) == visibleEdges.end())
+					{
+						TTriangle face;
+						face.vertex[0] = a;
+						face.vertex[1] = b;
+						face.vertex[2] = v;
+						newHull.push_back(face);
+					}
+				}
+			}
+			hull.swap(newHull);
+		}
+
+		triangles.swap(hull);
+		return true;
+	}
+
+	//Calculate the neighbours of every triangle of the hull
+	void CSphericalTriangulation::CalculateNeighbours()
+	{
+		long long numberOfPoints = (long long)points.size();
+		std::unordered_map<long long, int> edges;
+		edges.reserve(3 * triangles.size());
+		for (int t = 0; t < (int)triangles.size(); t++)
+		{
+			for (int e = 0; e < 3; e++)
+			{
+				edges.emplace(triangles[t].vertex[e] * numberOfPoints + triangles[t].vertex[(e + 1) % 3], t);
+			}
+		}
+		//The neighbour shares the same edge in the opposite direction
+		for (TTriangle & triangle : triangles)
+		{
+			for (int e = 0; e < 3; e++)
+			{
+				auto it = edges.find(triangle.vertex[(e + 1) % 3] * numberOfPoints + triangle.vertex[e]);
+				triangle.neighbour[e] = (it != edges.end()) ? it->second : 0;
+			}
+		}
+	}
+
+	//Get if the origin is behind all the triangles of the hull
+	bool CSphericalTriangulation::IsOriginInside() const
+	{
+		for (const TTriangle & triangle : triangles)
+		{
+			if (Determinant(points[triangle.vertex[0]], points[triangle.vertex[1]], points[triangle.vertex[2]]) <= TRIANGULATION_EPSILON) { return false; }
+		}
+		return !triangles.empty();
+	}
+
+	//Calculate the barycentric coordinates of one direction in one triangle
+	bool CSphericalTriangulation::GetBarycentricCoordinates(const TPoint & direction, const TTriangle & triangle, TSphericalTriangleStruct & result, int & outerEdge) const
+	{
+		const TPoint & a = points[triangle.vertex[0]];
+		const TPoint & b = points[triangle.vertex[1]];
+		const TPoint & c = points[triangle.vertex[2]];
+
+		//Each determinant is positive if the direction is on the inner side of one edge, and proportional to the coordinate of the opposite vertex
+		double edgeValue[3] = { Determinant(a, b, direction), Determinant(b, c, direction), Determinant(c, a, direction) };
+		outerEdge = 0;
+		for (int e = 1; e < 3; e++)
+		{
+			if (edgeValue[e] < edgeValue[outerEdge]) { outerEdge = e; }
+		}
+		if (edgeValue[outerEdge] < -TRIANGULATION_EPSILON) { return false; }
+
+		double alpha = std::fmax(edgeValue[1], 0.0);
+		double beta = std::fmax(edgeValue[2], 0.0);
+		double gamma = std::fmax(edgeValue[0], 0.0);
+		double sum = alpha + beta + gamma;
+		if (sum <= 0.0) { return false; }
+
+		result.vertexA = triangle.vertex[0];
+		result.vertexB = triangle.vertex[1];
+		result.vertexC = triangle.vertex[2];
+		result.alpha = (float)(alpha / sum);
+		result.beta = (float)(beta / sum);
+		result.gamma = (float)(gamma / sum);
+		return true;
+	}
+
+	//Choose the triangle of the nearest vertices when the triangle found and one of its neighbours are in the same plane
+	void CSphericalTriangulation::ChooseNearestVerticesDiagonal(const TPoint & direction, int found, TSphericalTriangleStruct & result) const
+	{
+		const TTriangle & triangle = triangles[found];
+		for (int e = 0; e < 3; e++)
+		{
+			//Vertex of the neighbour that is not in the shared edge
+			int a = triangle.vertex[e];
+			int b = triangle.vertex[(e + 1) % 3];
+			const TTriangle & neighbour = triangles[triangle.neighbour[e]];
+			int opposite = -1;
+			for (int v : neighbour.vertex)
+			{
+				if (v != a && v != b) { opposite = v; }
+			}
+			if (opposite < 0 || std::fabs(Orientation(points[a], points[b], points[triangle.vertex[(e + 2) % 3]], points[opposite])) > TRIANGULATION_COPLANAR_VOLUME) { continue; }
+
+			//Both diagonals of this quadrilateral are valid. Take the first triangle that contains the direction among the nearest corners,
+			// in the same order as the search among the nearest orientations (so regular grids keep their old triangles)
+			int corners[4] = { a, opposite, b, triangle.vertex[(e + 2) % 3] };
+			std::stable_sort(corners, corners + 4, [&](int first, int second) {
+				return Dot(points[first], direction) > Dot(points[second], direction);
+			});
+			const int combinations[4][3] = { { 0, 1, 2 }, { 0, 1, 3 }, { 0, 2, 3 }, { 1, 2, 3 } };
+			for (const int * combination : combinations)
+			{
+				TTriangle candidate;
+				candidate.vertex[0] = corners[combination[0]];
+				candidate.vertex[1] = corners[combination[1]];
+				candidate.vertex[2] = corners[combination[2]];
+				//Counterclockwise seen from outside, as the triangles of the hull
+				if (Determinant(points[candidate.vertex[0]], points[candidate.vertex[1]], points[candidate.vertex[2]]) < 0.0) { std::swap(candidate.vertex[1], candidate.vertex[2]); }
+
+				TSphericalTriangleStruct candidateResult;
+				int outerEdge;
+				if (GetBarycentricCoordinates(direction, candidate, candidateResult, outerEdge))
+				{
+					result = candidateResult;
+					return;
+				}
+			}
+			return;
+		}
+	}
+
+	//Convert one direction in degrees to cartesian coordinates on the unit sphere
+	CSphericalTriangulation::TPoint CSphericalTriangulation::ToCartesian(float azimuth, float elevation)
+	{
+		double azimuthRadians = azimuth * M_PI / 180.0;
+		double elevationRadians = elevation * M_PI / 180.0;
+		TPoint point;
+		point.x = std::cos(elevationRadians) * std::cos(azimuthRadians);
+		point.y = std::cos(elevationRadians) * std::sin(azimuthRadians);
+		point.z = std::sin(elevationRadians);
+		return point;
+	}
+
+	//Calculate the determinant of the three vectors
+	double CSphericalTriangulation::Determinant(const TPoint & a, const TPoint & b, const TPoint & c)
+	{
+		return (a.y * b.z - a.z * b.y) * c.x + (a.z * b.x - a.x * b.z) * c.y + (a.x * b.y - a.y * b.x) * c.z;
+	}
+
+	//Calculate the dot product of two vectors
+	double CSphericalTriangulation::Dot(const TPoint & a, const TPoint & b)
+	{
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	//Calculate the signed volume of the tetrahedron of the triangle abc and the point d
+	double CSphericalTriangulation::Orientation(const TPoint & a, const TPoint & b, const TPoint & c, const TPoint & d)
+	{
+		TPoint ab = { b.x - a.x, b.y - a.y, b.z - a.z };
+		TPoint ac = { c.x - a.x, c.y - a.y, c.z - a.z };
+		TPoint ad = { d.x - a.x, d.y - a.y, d.z - a.z };
+		return Determinant(ab, ac, ad);
+	}
+}
@@ -0,0 +1,152 @@
+/**
+* \class CSphericalTriangulation
+*
+* \brief Declaration of CSphericalTriangulation class interface.
+* \date	October 2026
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#ifndef _CSPHERICALTRIANGULATION_H_
+#define _CSPHERICALTRIANGULATION_H_
+
+#include <vector>
+
+namespace Binaural {
+
+	/** \brief Type definition for a triangle of the spherical triangulation that contains a direction
+	*/
+	struct TSphericalTriangleStruct {
+		int vertexA;	///< Index of the first vertex, in the order in which the vertices were added
+		int vertexB;	///< Index of the second vertex
+		int vertexC;	///< Index of the third vertex
+		float alpha;	///< Barycentric coordinate of the first vertex
+		float beta;		///< Barycentric coordinate of the second vertex
+		float gamma;	///< Barycentric coordinate of the third vertex
+	};
+
+	/** \details This class triangulates a set of directions on the sphere, for example the orientations of the measurements of an HRTF, and finds the triangle that contains any other direction.
+	*	\details The triangulation is the convex hull of the directions, which is their spherical Delaunay triangulation. It is calculated once, when the setup ends,
+	*	and each triangle is found walking from one triangle to its neighbour towards the direction of interest, so that every search only visits a few triangles.
+	*	The barycentric coordinates are those of the point where the direction of interest crosses the plane of the triangle, so they are never negative inside it.
+	*	\details When four directions are in the same plane, as the corners of the cells of a regular grid of azimuths and elevations, both diagonals of their quadrilateral are valid.
+	*	Then the triangle is chosen among the nearest of those directions, as the previous search among the nearest orientations of the HRTF did, so the interpolation does not change on those grids.
+	*	\details The triangulation can only be used if the directions surround the listener, that is, if the centre of the sphere is inside their convex hull.
+	*/
+	class CSphericalTriangulation
+	{
+
+	public:
+
+		/** \brief Default constructor
+		*   \eh Nothing is reported to the error handler.
+		*/
+		CSphericalTriangulation();
+
+		/** \brief Start a new triangulation, removing all the vertices of the previous one
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void BeginSetup();
+
+		/** \brief Add one direction to the triangulation. The vertices are numbered in the order in which they are added
+		*	\details Directions equal to one added before (for example, the same pole with different azimuths) are not triangulated, and the first one is returned instead of them.
+		*	\param [in] azimuth azimuth in degrees
+		*	\param [in] elevation elevation in degrees, from 0 to 90 upwards and from 360 to 270 downwards (or negative)
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void AddVertex(float azimuth, float elevation);
+
+		/** \brief Calculate the triangulation of all the added directions
+		*   \eh On success, RESULT_OK is reported to the error handler.
+		*       If the directions do not surround the listener, a warning is reported to the error handler and the triangulation can not be used.
+		*/
+		void EndSetup();
+
+		/** \brief Get if the triangulation has been calculated and can be used
+		*	\retval ready true if the triangulation can be used to find triangles
+		*   \eh Nothing is reported to the error handler.
+		*/
+		bool IsReady() const;
+
+		/** \brief Get the number of triangles of the triangulation
+		*	\retval numberOfTriangles number of triangles, 0 if the triangulation can not be used
+		*   \eh Nothing is reported to the error handler.
+		*/
+		int GetNumberOfTriangles() const;
+
+		/** \brief Find the triangle that contains one direction and the barycentric coordinates of the direction in it
+		*	\param [in] azimuth azimuth of the direction of interest in degrees
+		*	\param [in] elevation elevation of the direction of interest in degrees
+		*	\param [out] triangle vertices of the triangle and barycentric coordinates of the direction
+		*	\retval found true if the triangle has been found, false if the triangulation can not be used
+		*   \eh Nothing is reported to the error handler.
+		*/
+		bool FindTriangle(float azimuth, float elevation, TSphericalTriangleStruct & triangle) const;
+
+	private:
+		// Point on the unit sphere
+		struct TPoint {
+			double x;
+			double y;
+			double z;
+		};
+
+		// Triangle of the convex hull, with its vertices counterclockwise seen from outside
+		struct TTriangle {
+			int vertex[3];				//Vertices, indices of points
+			int neighbour[3];			//Triangle on the other side of the edge that goes from vertex[i] to vertex[(i + 1) % 3]
+		};
+
+		///////////////
+		// ATTRIBUTES
+		///////////////
+		std::vector<TPoint> points;				//Added directions, in cartesian coordinates
+		std::vector<int> uniqueVertex;			//For each added direction, the first added direction equal to it
+		std::vector<TTriangle> triangles;		//Triangles of the convex hull
+		bool ready;
+
+		///////////////
+		// METHODS
+		///////////////
+		//Calculate the convex hull of the different directions, adding them one by one to an initial tetrahedron. Returns false if all the directions are in the same plane
+		bool CalculateConvexHull(const std::vector<int> & vertices);
+
+		//Calculate the neighbours of every triangle of the hull
+		void CalculateNeighbours();
+
+		//Get if the origin is behind all the triangles of the hull, so every direction crosses one of them
+		bool IsOriginInside() const;
+
+		//Calculate the barycentric coordinates of one direction in one triangle. Returns false if the direction is out of the triangle
+		bool GetBarycentricCoordinates(const TPoint & direction, const TTriangle & triangle, TSphericalTriangleStruct & result, int & outerEdge) const;
+
+		//Choose, when the triangle found and one of its neighbours are in the same plane, the triangle of the nearest vertices that contains the direction
+		void ChooseNearestVerticesDiagonal(const TPoint & direction, int found, TSphericalTriangleStruct & result) const;
+
+		//Convert one direction in degrees to cartesian coordinates on the unit sphere
+		static TPoint ToCartesian(float azimuth, float elevation);
+
+		//Calculate the determinant of the three vectors (triple product)
+		static double Determinant(const TPoint & a, const TPoint & b, const TPoint & c);
+
+		//Calculate the dot product of two vectors
+		static double Dot(const TPoint & a, const TPoint & b);
+
+		//Calculate the signed volume of the tetrahedron of the triangle abc and the point d, positive if d is in front of the triangle
+		static double Orientation(const TPoint & a, const TPoint & b, const TPoint & c, const TPoint & d);
+	};
+}
+#endif
@@ -21,6 +21,7 @@
 */
 #include <BinauralSpatializer/UPCAnechoic.h>
 #include <Common/ErrorHandler.h>
+#include <algorithm>
 
 namespace Binaural {
 	/////////////////////////////
@@ -39,9 +40,9 @@ namespace Binaural {
 	{
 		if (setupDone){
 			//Second time that this method has been called - clear all buffers
-			storageInput_buffer.clear();
+			inBuffer_Time_dobleSize.clear();
 			storageInputFFT_buffer.clear();
-			storageHRIR_buffer.clear();
+			storageOutputFFT_buffer.clear();
 		}
 
 		inputSize = _inputSize;
@@ -50,28 +51,28 @@ namespace Binaural {
 		impulseResponseMemory = _IRMemory;
 
 		//Prepare the buffer with the space that we are going to need	
-		storageInput_buffer.resize(inputSize, 0.0f);
+		inBuffer_Time_dobleSize.resize(2 * inputSize, 0.0f);
 
-		//Preparing the vector of buffers that is going to store the history of FFTs	
-		storageInputFFT_buffer.resize(impulseResponseNumberOfSubfilters);
-		for (int i = 0; i < impulseResponseNumberOfSubfilters; i++) {
-			storageInputFFT_buffer[i].resize(impulseResponse_Frequency_Block_Size, 0.0f);
-		}
-		it_storageInputFFT = storageInputFFT_buffer.begin();
+		//Prepare the FFT of the double size input buffer
+		FFTPlan.Setup(2 * inputSize);
+
+		//Preparing the frequency-domain delay line, one aligned buffer that is going to store the history of FFTs
+		storageInputFFT_slotLength = Common::CalculateAlignedLength(impulseResponse_Frequency_Block_Size);
+		storageInputFFT_buffer.assign(impulseResponseNumberOfSubfilters * storageInputFFT_slotLength, 0.0f);
+		storageInputFFT_head = 0;
+
+		//Prepare the buffers used to multiply and accumulate the spectra of all the subfilters
+		outputFFT_buffer.resize(impulseResponse_Frequency_Block_Size, 0.0f);
+		outputIFFT_buffer.resize(2 * inputSize, 0.0f);
+		productInputFFT.reserve(impulseResponseNumberOfSubfilters);
+		productIR.reserve(impulseResponseNumberOfSubfilters);
 
-		//Preparing the vector of buffers that is going to store the history of the HRIR	
+		//Preparing the spectra of the next outputs, one aligned buffer with the same layout of the delay line
 		if (impulseResponseMemory)
 		{
-			storageHRIR_buffer.resize(impulseResponseNumberOfSubfilters);
-			for (int i = 0; i < impulseResponseNumberOfSubfilters; i++)
-			{
-				storageHRIR_buffer[i].resize(impulseResponseNumberOfSubfilters);
-				for (int j = 0; j < impulseResponseNumberOfSubfilters; j++)
-				{
-					storageHRIR_buffer[i][j].resize(impulseResponse_Frequency_Block_Size, 0.0f);
-				}
-			}
-			it_storageHRIR = storageHRIR_buffer.begin();
+			storageOutputFFT_buffer.assign(impulseResponseNumberOfSubfilters * storageInputFFT_slotLength, 0.0f);
+			storageOutputFFT_head = 0;
+			productOutputFFT.reserve(impulseResponseNumberOfSubfilters);
 		}
 		
 		setupDone = true;
@@ -81,52 +82,32 @@ namespace Binaural {
 	// Make the Uniformed Partitioned Convolution of the input signal
 	void CUPCAnechoic::ProcessUPConvolution(const CMonoBuffer<float>& inBuffer_Time, const TOneEarHRIRPartitionedStruct & IR, CMonoBuffer<float>& outBuffer)
 	{
-		CMonoBuffer<float> sum;
-		sum.resize(impulseResponse_Frequency_Block_Size, 0.0f);
-		CMonoBuffer<float> temp;
-
 
 		if (inBuffer_Time.size() == inputSize) {
 
-			//Step 1- extend the input time signal buffer in order to have double length
-			std::vector<float> inBuffer_Time_dobleSize;
-			inBuffer_Time_dobleSize.reserve(inputSize * 2);
-			inBuffer_Time_dobleSize.insert(inBuffer_Time_dobleSize.begin(), storageInput_buffer.begin(), storageInput_buffer.end());
-			inBuffer_Time_dobleSize.insert(inBuffer_Time_dobleSize.end(), inBuffer_Time.begin(), inBuffer_Time.end());
-			storageInput_buffer = inBuffer_Time;			//Store current input signal
-
-															//Step 2,3 - FFT of the input signal
-			CMonoBuffer<float> inBuffer_Frequency;
-			Common::CFprocessor::CalculateFFT(inBuffer_Time_dobleSize, inBuffer_Frequency);
-			*it_storageInputFFT = inBuffer_Frequency;		//Store the new input FFT into the first FTT history buffers
+			//Step 1, 2, 3 - Extend the input signal to double length and store its FFT in the delay line
+			ProcessInputFFT(inBuffer_Time);
 
-															//Step 4, 5 - Multiplications and sums
-			auto it_product = it_storageInputFFT;
+			//Step 4, 5 - Multiplications and sums, all of them in one pass
+			productInputFFT.clear();
+			productIR.clear();
 
 			for (int i = 0; i < impulseResponseNumberOfSubfilters; i++) {
-				Common::CFprocessor::ProcessComplexMultiplication(*it_product, IR.HRIR_Partitioned[i], temp);
-				sum += temp;
-				if (it_product == storageInputFFT_buffer.begin()) {
-					it_product = storageInputFFT_buffer.end() - 1;
-				}
-				else {
-					it_product--;
+				if (IR.HRIR_Partitioned[i].size() == (size_t)impulseResponse_Frequency_Block_Size) {
+					productInputFFT.push_back(GetInputFFT(i));
+					productIR.push_back(IR.HRIR_Partitioned[i].data());
 				}
 			}
-			//Move iterator waiting for the next input block
-			if (it_storageInputFFT == storageInputFFT_buffer.end() - 1) {
-				it_storageInputFFT = storageInputFFT_buffer.begin();
-			}
-			else {
-				it_storageInputFFT++;
-			}
+			std::fill(outputFFT_buffer.begin(), outputFFT_buffer.end(), 0.0f);
+			Common::CFprocessor::ProcessComplexMultiplyAccumulate(productInputFFT, productIR, outputFFT_buffer);
+
+			//Move the head of the delay line waiting for the next input block
+			ProcessAdvanceInputFFT();
+
 			// Make the IIF
-			CMonoBuffer<float> ouputBuffer_temp;
-			Common::CFprocessor::CalculateIFFT(sum, ouputBuffer_temp);
+			FFTPlan.CalculateIFFT_HalfSpectrum(outputFFT_buffer, outputIFFT_buffer);
 			//We are left only with the final half of the result
-			int halfsize = (int)(ouputBuffer_temp.size() * 0.5f);
-			CMonoBuffer<float> temp_OutputBlock(ouputBuffer_temp.begin() + halfsize, ouputBuffer_temp.end());
-			outBuffer = std::move(temp_OutputBlock);			//To use in C++11
+			outBuffer.assign(outputIFFT_buffer.begin() + inputSize, outputIFFT_buffer.end());
 
 		}
 		else {
@@ -138,77 +119,36 @@ namespace Binaural {
 	// Make the Uniformed Partitioned Convolution of the input signal using also last input signal buffers
 	void CUPCAnechoic::ProcessUPConvolutionWithMemory(const CMonoBuffer<float>& inBuffer_Time, const TOneEarHRIRPartitionedStruct & IR, CMonoBuffer<float>& outBuffer)
 	{
-		CMonoBuffer<float> sum;
-		sum.resize(impulseResponse_Frequency_Block_Size, 0.0f);
-		CMonoBuffer<float> temp;
-		
 		ASSERT(inBuffer_Time.size() == inputSize, RESULT_ERROR_BADSIZE, "Bad input size, don't match with the size setting up in the setup method", "");
 
 		if (impulseResponseMemory) 
 		{
 			if (inBuffer_Time.size() == inputSize && IR.HRIR_Partitioned.size() != 0)
 			{
-				//Step 1- extend the input time signal buffer in order to have double length
-				std::vector<float> inBuffer_Time_dobleSize;
-				inBuffer_Time_dobleSize.reserve(inputSize * 2);
-				inBuffer_Time_dobleSize.insert(inBuffer_Time_dobleSize.begin(), storageInput_buffer.begin(), storageInput_buffer.end());
-				inBuffer_Time_dobleSize.insert(inBuffer_Time_dobleSize.end(), inBuffer_Time.begin(), inBuffer_Time.end());
-				//Store current input signal
-				storageInput_buffer = inBuffer_Time;
-
-				//Step 2,3 - FFT of the input signal
-				CMonoBuffer<float> inBuffer_Frequency;
-				Common::CFprocessor::CalculateFFT(inBuffer_Time_dobleSize, inBuffer_Frequency);
-				//Store the new input FFT into the first FTT history buffers
-				*it_storageInputFFT = inBuffer_Frequency;
-
-				//Store the HRIR input signal in the storage HRIR matrix
-				*it_storageHRIR = IR.HRIR_Partitioned;
-
-				//Step 4, 5 - Multiplications and sums
-				auto it_product = it_storageInputFFT;
-				auto it_HRIR_multiplicationFactor = it_storageHRIR;
-
-				for (int i = 0; i < impulseResponseNumberOfSubfilters; i++) {
-					Common::CFprocessor::ProcessComplexMultiplication(*it_product, (*it_HRIR_multiplicationFactor)[i], temp);
-					sum += temp;
-					if (it_product == storageInputFFT_buffer.begin()) {
-						it_product = storageInputFFT_buffer.end() - 1;
-					}
-					else {
-						it_product--;
-					}
-
-					if (it_HRIR_multiplicationFactor == storageHRIR_buffer.end() - 1) {
-						it_HRIR_multiplicationFactor = storageHRIR_buffer.begin();
+				//Step 1, 2, 3 - Extend the input signal to double length and store its FFT in the delay line
+				ProcessInputFFT(inBuffer_Time);
+
+				//Step 4, 5 - Multiply the input FFT by all the subfilters, adding each product to the spectrum of the output in which it has to appear
+				productIR.clear();
+				productOutputFFT.clear();
+
+				int numberOfSubfilters = std::min(impulseResponseNumberOfSubfilters, static_cast<int>(IR.HRIR_Partitioned.size()));
+				for (int i = 0; i < numberOfSubfilters; i++) {
+					if (IR.HRIR_Partitioned[i].size() == (size_t)impulseResponse_Frequency_Block_Size) {
+						productIR.push_back(IR.HRIR_Partitioned[i].data());
+						productOutputFFT.push_back(GetOutputFFT(i));
 					}
-					else {
-						it_HRIR_multiplicationFactor++;
-					}
-				}
-				//Move iterator waiting for the next input block
-				if (it_storageInputFFT == storageInputFFT_buffer.end() - 1) {
-					it_storageInputFFT = storageInputFFT_buffer.begin();
-				}
-				else {
-					it_storageInputFFT++;
-				}
-
-				//Move iterator waiting for the next input block
-				if (it_storageHRIR == storageHRIR_buffer.begin()) {
-					it_storageHRIR = storageHRIR_buffer.end() - 1;
-				}
-				else {
-					it_storageHRIR--;
 				}
+				Common::CFprocessor::ProcessComplexMultiplyAccumulate(GetInputFFT(0), productIR, productOutputFFT, impulseResponse_Frequency_Block_Size);
 
-				// Make the IIF
-				CMonoBuffer<float> ouputBuffer_temp;
-				Common::CFprocessor::CalculateIFFT(sum, ouputBuffer_temp);
+				// Make the IIF of the current output, that has already got the products of all the subfilters
+				FFTPlan.CalculateIFFT_HalfSpectrum(GetOutputFFT(0), outputIFFT_buffer.data());
 				//We are left only with the final half of the result
-				int halfsize = (int)(ouputBuffer_temp.size() * 0.5f);
-				CMonoBuffer<float> temp_OutputBlock(ouputBuffer_temp.begin() + halfsize, ouputBuffer_temp.end());
-				outBuffer = std::move(temp_OutputBlock);			//To use in C++11
+				outBuffer.assign(outputIFFT_buffer.begin() + inputSize, outputIFFT_buffer.end());
+
+				//Move the heads waiting for the next input block
+				ProcessAdvanceInputFFT();
+				ProcessAdvanceOutputFFT();
 
 			}
 			else 
@@ -224,4 +164,55 @@ namespace Binaural {
 
 	}
 
+	/////////////////////
+	// Private Methods //
+	/////////////////////
+
+	//Extend the input signal to double length with the previous block and calculate its FFT directly into the head slot of the delay line
+	void CUPCAnechoic::ProcessInputFFT(const CMonoBuffer<float>& inBuffer_Time)
+	{
+		//The first half keeps the previous input block and the second half the current one
+		std::copy(inBuffer_Time_dobleSize.begin() + inputSize, inBuffer_Time_dobleSize.end(), inBuffer_Time_dobleSize.begin());
+		std::copy(inBuffer_Time.begin(), inBuffer_Time.end(), inBuffer_Time_dobleSize.begin() + inputSize);
+
+		float* inBuffer_Frequency = storageInputFFT_buffer.data() + storageInputFFT_head * storageInputFFT_slotLength;
+		FFTPlan.CalculateFFT_HalfSpectrum(inBuffer_Time_dobleSize.data(), inBuffer_Time_dobleSize.size(), inBuffer_Frequency);
+	}
+
+	//Get the FFT of the input block that is delay blocks older than the current one
+	const float* CUPCAnechoic::GetInputFFT(int delay) const
+	{
+		int slot = storageInputFFT_head + delay;
+		if (slot >= impulseResponseNumberOfSubfilters) { slot -= impulseResponseNumberOfSubfilters; }
+		return storageInputFFT_buffer.data() + slot * storageInputFFT_slotLength;
+	}
+
+	//Move the head of the delay line one slot back, so the older FFTs are read going forward through the buffer
+	void CUPCAnechoic::ProcessAdvanceInputFFT()
+	{
+		if (storageInputFFT_head == 0) {
+			storageInputFFT_head = impulseResponseNumberOfSubfilters - 1;
+		}
+		else {
+			storageInputFFT_head--;
+		}
+	}
+
+	//Get the spectrum of the output that is delay blocks later than the current one
+	float* CUPCAnechoic::GetOutputFFT(int delay)
+	{
+		int slot = storageOutputFFT_head + delay;
+		if (slot >= impulseResponseNumberOfSubfilters) { slot -= impulseResponseNumberOfSubfilters; }
+		return storageOutputFFT_buffer.data() + slot * storageInputFFT_slotLength;
+	}
+
+	//Clear the spectrum of the current output, that is going to be reused for the last subfilter, and move the head one slot forward
+	void CUPCAnechoic::ProcessAdvanceOutputFFT()
+	{
+		float* currentOutputFFT = GetOutputFFT(0);
+		std::fill(currentOutputFFT, currentOutputFFT + storageInputFFT_slotLength, 0.0f);
+
+		storageOutputFFT_head++;
+		if (storageOutputFFT_head == impulseResponseNumberOfSubfilters) { storageOutputFFT_head = 0; }
+	}
 }
\ No newline at end of file
@@ -27,6 +27,7 @@
 #include <vector>
 #include <Common/Fprocessor.h>
 #include <Common/Buffer.h>
+#include <Common/AlignedAllocator.h>
 #include <BinauralSpatializer/HRTF.h>
 
 /** \brief Type definition for partitioned HRIR table
@@ -50,7 +51,7 @@ namespace Binaural {
 		/** \brief Initialize the class and allocate memory.
 		*   \details When this method is called, the system initializes variables and allocates memory space for the buffer.
 		*	\param [in] _inputSize size of the input signal buffer (B size)
-		*	\param [in] _HRIR_Frequency_Block_Size size of the FTT Impulse Response blocks, this number is (2*B + k) = 2^n
+		*	\param [in] _HRIR_Frequency_Block_Size size of the FTT Impulse Response blocks, this number is 2*B + 2 (half spectrum of an FFT of 2*B points)
 		*	\param [in] _HRIR_Block_Number number of blocks in which is divided the the impluse response
 		*	\param [in] _IRMemory if true, the method with IR memory will be used (otherwise, the method without memory will be used instead)
 		*   \eh On error, an error code is reported to the error handler.
@@ -61,17 +62,18 @@ namespace Binaural {
 		*   \details This method performs the convolution between the input signal and the partitioned HRIR using the UPC* method, returning the FFT of the output.
 		*   \details *Wefers, F. (2015). Partitioned convolution algorithms for real-time auralization (Vol. 20). Logos Verlag Berlin GmbH.
 		*	\param [in] inBuffer_Time input signal buffer of B size
-		*	\param [in] IR buffer structure that contains the HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B
+		*	\param [in] IR buffer structure that contains the HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
 		*	\param [out] outBuffer FFT of the output signal of 2*B size (complex numbers). After the IIFT is done, only the last B samples are significant
 		*   \eh Nothing is reported to the error handler.
 		*/
 		void ProcessUPConvolution(const CMonoBuffer<float>& inBuffer_Time, const TOneEarHRIRPartitionedStruct & IR, CMonoBuffer<float>& outBuffer);
 
 		/** \brief Make the Uniformed Partitioned Convolution of the input signal using also last input signal buffers (method with memory)
-		*   \details This method performs the convolution between the input signal and the partitioned HRIR (the HRIR has been stored for each input signal block) using the UPC* method, returning the FFT of the output.
+		*   \details This method performs the convolution between the input signal and the partitioned HRIR (each input signal block is convolved with the HRIR received with it) using the UPC* method, returning the FFT of the output.
+		*	The products of each input block with all the subfilters are added in advance to the spectra of the next outputs, so the HRIR does not need to be stored.
 		*   \details *Wefers, F. (2015). Partitioned convolution algorithms for real-time auralization (Vol. 20). Logos Verlag Berlin GmbH.
 		*	\param [in] inBuffer_Time input signal buffer of B size
-		*	\param [in] IR buffer structure that contains the HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B
+		*	\param [in] IR buffer structure that contains the HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
 		*	\param [out] outBuffer FFT of the output signal of 2*B size (complex numbers). After the IIFT is done, only the last B samples are significant
 		*   \eh Nothing is reported to the error handler.
 		*/
@@ -85,11 +87,34 @@ namespace Binaural {
 		bool impulseResponseMemory;					//Indicate if HRTF storage buffer has to be prepared to do UPC with memory
 		bool setupDone;								//It's true when setup has been called at least once
 				
-		std::vector<float> storageInput_buffer;						//To store the last input signal
-		std::vector<vector<float>> storageInputFFT_buffer;			//To store the history of input signals FFTs 
-		std::vector<vector<float>>::iterator it_storageInputFFT;	//Declare a general iterator to keep the head of the FTTs buffer
-		std::vector<THRIR_partitioned> storageHRIR_buffer;			//To store the HRIR of the orientation of the previous frames
-		std::vector<THRIR_partitioned>::iterator it_storageHRIR;		//Declare a general iterator to keep the head of the storageHRIR_buffer		
+		std::vector<float> inBuffer_Time_dobleSize;					//To store the last two input signals, the previous one followed by the current one
+		Common::CAlignedVector<float> storageInputFFT_buffer;		//Frequency-domain delay line: history of input signals FFTs, one slot of storageInputFFT_slotLength values for each subfilter
+		int storageInputFFT_slotLength;								//Distance between two slots of the delay line, rounded up to keep every slot aligned
+		int storageInputFFT_head;									//Slot with the FFT of the current input signal. The FFT i blocks older is in the slot (head + i) % number of subfilters
+		Common::CAlignedVector<float> storageOutputFFT_buffer;		//Spectra of the next outputs (method with memory), one slot of storageInputFFT_slotLength values for each subfilter
+		int storageOutputFFT_head;									//Slot with the spectrum of the current output. The output i blocks later is accumulated in the slot (head + i) % number of subfilters
+		Common::CFFTPlan FFTPlan;								//FFT tables of 2*B points, calculated once in the setup method
+		std::vector<float> outputFFT_buffer;						//To accumulate the products of the input FFTs and the subfilters
+		std::vector<float> outputIFFT_buffer;						//To store the IFFT of the accumulated products, 2*B samples
+		std::vector<const float*> productInputFFT;					//Input FFTs multiplied in the current block
+		std::vector<const float*> productIR;						//Subfilters multiplied in the current block
+		std::vector<float*> productOutputFFT;						//Output spectra where the products of the current block are accumulated (method with memory)
+
+		// METHODS
+		//Extend the input signal to double length and calculate its FFT directly into the head slot of the delay line
+		void ProcessInputFFT(const CMonoBuffer<float>& inBuffer_Time);
+
+		//Get the FFT of the input signal that is delay blocks older than the current one
+		const float* GetInputFFT(int delay) const;
+
+		//Move the head of the delay line waiting for the next input block
+		void ProcessAdvanceInputFFT();
+
+		//Get the spectrum of the output that is delay blocks later than the current one
+		float* GetOutputFFT(int delay);
+
+		//Clear the spectrum of the current output and move the head waiting for the next input block
+		void ProcessAdvanceOutputFFT();
 	};
 }
 #endif
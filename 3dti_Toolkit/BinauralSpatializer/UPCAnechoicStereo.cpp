@@ -0,0 +1,456 @@
+/**
+* \class CUPCAnechoicStereo
+*
+* \brief Uniformly Partitioned Convolution Algorithm (UPC algorithm) of one input signal with the impulse responses of both ears
+*
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#include <BinauralSpatializer/UPCAnechoicStereo.h>
+#include <Common/ErrorHandler.h>
+#include <algorithm>
+
+namespace Binaural {
+	/////////////////////////////
+	// CONSTRUCTOR/DESTRUCTOR  //
+	/////////////////////////////
+	CUPCAnechoicStereo::CUPCAnechoicStereo() : setupDone{ false }
+	{
+	}
+
+	///////////////////
+	// Public Methods //
+	///////////////////
+
+	//Initialize the class and allocate memory.
+	void CUPCAnechoicStereo::Setup(int _inputSize, int _IR_Frequency_Block_Size, int _IR_Block_Number, bool _IRMemory)
+	{
+		if (setupDone) {
+			//Second time that this method has been called - clear all buffers
+			inBuffer_Time_dobleSize.clear();
+			storageInputFFT_buffer.clear();
+			storageOutputFFT_buffer.clear();
+		}
+
+		inputSize = _inputSize;
+		impulseResponse_Frequency_Block_Size = _IR_Frequency_Block_Size;
+		impulseResponseNumberOfSubfilters = _IR_Block_Number;
+		impulseResponseMemory = _IRMemory;
+
+		//Prepare the buffer with the space that we are going to need
+		inBuffer_Time_dobleSize.resize(2 * inputSize, 0.0f);
+
+		//Prepare the FFT of the double size input buffer
+		FFTPlan.Setup(2 * inputSize);
+
+		//Preparing the frequency-domain delay line shared by both ears, one aligned buffer with the history of FFTs
+		storageInputFFT_slotLength = Common::CalculateAlignedLength(impulseResponse_Frequency_Block_Size);
+		storageInputFFT_buffer.assign(impulseResponseNumberOfSubfilters * storageInputFFT_slotLength, 0.0f);
+		storageInputFFT_head = 0;
+
+		//Prepare the buffers used to multiply and accumulate the spectra of all the subfilters. They are reused for both ears
+		outputFFT_buffer.resize(impulseResponse_Frequency_Block_Size, 0.0f);
+		outputIFFT_buffer.resize(2 * inputSize, 0.0f);
+		productInputFFT.reserve(impulseResponseNumberOfSubfilters);
+		productIR.reserve(impulseResponseNumberOfSubfilters);
+		leftIR_subfilters.reserve(impulseResponseNumberOfSubfilters);
+		rightIR_subfilters.reserve(impulseResponseNumberOfSubfilters);
+
+		//Preparing the spectra of the next outputs of each ear, one aligned buffer with the left ones followed by the right ones
+		if (impulseResponseMemory)
+		{
+			storageOutputFFT_buffer.assign(2 * impulseResponseNumberOfSubfilters * storageInputFFT_slotLength, 0.0f);
+			storageOutputFFT_head = 0;
+			productOutputFFT.reserve(impulseResponseNumberOfSubfilters);
+		}
+
+		setupDone = true;
+		SET_RESULT(RESULT_OK, "Stereo UPC convolver successfully set");
+	}//Setup
+
+	// Make the Uniformed Partitioned Convolution of the input signal with the impulse responses of both ears
+	void CUPCAnechoicStereo::ProcessUPConvolution(const CMonoBuffer<float>& inBuffer_Time, const TOneEarHRIRPartitionedStruct & leftIR, const TOneEarHRIRPartitionedStruct & rightIR, CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer)
+	{
+		GetSubfilters(leftIR.HRIR_Partitioned, leftIR_subfilters);
+		GetSubfilters(rightIR.HRIR_Partitioned, rightIR_subfilters);
+		ProcessUPConvolution(inBuffer_Time, outLeftBuffer, outRightBuffer);
+	}
+
+	// Make the Uniformed Partitioned Convolution of the input signal with the impulse responses of both ears (impulse responses given as read-only views)
+	void CUPCAnechoicStereo::ProcessUPConvolution(const CMonoBuffer<float>& inBuffer_Time, const TOneEarHRIRPartitionedView & leftIR, const TOneEarHRIRPartitionedView & rightIR, CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer)
+	{
+		GetSubfilters(leftIR, leftIR_subfilters);
+		GetSubfilters(rightIR, rightIR_subfilters);
+		ProcessUPConvolution(inBuffer_Time, outLeftBuffer, outRightBuffer);
+	}
+
+	// Make the Uniformed Partitioned Convolution of the input signal with the impulse responses of both ears using also last input signal buffers
+	void CUPCAnechoicStereo::ProcessUPConvolutionWithMemory(const CMonoBuffer<float>& inBuffer_Time, const TOneEarHRIRPartitionedStruct & leftIR, const TOneEarHRIRPartitionedStruct & rightIR, CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer)
+	{
+		GetSubfilters(leftIR.HRIR_Partitioned, leftIR_subfilters);
+		GetSubfilters(rightIR.HRIR_Partitioned, rightIR_subfilters);
+		ProcessUPConvolutionWithMemory(inBuffer_Time, outLeftBuffer, outRightBuffer);
+	}
+
+	// Make the Uniformed Partitioned Convolution of the input signal with the impulse responses of both ears using also last input signal buffers (impulse responses given as read-only views)
+	void CUPCAnechoicStereo::ProcessUPConvolutionWithMemory(const CMonoBuffer<float>& inBuffer_Time, const TOneEarHRIRPartitionedView & leftIR, const TOneEarHRIRPartitionedView & rightIR, CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer)
+	{
+		GetSubfilters(leftIR, leftIR_subfilters);
+		GetSubfilters(rightIR, rightIR_subfilters);
+		ProcessUPConvolutionWithMemory(inBuffer_Time, outLeftBuffer, outRightBuffer);
+	}
+
+	// Make the Uniformed Partitioned Convolution of the input signal with the impulse responses of both ears, adding the spectra of the outputs to the output buffers
+	void CUPCAnechoicStereo::ProcessUPConvolution_withoutIFFT(const CMonoBuffer<float>& inBuffer_Time, const TOneEarHRIRPartitionedStruct & leftIR, const TOneEarHRIRPartitionedStruct & rightIR, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency)
+	{
+		GetSubfilters(leftIR.HRIR_Partitioned, leftIR_subfilters);
+		GetSubfilters(rightIR.HRIR_Partitioned, rightIR_subfilters);
+		ProcessUPConvolution_withoutIFFT(inBuffer_Time, outLeftBuffer_Frequency, outRightBuffer_Frequency);
+	}
+
+	// Make the Uniformed Partitioned Convolution of the input signal with the impulse responses of both ears, adding the spectra of the outputs to the output buffers (impulse responses given as read-only views)
+	void CUPCAnechoicStereo::ProcessUPConvolution_withoutIFFT(const CMonoBuffer<float>& inBuffer_Time, const TOneEarHRIRPartitionedView & leftIR, const TOneEarHRIRPartitionedView & rightIR, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency)
+	{
+		GetSubfilters(leftIR, leftIR_subfilters);
+		GetSubfilters(rightIR, rightIR_subfilters);
+		ProcessUPConvolution_withoutIFFT(inBuffer_Time, outLeftBuffer_Frequency, outRightBuffer_Frequency);
+	}
+
+	// Make the Uniformed Partitioned Convolution of the input signal with the impulse responses of both ears using also last input signal buffers, adding the spectra of the outputs to the output buffers
+	void CUPCAnechoicStereo::ProcessUPConvolutionWithMemory_withoutIFFT(const CMonoBuffer<float>& inBuffer_Time, const TOneEarHRIRPartitionedStruct & leftIR, const TOneEarHRIRPartitionedStruct & rightIR, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency)
+	{
+		GetSubfilters(leftIR.HRIR_Partitioned, leftIR_subfilters);
+		GetSubfilters(rightIR.HRIR_Partitioned, rightIR_subfilters);
+		ProcessUPConvolutionWithMemory_withoutIFFT(inBuffer_Time, outLeftBuffer_Frequency, outRightBuffer_Frequency);
+	}
+
+	// Make the Uniformed Partitioned Convolution of the input signal with the impulse responses of both ears using also last input signal buffers, adding the spectra of the outputs to the output buffers (impulse responses given as read-only views)
+	void CUPCAnechoicStereo::ProcessUPConvolutionWithMemory_withoutIFFT(const CMonoBuffer<float>& inBuffer_Time, const TOneEarHRIRPartitionedView & leftIR, const TOneEarHRIRPartitionedView & rightIR, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency)
+	{
+		GetSubfilters(leftIR, leftIR_subfilters);
+		GetSubfilters(rightIR, rightIR_subfilters);
+		ProcessUPConvolutionWithMemory_withoutIFFT(inBuffer_Time, outLeftBuffer_Frequency, outRightBuffer_Frequency);
+	}
+
+	// Extend the input signal to double length with the previous block, so its FFT can be calculated by the caller
+	void CUPCAnechoicStereo::PrepareInputFFT(const CMonoBuffer<float>& inBuffer_Time, const float* & inBuffer_dobleSize, float* & inBuffer_Frequency)
+	{
+		ASSERT(inBuffer_Time.size() == (size_t)inputSize, RESULT_ERROR_BADSIZE, "Bad input size, don't match with the size setting up in the setup method", "");
+
+		inBuffer_dobleSize = nullptr;
+		inBuffer_Frequency = nullptr;
+		if (inBuffer_Time.size() == (size_t)inputSize)	//Just in case error handler is off
+		{
+			ProcessDoubleSizeInput(inBuffer_Time);
+			inBuffer_dobleSize = inBuffer_Time_dobleSize.data();
+			inBuffer_Frequency = storageInputFFT_buffer.data() + storageInputFFT_head * storageInputFFT_slotLength;
+		}
+	}
+
+	// Make the Uniformed Partitioned Convolution of the input signal prepared by PrepareInputFFT, adding the spectra of the outputs to the output buffers
+	void CUPCAnechoicStereo::ProcessUPConvolution_withoutIFFT(const TOneEarHRIRPartitionedView & leftIR, const TOneEarHRIRPartitionedView & rightIR, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency)
+	{
+		ASSERT(outLeftBuffer_Frequency.size() == (size_t)impulseResponse_Frequency_Block_Size && outRightBuffer_Frequency.size() == (size_t)impulseResponse_Frequency_Block_Size, RESULT_ERROR_BADSIZE, "Bad output size, don't match with the size setting up in the setup method", "");
+
+		if (outLeftBuffer_Frequency.size() == (size_t)impulseResponse_Frequency_Block_Size && outRightBuffer_Frequency.size() == (size_t)impulseResponse_Frequency_Block_Size)	//Just in case error handler is off
+		{
+			GetSubfilters(leftIR, leftIR_subfilters);
+			GetSubfilters(rightIR, rightIR_subfilters);
+			ProcessOutputSpectra(outLeftBuffer_Frequency, outRightBuffer_Frequency);
+		}
+	}
+
+	// Make the Uniformed Partitioned Convolution with memory of the input signal prepared by PrepareInputFFT, adding the spectra of the outputs to the output buffers
+	void CUPCAnechoicStereo::ProcessUPConvolutionWithMemory_withoutIFFT(const TOneEarHRIRPartitionedView & leftIR, const TOneEarHRIRPartitionedView & rightIR, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency)
+	{
+		ASSERT(outLeftBuffer_Frequency.size() == (size_t)impulseResponse_Frequency_Block_Size && outRightBuffer_Frequency.size() == (size_t)impulseResponse_Frequency_Block_Size, RESULT_ERROR_BADSIZE, "Bad output size, don't match with the size setting up in the setup method", "");
+
+		if (!impulseResponseMemory)
+		{
+			SET_RESULT(RESULT_ERROR_NOTSET, "HRTF storage buffer to perform UP convolution with memory has not been initialized");
+			return;
+		}
+		GetSubfilters(leftIR, leftIR_subfilters);
+		GetSubfilters(rightIR, rightIR_subfilters);
+		if (outLeftBuffer_Frequency.size() == (size_t)impulseResponse_Frequency_Block_Size && outRightBuffer_Frequency.size() == (size_t)impulseResponse_Frequency_Block_Size &&
+			!leftIR_subfilters.empty() && !rightIR_subfilters.empty())
+		{
+			ProcessOutputSpectraWithMemory(outLeftBuffer_Frequency, outRightBuffer_Frequency);
+		}
+		else
+		{
+			SET_RESULT(RESULT_ERROR_BADSIZE, "The output buffer size is not correct or there is not a valid HRTF loded");
+		}
+	}
+
+	/////////////////////
+	// Private Methods //
+	/////////////////////
+
+	//Keep the subfilters of one HRIR, nullptr for the ones that do not have the size of the convolver
+	void CUPCAnechoicStereo::GetSubfilters(const THRIR_partitioned & IR, std::vector<const float*> & subfilters) const
+	{
+		subfilters.clear();
+		for (size_t i = 0; i < IR.size(); i++) {
+			subfilters.push_back(IR[i].size() == (size_t)impulseResponse_Frequency_Block_Size ? IR[i].data() : nullptr);
+		}
+	}
+
+	//Keep the subfilters of the view of one HRIR, nullptr for the ones that do not have the size of the convolver
+	void CUPCAnechoicStereo::GetSubfilters(const TOneEarHRIRPartitionedView & IR, std::vector<const float*> & subfilters) const
+	{
+		subfilters.clear();
+		for (int i = 0; i < IR.numberOfSubfilters; i++) {
+			subfilters.push_back(IR.subfilterLengths[i] == impulseResponse_Frequency_Block_Size ? IR.HRIR + IR.subfilterOffsets[i] : nullptr);
+		}
+	}
+
+	// Make the Uniformed Partitioned Convolution of the input signal with the impulse responses of both ears
+	void CUPCAnechoicStereo::ProcessUPConvolution(const CMonoBuffer<float>& inBuffer_Time, CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer)
+	{
+		ASSERT(inBuffer_Time.size() == (size_t)inputSize, RESULT_ERROR_BADSIZE, "Bad input size, don't match with the size setting up in the setup method", "");
+
+		if (inBuffer_Time.size() == (size_t)inputSize)	//Just in case error handler is off
+		{
+			//Step 1, 2, 3 - Extend the input signal to double length and store its FFT in the delay line, once for both ears
+			ProcessInputFFT(inBuffer_Time);
+
+			//Step 4, 5, 6 - Multiplications, sums and IFFT of each ear
+			std::fill(outputFFT_buffer.begin(), outputFFT_buffer.end(), 0.0f);
+			ProcessMultiplyAccumulate(leftIR_subfilters, outputFFT_buffer);
+			ProcessOutputIFFT(outputFFT_buffer.data(), outLeftBuffer);
+
+			std::fill(outputFFT_buffer.begin(), outputFFT_buffer.end(), 0.0f);
+			ProcessMultiplyAccumulate(rightIR_subfilters, outputFFT_buffer);
+			ProcessOutputIFFT(outputFFT_buffer.data(), outRightBuffer);
+
+			//Move the head of the delay line waiting for the next input block
+			ProcessAdvanceInputFFT();
+		}
+	}
+
+	// Make the Uniformed Partitioned Convolution of the input signal with the impulse responses of both ears using also last input signal buffers
+	void CUPCAnechoicStereo::ProcessUPConvolutionWithMemory(const CMonoBuffer<float>& inBuffer_Time, CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer)
+	{
+		ASSERT(inBuffer_Time.size() == (size_t)inputSize, RESULT_ERROR_BADSIZE, "Bad input size, don't match with the size setting up in the setup method", "");
+
+		if (impulseResponseMemory)
+		{
+			if (inBuffer_Time.size() == (size_t)inputSize && !leftIR_subfilters.empty() && !rightIR_subfilters.empty())
+			{
+				//Step 1, 2, 3 - Extend the input signal to double length and store its FFT in the delay line, once for both ears
+				ProcessInputFFT(inBuffer_Time);
+
+				//Step 4, 5 - Multiply the input FFT by all the subfilters of each ear, adding each product to the spectrum of the output in which it has to appear
+				ProcessMultiplyAccumulateWithMemory(leftIR_subfilters, Common::T_ear::LEFT);
+				ProcessMultiplyAccumulateWithMemory(rightIR_subfilters, Common::T_ear::RIGHT);
+
+				//Step 6 - IFFT of the current output of each ear, that has already got the products of all the subfilters
+				ProcessOutputIFFT(GetOutputFFT(0, Common::T_ear::LEFT), outLeftBuffer);
+				ProcessOutputIFFT(GetOutputFFT(0, Common::T_ear::RIGHT), outRightBuffer);
+
+				//Move the heads waiting for the next input block
+				ProcessAdvanceInputFFT();
+				ProcessAdvanceOutputFFT();
+			}
+			else
+			{
+				SET_RESULT(RESULT_ERROR_BADSIZE, "The input buffer size is not correct or there is not a valid HRTF loded");
+				outLeftBuffer.resize(inBuffer_Time.size(), 0.0f);
+				outRightBuffer.resize(inBuffer_Time.size(), 0.0f);
+			}
+		}
+		else
+		{
+			SET_RESULT(RESULT_ERROR_NOTSET, "HRTF storage buffer to perform UP convolution with memory has not been initialized");
+		}
+	}
+
+	// Make the Uniformed Partitioned Convolution of the input signal with the impulse responses of both ears, adding the spectra of the outputs to the output buffers
+	void CUPCAnechoicStereo::ProcessUPConvolution_withoutIFFT(const CMonoBuffer<float>& inBuffer_Time, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency)
+	{
+		ASSERT(inBuffer_Time.size() == (size_t)inputSize, RESULT_ERROR_BADSIZE, "Bad input size, don't match with the size setting up in the setup method", "");
+		ASSERT(outLeftBuffer_Frequency.size() == (size_t)impulseResponse_Frequency_Block_Size && outRightBuffer_Frequency.size() == (size_t)impulseResponse_Frequency_Block_Size, RESULT_ERROR_BADSIZE, "Bad output size, don't match with the size setting up in the setup method", "");
+
+		if (inBuffer_Time.size() == (size_t)inputSize &&
+			outLeftBuffer_Frequency.size() == (size_t)impulseResponse_Frequency_Block_Size && outRightBuffer_Frequency.size() == (size_t)impulseResponse_Frequency_Block_Size)	//Just in case error handler is off
+		{
+			//Step 1, 2, 3 - Extend the input signal to double length and store its FFT in the delay line, once for both ears
+			ProcessInputFFT(inBuffer_Time);
+
+			//Step 4, 5
+			ProcessOutputSpectra(outLeftBuffer_Frequency, outRightBuffer_Frequency);
+		}
+	}
+
+	// Make the Uniformed Partitioned Convolution of the input signal with the impulse responses of both ears using also last input signal buffers, adding the spectra of the outputs to the output buffers
+	void CUPCAnechoicStereo::ProcessUPConvolutionWithMemory_withoutIFFT(const CMonoBuffer<float>& inBuffer_Time, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency)
+	{
+		ASSERT(inBuffer_Time.size() == (size_t)inputSize, RESULT_ERROR_BADSIZE, "Bad input size, don't match with the size setting up in the setup method", "");
+		ASSERT(outLeftBuffer_Frequency.size() == (size_t)impulseResponse_Frequency_Block_Size && outRightBuffer_Frequency.size() == (size_t)impulseResponse_Frequency_Block_Size, RESULT_ERROR_BADSIZE, "Bad output size, don't match with the size setting up in the setup method", "");
+
+		if (impulseResponseMemory)
+		{
+			if (inBuffer_Time.size() == (size_t)inputSize &&
+				outLeftBuffer_Frequency.size() == (size_t)impulseResponse_Frequency_Block_Size && outRightBuffer_Frequency.size() == (size_t)impulseResponse_Frequency_Block_Size &&
+				!leftIR_subfilters.empty() && !rightIR_subfilters.empty())
+			{
+				//Step 1, 2, 3 - Extend the input signal to double length and store its FFT in the delay line, once for both ears
+				ProcessInputFFT(inBuffer_Time);
+
+				//Step 4, 5
+				ProcessOutputSpectraWithMemory(outLeftBuffer_Frequency, outRightBuffer_Frequency);
+			}
+			else
+			{
+				SET_RESULT(RESULT_ERROR_BADSIZE, "The input or output buffer size is not correct or there is not a valid HRTF loded");
+			}
+		}
+		else
+		{
+			SET_RESULT(RESULT_ERROR_NOTSET, "HRTF storage buffer to perform UP convolution with memory has not been initialized");
+		}
+	}
+
+	//Multiply the input FFT in the head slot of the delay line by the subfilters of each ear, directly over the output buffers
+	void CUPCAnechoicStereo::ProcessOutputSpectra(std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency)
+	{
+		//Step 4, 5 - Multiplications and sums, directly over the output buffers
+		ProcessMultiplyAccumulate(leftIR_subfilters, outLeftBuffer_Frequency);
+		ProcessMultiplyAccumulate(rightIR_subfilters, outRightBuffer_Frequency);
+
+		//Move the head of the delay line waiting for the next input block
+		ProcessAdvanceInputFFT();
+	}
+
+	//Multiply the input FFT in the head slot of the delay line by the subfilters of each ear, adding the current outputs to the output buffers
+	void CUPCAnechoicStereo::ProcessOutputSpectraWithMemory(std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency)
+	{
+		//Step 4, 5 - Multiply the input FFT by all the subfilters of each ear, adding each product to the spectrum of the output in which it has to appear
+		ProcessMultiplyAccumulateWithMemory(leftIR_subfilters, Common::T_ear::LEFT);
+		ProcessMultiplyAccumulateWithMemory(rightIR_subfilters, Common::T_ear::RIGHT);
+
+		//Add the current output of each ear, that has already got the products of all the subfilters, to the output buffers
+		const float* leftOutputFFT = GetOutputFFT(0, Common::T_ear::LEFT);
+		const float* rightOutputFFT = GetOutputFFT(0, Common::T_ear::RIGHT);
+		for (int j = 0; j < impulseResponse_Frequency_Block_Size; j++) {
+			outLeftBuffer_Frequency[j] += leftOutputFFT[j];
+			outRightBuffer_Frequency[j] += rightOutputFFT[j];
+		}
+
+		//Move the heads waiting for the next input block
+		ProcessAdvanceInputFFT();
+		ProcessAdvanceOutputFFT();
+	}
+
+	//Extend the input signal to double length with the previous block and calculate its FFT directly into the head slot of the delay line
+	void CUPCAnechoicStereo::ProcessInputFFT(const CMonoBuffer<float>& inBuffer_Time)
+	{
+		ProcessDoubleSizeInput(inBuffer_Time);
+
+		float* inBuffer_Frequency = storageInputFFT_buffer.data() + storageInputFFT_head * storageInputFFT_slotLength;
+		FFTPlan.CalculateFFT_HalfSpectrum(inBuffer_Time_dobleSize.data(), 2 * inputSize, inBuffer_Frequency);
+	}
+
+	//The first half keeps the previous input block and the second half the current one
+	void CUPCAnechoicStereo::ProcessDoubleSizeInput(const CMonoBuffer<float>& inBuffer_Time)
+	{
+		std::copy(inBuffer_Time_dobleSize.begin() + inputSize, inBuffer_Time_dobleSize.end(), inBuffer_Time_dobleSize.begin());
+		std::copy(inBuffer_Time.begin(), inBuffer_Time.end(), inBuffer_Time_dobleSize.begin() + inputSize);
+	}
+
+	//Get the FFT of the input block that is delay blocks older than the current one
+	const float* CUPCAnechoicStereo::GetInputFFT(int delay) const
+	{
+		int slot = storageInputFFT_head + delay;
+		if (slot >= impulseResponseNumberOfSubfilters) { slot -= impulseResponseNumberOfSubfilters; }
+		return storageInputFFT_buffer.data() + slot * storageInputFFT_slotLength;
+	}
+
+	//Get the spectrum of the output of one ear that is delay blocks later than the current one
+	float* CUPCAnechoicStereo::GetOutputFFT(int delay, Common::T_ear ear)
+	{
+		int slot = storageOutputFFT_head + delay;
+		if (slot >= impulseResponseNumberOfSubfilters) { slot -= impulseResponseNumberOfSubfilters; }
+		if (ear == Common::T_ear::RIGHT) { slot += impulseResponseNumberOfSubfilters; }
+		return storageOutputFFT_buffer.data() + slot * storageInputFFT_slotLength;
+	}
+
+	//Move the head of the delay line one slot back, so the older FFTs are read going forward through the buffer
+	void CUPCAnechoicStereo::ProcessAdvanceInputFFT()
+	{
+		if (storageInputFFT_head == 0) {
+			storageInputFFT_head = impulseResponseNumberOfSubfilters - 1;
+		}
+		else {
+			storageInputFFT_head--;
+		}
+	}
+
+	//Add to outBuffer_Frequency the products of the subfilters of one ear and the delay line of the input
+	void CUPCAnechoicStereo::ProcessMultiplyAccumulate(const std::vector<const float*> & subfilters, std::vector<float>& outBuffer_Frequency)
+	{
+		productInputFFT.clear();
+		productIR.clear();
+
+		int numberOfSubfilters = std::min(impulseResponseNumberOfSubfilters, static_cast<int>(subfilters.size()));
+		for (int i = 0; i < numberOfSubfilters; i++) {
+			if (subfilters[i] != nullptr) {
+				productInputFFT.push_back(GetInputFFT(i));
+				productIR.push_back(subfilters[i]);
+			}
+		}
+		Common::CFprocessor::ProcessComplexMultiplyAccumulate(productInputFFT, productIR, outBuffer_Frequency);
+	}
+
+	//Multiply the current input FFT by all the subfilters of one ear, adding each product to the spectrum of the output of that ear in which it has to appear
+	void CUPCAnechoicStereo::ProcessMultiplyAccumulateWithMemory(const std::vector<const float*> & subfilters, Common::T_ear ear)
+	{
+		productIR.clear();
+		productOutputFFT.clear();
+
+		int numberOfSubfilters = std::min(impulseResponseNumberOfSubfilters, static_cast<int>(subfilters.size()));
+		for (int i = 0; i < numberOfSubfilters; i++) {
+			if (subfilters[i] != nullptr) {
+				productIR.push_back(subfilters[i]);
+				productOutputFFT.push_back(GetOutputFFT(i, ear));
+			}
+		}
+		Common::CFprocessor::ProcessComplexMultiplyAccumulate(GetInputFFT(0), productIR, productOutputFFT, impulseResponse_Frequency_Block_Size);
+	}
+
+	//Clear the spectra of the current outputs, that are going to be reused for the last subfilter, and move the head one slot forward
+	void CUPCAnechoicStereo::ProcessAdvanceOutputFFT()
+	{
+		float* leftOutputFFT = GetOutputFFT(0, Common::T_ear::LEFT);
+		float* rightOutputFFT = GetOutputFFT(0, Common::T_ear::RIGHT);
+		std::fill(leftOutputFFT, leftOutputFFT + storageInputFFT_slotLength, 0.0f);
+		std::fill(rightOutputFFT, rightOutputFFT + storageInputFFT_slotLength, 0.0f);
+
+		storageOutputFFT_head++;
+		if (storageOutputFFT_head == impulseResponseNumberOfSubfilters) { storageOutputFFT_head = 0; }
+	}
+
+	//Calculate the output signal from the accumulated half spectrum
+	void CUPCAnechoicStereo::ProcessOutputIFFT(const float* inBuffer_Frequency, CMonoBuffer<float>& outBuffer)
+	{
+		// Make the IIF
+		FFTPlan.CalculateIFFT_HalfSpectrum(inBuffer_Frequency, outputIFFT_buffer.data());
+		//We are left only with the final half of the result
+		outBuffer.assign(outputIFFT_buffer.begin() + inputSize, outputIFFT_buffer.end());
+	}
+}
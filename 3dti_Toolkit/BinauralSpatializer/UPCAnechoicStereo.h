@@ -0,0 +1,245 @@
+/**
+* \class UPCAnechoicStereo
+*
+* \brief Declaration of CUPCAnechoicStereo class interface.
+* \date	October 2026
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#ifndef _CUPCANECHOICSTEREO_H_
+#define _CUPCANECHOICSTEREO_H_
+
+#include <vector>
+#include <Common/Fprocessor.h>
+#include <Common/Buffer.h>
+#include <Common/AlignedAllocator.h>
+#include <BinauralSpatializer/HRTF.h>
+#include <BinauralSpatializer/UPCAnechoic.h>
+
+namespace Binaural {
+
+	/** \details This class implements the Uniformly Partitioned Convolution Algorithm (UPC algorithm) of one input signal with the impulse responses of both ears.
+	*	The FFT of each input block is calculated only once and kept in one frequency-domain delay line shared by both ears, then it is multiplied and accumulated with the subfilters of each ear.
+	*	It gives the same result as two CUPCAnechoic objects, with half the forward FFTs.
+	*	The _withoutIFFT methods add the half spectra of the outputs to the buffers of the caller, so the outputs of many convolvers can be mixed before the IFFT (see CFrequencyDomainBuses).
+	*	They use the same delay line as the other methods, so the convolution can go on with any of them in the next block.
+	*	The input FFT can also be calculated by the caller, together with the ones of other convolvers (see PrepareInputFFT).
+	*/
+	class CUPCAnechoicStereo
+	{
+
+	public:
+
+		/** \brief Default constructor
+		*   \eh Nothing is reported to the error handler.
+		*/
+		CUPCAnechoicStereo();
+
+		/** \brief Initialize the class and allocate memory.
+		*   \details When this method is called, the system initializes variables and allocates memory space for the buffers.
+		*	\param [in] _inputSize size of the input signal buffer (B size)
+		*	\param [in] _HRIR_Frequency_Block_Size size of the FTT Impulse Response blocks, this number is 2*B + 2 (half spectrum of an FFT of 2*B points)
+		*	\param [in] _HRIR_Block_Number number of blocks in which is divided the the impluse response
+		*	\param [in] _IRMemory if true, the method with IR memory will be used (otherwise, the method without memory will be used instead)
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void Setup(int _inputSize, int _HRIR_Frequency_Block_Size, int _HRIR_Block_Number, bool _IRMemory);
+
+		/** \brief Process the Uniformed Partitioned Convolution of the input signal with the impulse responses of both ears
+		*   \details This method performs the convolution between the input signal and the partitioned HRIRs using the UPC* method.
+		*   \details *Wefers, F. (2015). Partitioned convolution algorithms for real-time auralization (Vol. 20). Logos Verlag Berlin GmbH.
+		*	\param [in] inBuffer_Time input signal buffer of B size
+		*	\param [in] leftIR buffer structure that contains the left ear HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
+		*	\param [in] rightIR buffer structure that contains the right ear HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
+		*	\param [out] outLeftBuffer left ear output signal of B size
+		*	\param [out] outRightBuffer right ear output signal of B size
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void ProcessUPConvolution(const CMonoBuffer<float>& inBuffer_Time, const TOneEarHRIRPartitionedStruct & leftIR, const TOneEarHRIRPartitionedStruct & rightIR, CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer);
+
+		/** \brief Process the Uniformed Partitioned Convolution of the input signal with the impulse responses of both ears, given as read-only views
+		*   \details Same as the method with TOneEarHRIRPartitionedStruct, but the subfilters are not copied into vectors, for example when they are got from CHRTF::GetHRIR_partitioned_BothEars with a scratch buffer.
+		*	\param [in] inBuffer_Time input signal buffer of B size
+		*	\param [in] leftIR view of the left ear HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
+		*	\param [in] rightIR view of the right ear HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
+		*	\param [out] outLeftBuffer left ear output signal of B size
+		*	\param [out] outRightBuffer right ear output signal of B size
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void ProcessUPConvolution(const CMonoBuffer<float>& inBuffer_Time, const TOneEarHRIRPartitionedView & leftIR, const TOneEarHRIRPartitionedView & rightIR, CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer);
+
+		/** \brief Make the Uniformed Partitioned Convolution of the input signal with the impulse responses of both ears using also last input signal buffers (method with memory)
+		*   \details This method performs the convolution between the input signal and the partitioned HRIRs (each input signal block is convolved with the HRIRs received with it) using the UPC* method.
+		*   \details *Wefers, F. (2015). Partitioned convolution algorithms for real-time auralization (Vol. 20). Logos Verlag Berlin GmbH.
+		*	\param [in] inBuffer_Time input signal buffer of B size
+		*	\param [in] leftIR buffer structure that contains the left ear HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
+		*	\param [in] rightIR buffer structure that contains the right ear HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
+		*	\param [out] outLeftBuffer left ear output signal of B size
+		*	\param [out] outRightBuffer right ear output signal of B size
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void ProcessUPConvolutionWithMemory(const CMonoBuffer<float>& inBuffer_Time, const TOneEarHRIRPartitionedStruct & leftIR, const TOneEarHRIRPartitionedStruct & rightIR, CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer);
+
+		/** \brief Make the Uniformed Partitioned Convolution of the input signal with the impulse responses of both ears, given as read-only views, using also last input signal buffers (method with memory)
+		*	\param [in] inBuffer_Time input signal buffer of B size
+		*	\param [in] leftIR view of the left ear HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
+		*	\param [in] rightIR view of the right ear HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
+		*	\param [out] outLeftBuffer left ear output signal of B size
+		*	\param [out] outRightBuffer right ear output signal of B size
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void ProcessUPConvolutionWithMemory(const CMonoBuffer<float>& inBuffer_Time, const TOneEarHRIRPartitionedView & leftIR, const TOneEarHRIRPartitionedView & rightIR, CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer);
+
+		/** \brief Process the Uniformed Partitioned Convolution of the input signal with the impulse responses of both ears, adding the half spectrum of the outputs to the output buffers
+		*   \details This method performs the convolution between the input signal and the partitioned HRIRs using the UPC* method, without the IFFT.
+		*   \details *Wefers, F. (2015). Partitioned convolution algorithms for real-time auralization (Vol. 20). Logos Verlag Berlin GmbH.
+		*	\param [in] inBuffer_Time input signal buffer of B size
+		*	\param [in] leftIR buffer structure that contains the left ear HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
+		*	\param [in] rightIR buffer structure that contains the right ear HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
+		*	\param [in,out] outLeftBuffer_Frequency half spectrum of 2*B + 2 size where the left ear output is accumulated. After the IIFT is done only the last B samples are significant
+		*	\param [in,out] outRightBuffer_Frequency half spectrum of 2*B + 2 size where the right ear output is accumulated. After the IIFT is done only the last B samples are significant
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void ProcessUPConvolution_withoutIFFT(const CMonoBuffer<float>& inBuffer_Time, const TOneEarHRIRPartitionedStruct & leftIR, const TOneEarHRIRPartitionedStruct & rightIR, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency);
+
+		/** \brief Process the Uniformed Partitioned Convolution of the input signal with the impulse responses of both ears given as read-only views, adding the half spectrum of the outputs to the output buffers
+		*	\param [in] inBuffer_Time input signal buffer of B size
+		*	\param [in] leftIR view of the left ear HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
+		*	\param [in] rightIR view of the right ear HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
+		*	\param [in,out] outLeftBuffer_Frequency half spectrum of 2*B + 2 size where the left ear output is accumulated
+		*	\param [in,out] outRightBuffer_Frequency half spectrum of 2*B + 2 size where the right ear output is accumulated
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void ProcessUPConvolution_withoutIFFT(const CMonoBuffer<float>& inBuffer_Time, const TOneEarHRIRPartitionedView & leftIR, const TOneEarHRIRPartitionedView & rightIR, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency);
+
+		/** \brief Make the Uniformed Partitioned Convolution of the input signal with the impulse responses of both ears using also last input signal buffers (method with memory), adding the half spectrum of the outputs to the output buffers
+		*   \details This method performs the convolution between the input signal and the partitioned HRIRs (each input signal block is convolved with the HRIRs received with it) using the UPC* method, without the IFFT.
+		*   \details *Wefers, F. (2015). Partitioned convolution algorithms for real-time auralization (Vol. 20). Logos Verlag Berlin GmbH.
+		*	\param [in] inBuffer_Time input signal buffer of B size
+		*	\param [in] leftIR buffer structure that contains the left ear HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
+		*	\param [in] rightIR buffer structure that contains the right ear HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
+		*	\param [in,out] outLeftBuffer_Frequency half spectrum of 2*B + 2 size where the left ear output is accumulated. After the IIFT is done only the last B samples are significant
+		*	\param [in,out] outRightBuffer_Frequency half spectrum of 2*B + 2 size where the right ear output is accumulated. After the IIFT is done only the last B samples are significant
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void ProcessUPConvolutionWithMemory_withoutIFFT(const CMonoBuffer<float>& inBuffer_Time, const TOneEarHRIRPartitionedStruct & leftIR, const TOneEarHRIRPartitionedStruct & rightIR, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency);
+
+		/** \brief Make the Uniformed Partitioned Convolution of the input signal with the impulse responses of both ears given as read-only views, using also last input signal buffers (method with memory), adding the half spectrum of the outputs to the output buffers
+		*	\param [in] inBuffer_Time input signal buffer of B size
+		*	\param [in] leftIR view of the left ear HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
+		*	\param [in] rightIR view of the right ear HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
+		*	\param [in,out] outLeftBuffer_Frequency half spectrum of 2*B + 2 size where the left ear output is accumulated
+		*	\param [in,out] outRightBuffer_Frequency half spectrum of 2*B + 2 size where the right ear output is accumulated
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void ProcessUPConvolutionWithMemory_withoutIFFT(const CMonoBuffer<float>& inBuffer_Time, const TOneEarHRIRPartitionedView & leftIR, const TOneEarHRIRPartitionedView & rightIR, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency);
+
+		/** \brief Extend the input signal to double length with the previous block, so its FFT can be calculated by the caller
+		*   \details This is the first step of the _withoutIFFT methods without input signal. The caller has to calculate the FFT of 2*B points of inBuffer_dobleSize into inBuffer_Frequency,
+		*	as CFFTPlan::CalculateFFT_HalfSpectrum does, for example in one batched call with the inputs of other convolvers, and then call one of those methods in the same block.
+		*	\param [in] inBuffer_Time input signal buffer of B size
+		*	\param [out] inBuffer_dobleSize 2*B samples whose FFT has to be calculated
+		*	\param [out] inBuffer_Frequency slot of the delay line of 2*B + 2 values where the half spectrum of the FFT has to be written
+		*   \eh On error, an error code is reported to the error handler and the pointers are null.
+		*/
+		void PrepareInputFFT(const CMonoBuffer<float>& inBuffer_Time, const float* & inBuffer_dobleSize, float* & inBuffer_Frequency);
+
+		/** \brief Process the Uniformed Partitioned Convolution of the input signal prepared by PrepareInputFFT, whose FFT has already been calculated by the caller, adding the half spectrum of the outputs to the output buffers
+		*	\param [in] leftIR view of the left ear HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
+		*	\param [in] rightIR view of the right ear HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
+		*	\param [in,out] outLeftBuffer_Frequency half spectrum of 2*B + 2 size where the left ear output is accumulated
+		*	\param [in,out] outRightBuffer_Frequency half spectrum of 2*B + 2 size where the right ear output is accumulated
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void ProcessUPConvolution_withoutIFFT(const TOneEarHRIRPartitionedView & leftIR, const TOneEarHRIRPartitionedView & rightIR, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency);
+
+		/** \brief Make the Uniformed Partitioned Convolution with memory of the input signal prepared by PrepareInputFFT, whose FFT has already been calculated by the caller, adding the half spectrum of the outputs to the output buffers
+		*	\param [in] leftIR view of the left ear HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
+		*	\param [in] rightIR view of the right ear HRIR divided in subfilters. Each subfilter with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
+		*	\param [in,out] outLeftBuffer_Frequency half spectrum of 2*B + 2 size where the left ear output is accumulated
+		*	\param [in,out] outRightBuffer_Frequency half spectrum of 2*B + 2 size where the right ear output is accumulated
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void ProcessUPConvolutionWithMemory_withoutIFFT(const TOneEarHRIRPartitionedView & leftIR, const TOneEarHRIRPartitionedView & rightIR, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency);
+
+	private:
+		// ATTRIBUTES
+		int inputSize;								//Size of the inputs buffer
+		int impulseResponse_Frequency_Block_Size;	//Size of the HRIR buffer
+		int impulseResponseNumberOfSubfilters;		//Number of blocks in which is divided the HRIR
+		bool impulseResponseMemory;					//Indicate if HRTF storage buffers have to be prepared to do UPC with memory
+		bool setupDone;								//It's true when setup has been called at least once
+
+		std::vector<float> inBuffer_Time_dobleSize;					//To store the last two input signals, the previous one followed by the current one
+		Common::CAlignedVector<float> storageInputFFT_buffer;		//Frequency-domain delay line shared by both ears, one slot of storageInputFFT_slotLength values for each subfilter
+		int storageInputFFT_slotLength;								//Distance between two slots of the delay line, rounded up to keep every slot aligned
+		int storageInputFFT_head;									//Slot with the FFT of the current input signal. The FFT i blocks older is in the slot (head + i) % number of subfilters
+		Common::CAlignedVector<float> storageOutputFFT_buffer;		//Spectra of the next outputs of each ear (methods with memory), the left ones followed by the right ones, one slot of storageInputFFT_slotLength values for each subfilter
+		int storageOutputFFT_head;									//Slot with the spectrum of the current output. The output i blocks later is accumulated in the slot (head + i) % number of subfilters
+		Common::CFFTPlan FFTPlan;									//FFT tables of 2*B points, calculated once in the setup method
+		std::vector<float> outputFFT_buffer;						//To accumulate the products of the input FFTs and the subfilters of one ear
+		std::vector<float> outputIFFT_buffer;						//To store the IFFT of the accumulated products, 2*B samples
+		std::vector<const float*> productInputFFT;					//Input FFTs multiplied in the current block
+		std::vector<const float*> productIR;						//Subfilters multiplied in the current block
+		std::vector<float*> productOutputFFT;						//Output spectra where the products of the current block are accumulated (methods with memory)
+		std::vector<const float*> leftIR_subfilters;				//Subfilters of the left ear HRIR of the current block, nullptr if they do not have the size of the convolver
+		std::vector<const float*> rightIR_subfilters;				//Subfilters of the right ear HRIR of the current block, nullptr if they do not have the size of the convolver
+
+		// METHODS
+		//Keep the subfilters of one HRIR, with nullptr for the ones whose size is not the one of the convolver
+		void GetSubfilters(const THRIR_partitioned & IR, std::vector<const float*> & subfilters) const;
+		void GetSubfilters(const TOneEarHRIRPartitionedView & IR, std::vector<const float*> & subfilters) const;
+
+		//Convolutions of the public methods, with the subfilters kept in leftIR_subfilters and rightIR_subfilters
+		void ProcessUPConvolution(const CMonoBuffer<float>& inBuffer_Time, CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer);
+		void ProcessUPConvolutionWithMemory(const CMonoBuffer<float>& inBuffer_Time, CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer);
+		void ProcessUPConvolution_withoutIFFT(const CMonoBuffer<float>& inBuffer_Time, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency);
+		void ProcessUPConvolutionWithMemory_withoutIFFT(const CMonoBuffer<float>& inBuffer_Time, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency);
+
+		//Steps of the _withoutIFFT methods after the input FFT, once it is in the head slot of the delay line
+		void ProcessOutputSpectra(std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency);
+		void ProcessOutputSpectraWithMemory(std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency);
+
+		//Extend the input signal to double length and calculate its FFT directly into the head slot of the delay line
+		void ProcessInputFFT(const CMonoBuffer<float>& inBuffer_Time);
+
+		//Move the input signal to the second half of the double length buffer, after the previous one
+		void ProcessDoubleSizeInput(const CMonoBuffer<float>& inBuffer_Time);
+
+		//Get the FFT of the input signal that is delay blocks older than the current one
+		const float* GetInputFFT(int delay) const;
+
+		//Get the spectrum of the output of one ear that is delay blocks later than the current one
+		float* GetOutputFFT(int delay, Common::T_ear ear);
+
+		//Move the head of the delay line waiting for the next input block
+		void ProcessAdvanceInputFFT();
+
+		//Add to outBuffer_Frequency the products of the subfilters of one ear and the delay line of the input
+		void ProcessMultiplyAccumulate(const std::vector<const float*> & subfilters, std::vector<float>& outBuffer_Frequency);
+
+		//Multiply the current input FFT by all the subfilters of one ear, adding each product to the spectrum of the output of that ear in which it has to appear
+		void ProcessMultiplyAccumulateWithMemory(const std::vector<const float*> & subfilters, Common::T_ear ear);
+
+		//Clear the spectra of the current outputs and move the head waiting for the next input block
+		void ProcessAdvanceOutputFFT();
+
+		//Calculate the output signal from the accumulated half spectrum
+		void ProcessOutputIFFT(const float* inBuffer_Frequency, CMonoBuffer<float>& outBuffer);
+	};
+}
+#endif
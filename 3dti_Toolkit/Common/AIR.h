@@ -123,7 +123,7 @@ namespace Common
 			inputSourceLength = _inputSourceLength;
 			impulseResponseLength = _irLength;
 			impulseResponseBlockLength_time = 2 * _inputSourceLength;
-			impulseResponseBlockLength_freq = 2 * impulseResponseBlockLength_time;
+			impulseResponseBlockLength_freq = impulseResponseBlockLength_time + 2;		//Points 0 to N/2 of the spectrum, real and imaginary parts
 			float temp_impulseResponseNumberOfBlocks = (float)impulseResponseLength / (float)inputSourceLength;
 			impulseResponseNumberOfBlocks = static_cast<int>(std::ceil(temp_impulseResponseNumberOfBlocks));
 
@@ -337,6 +337,7 @@ namespace Common
 		}
 
 		/** \brief Get data length of stored impulse responses in frequency domain (the length of one partition, which is the same for every partition)
+		*	\details Partitions are stored as the half spectrum (points 0 to N/2) of an FFT of N = 2 * input length points, so their length is N + 2
 		*	\retval dataLength Impulse response FFT partition buffer size (frequency domain)
 		*	\pre Impulse response length must be setup 
 		*	\sa SetupIFFT_OLA
@@ -371,7 +372,7 @@ namespace Common
 
 		/** \brief Returns true when the data is loaded and ready to be used
 		*   \eh Nothing is reported to the error handler.*/
-		bool IsInitialized() {
+		bool IsInitialized() const {
 #ifdef USE_FREQUENCY_COVOLUTION_WITHOUT_PARTITIONS_REVERB 
 			return impulseResponseLength != 0 && impulseResponseLength != 0 && setupDone && bFormat.size() > 0;
 #else
@@ -422,7 +423,7 @@ namespace Common
 				}
 				//FFT
 				CMonoBuffer<float> data_FFT;
-				Common::CFprocessor::CalculateFFT(data_FFT_doubleSize, data_FFT);
+				Common::CFprocessor::CalculateFFT_HalfSpectrum(data_FFT_doubleSize, data_FFT);
 				//Prepare struct to return the value
 				new_DataFFT_Partitioned.push_back(data_FFT);
 			}
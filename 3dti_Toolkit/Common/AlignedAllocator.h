@@ -0,0 +1,100 @@
+/**
+* \class CAlignedAllocator
+*
+* \brief Declaration and definition of CAlignedAllocator class.
+* \date	October 2026
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#ifndef _CALIGNED_ALLOCATOR_H_
+#define _CALIGNED_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+/*! \file */
+
+namespace Common {
+
+	/** \brief Alignment, in bytes, of the buffers used by the vectorized DSP code. It is the size of a cache line.
+	*/
+	const std::size_t SIMD_ALIGNMENT = 64;
+
+	/** \details Allocator for std::vector that returns memory aligned to a given number of bytes, so SIMD code can read it with aligned loads and without splitting cache lines.
+	*/
+	template <typename T, std::size_t Alignment = SIMD_ALIGNMENT>
+	class CAlignedAllocator
+	{
+	public:
+		typedef T value_type;
+
+		template <typename U> struct rebind { typedef CAlignedAllocator<U, Alignment> other; };
+
+		CAlignedAllocator() {}
+		template <typename U> CAlignedAllocator(const CAlignedAllocator<U, Alignment> &) {}
+
+		/** \brief Allocate memory for n elements, aligned to Alignment bytes
+		*   \throws std::bad_alloc if there is not enough memory
+		*/
+		T* allocate(std::size_t n)
+		{
+			if (n == 0) { return nullptr; }
+			void* p = nullptr;
+#ifdef _MSC_VER
+			p = _aligned_malloc(n * sizeof(T), Alignment);
+#else
+			if (posix_memalign(&p, Alignment, n * sizeof(T)) != 0) { p = nullptr; }
+#endif
+			if (p == nullptr) { throw std::bad_alloc(); }
+			return static_cast<T*>(p);
+		}
+
+		/** \brief Free memory returned by allocate
+		*/
+		void deallocate(T* p, std::size_t)
+		{
+#ifdef _MSC_VER
+			_aligned_free(p);
+#else
+			free(p);
+#endif
+		}
+
+		template <typename U> bool operator==(const CAlignedAllocator<U, Alignment> &) const { return true; }
+		template <typename U> bool operator!=(const CAlignedAllocator<U, Alignment> &) const { return false; }
+	};
+
+	/** \brief Type definition for a vector whose data is aligned to SIMD_ALIGNMENT bytes
+	*/
+	template <typename T>
+	using CAlignedVector = std::vector<T, CAlignedAllocator<T>>;
+
+	/** \brief Round up a number of floats to a multiple of SIMD_ALIGNMENT bytes
+	*	\details Used to calculate the distance between consecutive blocks stored in one aligned buffer, so every block starts aligned too.
+	*/
+	inline int CalculateAlignedLength(int numberOfFloats)
+	{
+		const int floatsPerAlignment = static_cast<int>(SIMD_ALIGNMENT / sizeof(float));
+		return ((numberOfFloats + floatsPerAlignment - 1) / floatsPerAlignment) * floatsPerAlignment;
+	}
+}//end namespace Common
+#endif
@@ -0,0 +1,141 @@
+/**
+* \class CAsyncPublisher
+*
+* \brief Declaration and definition of template class CAsyncPublisher
+* \date	October 2026
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#ifndef _CASYNCPUBLISHER_H_
+#define _CASYNCPUBLISHER_H_
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+
+namespace Common {
+
+	/** \details This template class hands objects that are not modified any more, built in any thread (for example the tables of a new HRTF),
+	*	over to the audio thread, which replaces the ones it is using when it is ready, at the beginning of a block.
+	*	\details The audio thread never waits: if the control thread is publishing at that moment, the object is taken in the next block.
+	*	The audio thread never frees memory either: this class keeps a reference to every object that the audio thread may release,
+	*	and the control thread frees the ones that are not used any more when it publishes the next one or when it calls ReleaseUnused.
+	*/
+	template <class T>
+	class CAsyncPublisher
+	{
+	public:
+
+		/** \brief Default constructor, with nothing published
+		*   \eh Nothing is reported to the error handler.
+		*/
+		CAsyncPublisher() : pendingReady{ false }
+		{}
+
+		/** \brief Publish a new object, that is taken by the audio thread with TakePublished. It replaces the previous one if it has not been taken yet
+		*	\details Called from the control thread or from a background thread. The objects published before that are not used any more are freed.
+		*	\param [in] newObject object that is not going to be modified any more
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void Publish(std::shared_ptr<const T> newObject)
+		{
+			std::lock_guard<std::mutex> lock(publishMutex);
+			ReleaseUnusedObjects();
+			ownedObjects.push_back(newObject);
+			pendingObject = std::move(newObject);
+			pendingReady.store(true, std::memory_order_release);
+		}
+
+		/** \brief Keep a reference to an object that the audio thread is using, although it has not been published with this class, so it is not freed in the audio thread when it is replaced
+		*	\param [in] object object in use by the audio thread
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void Retain(std::shared_ptr<const T> object)
+		{
+			std::lock_guard<std::mutex> lock(publishMutex);
+			if (std::find(ownedObjects.begin(), ownedObjects.end(), object) == ownedObjects.end()) { ownedObjects.push_back(std::move(object)); }
+		}
+
+		/** \brief Take the last object that has been published, if there is one. Called from the audio thread, it does not wait nor free memory
+		*	\param [out] object the published object, not modified if there is not a new one
+		*	\retval taken true if a new object has been taken
+		*   \eh Nothing is reported to the error handler.
+		*/
+		bool TakePublished(std::shared_ptr<const T> & object)
+		{
+			if (!pendingReady.load(std::memory_order_acquire)) { return false; }
+			std::unique_lock<std::mutex> lock(publishMutex, std::try_to_lock);
+			if (!lock.owns_lock()) { return false; }		//It is being published, it is taken in the next block
+			object = std::move(pendingObject);				//The object replaced by it is kept by ownedObjects
+			pendingObject.reset();
+			pendingReady.store(false, std::memory_order_relaxed);
+			return true;
+		}
+
+		/** \brief Get whether there is an object published that has not been taken yet
+		*	\retval pending true if an object is waiting for the audio thread
+		*   \eh Nothing is reported to the error handler.
+		*/
+		bool IsPublishedPending() const
+		{
+			return pendingReady.load(std::memory_order_acquire);
+		}
+
+		/** \brief Free the objects that are not used any more, neither by the audio thread nor by anyone else. Called from the control thread
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void ReleaseUnused()
+		{
+			std::lock_guard<std::mutex> lock(publishMutex);
+			ReleaseUnusedObjects();
+		}
+
+		/** \brief Discard the object that has not been taken yet and release all the references kept by this class. Called only when the audio thread is stopped
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void Clear()
+		{
+			std::lock_guard<std::mutex> lock(publishMutex);
+			pendingObject.reset();
+			pendingReady.store(false, std::memory_order_relaxed);
+			ownedObjects.clear();
+		}
+
+	private:
+		///////////////
+		// ATTRIBUTES
+		///////////////
+		std::mutex publishMutex;								//Protects the published object and the list of objects, never waited for by the audio thread
+		std::atomic<bool> pendingReady;							//There is an object published that has not been taken yet
+		std::shared_ptr<const T> pendingObject;					//Object published and not taken yet
+		std::vector<std::shared_ptr<const T>> ownedObjects;		//Objects that the audio thread may release, freed here when nobody else uses them
+
+		///////////////
+		// METHODS
+		///////////////
+		//Free the objects only referenced by this class. The audio thread can not take a new reference to any of them, because it only takes the pending one
+		void ReleaseUnusedObjects()
+		{
+			ownedObjects.erase(std::remove_if(ownedObjects.begin(), ownedObjects.end(), [this](const std::shared_ptr<const T> & object) {
+				return (object.use_count() == 1) && (object != pendingObject);
+			}), ownedObjects.end());
+		}
+	};
+}//end namespace Common
+#endif
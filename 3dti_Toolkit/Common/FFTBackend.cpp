@@ -0,0 +1,405 @@
+/**
+* \class CFFTBackend
+*
+* \brief Definition of CFFTBackend implementations.
+*
+* These classes compute the FFT of real signals, one with the Takuya OOURA library and other in single precision with SSE2/AVX2 butterflies.
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+#include "FFTBackend.h"
+#include "fftsg.h"
+#include "SIMDDetection.h"
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.1415926535897932385
+#endif
+
+namespace Common {
+
+	//////////////////////////////
+	// Butterflies of one stage //
+	//////////////////////////////
+
+	//Radix-2 butterflies of size h over the complex vector of size n, stored as separated real and imaginary parts
+	static void ProcessButterflies_Scalar(float* real, float* img, const float* twReal, const float* twImg, int n, int h)
+	{
+		for (int block = 0; block < n; block += 2 * h)
+		{
+			for (int j = 0; j < h; j++)
+			{
+				int top = block + j;
+				int bottom = top + h;
+				float tr = real[bottom] * twReal[j] - img[bottom] * twImg[j];
+				float ti = real[bottom] * twImg[j] + img[bottom] * twReal[j];
+				real[bottom] = real[top] - tr;
+				img[bottom] = img[top] - ti;
+				real[top] += tr;
+				img[top] += ti;
+			}
+		}
+	}
+
+#ifdef FFT_X86_SIMD
+	//Same butterflies, 4 at a time. h has to be multiple of 4
+	FFT_TARGET_SSE2
+	static void ProcessButterflies_SSE2(float* real, float* img, const float* twReal, const float* twImg, int n, int h)
+	{
+		for (int block = 0; block < n; block += 2 * h)
+		{
+			for (int j = 0; j < h; j += 4)
+			{
+				int top = block + j;
+				int bottom = top + h;
+				__m128 wr = _mm_loadu_ps(twReal + j);
+				__m128 wi = _mm_loadu_ps(twImg + j);
+				__m128 br = _mm_loadu_ps(real + bottom);
+				__m128 bi = _mm_loadu_ps(img + bottom);
+				__m128 ar = _mm_loadu_ps(real + top);
+				__m128 ai = _mm_loadu_ps(img + top);
+				__m128 tr = _mm_sub_ps(_mm_mul_ps(br, wr), _mm_mul_ps(bi, wi));
+				__m128 ti = _mm_add_ps(_mm_mul_ps(br, wi), _mm_mul_ps(bi, wr));
+				_mm_storeu_ps(real + bottom, _mm_sub_ps(ar, tr));
+				_mm_storeu_ps(img + bottom, _mm_sub_ps(ai, ti));
+				_mm_storeu_ps(real + top, _mm_add_ps(ar, tr));
+				_mm_storeu_ps(img + top, _mm_add_ps(ai, ti));
+			}
+		}
+	}
+
+	//Same butterflies, 8 at a time. h has to be multiple of 8
+	FFT_TARGET_AVX2
+	static void ProcessButterflies_AVX2(float* real, float* img, const float* twReal, const float* twImg, int n, int h)
+	{
+		for (int block = 0; block < n; block += 2 * h)
+		{
+			for (int j = 0; j < h; j += 8)
+			{
+				int top = block + j;
+				int bottom = top + h;
+				__m256 wr = _mm256_loadu_ps(twReal + j);
+				__m256 wi = _mm256_loadu_ps(twImg + j);
+				__m256 br = _mm256_loadu_ps(real + bottom);
+				__m256 bi = _mm256_loadu_ps(img + bottom);
+				__m256 ar = _mm256_loadu_ps(real + top);
+				__m256 ai = _mm256_loadu_ps(img + top);
+				__m256 tr = _mm256_sub_ps(_mm256_mul_ps(br, wr), _mm256_mul_ps(bi, wi));
+				__m256 ti = _mm256_add_ps(_mm256_mul_ps(br, wi), _mm256_mul_ps(bi, wr));
+				_mm256_storeu_ps(real + bottom, _mm256_sub_ps(ar, tr));
+				_mm256_storeu_ps(img + bottom, _mm256_sub_ps(ai, ti));
+				_mm256_storeu_ps(real + top, _mm256_add_ps(ar, tr));
+				_mm256_storeu_ps(img + top, _mm256_add_ps(ai, ti));
+			}
+		}
+	}
+#endif
+
+	/////////////////
+	// CFFTBackend //
+	/////////////////
+
+	CFFTBackend* CFFTBackend::Create(TFFTBackend backend)
+	{
+		if (backend == TFFTBackend::ReferenceDouble) { return new CFFTBackendReference(); }
+		return new CFFTBackendFloat();
+	}
+
+	//Transforms of several signals, one after the other
+	void CFFTBackend::ProcessForwardBatch(const float* const* input, int inputSize, float* const* packedOutput, int numberOfChannels)
+	{
+		for (int channel = 0; channel < numberOfChannels; channel++) { ProcessForward(input[channel], inputSize, packedOutput[channel]); }
+	}
+
+	void CFFTBackend::ProcessInverseBatch(const float* const* packedInput, float* const* output, int numberOfChannels)
+	{
+		for (int channel = 0; channel < numberOfChannels; channel++) { ProcessInverse(packedInput[channel], output[channel]); }
+	}
+
+	//Detect, only once, the instruction set supported by the CPU
+	TFFTSIMDLevel CFFTBackend::GetSIMDLevel()
+	{
+		static const TFFTSIMDLevel detectedLevel = []() {
+			TFFTSIMDLevel level = SIMD_NONE;
+#if defined(FFT_X86_SIMD) && defined(_MSC_VER)
+			int info[4];
+			__cpuid(info, 0);
+			int maxLeaf = info[0];
+			__cpuid(info, 1);
+			bool sse2 = (info[3] & (1 << 26)) != 0;
+			bool osxsave = (info[2] & (1 << 27)) != 0;
+			bool avx = (info[2] & (1 << 28)) != 0;
+			bool avx2 = false;
+			if (maxLeaf >= 7 && osxsave && avx && ((_xgetbv(0) & 6) == 6))
+			{
+				__cpuidex(info, 7, 0);
+				avx2 = (info[1] & (1 << 5)) != 0;
+			}
+			if (sse2) { level = SIMD_SSE2; }
+			if (avx2) { level = SIMD_AVX2; }
+#elif defined(FFT_X86_SIMD)
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("sse2")) { level = SIMD_SSE2; }
+			if (__builtin_cpu_supports("avx2")) { level = SIMD_AVX2; }
+#endif
+			return level;
+		}();
+		return detectedLevel;
+	}
+
+	//////////////////////////
+	// CFFTBackendReference //
+	//////////////////////////
+
+	CFFTBackendReference::CFFTBackendReference() : FFTSize{ 0 }
+	{
+	}
+
+	void CFFTBackendReference::Setup(int _FFTSize)
+	{
+		FFTSize = _FFTSize;
+
+		///////////////////////////////////////////////////////////////////////////////
+		// Calculate auxiliary arrays size, necessary to use the Takuya OOURA library
+		///////////////////////////////////////////////////////////////////////////////
+		ip.assign(static_cast<int>(std::sqrt(FFTSize / 2)) + 3, 0);		//Size of the auxiliary array ip. This come from lib documentation/examples.
+		w.assign(FFTSize / 2 + 1, 0.0);										//Size of the auxiliary array w. This come from lib documentation/examples.
+		workBuffer.assign(FFTSize, 0.0);
+
+		//Tables are initialized when ip[0] == 0, so we make a first transform here and never again
+		ip[0] = 0;
+		rdft(FFTSize, 1, workBuffer.data(), ip.data(), w.data());
+	}
+
+	void CFFTBackendReference::ProcessForward(const float* input, int inputSize, float* packedOutput)
+	{
+		for (int i = 0; i < inputSize; i++) { workBuffer[i] = static_cast<double>(input[i]); }
+		for (int i = inputSize; i < FFTSize; i++) { workBuffer[i] = 0.0; }
+
+		rdft(FFTSize, 1, workBuffer.data(), ip.data(), w.data());	//Make the FFT
+
+		for (int i = 0; i < FFTSize; i++) { packedOutput[i] = static_cast<float>(workBuffer[i]); }
+	}
+
+	void CFFTBackendReference::ProcessInverse(const float* packedInput, float* output)
+	{
+		for (int i = 0; i < FFTSize; i++) { workBuffer[i] = static_cast<double>(packedInput[i]); }
+
+		rdft(FFTSize, -1, workBuffer.data(), ip.data(), w.data());	//Make the IFFT
+
+		double normalizeCoef = 2.0 / FFTSize;		//Normalize coef for the FFT-1
+		for (int i = 0; i < FFTSize; i++) { output[i] = static_cast<float>(workBuffer[i] * normalizeCoef); }
+	}
+
+	//////////////////////
+	// CFFTBackendFloat //
+	//////////////////////
+
+	CFFTBackendFloat::CFFTBackendFloat() : FFTSize{ 0 }, halfSize{ 0 }, SIMDLevel{ SIMD_NONE }
+	{
+	}
+
+	void CFFTBackendFloat::Setup(int _FFTSize)
+	{
+		FFTSize = _FFTSize;
+		halfSize = FFTSize / 2;
+		SIMDLevel = GetSIMDLevel();
+
+		//Bit reversal of the indexes of the complex transform
+		int bits = 0;
+		while ((1 << bits) < halfSize) { bits++; }
+		bitReversal.resize(halfSize);
+		for (int i = 0; i < halfSize; i++)
+		{
+			int reversed = 0;
+			for (int b = 0; b < bits; b++) {
+				if (i & (1 << b)) { reversed |= 1 << (bits - 1 - b); }
+			}
+			bitReversal[i] = reversed;
+		}
+
+		//Twiddle factors exp(2*pi*i*j/(2*h)) of the stage with butterflies of size h, stored from index h
+		twiddleReal.assign(halfSize, 0.0f);
+		twiddleImg.assign(halfSize, 0.0f);
+		for (int h = 1; h < halfSize; h *= 2)
+		{
+			for (int j = 0; j < h; j++)
+			{
+				twiddleReal[h + j] = static_cast<float>(std::cos(M_PI * j / h));
+				twiddleImg[h + j] = static_cast<float>(std::sin(M_PI * j / h));
+			}
+		}
+
+		//Factors exp(2*pi*i*k/N) to get the real FFT from the complex one
+		postReal.resize(halfSize);
+		postImg.resize(halfSize);
+		for (int k = 0; k < halfSize; k++)
+		{
+			postReal[k] = static_cast<float>(std::cos(2.0 * M_PI * k / FFTSize));
+			postImg[k] = static_cast<float>(std::sin(2.0 * M_PI * k / FFTSize));
+		}
+
+		real.assign(halfSize, 0.0f);
+		img.assign(halfSize, 0.0f);
+	}
+
+	void CFFTBackendFloat::SetupBatch(int numberOfChannels)
+	{
+		if (real.size() < (size_t)numberOfChannels * halfSize)
+		{
+			real.resize(numberOfChannels * halfSize, 0.0f);
+			img.resize(numberOfChannels * halfSize, 0.0f);
+		}
+	}
+
+	void CFFTBackendFloat::ProcessComplexFFT(int numberOfChannels)
+	{
+		//The butterflies of one stage never mix two transforms, because each one has halfSize points, so all of them are done as if they were only one longer vector
+		int n = numberOfChannels * halfSize;
+		int h = 1;
+		if (halfSize >= 4)
+		{
+			//The first two stages only need twiddle factors 1 and i, so they are done together without multiplications
+			for (int block = 0; block < n; block += 4)
+			{
+				float* r = real.data() + block;
+				float* i = img.data() + block;
+				float r0 = r[0] + r[1], i0 = i[0] + i[1];
+				float r1 = r[0] - r[1], i1 = i[0] - i[1];
+				float r2 = r[2] + r[3], i2 = i[2] + i[3];
+				float r3 = r[2] - r[3], i3 = i[2] - i[3];
+				r[0] = r0 + r2;		i[0] = i0 + i2;
+				r[2] = r0 - r2;		i[2] = i0 - i2;
+				r[1] = r1 - i3;		i[1] = i1 + r3;
+				r[3] = r1 + i3;		i[3] = i1 - r3;
+			}
+			h = 4;
+		}
+		for (; h < halfSize; h *= 2)
+		{
+#ifdef FFT_X86_SIMD
+			if ((SIMDLevel == SIMD_AVX2) && (h >= 8)) {
+				ProcessButterflies_AVX2(real.data(), img.data(), twiddleReal.data() + h, twiddleImg.data() + h, n, h);
+				continue;
+			}
+			if ((SIMDLevel >= SIMD_SSE2) && (h >= 4)) {
+				ProcessButterflies_SSE2(real.data(), img.data(), twiddleReal.data() + h, twiddleImg.data() + h, n, h);
+				continue;
+			}
+#endif
+			ProcessButterflies_Scalar(real.data(), img.data(), twiddleReal.data() + h, twiddleImg.data() + h, n, h);
+		}
+	}
+
+	void CFFTBackendFloat::ProcessForward(const float* input, int inputSize, float* packedOutput)
+	{
+		ProcessForwardBatch(&input, inputSize, &packedOutput, 1);
+	}
+
+	void CFFTBackendFloat::ProcessInverse(const float* packedInput, float* output)
+	{
+		ProcessInverseBatch(&packedInput, &output, 1);
+	}
+
+	void CFFTBackendFloat::ProcessForwardBatch(const float* const* input, int inputSize, float* const* packedOutput, int numberOfChannels)
+	{
+		SetupBatch(numberOfChannels);
+
+		//Even samples go to the real part and odd samples to the imaginary part, in bit reversed order
+		for (int channel = 0; channel < numberOfChannels; channel++)
+		{
+			const float* channelInput = input[channel];
+			float* channelReal = real.data() + channel * halfSize;
+			float* channelImg = img.data() + channel * halfSize;
+			for (int n = 0; n < halfSize; n++)
+			{
+				int even = 2 * n;
+				channelReal[bitReversal[n]] = (even < inputSize) ? channelInput[even] : 0.0f;
+				channelImg[bitReversal[n]] = (even + 1 < inputSize) ? channelInput[even + 1] : 0.0f;
+			}
+		}
+
+		ProcessComplexFFT(numberOfChannels);
+
+		//Split the complex transform into the transforms of even and odd samples, E and O, and join them: X[k] = E[k] + exp(2*pi*i*k/N) * O[k]
+		for (int channel = 0; channel < numberOfChannels; channel++)
+		{
+			const float* channelReal = real.data() + channel * halfSize;
+			const float* channelImg = img.data() + channel * halfSize;
+			float* channelOutput = packedOutput[channel];
+			channelOutput[0] = channelReal[0] + channelImg[0];
+			channelOutput[1] = channelReal[0] - channelImg[0];
+			for (int k = 1; k < halfSize; k++)
+			{
+				int mirror = halfSize - k;
+				float evenReal = 0.5f * (channelReal[k] + channelReal[mirror]);
+				float evenImg = 0.5f * (channelImg[k] - channelImg[mirror]);
+				float oddReal = 0.5f * (channelImg[k] + channelImg[mirror]);
+				float oddImg = -0.5f * (channelReal[k] - channelReal[mirror]);
+				channelOutput[2 * k] = evenReal + postReal[k] * oddReal - postImg[k] * oddImg;
+				channelOutput[2 * k + 1] = evenImg + postReal[k] * oddImg + postImg[k] * oddReal;
+			}
+		}
+	}
+
+	void CFFTBackendFloat::ProcessInverseBatch(const float* const* packedInput, float* const* output, int numberOfChannels)
+	{
+		SetupBatch(numberOfChannels);
+
+		//Get the transforms of even and odd samples, E and O, and build Z = E + i*O. It is stored conjugated, in bit reversed order, so the same forward transform can be used
+		for (int channel = 0; channel < numberOfChannels; channel++)
+		{
+			const float* channelInput = packedInput[channel];
+			float* channelReal = real.data() + channel * halfSize;
+			float* channelImg = img.data() + channel * halfSize;
+			float evenReal = 0.5f * (channelInput[0] + channelInput[1]);
+			float oddReal = 0.5f * (channelInput[0] - channelInput[1]);
+			channelReal[bitReversal[0]] = evenReal;
+			channelImg[bitReversal[0]] = -oddReal;
+			for (int k = 1; k < halfSize; k++)
+			{
+				int mirror = halfSize - k;
+				float xReal = channelInput[2 * k];
+				float xImg = channelInput[2 * k + 1];
+				float mirrorReal = channelInput[2 * mirror];
+				float mirrorImg = channelInput[2 * mirror + 1];
+				float eReal = 0.5f * (xReal + mirrorReal);
+				float eImg = 0.5f * (xImg - mirrorImg);
+				float dReal = 0.5f * (xReal - mirrorReal);
+				float dImg = 0.5f * (xImg + mirrorImg);
+				float oReal = dReal * postReal[k] + dImg * postImg[k];		//O = D * conj(exp(2*pi*i*k/N))
+				float oImg = dImg * postReal[k] - dReal * postImg[k];
+				channelReal[bitReversal[k]] = eReal - oImg;
+				channelImg[bitReversal[k]] = -(eImg + oReal);
+			}
+		}
+
+		ProcessComplexFFT(numberOfChannels);
+
+		float normalizeCoef = 1.0f / halfSize;
+		for (int channel = 0; channel < numberOfChannels; channel++)
+		{
+			const float* channelReal = real.data() + channel * halfSize;
+			const float* channelImg = img.data() + channel * halfSize;
+			float* channelOutput = output[channel];
+			for (int n = 0; n < halfSize; n++)
+			{
+				channelOutput[2 * n] = channelReal[n] * normalizeCoef;
+				channelOutput[2 * n + 1] = -channelImg[n] * normalizeCoef;
+			}
+		}
+	}
+}//end namespace Common
@@ -0,0 +1,158 @@
+/**
+* \class CFFTBackend
+*
+* \brief Declaration of CFFTBackend interface and its implementations.
+* \date	October 2026
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#ifndef _CFFTBACKEND_H_
+#define _CFFTBACKEND_H_
+
+#include <vector>
+
+namespace Common {
+
+	/** \brief Type definition for the available FFT implementations
+	*/
+	enum TFFTBackend {
+		ReferenceDouble,	///< Takuya OOURA fftsg library, computed in double precision. Portable reference implementation.
+		NativeFloat			///< Single precision implementation, vectorized with SSE2/AVX2 when the CPU supports it
+	};
+
+	/** \brief Type definition for the instruction set used by the NativeFloat backend
+	*/
+	enum TFFTSIMDLevel {
+		SIMD_NONE,			///< Scalar code
+		SIMD_SSE2,			///< 4 floats per instruction
+		SIMD_AVX2			///< 8 floats per instruction
+	};
+
+	/** \details Interface of the FFT implementations used by CFFTPlan.
+	*	All of them compute the transform of N real points (N = 2^n) with the Takuya OOURA sign convention, X[k] = sum x[j] exp(2*pi*i*j*k/N),
+	*	and use its packed layout for the N/2+1 points of the spectrum: packed[0] = Re[X0], packed[1] = Re[X(N/2)], packed[2k] = Re[Xk], packed[2k+1] = Img[Xk] for 0<k<N/2.
+	*/
+	class CFFTBackend
+	{
+	public:
+		virtual ~CFFTBackend() {}
+
+		/** \brief Prepare the tables and buffers to compute transforms of N points
+		*	\param [in] _FFTSize number of real points of the transform (N), power of two
+		*/
+		virtual void Setup(int _FFTSize) = 0;
+
+		/** \brief Calculate the FFT of a real signal
+		*	\param [in] input samples in time domain. Samples from inputSize to N are taken as zeros.
+		*	\param [in] inputSize number of samples of input, less or equal than N
+		*	\param [out] packedOutput N values with the packed spectrum
+		*/
+		virtual void ProcessForward(const float* input, int inputSize, float* packedOutput) = 0;
+
+		/** \brief Calculate the normalized IFFT of a packed spectrum
+		*	\param [in] packedInput N values with the packed spectrum
+		*	\param [out] output N samples in time domain
+		*/
+		virtual void ProcessInverse(const float* packedInput, float* output) = 0;
+
+		/** \brief Prepare the working buffers to compute up to numberOfChannels transforms at once with the batched methods
+		*	\details The batched methods also prepare them when they are needed, but calling this method in advance avoids allocating memory in the audio thread.
+		*	\param [in] numberOfChannels maximum number of transforms computed at once
+		*/
+		virtual void SetupBatch(int /*numberOfChannels*/) {}
+
+		/** \brief Calculate the FFT of several real signals of the same size at once
+		*	\details The default implementation calls ProcessForward for each one of them.
+		*	\param [in] input pointers to the samples in time domain of each signal. Samples from inputSize to N are taken as zeros.
+		*	\param [in] inputSize number of samples of each input, less or equal than N
+		*	\param [out] packedOutput pointers to the N values where the packed spectrum of each signal is written
+		*	\param [in] numberOfChannels number of signals
+		*/
+		virtual void ProcessForwardBatch(const float* const* input, int inputSize, float* const* packedOutput, int numberOfChannels);
+
+		/** \brief Calculate the normalized IFFT of several packed spectra at once
+		*	\details The default implementation calls ProcessInverse for each one of them.
+		*	\param [in] packedInput pointers to the N values with the packed spectrum of each signal
+		*	\param [out] output pointers to the N samples in time domain of each signal
+		*	\param [in] numberOfChannels number of signals
+		*/
+		virtual void ProcessInverseBatch(const float* const* packedInput, float* const* output, int numberOfChannels);
+
+		/** \brief Create a new backend of the given type
+		*	\param [in] backend type of the new backend
+		*	\retval backend pointer to the new backend, owned by the caller
+		*/
+		static CFFTBackend* Create(TFFTBackend backend);
+
+		/** \brief Get the instruction set that the NativeFloat backend uses in this CPU
+		*	\retval SIMDLevel instruction set, detected only the first time this method is called
+		*/
+		static TFFTSIMDLevel GetSIMDLevel();
+	};
+
+	/** \details FFT backend that uses the Takuya OOURA fftsg library (rdft), in double precision.
+	*/
+	class CFFTBackendReference : public CFFTBackend
+	{
+	public:
+		CFFTBackendReference();
+		void Setup(int _FFTSize);
+		void ProcessForward(const float* input, int inputSize, float* packedOutput);
+		void ProcessInverse(const float* packedInput, float* output);
+
+	private:
+		int FFTSize;						//Number of real points of the transform (N)
+		std::vector<int> ip;				//Work area for bit reversal of the Takuya OOURA library
+		std::vector<double> w;				//Cos/sin table of the Takuya OOURA library
+		std::vector<double> workBuffer;		//In place buffer where the transform is computed
+	};
+
+	/** \details FFT backend computed in single precision.
+	*	The real FFT of N points is done with a complex radix-2 FFT of N/2 points, stored as separate real and imaginary arrays,
+	*	whose butterflies are vectorized with SSE2 or AVX2 depending on the CPU.
+	*	The batched methods keep the complex transforms of all the signals one after the other, so every stage of butterflies runs over all of them in one pass with the same twiddle factors.
+	*/
+	class CFFTBackendFloat : public CFFTBackend
+	{
+	public:
+		CFFTBackendFloat();
+		void Setup(int _FFTSize);
+		void ProcessForward(const float* input, int inputSize, float* packedOutput);
+		void ProcessInverse(const float* packedInput, float* output);
+		void SetupBatch(int numberOfChannels);
+		void ProcessForwardBatch(const float* const* input, int inputSize, float* const* packedOutput, int numberOfChannels);
+		void ProcessInverseBatch(const float* const* packedInput, float* const* output, int numberOfChannels);
+
+	private:
+		// METHODS
+		//Complex FFT of halfSize points of each one of the numberOfChannels transforms stored in real/img, one after the other, already in bit reversed order
+		void ProcessComplexFFT(int numberOfChannels);
+
+		// ATTRIBUTES
+		int FFTSize;						//Number of real points of the transform (N)
+		int halfSize;						//Number of complex points of the inner transform (N/2)
+		TFFTSIMDLevel SIMDLevel;			//Instruction set used by the butterflies
+		std::vector<int> bitReversal;		//Bit reversed index of each point of the complex transform
+		std::vector<float> twiddleReal;		//Twiddle factors of each stage, the ones of the stage with butterflies of size h start at index h
+		std::vector<float> twiddleImg;
+		std::vector<float> postReal;		//exp(2*pi*i*k/N), used to split the complex transform into the real one
+		std::vector<float> postImg;
+		std::vector<float> real;			//Real part of the complex transforms, halfSize values for each one
+		std::vector<float> img;				//Imaginary part of the complex transforms, halfSize values for each one
+	};
+}//end namespace Common
+#endif
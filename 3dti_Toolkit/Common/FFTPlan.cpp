@@ -0,0 +1,312 @@
+/**
+* \class CFFTPlan
+*
+* \brief Definition of CFFTPlan class.
+*
+* This class stores the tables and buffers needed to compute the FFT of real signals of a fixed size.
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+#include "FFTPlan.h"
+#include "ErrorHandler.h"
+#include <cmath>
+
+namespace Common {
+
+	std::atomic<int> CFFTPlan::defaultBackend{ TFFTBackend::NativeFloat };
+
+	/////////////////////////////
+	// CONSTRUCTOR/DESTRUCTOR  //
+	/////////////////////////////
+	CFFTPlan::CFFTPlan() : FFTSize{ 0 }, backendType{ TFFTBackend::NativeFloat }, batchSize{ 0 }
+	{
+	}
+
+	CFFTPlan::CFFTPlan(int _FFTSize) : FFTSize{ 0 }, backendType{ TFFTBackend::NativeFloat }, batchSize{ 0 }
+	{
+		Setup(_FFTSize);
+	}
+
+	CFFTPlan::CFFTPlan(const CFFTPlan & other) : FFTSize{ 0 }, backendType{ other.backendType }, batchSize{ 0 }
+	{
+		if (other.FFTSize > 0) {
+			Setup(other.FFTSize, other.backendType);
+			if (other.batchSize > 1) { SetupBatch(other.batchSize); }
+		}
+	}
+
+	CFFTPlan & CFFTPlan::operator=(const CFFTPlan & other)
+	{
+		if ((this != &other) && (other.FFTSize > 0)) {
+			Setup(other.FFTSize, other.backendType);
+			if (other.batchSize > 1) { SetupBatch(other.batchSize); }
+		}
+		return *this;
+	}
+
+	////////////////////
+	// Public Methods //
+	////////////////////
+
+	//Prepare the tables and the working buffer with the default backend
+	void CFFTPlan::Setup(int _FFTSize)
+	{
+		Setup(_FFTSize, GetDefaultBackend());
+	}
+
+	//Prepare the tables and the working buffer
+	void CFFTPlan::Setup(int _FFTSize, TFFTBackend _backend)
+	{
+		ASSERT((_FFTSize >= 2) && ((_FFTSize & (_FFTSize - 1)) == 0), RESULT_ERROR_BADSIZE, "FFT size has to be a power of two", "");
+
+		if ((_FFTSize >= 2) && ((_FFTSize & (_FFTSize - 1)) == 0))	//Just in case error handler is off
+		{
+			if ((_FFTSize == FFTSize) && (_backend == backendType) && backend) { return; }		//Tables already calculated
+
+			FFTSize = _FFTSize;
+			backendType = _backend;
+			backend.reset(CFFTBackend::Create(backendType));
+			backend->Setup(FFTSize);
+			packedBuffer.assign(FFTSize, 0.0f);
+			packedBatch.assign(1, packedBuffer.data());
+			batchSize = 1;
+		}
+	}
+
+	//Prepare the working buffers of the batched methods
+	void CFFTPlan::SetupBatch(int numberOfChannels)
+	{
+		ASSERT(FFTSize > 0, RESULT_ERROR_NOTINITIALIZED, "FFT plan has not been set up", "");
+
+		if ((FFTSize > 0) && (numberOfChannels > batchSize))	//Just in case error handler is off
+		{
+			batchSize = numberOfChannels;
+			packedBuffer.assign(batchSize * FFTSize, 0.0f);
+			packedBatch.resize(batchSize);
+			for (int channel = 0; channel < batchSize; channel++) { packedBatch[channel] = packedBuffer.data() + channel * FFTSize; }
+			backend->SetupBatch(batchSize);
+		}
+	}
+
+	int CFFTPlan::GetFFTSize() const
+	{
+		return FFTSize;
+	}
+
+	TFFTBackend CFFTPlan::GetBackend() const
+	{
+		return backendType;
+	}
+
+	void CFFTPlan::SetDefaultBackend(TFFTBackend _backend)
+	{
+		defaultBackend = _backend;
+	}
+
+	TFFTBackend CFFTPlan::GetDefaultBackend()
+	{
+		return static_cast<TFFTBackend>(defaultBackend.load());
+	}
+
+	//Calculate the FFT of the input signal
+	void CFFTPlan::CalculateFFT(const std::vector<float>& inputAudioBuffer_time, std::vector<float>& outputAudioBuffer_frequency)
+	{
+		ASSERT(FFTSize > 0, RESULT_ERROR_NOTINITIALIZED, "FFT plan has not been set up", "");
+		ASSERT(inputAudioBuffer_time.size() <= (size_t)FFTSize, RESULT_ERROR_BADSIZE, "Input buffer is bigger than the FFT plan size", "");
+
+		if ((FFTSize > 0) && (inputAudioBuffer_time.size() <= (size_t)FFTSize))	//Just in case error handler is off
+		{
+			backend->ProcessForward(inputAudioBuffer_time.data(), inputAudioBuffer_time.size(), packedBuffer.data());	//Make the FFT
+
+			//The real FFT only gives the first half of the spectrum, the second half is the conjugate of the first one
+			if (outputAudioBuffer_frequency.size() != 2 * (size_t)FFTSize) { outputAudioBuffer_frequency.resize(2 * FFTSize); }
+			int halfSize = FFTSize / 2;
+			outputAudioBuffer_frequency[0] = packedBuffer[0];
+			outputAudioBuffer_frequency[1] = 0.0f;
+			outputAudioBuffer_frequency[FFTSize] = packedBuffer[1];		//Nyquist point is stored in packedBuffer[1]
+			outputAudioBuffer_frequency[FFTSize + 1] = 0.0f;
+			for (int k = 1; k < halfSize; k++)
+			{
+				float real = packedBuffer[2 * k];
+				float img = packedBuffer[2 * k + 1];
+				outputAudioBuffer_frequency[2 * k] = real;
+				outputAudioBuffer_frequency[2 * k + 1] = img;
+				outputAudioBuffer_frequency[2 * (FFTSize - k)] = real;
+				outputAudioBuffer_frequency[2 * (FFTSize - k) + 1] = -img;
+			}
+		}
+	}
+
+	//Calculate the IFFT of the input spectrum
+	void CFFTPlan::CalculateIFFT(const std::vector<float>& inputAudioBuffer_frequency, std::vector<float>& outputAudioBuffer_time)
+	{
+		ASSERT(FFTSize > 0, RESULT_ERROR_NOTINITIALIZED, "FFT plan has not been set up", "");
+		ASSERT(inputAudioBuffer_frequency.size() == 2 * (size_t)FFTSize, RESULT_ERROR_BADSIZE, "Input buffer size doesn't match with the FFT plan size", "");
+
+		if ((FFTSize > 0) && (inputAudioBuffer_frequency.size() == 2 * (size_t)FFTSize))	//Just in case error handler is off
+		{
+			//Keep the hermitian part of the spectrum, which is the one that gives the real part of the complex IFFT
+			int halfSize = FFTSize / 2;
+			packedBuffer[0] = inputAudioBuffer_frequency[0];
+			packedBuffer[1] = inputAudioBuffer_frequency[FFTSize];
+			for (int k = 1; k < halfSize; k++)
+			{
+				packedBuffer[2 * k] = 0.5f * (inputAudioBuffer_frequency[2 * k] + inputAudioBuffer_frequency[2 * (FFTSize - k)]);
+				packedBuffer[2 * k + 1] = 0.5f * (inputAudioBuffer_frequency[2 * k + 1] - inputAudioBuffer_frequency[2 * (FFTSize - k) + 1]);
+			}
+
+			if (outputAudioBuffer_time.size() != (size_t)FFTSize) { outputAudioBuffer_time.resize(FFTSize); }
+			backend->ProcessInverse(packedBuffer.data(), outputAudioBuffer_time.data());	//Make the IFFT
+
+			ProcessRoundToZero(outputAudioBuffer_time.data(), FFTSize);
+		}
+	}
+
+	//Calculate the FFT of the input signal, keeping only the points from 0 to N/2
+	void CFFTPlan::CalculateFFT_HalfSpectrum(const std::vector<float>& inputAudioBuffer_time, std::vector<float>& outputAudioBuffer_frequency)
+	{
+		if (outputAudioBuffer_frequency.size() != (size_t)FFTSize + 2) { outputAudioBuffer_frequency.resize(FFTSize + 2); }
+		CalculateFFT_HalfSpectrum(inputAudioBuffer_time.data(), inputAudioBuffer_time.size(), outputAudioBuffer_frequency.data());
+	}
+
+	//Calculate the FFT of the input signal, keeping only the points from 0 to N/2
+	void CFFTPlan::CalculateFFT_HalfSpectrum(const float* inputAudioBuffer_time, int inputSize, float* outputAudioBuffer_frequency)
+	{
+		ASSERT(FFTSize > 0, RESULT_ERROR_NOTINITIALIZED, "FFT plan has not been set up", "");
+		ASSERT(inputSize <= FFTSize, RESULT_ERROR_BADSIZE, "Input buffer is bigger than the FFT plan size", "");
+
+		if ((FFTSize > 0) && (inputSize <= FFTSize))	//Just in case error handler is off
+		{
+			backend->ProcessForward(inputAudioBuffer_time, inputSize, packedBuffer.data());	//Make the FFT
+			ProcessPackedToHalfSpectrum(packedBuffer.data(), outputAudioBuffer_frequency);
+		}
+	}
+
+	//Calculate the IFFT of the points from 0 to N/2 of a spectrum
+	void CFFTPlan::CalculateIFFT_HalfSpectrum(const std::vector<float>& inputAudioBuffer_frequency, std::vector<float>& outputAudioBuffer_time)
+	{
+		ASSERT(inputAudioBuffer_frequency.size() == (size_t)FFTSize + 2, RESULT_ERROR_BADSIZE, "Input buffer size doesn't match with the FFT plan size", "");
+
+		if (inputAudioBuffer_frequency.size() == (size_t)FFTSize + 2)	//Just in case error handler is off
+		{
+			if (outputAudioBuffer_time.size() != (size_t)FFTSize) { outputAudioBuffer_time.resize(FFTSize); }
+			CalculateIFFT_HalfSpectrum(inputAudioBuffer_frequency.data(), outputAudioBuffer_time.data());
+		}
+	}
+
+	//Calculate the IFFT of the points from 0 to N/2 of a spectrum
+	void CFFTPlan::CalculateIFFT_HalfSpectrum(const float* inputAudioBuffer_frequency, float* outputAudioBuffer_time)
+	{
+		ASSERT(FFTSize > 0, RESULT_ERROR_NOTINITIALIZED, "FFT plan has not been set up", "");
+
+		if (FFTSize > 0)	//Just in case error handler is off
+		{
+			ProcessHalfSpectrumToPacked(inputAudioBuffer_frequency, packedBuffer.data());
+
+			backend->ProcessInverse(packedBuffer.data(), outputAudioBuffer_time);	//Make the IFFT
+
+			ProcessRoundToZero(outputAudioBuffer_time, FFTSize);
+		}
+	}
+
+	//Calculate the FFT of several input signals at once, keeping only the points from 0 to N/2
+	void CFFTPlan::CalculateFFT_HalfSpectrum(const std::vector<const float*>& inputAudioBuffers_time, int inputSize, const std::vector<float*>& outputAudioBuffers_frequency)
+	{
+		ASSERT(FFTSize > 0, RESULT_ERROR_NOTINITIALIZED, "FFT plan has not been set up", "");
+		ASSERT(inputSize <= FFTSize, RESULT_ERROR_BADSIZE, "Input buffer is bigger than the FFT plan size", "");
+		ASSERT(inputAudioBuffers_time.size() == outputAudioBuffers_frequency.size(), RESULT_ERROR_BADSIZE, "The batched FFT needs one output buffer for each input buffer", "");
+
+		if ((FFTSize > 0) && (inputSize <= FFTSize) && (inputAudioBuffers_time.size() == outputAudioBuffers_frequency.size()))	//Just in case error handler is off
+		{
+			int numberOfChannels = inputAudioBuffers_time.size();
+			SetupBatch(numberOfChannels);
+
+			backend->ProcessForwardBatch(inputAudioBuffers_time.data(), inputSize, packedBatch.data(), numberOfChannels);	//Make the FFTs
+			for (int channel = 0; channel < numberOfChannels; channel++)
+			{
+				ProcessPackedToHalfSpectrum(packedBatch[channel], outputAudioBuffers_frequency[channel]);
+			}
+		}
+	}
+
+	//Calculate the IFFT of several spectra at once, from their points 0 to N/2
+	void CFFTPlan::CalculateIFFT_HalfSpectrum(const std::vector<const float*>& inputAudioBuffers_frequency, const std::vector<float*>& outputAudioBuffers_time)
+	{
+		ASSERT(FFTSize > 0, RESULT_ERROR_NOTINITIALIZED, "FFT plan has not been set up", "");
+		ASSERT(inputAudioBuffers_frequency.size() == outputAudioBuffers_time.size(), RESULT_ERROR_BADSIZE, "The batched IFFT needs one output buffer for each input buffer", "");
+
+		if ((FFTSize > 0) && (inputAudioBuffers_frequency.size() == outputAudioBuffers_time.size()))	//Just in case error handler is off
+		{
+			int numberOfChannels = inputAudioBuffers_frequency.size();
+			SetupBatch(numberOfChannels);
+
+			for (int channel = 0; channel < numberOfChannels; channel++)
+			{
+				ProcessHalfSpectrumToPacked(inputAudioBuffers_frequency[channel], packedBatch[channel]);
+			}
+			backend->ProcessInverseBatch(packedBatch.data(), outputAudioBuffers_time.data(), numberOfChannels);	//Make the IFFTs
+			for (int channel = 0; channel < numberOfChannels; channel++)
+			{
+				ProcessRoundToZero(outputAudioBuffers_time[channel], FFTSize);
+			}
+		}
+	}
+
+	/////////////////////
+	// Private Methods //
+	/////////////////////
+
+	//Split the packed spectrum into the real parts and the imaginary parts of the points 0 to N/2
+	void CFFTPlan::ProcessPackedToHalfSpectrum(const float* packed, float* halfSpectrum)
+	{
+		int numberOfPoints = FFTSize / 2 + 1;
+		float* real = halfSpectrum;
+		float* img = real + numberOfPoints;
+		real[0] = packed[0];
+		img[0] = 0.0f;
+		real[numberOfPoints - 1] = packed[1];		//Nyquist point is stored in packed[1]
+		img[numberOfPoints - 1] = 0.0f;
+		for (int k = 1; k < numberOfPoints - 1; k++)
+		{
+			real[k] = packed[2 * k];
+			img[k] = packed[2 * k + 1];
+		}
+	}
+
+	//Join real and imaginary parts in the packed layout. The imaginary parts of the DC and Nyquist points are zero for real signals
+	void CFFTPlan::ProcessHalfSpectrumToPacked(const float* halfSpectrum, float* packed)
+	{
+		int numberOfPoints = FFTSize / 2 + 1;
+		const float* real = halfSpectrum;
+		const float* img = real + numberOfPoints;
+		packed[0] = real[0];
+		packed[1] = real[numberOfPoints - 1];
+		for (int k = 1; k < numberOfPoints - 1; k++)
+		{
+			packed[2 * k] = real[k];
+			packed[2 * k + 1] = img[k];
+		}
+	}
+
+	//Round to zero the values very close to zero
+	void CFFTPlan::ProcessRoundToZero(float* buffer, int size)
+	{
+		for (int i = 0; i < size; i++)
+		{
+			if (std::abs(buffer[i]) < THRESHOLD) { buffer[i] = 0.0f; }
+		}
+	}
+}//end namespace Common
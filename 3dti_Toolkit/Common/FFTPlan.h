@@ -0,0 +1,202 @@
+/**
+* \class CFFTPlan
+*
+* \brief Declaration of CFFTPlan class interface.
+* \date	October 2026
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#ifndef _CFFTPLAN_H_
+#define _CFFTPLAN_H_
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include "FFTBackend.h"
+
+#ifndef THRESHOLD
+#define THRESHOLD 0.0000001f
+#endif
+
+namespace Common {
+
+	/** \details This class stores everything needed to compute the FFT of real signals of a fixed size (N = 2^n points).
+	*	The tables of the FFT backend are computed only once, in the Setup method, and the working buffers are also
+	*	reused between calls, so the FFT/IFFT methods do not allocate memory in the audio thread.
+	*	The backend is chosen when the plan is set up, see \link SetDefaultBackend \endlink.
+	*	The spectrum is returned interlaced (re, im) with the N complex points, that is, 2*N values, as the CFprocessor methods always did,
+	*	or only with its non redundant half (points 0 to N/2), that is, N+2 values, with the _HalfSpectrum methods. The half spectrum is stored split,
+	*	first the N/2+1 real parts and then the N/2+1 imaginary parts, so the complex products of the convolutions can be vectorized.
+	*/
+	class CFFTPlan
+	{
+	public:
+
+		/** \brief Default constructor
+		*   \details The plan is empty. Setup has to be called before using it.
+		*/
+		CFFTPlan();
+
+		/** \brief Constructor that also calls the Setup method
+		*	\param [in] _FFTSize number of real points of the transform (N). It has to be a power of two.
+		*/
+		CFFTPlan(int _FFTSize);
+
+		/** \brief Copy constructor
+		*   \details The copy has its own tables and buffers, of the same size and backend of the original one.
+		*/
+		CFFTPlan(const CFFTPlan & other);
+
+		/** \brief Copy assignment
+		*   \details The tables and buffers are calculated again for the size and backend of the other plan.
+		*/
+		CFFTPlan & operator=(const CFFTPlan & other);
+
+		/** \brief Prepare the plan (tables and working buffer) to compute FFTs of N points
+		*	\param [in] _FFTSize number of real points of the transform (N). It has to be a power of two.
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void Setup(int _FFTSize);
+
+		/** \brief Prepare the plan (tables and working buffer) to compute FFTs of N points, with a specific backend
+		*	\param [in] _FFTSize number of real points of the transform (N). It has to be a power of two.
+		*	\param [in] _backend FFT implementation used by this plan
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void Setup(int _FFTSize, TFFTBackend _backend);
+
+		/** \brief Get the number of real points of the transform (N)
+		*	\retval FFTSize N, or 0 if Setup has not been called yet
+		*/
+		int GetFFTSize() const;
+
+		/** \brief Get the FFT implementation used by this plan
+		*	\retval backend FFT backend
+		*/
+		TFFTBackend GetBackend() const;
+
+		/** \brief Set the FFT implementation used by the plans that are set up from now on
+		*   \details The default backend is NativeFloat. ReferenceDouble can be used to compare results with the previous versions of the toolkit.
+		*	Plans already set up keep their backend until their Setup method is called again.
+		*	\param [in] _backend FFT backend
+		*/
+		static void SetDefaultBackend(TFFTBackend _backend);
+
+		/** \brief Get the FFT implementation used by the plans that are set up from now on
+		*	\retval backend FFT backend
+		*/
+		static TFFTBackend GetDefaultBackend();
+
+		/** \brief Calculate the FFT of N points of a real signal
+		*   \details The input buffer is extended with zeros until N samples.
+		*	\param [in] inputAudioBuffer_time vector containing the samples of input signal in time-domain. Its size has to be less or equal than N.
+		*	\param [out] outputAudioBuffer_frequency FFT of the input signal. It has a size of N * 2, because contains the real and imaginary parts of each point.
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void CalculateFFT(const std::vector<float>& inputAudioBuffer_time, std::vector<float>& outputAudioBuffer_frequency);
+
+		/** \brief Calculate the IFFT of N points of the spectrum of a real signal
+		*   \details Only the real part of the result is returned, normalized and with the values very close to zero rounded to zero.
+		*	\param [in] inputAudioBuffer_frequency vector with the spectrum, real and imaginary parts interlaced. Its size has to be N * 2.
+		*	\param [out] outputAudioBuffer_time vector where the N samples in time-domain will be returned.
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void CalculateIFFT(const std::vector<float>& inputAudioBuffer_frequency, std::vector<float>& outputAudioBuffer_time);
+
+		/** \brief Calculate the FFT of N points of a real signal, returning only the non redundant half of the spectrum
+		*   \details The input buffer is extended with zeros until N samples. The spectrum of a real signal is hermitian, so only the points from 0 to N/2 (both included) are returned.
+		*	\param [in] inputAudioBuffer_time vector containing the samples of input signal in time-domain. Its size has to be less or equal than N.
+		*	\param [out] outputAudioBuffer_frequency points 0 to N/2 of the FFT of the input signal, first the N/2+1 real parts and then the N/2+1 imaginary parts. It has a size of N + 2.
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void CalculateFFT_HalfSpectrum(const std::vector<float>& inputAudioBuffer_time, std::vector<float>& outputAudioBuffer_frequency);
+
+		/** \brief Calculate the FFT of N points of a real signal, returning only the non redundant half of the spectrum
+		*   \details Same as the previous method, but the spectrum is written in a buffer owned by the caller, for example one slot of a frequency-domain delay line.
+		*	\param [in] inputAudioBuffer_time samples of the input signal in time-domain
+		*	\param [in] inputSize number of samples of the input signal. It has to be less or equal than N.
+		*	\param [out] outputAudioBuffer_frequency buffer of N + 2 values where the points 0 to N/2 of the FFT are written, first the real parts and then the imaginary parts
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void CalculateFFT_HalfSpectrum(const float* inputAudioBuffer_time, int inputSize, float* outputAudioBuffer_frequency);
+
+		/** \brief Calculate the IFFT of N points from the non redundant half of the spectrum of a real signal
+		*   \details The result is normalized and the values very close to zero are rounded to zero.
+		*	\param [in] inputAudioBuffer_frequency vector with the points 0 to N/2 of the spectrum, first the N/2+1 real parts and then the N/2+1 imaginary parts. Its size has to be N + 2.
+		*	\param [out] outputAudioBuffer_time vector where the N samples in time-domain will be returned.
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void CalculateIFFT_HalfSpectrum(const std::vector<float>& inputAudioBuffer_frequency, std::vector<float>& outputAudioBuffer_time);
+
+		/** \brief Calculate the IFFT of N points from the non redundant half of the spectrum of a real signal
+		*   \details Same as the previous method, but working with buffers owned by the caller.
+		*	\param [in] inputAudioBuffer_frequency buffer of N + 2 values with the points 0 to N/2 of the spectrum, first the real parts and then the imaginary parts
+		*	\param [out] outputAudioBuffer_time buffer where the N samples in time-domain will be written
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void CalculateIFFT_HalfSpectrum(const float* inputAudioBuffer_frequency, float* outputAudioBuffer_time);
+
+		/** \brief Prepare the working buffers to compute up to numberOfChannels transforms at once with the batched methods
+		*	\details The batched methods also prepare them the first time they need them, but calling this method in the setup of the caller avoids allocating memory in the audio thread.
+		*	\param [in] numberOfChannels maximum number of signals transformed at once
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void SetupBatch(int numberOfChannels);
+
+		/** \brief Calculate the FFT of N points of several real signals of the same size at once, returning only the non redundant half of each spectrum
+		*   \details The result is the same as calling CalculateFFT_HalfSpectrum for each signal, but the per-call work and the accesses to the tables are shared by all of them.
+		*	\param [in] inputAudioBuffers_time pointers to the samples of each input signal in time-domain
+		*	\param [in] inputSize number of samples of each input signal. It has to be less or equal than N.
+		*	\param [out] outputAudioBuffers_frequency pointers to the buffers of N + 2 values where the points 0 to N/2 of the FFT of each signal are written, first the real parts and then the imaginary parts
+		*	\pre Both vectors have to have the same number of pointers
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void CalculateFFT_HalfSpectrum(const std::vector<const float*>& inputAudioBuffers_time, int inputSize, const std::vector<float*>& outputAudioBuffers_frequency);
+
+		/** \brief Calculate the IFFT of N points of several non redundant half spectra at once
+		*   \details The result is the same as calling CalculateIFFT_HalfSpectrum for each spectrum, but the per-call work and the accesses to the tables are shared by all of them.
+		*	\param [in] inputAudioBuffers_frequency pointers to the buffers of N + 2 values with the points 0 to N/2 of each spectrum, first the real parts and then the imaginary parts
+		*	\param [out] outputAudioBuffers_time pointers to the buffers where the N samples in time-domain of each signal will be written
+		*	\pre Both vectors have to have the same number of pointers
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void CalculateIFFT_HalfSpectrum(const std::vector<const float*>& inputAudioBuffers_frequency, const std::vector<float*>& outputAudioBuffers_time);
+
+	private:
+		// METHODS
+		//Copy a packed spectrum into the split layout of the half spectrum
+		void ProcessPackedToHalfSpectrum(const float* packed, float* halfSpectrum);
+
+		//Copy a half spectrum into the packed layout of the backends
+		void ProcessHalfSpectrumToPacked(const float* halfSpectrum, float* packed);
+
+		//Round to zero the values very close to zero
+		void ProcessRoundToZero(float* buffer, int size);
+
+
+		// ATTRIBUTES
+		int FFTSize;								//Number of real points of the transform (N)
+		TFFTBackend backendType;					//FFT implementation used by this plan
+		std::unique_ptr<CFFTBackend> backend;		//Object that computes the transforms
+		std::vector<float> packedBuffer;			//Spectrum in the packed layout of the backends, N values for each signal of the batched methods
+		std::vector<float*> packedBatch;			//Pointers to the packed spectrum of each signal of the batched methods
+		int batchSize;								//Number of signals that the batched methods can transform without allocating memory
+
+		static std::atomic<int> defaultBackend;		//Backend of the plans that are set up from now on
+	};
+}//end namespace Common
+#endif
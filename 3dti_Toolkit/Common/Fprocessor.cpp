@@ -22,6 +22,7 @@
 */
 #include "Fprocessor.h"
 #include "ErrorHandler.h"
+#include "SIMDDetection.h"
 #include <cmath>
 
 //#define USE_PROFILER_Fprocessor
@@ -34,10 +35,139 @@ CProfilerDataSet dataSetOthers;
 #endif
 
 namespace Common {
+
+	/////////////////////////////////////////////////
+	// Multiply-accumulate kernels of half spectra //
+	/////////////////////////////////////////////////
+
+	//y += sum of x[p] * h[p], from point k to the end. Every spectrum has numberOfPoints real parts followed by numberOfPoints imaginary parts
+	static void ProcessComplexMultiplyAccumulate_Scalar(const float* const* x, const float* const* h, int numberOfSpectra, int numberOfPoints, int k, float* y)
+	{
+		float* yReal = y;
+		float* yImg = y + numberOfPoints;
+		for (; k < numberOfPoints; k++)
+		{
+			float accReal = yReal[k];
+			float accImg = yImg[k];
+			for (int p = 0; p < numberOfSpectra; p++)
+			{
+				float a = x[p][k];
+				float b = x[p][numberOfPoints + k];
+				float c = h[p][k];
+				float d = h[p][numberOfPoints + k];
+				accReal += a*c - b*d;
+				accImg += a*d + b*c;
+			}
+			yReal[k] = accReal;
+			yImg[k] = accImg;
+		}
+	}
+
+#ifdef FFT_X86_SIMD
+	//Same multiply-accumulate, 4 points at a time. Returns the number of points processed
+	FFT_TARGET_SSE2
+	static int ProcessComplexMultiplyAccumulate_SSE2(const float* const* x, const float* const* h, int numberOfSpectra, int numberOfPoints, float* y)
+	{
+		float* yReal = y;
+		float* yImg = y + numberOfPoints;
+		int k = 0;
+		for (; k + 4 <= numberOfPoints; k += 4)
+		{
+			__m128 accReal = _mm_loadu_ps(yReal + k);
+			__m128 accImg = _mm_loadu_ps(yImg + k);
+			for (int p = 0; p < numberOfSpectra; p++)
+			{
+				__m128 a = _mm_loadu_ps(x[p] + k);
+				__m128 b = _mm_loadu_ps(x[p] + numberOfPoints + k);
+				__m128 c = _mm_loadu_ps(h[p] + k);
+				__m128 d = _mm_loadu_ps(h[p] + numberOfPoints + k);
+				accReal = _mm_add_ps(accReal, _mm_sub_ps(_mm_mul_ps(a, c), _mm_mul_ps(b, d)));
+				accImg = _mm_add_ps(accImg, _mm_add_ps(_mm_mul_ps(a, d), _mm_mul_ps(b, c)));
+			}
+			_mm_storeu_ps(yReal + k, accReal);
+			_mm_storeu_ps(yImg + k, accImg);
+		}
+		return k;
+	}
+
+	//Same multiply-accumulate, 8 points at a time. Returns the number of points processed
+	FFT_TARGET_AVX2
+	static int ProcessComplexMultiplyAccumulate_AVX2(const float* const* x, const float* const* h, int numberOfSpectra, int numberOfPoints, float* y)
+	{
+		float* yReal = y;
+		float* yImg = y + numberOfPoints;
+		int k = 0;
+		for (; k + 8 <= numberOfPoints; k += 8)
+		{
+			__m256 accReal = _mm256_loadu_ps(yReal + k);
+			__m256 accImg = _mm256_loadu_ps(yImg + k);
+			for (int p = 0; p < numberOfSpectra; p++)
+			{
+				__m256 a = _mm256_loadu_ps(x[p] + k);
+				__m256 b = _mm256_loadu_ps(x[p] + numberOfPoints + k);
+				__m256 c = _mm256_loadu_ps(h[p] + k);
+				__m256 d = _mm256_loadu_ps(h[p] + numberOfPoints + k);
+				accReal = _mm256_add_ps(accReal, _mm256_sub_ps(_mm256_mul_ps(a, c), _mm256_mul_ps(b, d)));
+				accImg = _mm256_add_ps(accImg, _mm256_add_ps(_mm256_mul_ps(a, d), _mm256_mul_ps(b, c)));
+			}
+			_mm256_storeu_ps(yReal + k, accReal);
+			_mm256_storeu_ps(yImg + k, accImg);
+		}
+		return k;
+	}
+#endif
+
+	//Vectorized multiply-accumulate with the best instruction set of the CPU. Returns the number of points processed, the rest have to be done with the scalar kernel
+	static int ProcessComplexMultiplyAccumulate_SIMD(const float* const* x, const float* const* h, int numberOfSpectra, int numberOfPoints, float* y)
+	{
+#ifdef FFT_X86_SIMD
+		TFFTSIMDLevel SIMDLevel = CFFTBackend::GetSIMDLevel();
+		if (SIMDLevel == SIMD_AVX2) { return ProcessComplexMultiplyAccumulate_AVX2(x, h, numberOfSpectra, numberOfPoints, y); }
+		if (SIMDLevel == SIMD_SSE2) { return ProcessComplexMultiplyAccumulate_SSE2(x, h, numberOfSpectra, numberOfPoints, y); }
+#endif
+		return 0;
+	}
+
+	////////////////////////////////////////////
+	// Scaled-add kernels of the direct FIR   //
+	////////////////////////////////////////////
+
+	//y += g * x, from sample n to the end
+	static void ProcessScaledAdd_Scalar(const float* x, float g, int size, int n, float* y)
+	{
+		for (; n < size; n++) { y[n] += g * x[n]; }
+	}
+
+#ifdef FFT_X86_SIMD
+	//Same scaled add, 4 samples at a time. Returns the number of samples processed
+	FFT_TARGET_SSE2
+	static int ProcessScaledAdd_SSE2(const float* x, float g, int size, float* y)
+	{
+		__m128 gain = _mm_set1_ps(g);
+		int n = 0;
+		for (; n + 4 <= size; n += 4) {
+			_mm_storeu_ps(y + n, _mm_add_ps(_mm_loadu_ps(y + n), _mm_mul_ps(gain, _mm_loadu_ps(x + n))));
+		}
+		return n;
+	}
+
+	//Same scaled add, 8 samples at a time. Returns the number of samples processed
+	FFT_TARGET_AVX2
+	static int ProcessScaledAdd_AVX2(const float* x, float g, int size, float* y)
+	{
+		__m256 gain = _mm256_set1_ps(g);
+		int n = 0;
+		for (; n + 8 <= size; n += 8) {
+			_mm256_storeu_ps(y + n, _mm256_add_ps(_mm256_loadu_ps(y + n), _mm256_mul_ps(gain, _mm256_loadu_ps(x + n))));
+		}
+		return n;
+	}
+#endif
+
 	/////////////////////////////
 	// CONSTRUCTOR/DESTRUCTOR  //
 	/////////////////////////////
-	CFprocessor::CFprocessor() : inputSize{ 0 }, IRSize{ 0 }, FFTBufferSize{ 0 }, setupDone{ false }
+	CFprocessor::CFprocessor() : inputSize{ 0 }, IRSize{ 0 }, FFTBufferSize{ 0 }, setupDone{ false }, storageBuffer_head{ 0 }
 	{		
 	}
 
@@ -62,32 +192,11 @@ namespace Common {
 			if (!CalculateIsPowerOfTwo(FFTBufferSize)) {
 				FFTBufferSize = CalculateNextPowerOfTwo(FFTBufferSize);
 			}
-			FFTBufferSize *= 2;							//We multiplicate by 2 because we need to store real and imaginary part
-
-			///////////////////////////////////////////////////////////////////////////////
-			// Calculate auxiliary arrays size, necessary to use the Takuya OOURA library
-			///////////////////////////////////////////////////////////////////////////////
-			int ip_size = std::sqrt(FFTBufferSize / 2) + 2;		//Size of the auxiliary array w. This come from lib documentation/examples.
-			int w_size = FFTBufferSize * 5 / 4;					//Size of the auxiliary array w. This come from lib documentation/examples.
-			std::vector<int> ip(ip_size);						//Define the auxiliary array ip 
-			std::vector<double> w(w_size);						//Define the auxiliary array w			
-			ip[0] = 0;											//w[],ip[] are initialized if ip[0] == 0.
 
 			//////////////
 			// Make FFT //
-			//////////////			
-			std::vector<double> inputAudioBuffer_frequency(FFTBufferSize, 0.0f);			//Initialize the vector of doubles to store the FFT					
-			ProcessAddImaginaryPart(inputAudioBuffer_time, inputAudioBuffer_frequency);			//Copy the input vector into an vector of doubles and insert the imaginary part.											
-			cdft(FFTBufferSize, 1, inputAudioBuffer_frequency.data(), ip.data(), w.data());	//Make the FFT
-			
-			////////////////////
-			// Prepare Output //
-			////////////////////	
-			//Copy to the output float vector			
-			if (outputAudioBuffer_frequency.size() != FFTBufferSize) { outputAudioBuffer_frequency.resize(FFTBufferSize); }
-			for (int i = 0; i < inputAudioBuffer_frequency.size(); i++) {
-				outputAudioBuffer_frequency[i] = static_cast<float>(inputAudioBuffer_frequency[i]);
-			}
+			//////////////
+			GetCachedPlan(FFTBufferSize).CalculateFFT(inputAudioBuffer_time, outputAudioBuffer_frequency);
 		}		
 	}
 
@@ -109,31 +218,11 @@ namespace Common {
 			if (!CalculateIsPowerOfTwo(FFTBufferSize)) {
 				FFTBufferSize = CalculateNextPowerOfTwo(FFTBufferSize);
 			}
-			FFTBufferSize *= 2;			//We multiplicate by 2 because we need to store real and imaginary part
-
-			///////////////////////////////////////////////////////////////////////////////
-			// Calculate auxiliary arrays size, necessary to use the Takuya OOURA library
-			///////////////////////////////////////////////////////////////////////////////
-			int ip_size = std::sqrt(FFTBufferSize / 2) + 2;		//Size of the auxiliary array w. This come from lib documentation/examples.
-			int w_size = FFTBufferSize * 5 / 4;					//Size of the auxiliary array w. This come from lib documentation/examples.
-			std::vector<int> ip(ip_size);						//Define the auxiliary array ip 
-			std::vector<double> w(w_size);						//Define the auxiliary array w			
-			ip[0] = 0;											//w[],ip[] are initialized if ip[0] == 0.
 
 			//////////////
 			// Make FFT //
-			//////////////	
-			std::vector<double> inputAudioBuffer_frequency(FFTBufferSize, 0.0f);			//Initialize the vector of doubles to store the FFT					
-			ProcessAddImaginaryPart(inputAudioBuffer_time, inputAudioBuffer_frequency);			//Copy the input vector into an vector of doubles and insert the imaginary part.
-			cdft(FFTBufferSize, 1, inputAudioBuffer_frequency.data(), ip.data(), w.data());	//Make the FFT
-
-			////////////////////
-			// Prepare Output //
-			////////////////////			
-			outputAudioBuffer_frequency.resize(FFTBufferSize);
-			for (int i = 0; i < inputAudioBuffer_frequency.size(); i++) {
-				outputAudioBuffer_frequency[i] = static_cast<float>(inputAudioBuffer_frequency[i]);
-			}
+			//////////////
+			GetCachedPlan(FFTBufferSize).CalculateFFT(inputAudioBuffer_time, outputAudioBuffer_frequency);
 		}
 	}
 	
@@ -159,6 +248,72 @@ namespace Common {
 		}
 	}//ComplexMultiplicaton
 
+	//This method adds the complex multiplication between the half spectra elements to the output vector. The three vectors have to be the same size
+	void CFprocessor::ProcessComplexMultiplyAccumulate(const std::vector<float>& x, const std::vector<float>& h, std::vector<float>& y)
+	{
+		ASSERT((x.size() == h.size()) && (x.size() == y.size()), RESULT_ERROR_BADSIZE, "Complex multiply-accumulate in frequency convolver requires three vectors of the same size", "");
+
+		if ((x.size() == h.size()) && (x.size() == y.size()))	//Just in case error handler is off
+		{
+			const float* xData = x.data();
+			const float* hData = h.data();
+			int numberOfPoints = y.size() / 2;
+			int k = ProcessComplexMultiplyAccumulate_SIMD(&xData, &hData, 1, numberOfPoints, y.data());
+			ProcessComplexMultiplyAccumulate_Scalar(&xData, &hData, 1, numberOfPoints, k, y.data());
+		}
+	}//ProcessComplexMultiplyAccumulate
+
+	//This method adds the complex multiplication of every pair of half spectra to the output vector, in only one pass
+	void CFprocessor::ProcessComplexMultiplyAccumulate(const std::vector<const float*>& x, const std::vector<const float*>& h, std::vector<float>& y)
+	{
+		ASSERT(x.size() == h.size(), RESULT_ERROR_BADSIZE, "Complex multiply-accumulate in frequency convolver requires the same number of spectra in both operands", "");
+
+		if ((x.size() == h.size()) && (x.size() > 0))	//Just in case error handler is off
+		{
+			int numberOfPoints = y.size() / 2;
+			int k = ProcessComplexMultiplyAccumulate_SIMD(x.data(), h.data(), x.size(), numberOfPoints, y.data());
+			ProcessComplexMultiplyAccumulate_Scalar(x.data(), h.data(), x.size(), numberOfPoints, k, y.data());
+		}
+	}//ProcessComplexMultiplyAccumulate
+
+	//This method adds the complex multiplication of one half spectrum with each one of several others to its own output
+	void CFprocessor::ProcessComplexMultiplyAccumulate(const float* x, const std::vector<const float*>& h, const std::vector<float*>& y, int spectrumSize)
+	{
+		ASSERT(h.size() == y.size(), RESULT_ERROR_BADSIZE, "Complex multiply-accumulate in frequency convolver requires the same number of spectra in the second operand and in the output", "");
+
+		if (h.size() == y.size())	//Just in case error handler is off
+		{
+			int numberOfPoints = spectrumSize / 2;
+			for (size_t j = 0; j < h.size(); j++)
+			{
+				int k = ProcessComplexMultiplyAccumulate_SIMD(&x, &h[j], 1, numberOfPoints, y[j]);
+				ProcessComplexMultiplyAccumulate_Scalar(&x, &h[j], 1, numberOfPoints, k, y[j]);
+			}
+		}
+	}//ProcessComplexMultiplyAccumulate
+
+	//This method adds the direct convolution of x and h to y, one scaled copy of x for each coefficient of h
+	void CFprocessor::ProcessDirectConvolution(const float* x, int inputSize, const float* h, int IRSize, float* y)
+	{
+		ASSERT(inputSize >= 0 && IRSize >= 0, RESULT_ERROR_BADSIZE, "Bad size of the signals of the direct convolution", "");
+
+		if (inputSize >= 0 && IRSize >= 0)	//Just in case error handler is off
+		{
+#ifdef FFT_X86_SIMD
+			TFFTSIMDLevel SIMDLevel = CFFTBackend::GetSIMDLevel();
+#endif
+			for (int k = 0; k < IRSize; k++)
+			{
+				int n = 0;
+#ifdef FFT_X86_SIMD
+				if (SIMDLevel == SIMD_AVX2) { n = ProcessScaledAdd_AVX2(x, h[k], inputSize, y + k); }
+				else if (SIMDLevel == SIMD_SSE2) { n = ProcessScaledAdd_SSE2(x, h[k], inputSize, y + k); }
+#endif
+				ProcessScaledAdd_Scalar(x, h[k], inputSize, n, y + k);
+			}
+		}
+	}//ProcessDirectConvolution
+
 	//Calculate the IFFT of the output signal
 	void CFprocessor::CalculateIFFT(const std::vector<float>& inputAudioBuffer_frequency, std::vector<float>& outputAudioBuffer_time)
 	{
@@ -170,34 +325,68 @@ namespace Common {
 			//////////////////////////////
 			// Calculate output size	//
 			//////////////////////////////
-			int FFTBufferSize = inputBufferSize;
-			
-			///////////////////////////////////////////////////////////////////////////////
-			// Calculate auxiliary arrays size, necessary to use the Takuya OOURA library
-			///////////////////////////////////////////////////////////////////////////////
-			int ip_size = std::sqrt(FFTBufferSize / 2) + 2;		//Size of the auxiliary array w. This come from lib documentation/examples.
-			int w_size = FFTBufferSize * 5 / 4;					//Size of the auxiliary array w. This come from lib documentation/examples.																				
-			std::vector<int> ip(ip_size);						//Define the auxiliary array ip 
-			std::vector<double> w(w_size);						//Define the auxiliary array w			
-			ip[0] = 0;											//w[],ip[] are initialized if ip[0] == 0.
-			
+			int FFTBufferSize = inputBufferSize / 2;		//Number of complex points of the spectrum
+
 			///////////////
 			// Make IFFT //
-			///////////////																
-			std::vector<double> outBuffer_temp(inputAudioBuffer_frequency.begin(), inputAudioBuffer_frequency.end());	//Convert to double
-			cdft(FFTBufferSize, -1, outBuffer_temp.data(), ip.data(), w.data());										//Make the IFFT
+			///////////////
+			GetCachedPlan(FFTBufferSize).CalculateIFFT(inputAudioBuffer_frequency, outputAudioBuffer_time);
+		}		
+	}
 
-			////////////////////
-			// Prepare Output //
-			////////////////////	
-			int outBufferSize = inputAudioBuffer_frequency.size() / 2;	//Locar var to move throught the outbuffer
-			if (outputAudioBuffer_time.size() != outBufferSize) { outputAudioBuffer_time.resize(outBufferSize); }
-			float normalizeCoef = 2.0f / FFTBufferSize;			//Store the normalize coef for the FFT-1	
-			//Fill out the output signal buffer
-			for (int i = 0; i < outBufferSize; i++)	{
-				outputAudioBuffer_time[i] = static_cast<float>(CalculateRoundToZero(outBuffer_temp[2 * i] * normalizeCoef));
+	//Calculate the FFT of the input signal, keeping only the non redundant half of the spectrum
+	void CFprocessor::CalculateFFT_HalfSpectrum(const std::vector<float>& inputAudioBuffer_time, std::vector<float>& outputAudioBuffer_frequency)
+	{
+		int inputBufferSize = inputAudioBuffer_time.size();
+
+		ASSERT(inputBufferSize != 0, RESULT_ERROR_BADSIZE, "Bad input size when setting up frequency convolver", "");
+
+		if (inputBufferSize > 0) //Just in case error handler is off
+		{
+			int FFTBufferSize = inputBufferSize;
+			//Check if if power of two, if not round up to the next highest power of 2 
+			if (!CalculateIsPowerOfTwo(FFTBufferSize)) {
+				FFTBufferSize = CalculateNextPowerOfTwo(FFTBufferSize);
 			}
-		}		
+
+			GetCachedPlan(FFTBufferSize).CalculateFFT_HalfSpectrum(inputAudioBuffer_time, outputAudioBuffer_frequency);
+		}
+	}
+
+	//Calculate the IFFT from the non redundant half of the spectrum
+	void CFprocessor::CalculateIFFT_HalfSpectrum(const std::vector<float>& inputAudioBuffer_frequency, std::vector<float>& outputAudioBuffer_time)
+	{
+		int inputBufferSize = inputAudioBuffer_frequency.size();
+		ASSERT(inputBufferSize > 2, RESULT_ERROR_BADSIZE, "Bad input size", "");
+
+		if (inputBufferSize > 2) //Just in case error handler is off
+		{
+			int FFTBufferSize = inputBufferSize - 2;		//Points 0 to B/2, real and imaginary parts
+
+			GetCachedPlan(FFTBufferSize).CalculateIFFT_HalfSpectrum(inputAudioBuffer_frequency, outputAudioBuffer_time);
+		}
+	}
+
+	//Calculate the FFT of several input signals at once, keeping only the non redundant half of each spectrum
+	void CFprocessor::CalculateFFT_HalfSpectrum(const std::vector<const float*>& inputAudioBuffers_time, int inputSize, const std::vector<float*>& outputAudioBuffers_frequency, int FFTSize)
+	{
+		ASSERT(CalculateIsPowerOfTwo(FFTSize), RESULT_ERROR_BADSIZE, "FFT size has to be a power of two", "");
+
+		if (CalculateIsPowerOfTwo(FFTSize)) //Just in case error handler is off
+		{
+			GetCachedPlan(FFTSize).CalculateFFT_HalfSpectrum(inputAudioBuffers_time, inputSize, outputAudioBuffers_frequency);
+		}
+	}
+
+	//Calculate the IFFT of several spectra at once, from the non redundant half of each one
+	void CFprocessor::CalculateIFFT_HalfSpectrum(const std::vector<const float*>& inputAudioBuffers_frequency, const std::vector<float*>& outputAudioBuffers_time, int FFTSize)
+	{
+		ASSERT(CalculateIsPowerOfTwo(FFTSize), RESULT_ERROR_BADSIZE, "FFT size has to be a power of two", "");
+
+		if (CalculateIsPowerOfTwo(FFTSize)) //Just in case error handler is off
+		{
+			GetCachedPlan(FFTSize).CalculateIFFT_HalfSpectrum(inputAudioBuffers_frequency, outputAudioBuffers_time);
+		}
 	}
 
 	void CFprocessor::ProcessToModulePhase(const std::vector<float>& inputBuffer, std::vector<float>& moduleBuffer, std::vector<float>& phaseBuffer)
@@ -276,10 +465,6 @@ namespace Common {
 
 		if ((_inputSize > 0) && (_AIRSize > 0))		//Just in case error handler is off
 		{
-			if (setupDone) {
-				storageBuffer.clear();		//If is the second time that this method has been called -> clear all buffers
-			}
-
 			///////////////////////////////
 			// Calculate FFT/output size //
 			///////////////////////////////
@@ -290,15 +475,11 @@ namespace Common {
 			if (!CalculateIsPowerOfTwo(FFTBufferSize)) {
 				FFTBufferSize = CalculateNextPowerOfTwo(FFTBufferSize);
 			}
-			storageBuffer.resize(FFTBufferSize);		//Prepare the buffer with the space that we are going to needed
-			normalizeCoef = 1.0f / FFTBufferSize;		//Store the normalize coef for the FFT-1
+			storageBuffer.assign(FFTBufferSize, 0.0);	//Prepare the circular buffer with the space that we are going to need, cleared if this is not the first setup
+			storageBuffer_head = 0;
+			IFFTBuffer.assign(FFTBufferSize, 0.0f);	//Prepare the IFFT buffer, so the IFFT does not allocate memory
+			FFTPlan.Setup(FFTBufferSize);				//Calculate the FFT tables only once
 			FFTBufferSize *= 2;							//We multiplicate by 2 because we need to store real and imaginary part
-			
-			///////////////////////////////////////////////////////////////////////////////
-			// Calculate auxiliary arrays size, necessary to use the Takuya OOURA library
-			///////////////////////////////////////////////////////////////////////////////
-			ip_size = std::sqrt(FFTBufferSize / 2) + 2;		//Size of the auxiliary array w. This come from lib documentation/examples.
-			w_size = FFTBufferSize * 5 / 4;				//Size of the auxiliary array w. This come from lib documentation/examples.
 
 			setupDone = true;
 			SET_RESULT(RESULT_OK, "Frequency convolver succesfully set");		
@@ -312,24 +493,15 @@ namespace Common {
 
 		if ((setupDone) && (inputBuffer_frequency.size() == FFTBufferSize) )	//Just in case error handler is off
 		{
-			///////////////////////////////////////////////////////////////////////////////
-			// Calculate auxiliary arrays size, necessary to use the Takuya OOURA library
-			///////////////////////////////////////////////////////////////////////////////
-			//Prepare the FFT						
-			std::vector<int> ip(ip_size);	//Define the auxiliary array ip 
-			std::vector<double> w(w_size);	//Define the auxiliary array w			
-			ip[0] = 0;						//w[],ip[] are initialized if ip[0] == 0.
-
 			///////////////
 			// Make IFFT //
-			///////////////				
-			std::vector<double> outBuffer_temp(inputBuffer_frequency.begin(), inputBuffer_frequency.end());		//Convert to double
-			cdft(FFTBufferSize, -1, outBuffer_temp.data(), ip.data(), w.data());								//Make the FFT-1
-			
+			///////////////
+			FFTPlan.CalculateIFFT(inputBuffer_frequency, IFFTBuffer);
+
 			////////////////////
 			// Prepare Output //
 			////////////////////
-			ProcessOutputBuffer_IFFT_OverlapAddMethod(outBuffer_temp, outputBuffer_time);
+			ProcessOutputBuffer_IFFT_OverlapAddMethod(IFFTBuffer, outputBuffer_time);
 		}		
 	}
 
@@ -337,20 +509,21 @@ namespace Common {
 	// Private methods //
 	/////////////////////
 
-	//This method copies the input vector into an array and insert the imaginary part.
-	void CFprocessor::ProcessAddImaginaryPart(const std::vector<float>& input, std::vector<double>& output)
+	//Get the FFT plan of the given size, which is calculated only the first time it is needed in each thread
+	CFFTPlan & CFprocessor::GetCachedPlan(int FFTSize)
 	{
-		ASSERT(output.size() >= 2 * input.size(), RESULT_ERROR_BADSIZE, "Output buffer size must be at least twice the input buffer size when adding imaginary part in frequency convolver", "");
+		static thread_local std::unordered_map<int, CFFTPlan> cachedPlans;
 
-		for (int i = 0; i < input.size(); i++)
+		CFFTPlan & plan = cachedPlans[FFTSize];
+		if ((plan.GetFFTSize() != FFTSize) || (plan.GetBackend() != CFFTPlan::GetDefaultBackend()))
 		{
-			output[2 * i] = static_cast<double> (input[i]);
-			//output[2 * i + 1] = 0;
+			plan.Setup(FFTSize);
 		}
-	}//ProcessAddImaginaryPart
+		return plan;
+	}//GetCachedPlan
 	
-	 //This method copy the FFT-1 output array into the storage vector, remove the imaginary part and normalize the output.	
-	void CFprocessor::ProcessOutputBuffer_IFFT_OverlapAddMethod(std::vector<double>& input_ConvResultBuffer, std::vector<float>& outBuffer)
+	//This method adds the FFT-1 output array to the storage circular buffer, which keeps the tails of the previous ones, and takes the output from its head
+	void CFprocessor::ProcessOutputBuffer_IFFT_OverlapAddMethod(const std::vector<float>& input_ConvResultBuffer, std::vector<float>& outBuffer)
 	{
 		//Prepare the outbuffer
 		if (outBuffer.size() < inputSize)
@@ -359,46 +532,32 @@ namespace Common {
 		}
 		//Check buffer sizes	
 		ASSERT(outBuffer.size() == inputSize, RESULT_ERROR_BADSIZE, "OutBuffer size has to be zero or equal to the input size indicated by the setup method", "");
+		ASSERT(input_ConvResultBuffer.size() == storageBuffer.size(), RESULT_ERROR_BADSIZE, "The size of the IFFT doesn't match with the size indicated by the setup method", "");
 
-		int outBufferSize = inputSize;	//Locar var to move throught the outbuffer
-										
-		//Fill out the output signal buffer
-		for (int i = 0; i < outBufferSize; i++)
+		if ((outBuffer.size() == inputSize) && (input_ConvResultBuffer.size() == storageBuffer.size()))	//Just in case error handler is off
 		{
-			if (i < storageBuffer.size()) {
-				outBuffer[i] = static_cast<float>(storageBuffer[i] + CalculateRoundToZero(input_ConvResultBuffer[2 * i] * normalizeCoef));
-			}
-			else
-			{
-				outBuffer[i] = static_cast<float>(CalculateRoundToZero(input_ConvResultBuffer[2 * i] * normalizeCoef));
-			}
-		}
-		//Fill out the storage buffer to be used in the next call
-		std::vector<double> temp;
-		temp.reserve(0.5f * input_ConvResultBuffer.size() - outBufferSize);
-		int inputConvResult_size = 0.5f * input_ConvResultBuffer.size();	//Locar var to move to the end of the input_ConvResultBuffer
-		for (int i = outBufferSize; i < inputConvResult_size; i++)
-		{
-			if (i<storageBuffer.size())
+			int storageSize = storageBuffer.size();
+			//Fill out the output signal buffer, and clear those positions, which will be the end of the tail from the next call
+			for (int i = 0; i < inputSize; i++)
 			{
-				temp.push_back(storageBuffer[i] + CalculateRoundToZero(input_ConvResultBuffer[2 * i] * normalizeCoef));
+				int j = storageBuffer_head + i;
+				if (j >= storageSize) { j -= storageSize; }
+				outBuffer[i] = static_cast<float>(storageBuffer[j] + input_ConvResultBuffer[i]);
+				storageBuffer[j] = 0.0;
 			}
-			else
+			//Add the rest of the result to the storage buffer, to be used in the next calls
+			for (int i = inputSize; i < storageSize; i++)
 			{
-				temp.push_back(CalculateRoundToZero(input_ConvResultBuffer[2 * i] * normalizeCoef));
+				int j = storageBuffer_head + i;
+				if (j >= storageSize) { j -= storageSize; }
+				storageBuffer[j] += input_ConvResultBuffer[i];
 			}
+			//Move the head to the samples of the next output
+			storageBuffer_head += inputSize;
+			if (storageBuffer_head >= storageSize) { storageBuffer_head -= storageSize; }
 		}
-		//storageBuffer.swap(temp);				//To use in C++03
-		storageBuffer = std::move(temp);			//To use in C++11
 	}//ProcessOutputBuffer_IFFT_OverlapAddMethod
 		
-	 //This method rounds to zero a value that is very close to zero.
-	double CFprocessor::CalculateRoundToZero(double number)
-	{
-		if (std::abs(number) < THRESHOLD) {	return 0.0f;}
-		else { return number; }
-	}
-
 	//This method check if a number is a power of 2
 	bool CFprocessor::CalculateIsPowerOfTwo(int x)
 	{
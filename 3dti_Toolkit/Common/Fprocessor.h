@@ -27,13 +27,10 @@
 //#include <math.h>
 #include <iostream>
 #include <vector>
-#include "fftsg.h"
+#include <unordered_map>
+#include "FFTPlan.h"
 #include "Buffer.h"
 
-#ifndef THRESHOLD
-#define THRESHOLD 0.0000001f
-#endif
-
 namespace Common {
 
 	/** \details This class implements the necessary algorithms to do the convolution, in frequency domain, between signal and a impulse response.
@@ -71,6 +68,43 @@ namespace Common {
 		*/
 		static void CalculateIFFT(const std::vector<float>& inputAudioBuffer_frequency, std::vector<float>& outputAudioBuffer_time);
 
+		/** \brief Calculate the FFT of B points of the input signal, returning only the non redundant half of its spectrum. Where B = 2^n = (N + k).
+		*   \details This method will extend the input buffer with zeros (k) until be power of 2 and then made the FFT. As the input signal is real, only the points from 0 to B/2 are returned.
+		*	\param [in] inputAudioBuffer_time vector containing the samples of input signal in time-domain. N is this buffer size.
+		*	\param [out] outputAudioBuffer_frequency points 0 to B/2 of the FFT of the input signal. Have a size of B + 2, first the B/2+1 real parts and then the B/2+1 imaginary parts.
+		*/
+		static void CalculateFFT_HalfSpectrum(const std::vector<float>& inputAudioBuffer_time, std::vector<float>& outputAudioBuffer_frequency);
+
+		/** \brief Get the IFFT of B points from the non redundant half of the spectrum of a real signal
+		*   \details This method makes the IFFT of the input buffer. This method doesn't implement OLA or OLS algothim, it doesn't resolve the inverse convolution.
+		*   \param [in] inputAudioBuffer_frequency Vector with the points 0 to B/2 of the spectrum, first the B/2+1 real parts and then the B/2+1 imaginary parts. This buffers has to be size of B + 2
+		*   \param [out] outputAudioBuffer_time Vector of samples where the IFFT of the output signal will be returned in time domain. This vector will have a size of B.
+		*	\pre inputAudioBuffer_frequency has to have the same size that the one returned by CalculateFFT_HalfSpectrum.
+		*   \throws May throw exceptions and errors to debugger
+		*/
+		static void CalculateIFFT_HalfSpectrum(const std::vector<float>& inputAudioBuffer_frequency, std::vector<float>& outputAudioBuffer_time);
+
+		/** \brief Calculate the FFT of B points of several signals at once, for example the channels of a b-format signal or the inputs of several sources, returning only the non redundant half of each spectrum
+		*   \details The result is the same as calling CalculateFFT_HalfSpectrum for each signal, but all of them are transformed together, so the per-call work and the accesses to the FFT tables are shared.
+		*	\param [in] inputAudioBuffers_time pointers to the samples in time-domain of each input signal
+		*	\param [in] inputSize number of samples of each input signal. It has to be less or equal than B.
+		*	\param [out] outputAudioBuffers_frequency pointers to the buffers of B + 2 values where the points 0 to B/2 of the FFT of each signal are written, first the real parts and then the imaginary parts
+		*	\param [in] FFTSize number of points of the FFT (B). It has to be a power of two.
+		*	\pre Both vectors have to have the same number of pointers
+		*   \throws May throw exceptions and errors to debugger
+		*/
+		static void CalculateFFT_HalfSpectrum(const std::vector<const float*>& inputAudioBuffers_time, int inputSize, const std::vector<float*>& outputAudioBuffers_frequency, int FFTSize);
+
+		/** \brief Get the IFFT of B points of several non redundant half spectra at once
+		*   \details The result is the same as calling CalculateIFFT_HalfSpectrum for each spectrum, but all of them are transformed together, so the per-call work and the accesses to the FFT tables are shared.
+		*   \param [in] inputAudioBuffers_frequency pointers to the buffers of B + 2 values with the points 0 to B/2 of each spectrum, first the real parts and then the imaginary parts
+		*   \param [out] outputAudioBuffers_time pointers to the buffers where the B samples in time-domain of each signal will be written
+		*	\param [in] FFTSize number of points of the IFFT (B). It has to be a power of two.
+		*	\pre Both vectors have to have the same number of pointers
+		*   \throws May throw exceptions and errors to debugger
+		*/
+		static void CalculateIFFT_HalfSpectrum(const std::vector<const float*>& inputAudioBuffers_frequency, const std::vector<float*>& outputAudioBuffers_time, int FFTSize);
+
 		/** \brief Process complex multiplication between the elements of two vectors.
 		*   \details This method makes the complex multiplication of vector samples: (a+bi)(c+di) = (ac-bd)+i(ad+bc)
 		*   \param [in] x Vector of samples that has real and imaginary parts interlaced. x[i] = Re[Xj], x[i+1] = Img[Xj]
@@ -81,6 +115,51 @@ namespace Common {
 		*/
 		static void ProcessComplexMultiplication(const std::vector<float>& x, const std::vector<float>& h, std::vector<float>& y);
 
+		/** \brief Process complex multiplication between the elements of two half spectra, adding the result to a third one.
+		*   \details This method makes y = y + x * h, without any temporary buffer.
+		*   \param [in] x Half spectrum, as returned by CalculateFFT_HalfSpectrum. x[j] = Re[Xj], x[j + M] = Img[Xj], where M is half the vector size
+		*   \param [in] h Half spectrum, as returned by CalculateFFT_HalfSpectrum. h[j] = Re[Hj], h[j + M] = Img[Hj]
+		*	\param [in,out] y Half spectrum where the complex multiplication of x and h is accumulated
+		*	\pre The three vectors have to be the same size
+		*   \throws May throw exceptions and errors to debugger
+		*/
+		static void ProcessComplexMultiplyAccumulate(const std::vector<float>& x, const std::vector<float>& h, std::vector<float>& y);
+
+		/** \brief Process the complex multiplication of several pairs of half spectra, adding all of them to the output vector.
+		*   \details This method makes y = y + x[0] * h[0] + x[1] * h[1] + ... in only one pass over the output vector, vectorized with SSE2/AVX2 when the CPU supports it.
+		*	It is the multiply-accumulate step of the partitioned convolution, where x are the spectra of the last input blocks and h the subfilters.
+		*   \param [in] x Pointers to the half spectra of the first operand, with the layout returned by CalculateFFT_HalfSpectrum
+		*   \param [in] h Pointers to the half spectra of the second operand, with the layout returned by CalculateFFT_HalfSpectrum
+		*	\param [in,out] y Half spectrum where the sum of the complex multiplications is accumulated
+		*	\pre x and h have to have the same number of pointers, and every spectrum has to have the size of y
+		*   \throws May throw exceptions and errors to debugger
+		*/
+		static void ProcessComplexMultiplyAccumulate(const std::vector<const float*>& x, const std::vector<const float*>& h, std::vector<float>& y);
+
+		/** \brief Process the complex multiplication of one half spectrum with several others, adding each product to its own output.
+		*   \details This method makes y[0] = y[0] + x * h[0], y[1] = y[1] + x * h[1], ... vectorized with SSE2/AVX2 when the CPU supports it.
+		*	It is the multiply-accumulate step of the partitioned convolution when the outputs of the next blocks are accumulated in advance, where x is the spectrum of the current input block and h the subfilters.
+		*   \param [in] x Half spectrum of the first operand, with the layout returned by CalculateFFT_HalfSpectrum
+		*   \param [in] h Pointers to the half spectra of the second operand, with the layout returned by CalculateFFT_HalfSpectrum
+		*	\param [in,out] y Pointers to the half spectra where each complex multiplication is accumulated
+		*	\param [in] spectrumSize Number of values of every spectrum (N + 2 for an FFT of N points)
+		*	\pre h and y have to have the same number of pointers
+		*   \throws May throw exceptions and errors to debugger
+		*/
+		static void ProcessComplexMultiplyAccumulate(const float* x, const std::vector<const float*>& h, const std::vector<float*>& y, int spectrumSize);
+
+		/** \brief Process the direct convolution, in time domain, of one signal with one impulse response, adding the result to the output vector.
+		*   \details This method makes y[n + k] = y[n + k] + x[n] * h[k] for every sample n of x and every coefficient k of h, vectorized with SSE2/AVX2 when the CPU supports it.
+		*	It is cheaper than a partitioned convolution for short impulse responses, and it does not add any latency.
+		*   \param [in] x Input signal
+		*   \param [in] inputSize Number of samples of x
+		*   \param [in] h Impulse response
+		*   \param [in] IRSize Number of coefficients of h
+		*	\param [in,out] y Signal where the convolution is accumulated. It has to have inputSize + IRSize - 1 samples, at least
+		*   \throws May throw exceptions and errors to debugger
+		*/
+		static void ProcessDirectConvolution(const float* x, int inputSize, const float* h, int IRSize, float* y);
+
 		/** \brief Process a buffer with complex numbers to get two separated vectors one with the modules and other with the phases.
 		*   \details This method return two vectors with the module and phase of the vector introduced.
 		*   \param [in] inputBuffer Vector of samples that has real and imaginary parts interlaced. inputBuffer[i] = Re[Xj], x[i+1] = Img[Xj]
@@ -118,6 +197,7 @@ namespace Common {
 
 		/** \brief Calculate the IFFT of the output signal using OLA (Overlap-Add) algorithm.
 		*   \details This method makes the IFFT of the signal using OLA (Overlap-Add) algorithm. Do the IFFT, adds the samples obtained with buffer samples in order to get output signal, and updates the buffer.
+		*	The buffers are allocated by \link SetupIFFT_OLA \endlink, so this method does not allocate memory once the output vector has the right size.
 		*   \param [in] signal_frequency Vector of samples storing the output signal in frecuency domain.
 		*   \param [out] signal_time Vector of samples where the IFFT of the output signal will be returned in time domain. This vector will have the size indicated in \link SetupIFFT_OLA \endlink method.
 		*	\pre signal_frequency has to have the same size that the one returned by any of the CalculateFFT_ methods.
@@ -137,23 +217,20 @@ namespace Common {
 		int inputSize;			//Size of the inputs buffer		
 		int IRSize;				//Size of the AmbiIR buffer
 		int FFTBufferSize;		//Size of the outputbuffer and zeropadding buffers	
-		double normalizeCoef;		//Coef to normalize the Inverse FFT
-		int ip_size;			//Size of the auxiliary array ip;
-		int w_size;				//Size of the auxiliary array w;	
 		bool setupDone;			//It's true when setup has been called at least once
-		std::vector<double> storageBuffer;		//To store the results of the convolution
+		std::vector<double> storageBuffer;		//Circular buffer to store the tails of the results of the convolution, FFT size
+		int storageBuffer_head;					//Position in the storage buffer of the first sample of the next output
+		CFFTPlan FFTPlan;						//FFT tables used by the CalculateIFFT_OLA method
+		std::vector<float> IFFTBuffer;			//To store the IFFT before adding it to the storage buffer
 
 
 		// METHODS 	
 
-		// brief This method copies the input vector into an array and insert the imaginary part.
-		static void ProcessAddImaginaryPart(const std::vector<float>& input, std::vector<double>& output);
+		//This method returns the FFT plan of a given size (N complex points), calculating it the first time is requested from each thread
+		static CFFTPlan & GetCachedPlan(int FFTSize);
 		
-		//This method copy the FFT-1 output array into the storage vector, remove the imaginary part and normalize the output.	
-		void ProcessOutputBuffer_IFFT_OverlapAddMethod(std::vector<double>& input, std::vector<float>& outBuffer);
-
-		//This method rounds to zero a value that is very close to zero.
-		static double CalculateRoundToZero(double number);
+		//This method adds the FFT-1 output array to the storage circular buffer and takes the output from it, without allocating memory
+		void ProcessOutputBuffer_IFFT_OverlapAddMethod(const std::vector<float>& input, std::vector<float>& outBuffer);
 
 		//This method Round up to the next highest power of 2 
 		static int CalculateNextPowerOfTwo(int v);
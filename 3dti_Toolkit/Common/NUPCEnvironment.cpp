@@ -0,0 +1,261 @@
+/**
+* \class CNUPCEnvironment
+*
+* \brief  Non-Uniformly Partitioned Convolution Algorithm (NUPC algorithm) for reverb path
+* \date	October 2026
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+
+#include <Common/NUPCEnvironment.h>
+#include <Common/ErrorHandler.h>
+#include <algorithm>
+
+namespace Common
+{
+	CNUPCEnvironment::CNUPCEnvironment()
+	{
+		setupDone = false;
+	}
+
+	//Initialize the class from the impulse responses in time domain
+	void CNUPCEnvironment::Setup(int _inputSize, const TImpulseResponse & leftIR_Time, const TImpulseResponse & rightIR_Time, int _partitionsPerSegment)
+	{
+		ASSERT((_inputSize > 0) && ((_inputSize & (_inputSize - 1)) == 0), RESULT_ERROR_BADSIZE, "Input size of the NUPC convolver has to be a power of two", "");
+		ASSERT(_partitionsPerSegment >= 1, RESULT_ERROR_OUTOFRANGE, "The NUPC convolver needs at least one partition per segment", "");
+		ASSERT(leftIR_Time.size() > 0 || rightIR_Time.size() > 0, RESULT_ERROR_BADSIZE, "Attempt to set up the NUPC convolver with empty impulse responses", "");
+
+		setupDone = false;
+		segments.clear();
+		storageOutput_buffer.clear();
+
+		int IRLength = std::max(leftIR_Time.size(), rightIR_Time.size());
+		if ((_inputSize > 0) && ((_inputSize & (_inputSize - 1)) == 0) && (_partitionsPerSegment >= 1) && (IRLength > 0))	//Just in case error handler is off
+		{
+			inputSize = _inputSize;
+			partitionsPerSegment = _partitionsPerSegment;
+
+			//Split the impulse responses in segments. The partitions of each segment are twice as long as the ones of the previous segment.
+			//A segment with partitions of L samples starts, at least, L samples after the beginning of the impulse response, so its output is ready before it has to be played
+			int offset = 0;
+			int partitionSize = inputSize;
+			while (offset < IRLength)
+			{
+				TSegment newSegment;
+				newSegment.partitionSize = partitionSize;
+				newSegment.numberOfPartitions = std::min(partitionsPerSegment, (IRLength - offset + partitionSize - 1) / partitionSize);
+				newSegment.offset = offset;
+				newSegment.period = partitionSize / inputSize;
+				segments.push_back(std::move(newSegment));
+
+				offset += segments.back().numberOfPartitions * partitionSize;
+				partitionSize *= 2;
+			}
+			for (TSegment & segment : segments) { SetupSegment(segment, leftIR_Time, rightIR_Time); }
+
+			//The outputs of each segment are added offset - L + B samples ahead of the current output and are L samples long, the last segment is the one that reaches further
+			storageOutput_length = segments.back().offset + inputSize;
+			storageOutput_buffer.assign(2 * storageOutput_length, 0.0f);
+			storageOutput_head = 0;
+			blockCounter = 0;
+
+			setupDone = true;
+			SET_RESULT(RESULT_OK, "NUPC convolver successfully set");
+		}
+	}//Setup
+
+	//Initialize the class from the uniformly partitioned impulse responses
+	void CNUPCEnvironment::Setup(int _inputSize, const TImpulseResponse_Partitioned & leftIR, const TImpulseResponse_Partitioned & rightIR, int _partitionsPerSegment)
+	{
+		ASSERT(_inputSize > 0, RESULT_ERROR_BADSIZE, "Input size of the NUPC convolver has to be greater than 0", "");
+
+		if (_inputSize > 0)	//Just in case error handler is off
+		{
+			TImpulseResponse leftIR_Time;
+			TImpulseResponse rightIR_Time;
+			CalculateImpulseResponse_Time(_inputSize, leftIR, leftIR_Time);
+			CalculateImpulseResponse_Time(_inputSize, rightIR, rightIR_Time);
+			Setup(_inputSize, leftIR_Time, rightIR_Time, _partitionsPerSegment);
+		}
+	}//Setup
+
+	void CNUPCEnvironment::ProcessNUPConvolution(const CMonoBuffer<float>& inBuffer_Time, CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer)
+	{
+		ASSERT(setupDone, RESULT_ERROR_NOTINITIALIZED, "The NUPC convolver has not been set up", "");
+		ASSERT(inBuffer_Time.size() == (size_t)inputSize, RESULT_ERROR_BADSIZE, "Bad input size, don't match with the size setting up in the setup method", "");
+		ASSERT(outLeftBuffer.size() == (size_t)inputSize && outRightBuffer.size() == (size_t)inputSize, RESULT_ERROR_BADSIZE, "Bad output size, don't match with the size setting up in the setup method", "");
+
+		if (setupDone && (inBuffer_Time.size() == (size_t)inputSize) && (outLeftBuffer.size() == (size_t)inputSize) && (outRightBuffer.size() == (size_t)inputSize))	//Just in case error handler is off
+		{
+			for (TSegment & segment : segments)
+			{
+				//Store the input block in the second half of the time buffer of the segment, after the blocks already received
+				int phase = blockCounter % segment.period;
+				std::copy(inBuffer_Time.begin(), inBuffer_Time.end(), segment.inBuffer_Time_dobleSize.begin() + segment.partitionSize + phase * inputSize);
+
+				//Convolve when the segment has received L new samples
+				if (phase == segment.period - 1) { ProcessSegment(segment); }
+			}
+			blockCounter++;
+			if (blockCounter == segments.back().period) { blockCounter = 0; }
+
+			//Take the outputs of the current block from the ring buffers and leave their place free for the outputs to come
+			float* leftOutput = storageOutput_buffer.data() + storageOutput_head;
+			float* rightOutput = leftOutput + storageOutput_length;
+			for (int i = 0; i < inputSize; i++)
+			{
+				outLeftBuffer[i] += leftOutput[i];
+				outRightBuffer[i] += rightOutput[i];
+			}
+			std::fill(leftOutput, leftOutput + inputSize, 0.0f);
+			std::fill(rightOutput, rightOutput + inputSize, 0.0f);
+			storageOutput_head += inputSize;
+			if (storageOutput_head == storageOutput_length) { storageOutput_head = 0; }
+		}
+	}
+
+	int CNUPCEnvironment::GetNumberOfSegments() const
+	{
+		return segments.size();
+	}
+
+	/////////////////////
+	// Private Methods //
+	/////////////////////
+
+	//Prepare the buffers of one segment and calculate the half spectrum of each one of its partitions
+	void CNUPCEnvironment::SetupSegment(TSegment & segment, const TImpulseResponse & leftIR_Time, const TImpulseResponse & rightIR_Time)
+	{
+		int L = segment.partitionSize;
+		segment.subfilterLength = 2 * L + 2;
+		segment.slotLength = CalculateAlignedLength(segment.subfilterLength);
+		segment.FFTPlan.Setup(2 * L);
+		segment.inBuffer_Time_dobleSize.assign(2 * L, 0.0f);
+
+		segment.subfilters.assign(2 * segment.numberOfPartitions * segment.slotLength, 0.0f);
+		CalculateSegmentSubfilters(segment, leftIR_Time, segment.subfilters.data());
+		CalculateSegmentSubfilters(segment, rightIR_Time, segment.subfilters.data() + segment.numberOfPartitions * segment.slotLength);
+
+		segment.storageInputFFT_buffer.assign(segment.numberOfPartitions * segment.slotLength, 0.0f);
+		segment.storageInputFFT_head = 0;
+
+		segment.outputFFT_buffer.assign(segment.subfilterLength, 0.0f);
+		segment.outputIFFT_buffer.assign(2 * L, 0.0f);
+		segment.productInputFFT.reserve(segment.numberOfPartitions);
+		segment.productIR.reserve(segment.numberOfPartitions);
+	}
+
+	//Each partition is extended with L zeros before the FFT. The samples beyond the end of the impulse response are zeros
+	void CNUPCEnvironment::CalculateSegmentSubfilters(TSegment & segment, const TImpulseResponse & IR_Time, float* subfilters)
+	{
+		int L = segment.partitionSize;
+		std::vector<float> partition_Time(2 * L, 0.0f);
+		for (int i = 0; i < segment.numberOfPartitions; i++)
+		{
+			int begin = std::min(segment.offset + i * L, (int)IR_Time.size());
+			int end = std::min(begin + L, (int)IR_Time.size());
+			std::fill(partition_Time.begin(), partition_Time.end(), 0.0f);
+			std::copy(IR_Time.begin() + begin, IR_Time.begin() + end, partition_Time.begin());
+			segment.FFTPlan.CalculateFFT_HalfSpectrum(partition_Time.data(), partition_Time.size(), subfilters + i * segment.slotLength);
+		}
+	}
+
+	//UPC of the last L input samples with the partitions of one segment
+	void CNUPCEnvironment::ProcessSegment(TSegment & segment)
+	{
+		int L = segment.partitionSize;
+
+		//FFT of the previous L samples followed by the current ones, directly into the head slot of the delay line
+		float* inBuffer_Frequency = segment.storageInputFFT_buffer.data() + segment.storageInputFFT_head * segment.slotLength;
+		segment.FFTPlan.CalculateFFT_HalfSpectrum(segment.inBuffer_Time_dobleSize.data(), segment.inBuffer_Time_dobleSize.size(), inBuffer_Frequency);
+		std::copy(segment.inBuffer_Time_dobleSize.begin() + L, segment.inBuffer_Time_dobleSize.end(), segment.inBuffer_Time_dobleSize.begin());
+
+		//Both ears are multiplied by the same input FFTs
+		segment.productInputFFT.clear();
+		for (int i = 0; i < segment.numberOfPartitions; i++) {
+			segment.productInputFFT.push_back(GetInputFFT(segment, i));
+		}
+		ProcessSegmentOutput(segment, segment.subfilters.data(), storageOutput_buffer.data());
+		ProcessSegmentOutput(segment, segment.subfilters.data() + segment.numberOfPartitions * segment.slotLength, storageOutput_buffer.data() + storageOutput_length);
+
+		ProcessAdvanceInputFFT(segment);
+	}
+
+	//Multiplications and sums of one ear, all of them in one pass, and IFFT
+	void CNUPCEnvironment::ProcessSegmentOutput(TSegment & segment, const float* subfilters, float* storageOutput)
+	{
+		int L = segment.partitionSize;
+
+		segment.productIR.clear();
+		for (int i = 0; i < segment.numberOfPartitions; i++) {
+			segment.productIR.push_back(subfilters + i * segment.slotLength);
+		}
+		std::fill(segment.outputFFT_buffer.begin(), segment.outputFFT_buffer.end(), 0.0f);
+		Common::CFprocessor::ProcessComplexMultiplyAccumulate(segment.productInputFFT, segment.productIR, segment.outputFFT_buffer);
+
+		//Only the final half of the IFFT is the result. It is the output of the L samples that have just been received,
+		//which has to be played offset samples later, that is, offset - L + B samples after the first sample of the current output block
+		segment.FFTPlan.CalculateIFFT_HalfSpectrum(segment.outputFFT_buffer, segment.outputIFFT_buffer);
+		int position = storageOutput_head + segment.offset - L + inputSize;
+		if (position >= storageOutput_length) { position -= storageOutput_length; }
+		for (int i = 0; i < L; i++)
+		{
+			storageOutput[position] += segment.outputIFFT_buffer[L + i];
+			position++;
+			if (position == storageOutput_length) { position = 0; }
+		}
+	}
+
+	//Each subfilter is the FFT of B samples of the impulse response followed by B zeros, so the first half of its IFFT gives back those samples
+	void CNUPCEnvironment::CalculateImpulseResponse_Time(int _inputSize, const TImpulseResponse_Partitioned & IR, TImpulseResponse & IR_Time)
+	{
+		CFFTPlan subfilterPlan(2 * _inputSize);
+		std::vector<float> subfilter_Time;
+		IR_Time.clear();
+		IR_Time.reserve(IR.size() * _inputSize);
+		for (int i = 0; i < (int)IR.size(); i++)
+		{
+			ASSERT(IR[i].size() == 2 * (size_t)_inputSize + 2, RESULT_ERROR_BADSIZE, "Size of the subfilters doesn't match with the input size of the NUPC convolver", "");
+			if (IR[i].size() == 2 * (size_t)_inputSize + 2) {
+				subfilterPlan.CalculateIFFT_HalfSpectrum(IR[i], subfilter_Time);
+				IR_Time.insert(IR_Time.end(), subfilter_Time.begin(), subfilter_Time.begin() + _inputSize);
+			}
+			else {
+				IR_Time.insert(IR_Time.end(), _inputSize, 0.0f);
+			}
+		}
+	}
+
+	//Get the FFT of the input of one segment that is delay blocks of L samples older than the current one
+	const float* CNUPCEnvironment::GetInputFFT(const TSegment & segment, int delay) const
+	{
+		int slot = segment.storageInputFFT_head + delay;
+		if (slot >= segment.numberOfPartitions) { slot -= segment.numberOfPartitions; }
+		return segment.storageInputFFT_buffer.data() + slot * segment.slotLength;
+	}
+
+	//Move the head of the delay line of one segment one slot back, so the older FFTs are read going forward through the buffer
+	void CNUPCEnvironment::ProcessAdvanceInputFFT(TSegment & segment)
+	{
+		if (segment.storageInputFFT_head == 0) {
+			segment.storageInputFFT_head = segment.numberOfPartitions - 1;
+		}
+		else {
+			segment.storageInputFFT_head--;
+		}
+	}
+}//end namespace Common
@@ -0,0 +1,150 @@
+/**
+* \class CNUPCEnvironment
+*
+* \brief Declaration of CNUPCEnvironment class interface.
+* \date	October 2026
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#ifndef _CNUPCENVIRONMENT_H_
+#define _CNUPCENVIRONMENT_H_
+
+#include <vector>
+#include <Common/Fprocessor.h>
+#include <Common/FFTPlan.h>
+#include <Common/Buffer.h>
+#include <Common/AlignedAllocator.h>
+#include <Common/AIR.h>
+
+/** \brief Default number of partitions of each segment of the non-uniformly partitioned convolution
+*/
+#define DEFAULT_NUPC_PARTITIONS_PER_SEGMENT 16
+
+namespace Common {
+
+	/** \details This class implements a Non-Uniformly Partitioned Convolution algorithm (NUPC algorithm) of one input signal with the impulse responses of both ears, for reverb path.
+	*	The impulse response is split in segments of partitions of the same size. The first segment has partitions of the size of the input buffer (B),
+	*	and the partitions of each of the next segments are twice as long as the previous ones (2B, 4B, 8B...). Each segment is convolved with the UPC method,
+	*	but only when it has received as many input samples as its partition size, so the tail of long impulse responses is processed with few big partitions
+	*	while the latency is still one input buffer. The input FFTs of each segment are shared by both ears.
+	*	\details Garcia, G. (2002). Optimal filter partition for efficient convolution with short input/output delay. 113th AES Convention.
+	*/
+	class CNUPCEnvironment
+	{
+
+	public:
+
+		/** \brief Default constructor
+		*   \eh Nothing is reported to the error handler.
+		*/
+		CNUPCEnvironment();
+
+		/** \brief Initialize the class, calculate the partitions of the impulse responses and allocate memory.
+		*	\param [in] _inputSize size of the input signal buffer (B size). It has to be a power of two.
+		*	\param [in] leftIR_Time left ear impulse response in time domain
+		*	\param [in] rightIR_Time right ear impulse response in time domain. If the lengths of both impulse responses are different, the shorter one is extended with zeros
+		*	\param [in] _partitionsPerSegment number of partitions of each segment, 1 or more. Any number keeps the latency of one buffer, since the partitions of L samples start at least L - B samples after the beginning of the impulse response; more partitions per segment need fewer big FFTs.
+		*   \eh On success, RESULT_OK is reported to the error handler.
+		*       On error, an error code is reported to the error handler.
+		*/
+		void Setup(int _inputSize, const TImpulseResponse & leftIR_Time, const TImpulseResponse & rightIR_Time, int _partitionsPerSegment = DEFAULT_NUPC_PARTITIONS_PER_SEGMENT);
+
+		/** \brief Initialize the class, calculate the partitions of the impulse responses and allocate memory.
+		*   \details The impulse responses are given with the uniform partitions used by the UPC algorithm, for example the ones stored in CABIR.
+		*	\param [in] _inputSize size of the input signal buffer (B size). It has to be a power of two.
+		*	\param [in] leftIR left ear impulse response uniformly partitioned, each block with a size of 2*B + 2 (half spectrum of an FFT of 2*B points)
+		*	\param [in] rightIR right ear impulse response uniformly partitioned in the same way
+		*	\param [in] _partitionsPerSegment number of partitions of each segment, 1 or more. Any number keeps the latency of one buffer, since the partitions of L samples start at least L - B samples after the beginning of the impulse response; more partitions per segment need fewer big FFTs.
+		*   \eh On success, RESULT_OK is reported to the error handler.
+		*       On error, an error code is reported to the error handler.
+		*/
+		void Setup(int _inputSize, const TImpulseResponse_Partitioned & leftIR, const TImpulseResponse_Partitioned & rightIR, int _partitionsPerSegment = DEFAULT_NUPC_PARTITIONS_PER_SEGMENT);
+
+		/** \brief Make the Non-Uniformly Partitioned Convolution of the input signal with the impulse responses of both ears, adding the outputs to the buffers of the caller
+		*   \details The output buffers are not cleared, so the caller can accumulate the outputs of several convolvers in them.
+		*	\param [in] inBuffer_Time input signal buffer of B size
+		*	\param [in,out] outLeftBuffer left ear output signal of B size
+		*	\param [in,out] outRightBuffer right ear output signal of B size
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void ProcessNUPConvolution(const CMonoBuffer<float>& inBuffer_Time, CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer);
+
+		/** \brief Get the number of segments in which the impulse response has been split
+		*	\retval numberOfSegments number of segments, 0 if the class has not been set up
+		*   \eh Nothing is reported to the error handler.
+		*/
+		int GetNumberOfSegments() const;
+
+	private:
+		// Data of one segment of partitions of the same size
+		struct TSegment {
+			int partitionSize;								//Size of the partitions of this segment (L), a multiple of B
+			int numberOfPartitions;							//Number of partitions of this segment
+			int offset;										//Position in the impulse response of the first sample of this segment
+			int period;										//Number of input blocks needed to complete L samples (L / B)
+			int subfilterLength;							//Size of the half spectrum of the FFT of 2*L points, 2*L + 2
+			int slotLength;									//Distance between two subfilters or two input FFTs, rounded up to keep every one aligned
+			CFFTPlan FFTPlan;								//FFT tables of 2*L points
+			std::vector<float> inBuffer_Time_dobleSize;		//Previous L input samples followed by the current ones
+			CAlignedVector<float> subfilters;				//Half spectra of the partitions of this segment, one slot for each one, first the left ear ones and then the right ear ones
+			CAlignedVector<float> storageInputFFT_buffer;	//Frequency-domain delay line of this segment, shared by both ears
+			int storageInputFFT_head;						//Slot with the FFT of the current input. The FFT i blocks of L samples older is in the slot (head + i) % number of partitions
+			std::vector<float> outputFFT_buffer;			//To accumulate the products of the input FFTs and the subfilters
+			std::vector<float> outputIFFT_buffer;			//To store the IFFT of the accumulated products, 2*L samples
+			std::vector<const float*> productInputFFT;		//Input FFTs multiplied in each block
+			std::vector<const float*> productIR;			//Subfilters multiplied in each block
+		};
+
+		///////////////
+		// ATTRIBUTES
+		///////////////
+		int inputSize;									//Size of the inputs buffer (B)
+		int partitionsPerSegment;						//Number of partitions of each segment, the last one may have less
+		bool setupDone;
+
+		std::vector<TSegment> segments;					//Segments of the impulse response, with partitions of increasing size
+		std::vector<float> storageOutput_buffer;		//Ring buffers where every segment adds its outputs, in time domain, at the position where they have to be played. First the left ear one and then the right ear one
+		int storageOutput_length;						//Length of the ring buffer of each ear
+		int storageOutput_head;							//Position in the ring buffers of the output of the current block
+		int blockCounter;								//Number of input blocks processed, modulo the period of the last segment
+
+		///////////////
+		// METHODS
+		///////////////
+		//Prepare one segment and calculate the spectra of its partitions
+		void SetupSegment(TSegment & segment, const TImpulseResponse & leftIR_Time, const TImpulseResponse & rightIR_Time);
+
+		//Calculate the spectra of the partitions of one segment for one ear
+		void CalculateSegmentSubfilters(TSegment & segment, const TImpulseResponse & IR_Time, float* subfilters);
+
+		//Convolve the last L input samples with the partitions of one segment and add the results to the output ring buffers
+		void ProcessSegment(TSegment & segment);
+
+		//Multiply the input FFTs of one segment by its subfilters of one ear and add the result to the output ring buffer of that ear
+		void ProcessSegmentOutput(TSegment & segment, const float* subfilters, float* storageOutput);
+
+		//Convert a uniformly partitioned impulse response back to time domain
+		void CalculateImpulseResponse_Time(int _inputSize, const TImpulseResponse_Partitioned & IR, TImpulseResponse & IR_Time);
+
+		//Get the FFT of the input of one segment that is delay blocks of L samples older than the current one
+		const float* GetInputFFT(const TSegment & segment, int delay) const;
+
+		//Move the head of the delay line of one segment waiting for its next input
+		void ProcessAdvanceInputFFT(TSegment & segment);
+	};
+}//end namespace Common
+#endif
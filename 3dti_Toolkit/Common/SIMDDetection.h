@@ -0,0 +1,42 @@
+/**
+*
+* \brief Detection of the x86 instruction sets used by the vectorized FFT and convolution kernels. Internal header, only included by .cpp files
+* \date	October 2026
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#ifndef _SIMD_DETECTION_H_
+#define _SIMD_DETECTION_H_
+
+// FFT_X86_SIMD is defined when the target is x86, so the SSE2 and AVX2 kernels are compiled. Which of them is used is decided in run time with CFFTBackend::GetSIMDLevel.
+// FFT_TARGET_SSE2 and FFT_TARGET_AVX2 let GCC and Clang compile each kernel for its instruction set, without enabling it for the rest of the code. MSVC does not need them.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define FFT_X86_SIMD
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+#define FFT_TARGET_SSE2 __attribute__((target("sse2")))
+#define FFT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define FFT_TARGET_SSE2
+#define FFT_TARGET_AVX2
+#endif
+#endif
+
+#endif
@@ -23,6 +23,7 @@
 
 #include <Common/UPCEnvironment.h>
 #include <Common/ErrorHandler.h>
+#include <algorithm>
 
 namespace Common
 {
@@ -36,7 +37,7 @@ namespace Common
 	{
 		if (setupDone) {
 			//Second time that this method has been called - clear all buffers
-			storageInput_buffer.clear();
+			inBuffer_Time_dobleSize.clear();
 			storageInputFFT_buffer.clear();
 			storageHRIR_buffer.clear();
 		}
@@ -47,14 +48,21 @@ namespace Common
 		IR_Memory = _IRMemory;
 
 		//Prepare the buffer with the space that we are going to need	
-		storageInput_buffer.resize(inputSize, 0.0f);
+		inBuffer_Time_dobleSize.resize(2 * inputSize, 0.0f);
 
-		//Preparing the vector of buffers that is going to store the history of FFTs	
-		storageInputFFT_buffer.resize(IR_NumOfSubfilters);
-		for (int i = 0; i < IR_NumOfSubfilters; i++) {
-			storageInputFFT_buffer[i].resize(IR_Frequency_Block_Size, 0.0f);
-		}
-		it_storageInputFFT = storageInputFFT_buffer.begin();
+		//Prepare the FFT of the double size input buffer
+		FFTPlan.Setup(2 * inputSize);
+
+		//Preparing the frequency-domain delay line, one aligned buffer that is going to store the history of FFTs
+		storageInputFFT_slotLength = CalculateAlignedLength(IR_Frequency_Block_Size);
+		storageInputFFT_buffer.assign(IR_NumOfSubfilters * storageInputFFT_slotLength, 0.0f);
+		storageInputFFT_head = 0;
+
+		//Prepare the buffers used to multiply and accumulate the spectra of all the subfilters
+		outputFFT_buffer.resize(IR_Frequency_Block_Size, 0.0f);
+		outputIFFT_buffer.resize(2 * inputSize, 0.0f);
+		productInputFFT.reserve(IR_NumOfSubfilters);
+		productIR.reserve(IR_NumOfSubfilters);
 
 		//Preparing the vector of buffers that is going to store the history of the HRIR	
 		if (IR_Memory)
@@ -78,51 +86,31 @@ namespace Common
 
 	void CUPCEnvironment::ProcessUPConvolution(const CMonoBuffer<float>& inBuffer_Time, const TImpulseResponse_Partitioned & IR, CMonoBuffer<float>& outBuffer)
 	{
-		CMonoBuffer<float> sum;
-		sum.resize(IR_Frequency_Block_Size, 0.0f);
-		CMonoBuffer<float> temp;
-
 		if (inBuffer_Time.size() == inputSize) {
 
-			//Step 1- extend the input time signal buffer in order to have double length
-			std::vector<float> inBuffer_Time_dobleSize;
-			inBuffer_Time_dobleSize.reserve(inputSize * 2);
-			inBuffer_Time_dobleSize.insert(inBuffer_Time_dobleSize.begin(), storageInput_buffer.begin(), storageInput_buffer.end());
-			inBuffer_Time_dobleSize.insert(inBuffer_Time_dobleSize.end(), inBuffer_Time.begin(), inBuffer_Time.end());
-			storageInput_buffer = inBuffer_Time;			//Store current input signal
-
-															//Step 2,3 - FFT of the input signal
-			CMonoBuffer<float> inBuffer_Frequency;
-			Common::CFprocessor::CalculateFFT(inBuffer_Time_dobleSize, inBuffer_Frequency);
-			*it_storageInputFFT = inBuffer_Frequency;		//Store the new input FFT into the first FTT history buffers
+			//Step 1, 2, 3 - Extend the input signal to double length and store its FFT in the delay line
+			ProcessInputFFT(inBuffer_Time);
 
-															//Step 4, 5 - Multiplications and sums
-			auto it_product = it_storageInputFFT;
+			//Step 4, 5 - Multiplications and sums, all of them in one pass
+			productInputFFT.clear();
+			productIR.clear();
 
 			for (int i = 0; i < IR_NumOfSubfilters; i++) {
-				Common::CFprocessor::ProcessComplexMultiplication(*it_product, IR[i], temp);
-				sum += temp;
-				if (it_product == storageInputFFT_buffer.begin()) {
-					it_product = storageInputFFT_buffer.end() - 1;
+				if (IR[i].size() == (size_t)IR_Frequency_Block_Size) {
+					productInputFFT.push_back(GetInputFFT(i));
+					productIR.push_back(IR[i].data());
 				}
-				else {
-					it_product--;
-				}
-			}
-			//Move iterator waiting for the next input block
-			if (it_storageInputFFT == storageInputFFT_buffer.end() - 1) {
-				it_storageInputFFT = storageInputFFT_buffer.begin();
-			}
-			else {
-				it_storageInputFFT++;
 			}
+			std::fill(outputFFT_buffer.begin(), outputFFT_buffer.end(), 0.0f);
+			Common::CFprocessor::ProcessComplexMultiplyAccumulate(productInputFFT, productIR, outputFFT_buffer);
+
+			//Move the head of the delay line waiting for the next input block
+			ProcessAdvanceInputFFT();
+
 			// Make the IIF
-			CMonoBuffer<float> ouputBuffer_temp;
-			Common::CFprocessor::CalculateIFFT(sum, ouputBuffer_temp);
+			FFTPlan.CalculateIFFT_HalfSpectrum(outputFFT_buffer, outputIFFT_buffer);
 			//We are left only with the final half of the result
-			int halfsize = (int)(ouputBuffer_temp.size() * 0.5f);
-			CMonoBuffer<float> temp_OutputBlock(ouputBuffer_temp.begin() + halfsize, ouputBuffer_temp.end());
-			outBuffer = std::move(temp_OutputBlock);			//To use in C++11
+			outBuffer.assign(outputIFFT_buffer.begin() + inputSize, outputIFFT_buffer.end());
 
 		}
 		else {
@@ -132,57 +120,30 @@ namespace Common
 
 	void CUPCEnvironment::ProcessUPConvolution_withoutIFFT(const CMonoBuffer<float>& inBuffer_Time, const TImpulseResponse_Partitioned & IR, CMonoBuffer<float>& outBuffer, int numberOfSilencedFrames)
 	{
-		CMonoBuffer<float> sum;
-		sum.resize(IR_Frequency_Block_Size, 0.0f);
-		CMonoBuffer<float> temp;
-
-		CMonoBuffer<float> cero;
-		cero.resize(IR_Frequency_Block_Size, 0.0f);
-
 		ASSERT(inBuffer_Time.size() == inputSize, RESULT_ERROR_BADSIZE, "Bad input size, don't match with the size setting up in the setup method", "");
 
 		if (inBuffer_Time.size() == inputSize && IR.size() != 0 ) 
 		{
-			//Step 1- extend the input time signal buffer in order to have double length
-			std::vector<float> inBuffer_Time_dobleSize;
-			inBuffer_Time_dobleSize.reserve(inputSize * 2);
-			inBuffer_Time_dobleSize.insert(inBuffer_Time_dobleSize.begin(), storageInput_buffer.begin(), storageInput_buffer.end());
-			inBuffer_Time_dobleSize.insert(inBuffer_Time_dobleSize.end(), inBuffer_Time.begin(), inBuffer_Time.end());
-			storageInput_buffer = inBuffer_Time;			//Store current input signal
-
-															//Step 2,3 - FFT of the input signal
-			CMonoBuffer<float> inBuffer_Frequency;
-			Common::CFprocessor::CalculateFFT(inBuffer_Time_dobleSize, inBuffer_Frequency);
-			*it_storageInputFFT = inBuffer_Frequency;		//Store the new input FFT into the first FTT history buffers
-
-															//Step 4, 5 - Multiplications and sums
-			auto it_product = it_storageInputFFT;
-
-			for (int i = 0; i < IR_NumOfSubfilters; i++) {
-
-				if (i >= numberOfSilencedFrames)
-					Common::CFprocessor::ProcessComplexMultiplication(*it_product, IR[i], temp);
-				else
-					Common::CFprocessor::ProcessComplexMultiplication(*it_product, cero, temp);
-
-				sum += temp;
-				if (it_product == storageInputFFT_buffer.begin()) {
-					it_product = storageInputFFT_buffer.end() - 1;
+			//Step 1, 2, 3 - Extend the input signal to double length and store its FFT in the delay line
+			ProcessInputFFT(inBuffer_Time);
+
+			//Step 4, 5 - Multiplications and sums, all of them in one pass. The silenced partitions are skipped, not multiplied
+			productInputFFT.clear();
+			productIR.clear();
+
+			int numberOfSubfilters = std::min(IR_NumOfSubfilters, (int)IR.size());
+			for (int i = std::max(numberOfSilencedFrames, 0); i < numberOfSubfilters; i++) {
+				if (IR[i].size() == (size_t)IR_Frequency_Block_Size) {
+					productInputFFT.push_back(GetInputFFT(i));
+					productIR.push_back(IR[i].data());
 				}
-				else {
-					it_product--;
-				}
-			
-			}
-			//Move iterator waiting for the next input block
-			if (it_storageInputFFT == storageInputFFT_buffer.end() - 1) {
-				it_storageInputFFT = storageInputFFT_buffer.begin();
-			}
-			else {
-				it_storageInputFFT++;
 			}
-			//outBuffer.swap(temp);				//To use in C++03
-			outBuffer = std::move(sum);			//To use in C++11			
+			//Move the head of the delay line waiting for the next input block
+			ProcessAdvanceInputFFT();
+
+			//The output spectrum is accumulated directly in the output buffer
+			outBuffer.assign(IR_Frequency_Block_Size, 0.0f);
+			Common::CFprocessor::ProcessComplexMultiplyAccumulate(productInputFFT, productIR, outBuffer);
 		}
 		else 
 		{		
@@ -190,4 +151,38 @@ namespace Common
 			outBuffer.resize(inBuffer_Time.size(), 0.0f);
 		}
 	}//UPC_withoutIFFT
+
+	/////////////////////
+	// Private Methods //
+	/////////////////////
+
+	//Extend the input signal to double length with the previous block and calculate its FFT directly into the head slot of the delay line
+	void CUPCEnvironment::ProcessInputFFT(const CMonoBuffer<float>& inBuffer_Time)
+	{
+		//The first half keeps the previous input block and the second half the current one
+		std::copy(inBuffer_Time_dobleSize.begin() + inputSize, inBuffer_Time_dobleSize.end(), inBuffer_Time_dobleSize.begin());
+		std::copy(inBuffer_Time.begin(), inBuffer_Time.end(), inBuffer_Time_dobleSize.begin() + inputSize);
+
+		float* inBuffer_Frequency = storageInputFFT_buffer.data() + storageInputFFT_head * storageInputFFT_slotLength;
+		FFTPlan.CalculateFFT_HalfSpectrum(inBuffer_Time_dobleSize.data(), inBuffer_Time_dobleSize.size(), inBuffer_Frequency);
+	}
+
+	//Get the FFT of the input block that is delay blocks older than the current one
+	const float* CUPCEnvironment::GetInputFFT(int delay) const
+	{
+		int slot = storageInputFFT_head + delay;
+		if (slot >= IR_NumOfSubfilters) { slot -= IR_NumOfSubfilters; }
+		return storageInputFFT_buffer.data() + slot * storageInputFFT_slotLength;
+	}
+
+	//Move the head of the delay line one slot back, so the older FFTs are read going forward through the buffer
+	void CUPCEnvironment::ProcessAdvanceInputFFT()
+	{
+		if (storageInputFFT_head == 0) {
+			storageInputFFT_head = IR_NumOfSubfilters - 1;
+		}
+		else {
+			storageInputFFT_head--;
+		}
+	}
 }//end namespace Common
\ No newline at end of file
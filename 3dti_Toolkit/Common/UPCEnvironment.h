@@ -27,6 +27,7 @@
 #include <vector>
 #include <Common/Fprocessor.h>
 #include <Common/Buffer.h>
+#include <Common/AlignedAllocator.h>
 #include <Common/AIR.h>
 
 typedef std::vector<CMonoBuffer<float>> HRIR_partitioned;
@@ -48,7 +49,7 @@ namespace Common {
 		/** \brief Initialize the class and allocate memory.
 		*   \details When this method is called, the system initializes variables and allocates memory space for the buffer.
 		*	\param [in] _inputSize size of the input signal buffer (B size)
-		*	\param [in] _IR_Frequency_Block_Size size of the FTT Impulse Response blocks, this number is (2*B + k) = 2^n
+		*	\param [in] _IR_Frequency_Block_Size size of the FTT Impulse Response blocks, this number is 2*B + 2 (half spectrum of an FFT of 2*B points)
 		*	\param [in] _IR_Block_Number number of blocks in which is divided the the impluse response
 		*	\param [in] _IRMemory if true, the method with IR memory will be used (otherwise, the method without memory will be used instead)
 		*   \eh On success, RESULT_OK is reported to the error handler.
@@ -59,7 +60,7 @@ namespace Common {
 		*   \details This method make the convolution between the input signal and the partitioned IR using the UPC* method.
 		*   \details *Wefers, F. (2015). Partitioned convolution algorithms for real-time auralization (Vol. 20). Logos Verlag Berlin GmbH.
 		*	\param [in] inBuffer_Time input signal buffer of B size
-		*	\param [in] IR buffer structure that contains the Impulse Response partitioned in _HRIR_Block_Number blocks. Each block with a size of HRIR_Frequency_Block_Size size  = 2*B
+		*	\param [in] IR buffer structure that contains the Impulse Response partitioned in _HRIR_Block_Number blocks. Each block with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
 		*	\param [out] outBuffer output signal of B size
 		*   \throws May throw exceptions and errors to debugger
 		*/
@@ -69,8 +70,8 @@ namespace Common {
 		*   \details This method make the convolution between the input signal and the partitioned IR using the UPC* method, but return the FFT of the output.
 		*   \details *Wefers, F. (2015). Partitioned convolution algorithms for real-time auralization (Vol. 20). Logos Verlag Berlin GmbH.
 		*	\param [in] inBuffer_Time input signal buffer of B size
-		*	\param [in] IR buffer structure that contains the Impulse Response partitioned in _HRIR_Block_Number blocks. Each block with a size of HRIR_Frequency_Block_Size size  = 2*B
-		*	\param [out] outBuffer FFT of the output signal of 2*B size. After the IIFT is done only the last B samples are significant
+		*	\param [in] IR buffer structure that contains the Impulse Response partitioned in _HRIR_Block_Number blocks. Each block with a size of HRIR_Frequency_Block_Size size  = 2*B + 2
+		*	\param [out] outBuffer half spectrum of the output signal, of 2*B + 2 size. After the IIFT is done only the last B samples are significant
 		*   \param [in] numberOfSilencedFrames number of initial silenced frames in the reverb stage
 		*   \throws May throw exceptions and errors to debugger
 		*/
@@ -87,11 +88,29 @@ namespace Common {
 		bool IR_Memory;						//Indicate if HRTF storage buffer has to be prepared to do UPC with memory
 		bool setupDone;
 		
-		std::vector<float> storageInput_buffer;						//To store the last input signal
-		std::vector<vector<float>> storageInputFFT_buffer;			//To store the history of input signals FFTs 
-		std::vector<vector<float>>::iterator it_storageInputFFT;	//Declare a general iterator to keep the head of the FTTs buffer
+		std::vector<float> inBuffer_Time_dobleSize;					//To store the last two input signals, the previous one followed by the current one
+		CAlignedVector<float> storageInputFFT_buffer;				//Frequency-domain delay line: history of input signals FFTs, one slot of storageInputFFT_slotLength values for each subfilter
+		int storageInputFFT_slotLength;								//Distance between two slots of the delay line, rounded up to keep every slot aligned
+		int storageInputFFT_head;									//Slot with the FFT of the current input signal. The FFT i blocks older is in the slot (head + i) % number of subfilters
 		std::vector<HRIR_partitioned> storageHRIR_buffer;			//To store the HRIR of the orientation of the previous frames
 		std::vector<HRIR_partitioned>::iterator it_storageHRIR;		//Declare a general iterator to keep the head of the storageHRIR_buffer
+		Common::CFFTPlan FFTPlan;								//FFT tables of 2*B points, calculated once in the setup method
+		std::vector<float> outputFFT_buffer;						//To accumulate the products of the input FFTs and the subfilters
+		std::vector<float> outputIFFT_buffer;						//To store the IFFT of the accumulated products, 2*B samples
+		std::vector<const float*> productInputFFT;					//Input FFTs multiplied in the current block
+		std::vector<const float*> productIR;						//Subfilters multiplied in the current block
+
+		///////////////
+		// METHODS
+		///////////////
+		//Extend the input signal to double length and calculate its FFT directly into the head slot of the delay line
+		void ProcessInputFFT(const CMonoBuffer<float>& inBuffer_Time);
+
+		//Get the FFT of the input signal that is delay blocks older than the current one
+		const float* GetInputFFT(int delay) const;
+
+		//Move the head of the delay line waiting for the next input block
+		void ProcessAdvanceInputFFT();
 
 	};
 }//end namespace Common
@@ -0,0 +1,323 @@
+/**
+* \class CUPCEnvironmentAsyncTail
+*
+* \brief  Convolution of the tail of the reverb impulse responses in a worker thread
+* \date	October 2026
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+
+#include <Common/UPCEnvironmentAsyncTail.h>
+#include <Common/ErrorHandler.h>
+#include <algorithm>
+
+namespace Common
+{
+	CUPCEnvironmentAsyncTail::CUPCEnvironmentAsyncTail()
+	{
+		setupDone = false;
+		numberOfChannels = 0;
+		running = false;
+		numberOfLateBlocks = 0;
+		inputSlot = nullptr;
+		blockCounter = 0;
+	}
+
+	CUPCEnvironmentAsyncTail::~CUPCEnvironmentAsyncTail()
+	{
+		Stop();
+	}
+
+	void CUPCEnvironmentAsyncTail::Setup(int _inputSize, int _IR_Frequency_Block_Size, int _IR_Block_Number, int _headNumberOfBlocks, int _latencyBlocks, int _numberOfChannels)
+	{
+		Stop();
+		setupDone = false;
+
+		ASSERT(_latencyBlocks >= 1 && _latencyBlocks <= _headNumberOfBlocks, RESULT_ERROR_OUTOFRANGE, "The latency of the reverb tail has to be from one block to the number of blocks of the head", "");
+		ASSERT(_headNumberOfBlocks < _IR_Block_Number, RESULT_ERROR_OUTOFRANGE, "The head of the impulse response has to be shorter than the impulse response, otherwise there is no tail", "");
+		ASSERT(_numberOfChannels > 0, RESULT_ERROR_BADSIZE, "The reverb tail convolver needs at least one channel", "");
+
+		if ((_latencyBlocks >= 1) && (_latencyBlocks <= _headNumberOfBlocks) && (_headNumberOfBlocks < _IR_Block_Number) && (_numberOfChannels > 0))	//Just in case error handler is off
+		{
+			inputSize = _inputSize;
+			IR_Frequency_Block_Size = _IR_Frequency_Block_Size;
+			IR_NumOfSubfilters = _IR_Block_Number;
+			headNumberOfBlocks = _headNumberOfBlocks;
+			latencyBlocks = _latencyBlocks;
+			numberOfChannels = _numberOfChannels;
+
+			leftTailIR.assign(numberOfChannels, TImpulseResponse_Partitioned());
+			rightTailIR.assign(numberOfChannels, TImpulseResponse_Partitioned());
+
+			setupDone = true;
+			SET_RESULT(RESULT_OK, "Reverb tail convolver successfully set");
+		}
+	}//Setup
+
+	//The output of the tail for the block n + latency is calculated with the input of the block n, so the partition k of the IR is
+	//multiplied by the input FFT that is k - latency blocks older. That is, the IRs are moved latency blocks backward
+	void CUPCEnvironmentAsyncTail::SetImpulseResponse(int channel, const TImpulseResponse_Partitioned & leftIR, const TImpulseResponse_Partitioned & rightIR)
+	{
+		ASSERT(setupDone, RESULT_ERROR_NOTINITIALIZED, "The reverb tail convolver has not been set up", "");
+		ASSERT(channel >= 0 && channel < numberOfChannels, RESULT_ERROR_OUTOFRANGE, "Attempt to set the impulse response of a channel that has not been set up in the reverb tail convolver", "");
+		ASSERT(leftIR.size() == (size_t)IR_NumOfSubfilters && rightIR.size() == (size_t)IR_NumOfSubfilters, RESULT_ERROR_BADSIZE, "The number of subfilters of the impulse response doesn't match with the one setting up in the setup method", "");
+
+		if (setupDone && channel >= 0 && channel < numberOfChannels && leftIR.size() == (size_t)IR_NumOfSubfilters && rightIR.size() == (size_t)IR_NumOfSubfilters)	//Just in case error handler is off
+		{
+			//The partitions before the tail are left empty, they are never multiplied
+			leftTailIR[channel].assign(IR_NumOfSubfilters - latencyBlocks, TImpulseResponse());
+			rightTailIR[channel].assign(IR_NumOfSubfilters - latencyBlocks, TImpulseResponse());
+			for (int i = headNumberOfBlocks; i < IR_NumOfSubfilters; i++)
+			{
+				leftTailIR[channel][i - latencyBlocks] = leftIR[i];
+				rightTailIR[channel][i - latencyBlocks] = rightIR[i];
+			}
+		}
+	}
+
+	void CUPCEnvironmentAsyncTail::Start()
+	{
+		ASSERT(setupDone, RESULT_ERROR_NOTINITIALIZED, "The reverb tail convolver has not been set up", "");
+		if (!setupDone) { return; }		//Just in case error handler is off
+
+		for (int channel = 0; channel < numberOfChannels; channel++)
+		{
+			if (leftTailIR[channel].size() == 0 || rightTailIR[channel].size() == 0)
+			{
+				SET_RESULT(RESULT_ERROR_NOTSET, "The impulse responses of all the channels have to be set before starting the reverb tail convolver");
+				return;
+			}
+		}
+		Stop();
+
+		//Data of the worker thread
+		tailConvolution.Setup(inputSize, IR_Frequency_Block_Size, IR_NumOfSubfilters - latencyBlocks, numberOfChannels);
+		workerInput.assign(numberOfChannels, CMonoBuffer<float>(inputSize, 0.0f));
+		workerInputs.clear();
+		workerLeftIRs.clear();
+		workerRightIRs.clear();
+		for (int channel = 0; channel < numberOfChannels; channel++)
+		{
+			workerInputs.push_back(&workerInput[channel]);
+			workerLeftIRs.push_back(&leftTailIR[channel]);
+			workerRightIRs.push_back(&rightTailIR[channel]);
+		}
+		leftTail_Frequency.assign(IR_Frequency_Block_Size, 0.0f);
+		rightTail_Frequency.assign(IR_Frequency_Block_Size, 0.0f);
+		FFTPlan.Setup(2 * inputSize);
+		outputIFFT_buffer.assign(2 * inputSize, 0.0f);
+		expectedSequence = 0;
+
+		//The rings have room for some blocks more than the latency, so the worker thread can be late for a while without losing inputs
+		SetupRing(inputRing, numberOfChannels * inputSize, 2 * latencyBlocks + 2);
+		SetupRing(outputRing, 2 * inputSize, 2 * latencyBlocks + 2);
+		numberOfLateBlocks = 0;
+		inputSlot = nullptr;
+		blockCounter = 0;
+
+		running = true;
+		workerThread = std::thread(&CUPCEnvironmentAsyncTail::ProcessWorkerLoop, this);
+		SET_RESULT(RESULT_OK, "Reverb tail convolver successfully started");
+	}
+
+	void CUPCEnvironmentAsyncTail::Stop()
+	{
+		if (workerThread.joinable())
+		{
+			running = false;
+			NotifyWorker();
+			workerThread.join();
+		}
+		running = false;
+	}
+
+	bool CUPCEnvironmentAsyncTail::IsRunning() const
+	{
+		return running;
+	}
+
+	void CUPCEnvironmentAsyncTail::SetInput(int channel, const CMonoBuffer<float>& inBuffer_Time)
+	{
+		ASSERT(channel >= 0 && channel < numberOfChannels, RESULT_ERROR_OUTOFRANGE, "Attempt to convolve a channel that has not been set up in the reverb tail convolver", "");
+		ASSERT(inBuffer_Time.size() == (size_t)inputSize, RESULT_ERROR_BADSIZE, "Bad input size, don't match with the size setting up in the setup method", "");
+
+		if (running && channel >= 0 && channel < numberOfChannels && inBuffer_Time.size() == (size_t)inputSize)	//Just in case error handler is off
+		{
+			//The slot is taken with the first channel of each block. If the ring is full, the inputs of this block are lost
+			if (inputSlot == nullptr) {
+				inputSlot = GetWriteSlot(inputRing);
+				if (inputSlot != nullptr) { std::fill(inputSlot, inputSlot + numberOfChannels * inputSize, 0.0f); }
+			}
+			if (inputSlot != nullptr) {
+				std::copy(inBuffer_Time.begin(), inBuffer_Time.end(), inputSlot + channel * inputSize);
+			}
+		}
+	}
+
+	void CUPCEnvironmentAsyncTail::ProcessTailOutput(CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer, int numberOfSilencedFrames)
+	{
+		ASSERT(outLeftBuffer.size() == (size_t)inputSize && outRightBuffer.size() == (size_t)inputSize, RESULT_ERROR_BADSIZE, "Bad output size, don't match with the size setting up in the setup method", "");
+		if (!running || outLeftBuffer.size() != (size_t)inputSize || outRightBuffer.size() != (size_t)inputSize) { return; }	//Just in case error handler is off
+
+		//Send the inputs of this block to the worker thread
+		if (inputSlot != nullptr)
+		{
+			CommitWrite(inputRing, blockCounter, numberOfSilencedFrames);
+			inputSlot = nullptr;
+			NotifyWorker();
+		}
+
+		//Look for the tail of this block, the older ones that were late are discarded
+		long long sequence;
+		int silencedFrames;
+		const float* outputSlot;
+		bool tailFound = false;
+		while ((outputSlot = GetReadSlot(outputRing, sequence, silencedFrames)) != nullptr && sequence <= blockCounter)
+		{
+			if (sequence == blockCounter)
+			{
+				for (int i = 0; i < inputSize; i++)
+				{
+					outLeftBuffer[i] += outputSlot[i];
+					outRightBuffer[i] += outputSlot[inputSize + i];
+				}
+				tailFound = true;
+			}
+			CommitRead(outputRing);
+		}
+
+		//The tail of the first blocks only depends on previous inputs, which are silence
+		if (!tailFound && blockCounter >= latencyBlocks)
+		{
+			numberOfLateBlocks++;		//Not reported to the error handler, which would build a string and lock its mutex in the audio thread
+		}
+		blockCounter++;
+	}
+
+	int CUPCEnvironmentAsyncTail::GetNumberOfLateBlocks() const
+	{
+		return numberOfLateBlocks;
+	}
+
+	/////////////////////
+	// Private Methods //
+	/////////////////////
+
+	//The worker thread sleeps until there is some input in the ring or it is stopped. The convolutions are done without the mutex
+	void CUPCEnvironmentAsyncTail::ProcessWorkerLoop()
+	{
+		while (running)
+		{
+			ProcessPendingInputs();
+
+			std::unique_lock<std::mutex> lock(workerMutex);
+			workerCondition.wait(lock, [this] { return !running || !IsRingEmpty(inputRing); });
+		}
+	}
+
+	void CUPCEnvironmentAsyncTail::NotifyWorker()
+	{
+		//The worker thread holds the mutex from the moment it checks the ring until it waits, so the notification arrives after that
+		{ std::lock_guard<std::mutex> lock(workerMutex); }
+		workerCondition.notify_one();
+	}
+
+	void CUPCEnvironmentAsyncTail::ProcessPendingInputs()
+	{
+		long long sequence;
+		int silencedFrames;
+		const float* slot;
+		while (running && (slot = GetReadSlot(inputRing, sequence, silencedFrames)) != nullptr)
+		{
+			//If some blocks were lost the input FFTs in the delay lines are not consecutive, so they are cleared
+			if (sequence != expectedSequence) {
+				tailConvolution.ResetBuffers();
+			}
+			expectedSequence = sequence + 1;
+
+			//Only the partitions of the tail are multiplied, the previous ones are treated as silenced
+			std::fill(leftTail_Frequency.begin(), leftTail_Frequency.end(), 0.0f);
+			std::fill(rightTail_Frequency.begin(), rightTail_Frequency.end(), 0.0f);
+			for (int channel = 0; channel < numberOfChannels; channel++)
+			{
+				std::copy(slot + channel * inputSize, slot + (channel + 1) * inputSize, workerInput[channel].begin());
+			}
+			CommitRead(inputRing);
+			//The IRs are moved latencyBlocks backward, and the silenced frames are skipped only when they reach the tail
+			int firstPartition = std::max(headNumberOfBlocks, silencedFrames) - latencyBlocks;
+			tailConvolution.ProcessUPConvolution_withoutIFFT(workerInputs, workerLeftIRs, workerRightIRs, leftTail_Frequency, rightTail_Frequency, firstPartition);
+
+			//Only one IFFT per ear, the final half of the result is the output of the tail for the block latencyBlocks later
+			float* outputSlot = GetWriteSlot(outputRing);
+			if (outputSlot != nullptr)
+			{
+				FFTPlan.CalculateIFFT_HalfSpectrum(leftTail_Frequency, outputIFFT_buffer);
+				std::copy(outputIFFT_buffer.begin() + inputSize, outputIFFT_buffer.end(), outputSlot);
+				FFTPlan.CalculateIFFT_HalfSpectrum(rightTail_Frequency, outputIFFT_buffer);
+				std::copy(outputIFFT_buffer.begin() + inputSize, outputIFFT_buffer.end(), outputSlot + inputSize);
+				CommitWrite(outputRing, sequence + latencyBlocks, 0);
+			}
+		}
+	}
+
+	void CUPCEnvironmentAsyncTail::SetupRing(TRing & ring, int blockLength, int numberOfSlots)
+	{
+		ring.slotLength = CalculateAlignedLength(blockLength);
+		ring.numberOfSlots = numberOfSlots;
+		ring.buffer.assign(numberOfSlots * ring.slotLength, 0.0f);
+		ring.sequence.assign(numberOfSlots, 0);
+		ring.silencedFrames.assign(numberOfSlots, 0);
+		ring.writeIndex = 0;
+		ring.readIndex = 0;
+	}
+
+	float* CUPCEnvironmentAsyncTail::GetWriteSlot(TRing & ring)
+	{
+		int writeIndex = ring.writeIndex.load(std::memory_order_relaxed);
+		int nextIndex = (writeIndex + 1) % ring.numberOfSlots;
+		if (nextIndex == ring.readIndex.load(std::memory_order_acquire)) { return nullptr; }
+		return ring.buffer.data() + writeIndex * ring.slotLength;
+	}
+
+	void CUPCEnvironmentAsyncTail::CommitWrite(TRing & ring, long long sequence, int silencedFrames)
+	{
+		int writeIndex = ring.writeIndex.load(std::memory_order_relaxed);
+		ring.sequence[writeIndex] = sequence;
+		ring.silencedFrames[writeIndex] = silencedFrames;
+		ring.writeIndex.store((writeIndex + 1) % ring.numberOfSlots, std::memory_order_release);
+	}
+
+	const float* CUPCEnvironmentAsyncTail::GetReadSlot(TRing & ring, long long & sequence, int & silencedFrames)
+	{
+		int readIndex = ring.readIndex.load(std::memory_order_relaxed);
+		if (readIndex == ring.writeIndex.load(std::memory_order_acquire)) { return nullptr; }
+		sequence = ring.sequence[readIndex];
+		silencedFrames = ring.silencedFrames[readIndex];
+		return ring.buffer.data() + readIndex * ring.slotLength;
+	}
+
+	bool CUPCEnvironmentAsyncTail::IsRingEmpty(const TRing & ring) const
+	{
+		return ring.readIndex.load(std::memory_order_relaxed) == ring.writeIndex.load(std::memory_order_acquire);
+	}
+
+	void CUPCEnvironmentAsyncTail::CommitRead(TRing & ring)
+	{
+		int readIndex = ring.readIndex.load(std::memory_order_relaxed);
+		ring.readIndex.store((readIndex + 1) % ring.numberOfSlots, std::memory_order_release);
+	}
+}//end namespace Common
@@ -0,0 +1,204 @@
+/**
+* \class CUPCEnvironmentAsyncTail
+*
+* \brief Declaration of CUPCEnvironmentAsyncTail class interface.
+* \date	October 2026
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#ifndef _CUPCENVIRONMENTASYNCTAIL_H_
+#define _CUPCENVIRONMENTASYNCTAIL_H_
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <Common/UPCEnvironmentMultichannel.h>
+#include <Common/FFTPlan.h>
+#include <Common/Buffer.h>
+#include <Common/AlignedAllocator.h>
+#include <Common/AIR.h>
+
+namespace Common {
+
+	/** \details This class convolves the tail of the impulse responses of several input channels, for example the b-format channels of the reverb path,
+	*	in a worker thread, so the audio thread only has to convolve their head.
+	*	The impulse responses are uniformly partitioned. The first partitions (head) are convolved by the caller, and this class convolves the rest of them (tail).
+	*	The input blocks of the audio thread are sent to the worker thread, and the outputs of the tail are sent back, through two lock-free rings,
+	*	so the audio thread never waits for a convolution: it only locks a mutex to wake up the worker thread, which holds it only while it checks the input ring. The output of the tail is calculated some blocks (latency) before it has to be played,
+	*	so the worker thread has that number of blocks to do it. If it is late, that block of the tail is lost and counted.
+	*	\details The latency can not be longer than the head, because the output of the tail for the block n + latency only needs the inputs up to the block n + latency - head.
+	*/
+	class CUPCEnvironmentAsyncTail
+	{
+
+	public:
+
+		/** \brief Default constructor
+		*   \eh Nothing is reported to the error handler.
+		*/
+		CUPCEnvironmentAsyncTail();
+
+		/** \brief Destructor. The worker thread is stopped
+		*   \eh Nothing is reported to the error handler.
+		*/
+		~CUPCEnvironmentAsyncTail();
+
+		/** \brief Stop the worker thread, if it is running, and configure the class for new impulse responses
+		*	\param [in] _inputSize size of the input signal buffer (B size)
+		*	\param [in] _IR_Frequency_Block_Size size of the FTT Impulse Response blocks, this number is 2*B + 2 (half spectrum of an FFT of 2*B points)
+		*	\param [in] _IR_Block_Number number of blocks in which are divided the impluse responses, head and tail
+		*	\param [in] _headNumberOfBlocks number of blocks of the head, that are not convolved by this class
+		*	\param [in] _latencyBlocks number of blocks that the output of the tail is calculated in advance. It has to be from 1 to the number of blocks of the head.
+		*	\param [in] _numberOfChannels number of input channels
+		*   \eh On success, RESULT_OK is reported to the error handler.
+		*       On error, an error code is reported to the error handler.
+		*/
+		void Setup(int _inputSize, int _IR_Frequency_Block_Size, int _IR_Block_Number, int _headNumberOfBlocks, int _latencyBlocks, int _numberOfChannels);
+
+		/** \brief Set the impulse responses of one channel. Only the partitions of the tail are copied
+		*	\param [in] channel input channel, from 0 to the number of channels - 1
+		*	\param [in] leftIR left ear impulse response of this channel, partitioned in _IR_Block_Number blocks
+		*	\param [in] rightIR right ear impulse response of this channel, partitioned in _IR_Block_Number blocks
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void SetImpulseResponse(int channel, const TImpulseResponse_Partitioned & leftIR, const TImpulseResponse_Partitioned & rightIR);
+
+		/** \brief Start the worker thread, once the impulse responses of all the channels have been set
+		*   \eh On success, RESULT_OK is reported to the error handler.
+		*       On error, an error code is reported to the error handler.
+		*/
+		void Start();
+
+		/** \brief Stop the worker thread, waiting for it to finish the block it is processing
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void Stop();
+
+		/** \brief Get the state of the worker thread
+		*	\retval running true if the worker thread has been started and not stopped
+		*   \eh Nothing is reported to the error handler.
+		*/
+		bool IsRunning() const;
+
+		/** \brief Send the input of one channel for the current block to the worker thread. To be called from the audio thread
+		*	\details The input of all the channels is sent to the worker thread when ProcessTailOutput is called
+		*	\param [in] channel input channel, from 0 to the number of channels - 1
+		*	\param [in] inBuffer_Time input signal buffer of B size
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void SetInput(int channel, const CMonoBuffer<float>& inBuffer_Time);
+
+		/** \brief Send the inputs of the current block to the worker thread and add the output of the tail for the current block to the buffers of the caller. To be called from the audio thread
+		*	\details If the tail of the current block is not ready, the block is played without tail and only the counter of GetNumberOfLateBlocks is incremented.
+		*	The number of silenced frames is sent with the inputs, so it is applied to the tail calculated with them, which is played latency blocks later.
+		*	\param [in,out] outLeftBuffer left ear output signal of B size
+		*	\param [in,out] outRightBuffer right ear output signal of B size
+		*   \param [in] numberOfSilencedFrames number of initial partitions of the impulse responses that are not convolved. Only the ones after the head are skipped by this class
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void ProcessTailOutput(CMonoBuffer<float>& outLeftBuffer, CMonoBuffer<float>& outRightBuffer, int numberOfSilencedFrames = 0);
+
+		/** \brief Get the number of blocks whose tail was not ready when it had to be played, since the worker thread was started
+		*	\retval numberOfLateBlocks number of blocks played without tail
+		*   \eh Nothing is reported to the error handler.
+		*/
+		int GetNumberOfLateBlocks() const;
+
+	private:
+		// Lock-free ring of blocks, with one producer thread and one consumer thread
+		struct TRing {
+			CAlignedVector<float> buffer;			//Blocks of the ring, one after the other
+			std::vector<long long> sequence;		//Number of the block stored in each slot
+			std::vector<int> silencedFrames;		//Number of silenced frames of the block stored in each slot
+			int slotLength;							//Distance between two blocks, rounded up to keep every one aligned
+			int numberOfSlots;						//Number of blocks of the ring, one of them is always empty
+			std::atomic<int> writeIndex;			//Slot where the producer writes the next block
+			std::atomic<int> readIndex;				//Slot where the consumer reads the next block
+		};
+
+		///////////////
+		// ATTRIBUTES
+		///////////////
+		int inputSize;								//Size of the inputs buffer
+		int IR_Frequency_Block_Size;				//Size of the subfilters
+		int IR_NumOfSubfilters;						//Number of blocks in which are divided the IRs, head and tail
+		int headNumberOfBlocks;						//Number of blocks of the head of the IRs
+		int latencyBlocks;							//Number of blocks that the output of the tail is calculated in advance
+		int numberOfChannels;						//Number of input channels
+		bool setupDone;
+
+		//Data of the worker thread
+		std::vector<TImpulseResponse_Partitioned> leftTailIR;		//For each channel, the left IR moved latencyBlocks backward. Its first partitions, until the tail, are empty
+		std::vector<TImpulseResponse_Partitioned> rightTailIR;		//For each channel, the right IR moved latencyBlocks backward
+		CUPCEnvironmentMultichannel tailConvolution;				//UPC of all the channels with the partitions of the tail
+		std::vector<CMonoBuffer<float>> workerInput;				//Input of each channel in the block that is being processed
+		std::vector<const CMonoBuffer<float>*> workerInputs;		//Pointers to the inputs, to convolve all the channels at once
+		std::vector<const TImpulseResponse_Partitioned*> workerLeftIRs;		//Pointers to the left IR of each channel
+		std::vector<const TImpulseResponse_Partitioned*> workerRightIRs;	//Pointers to the right IR of each channel
+		std::vector<float> leftTail_Frequency;						//Half spectrum where the tail of all the channels is mixed, left ear
+		std::vector<float> rightTail_Frequency;						//Half spectrum where the tail of all the channels is mixed, right ear
+		CFFTPlan FFTPlan;											//FFT tables of 2*B points, to do the IFFT of the mixed spectra
+		std::vector<float> outputIFFT_buffer;						//IFFT of one of the mixed spectra, 2*B samples
+		long long expectedSequence;									//Number of the next input block, to detect the blocks that were not sent
+
+		//Data shared by both threads
+		TRing inputRing;							//Inputs of all the channels, from the audio thread to the worker thread
+		TRing outputRing;							//Outputs of the tail of both ears, from the worker thread to the audio thread
+		std::atomic<bool> running;					//The worker thread keeps running while it is true
+		std::atomic<int> numberOfLateBlocks;		//Number of blocks whose tail was not ready
+		std::thread workerThread;
+		std::mutex workerMutex;						//Held by the worker thread only while it checks the input ring before waiting, so the audio thread never waits for a convolution
+		std::condition_variable workerCondition;	//Notified by the audio thread when there is a new input, and when the worker thread is stopped
+
+		//Data of the audio thread
+		float* inputSlot;							//Slot of the input ring where the inputs of the current block are being written, null if the ring is full
+		long long blockCounter;						//Number of the current block
+
+		///////////////
+		// METHODS
+		///////////////
+		//Main loop of the worker thread
+		void ProcessWorkerLoop();
+
+		//Convolve all the inputs that are waiting in the input ring. Called by the worker thread
+		void ProcessPendingInputs();
+
+		//Wake up the worker thread. The mutex is locked before the notification, so it is not lost if the worker thread is going to wait
+		void NotifyWorker();
+
+		//Prepare one ring of empty blocks
+		void SetupRing(TRing & ring, int blockLength, int numberOfSlots);
+
+		//Get the slot where the next block has to be written, null if the ring is full. Called by the producer
+		float* GetWriteSlot(TRing & ring);
+
+		//Make the block written in the write slot visible to the consumer. Called by the producer
+		void CommitWrite(TRing & ring, long long sequence, int silencedFrames);
+
+		//Get the oldest block of the ring, null if it is empty. Called by the consumer
+		const float* GetReadSlot(TRing & ring, long long & sequence, int & silencedFrames);
+
+		//Check whether the ring has some block. Called by the consumer
+		bool IsRingEmpty(const TRing & ring) const;
+
+		//Free the oldest block of the ring. Called by the consumer
+		void CommitRead(TRing & ring);
+	};
+}//end namespace Common
+#endif
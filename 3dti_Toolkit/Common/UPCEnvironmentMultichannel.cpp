@@ -0,0 +1,249 @@
+/**
+* \class CUPCEnvironmentMultichannel
+*
+* \brief  Uniformly Partitioned Convolution Algorithm (UPC algorithm) of several input channels with the impulse responses of both ears
+* \date	October 2026
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+
+#include <Common/UPCEnvironmentMultichannel.h>
+#include <Common/ErrorHandler.h>
+#include <algorithm>
+
+namespace Common
+{
+	CUPCEnvironmentMultichannel::CUPCEnvironmentMultichannel()
+	{
+		setupDone = false;
+		numberOfChannels = 0;
+	}
+
+	//Initialize the class and allocate memory.
+	void CUPCEnvironmentMultichannel::Setup(int _inputSize, int _IR_Frequency_Block_Size, int _IR_Block_Number, int _numberOfChannels)
+	{
+		ASSERT(_numberOfChannels > 0, RESULT_ERROR_BADSIZE, "The multichannel UPC convolver needs at least one channel", "");
+
+		if (_numberOfChannels > 0)	//Just in case error handler is off
+		{
+			inputSize = _inputSize;
+			IR_Frequency_Block_Size = _IR_Frequency_Block_Size;
+			IR_NumOfSubfilters = _IR_Block_Number;
+			numberOfChannels = _numberOfChannels;
+
+			//Prepare the buffer with the space that we are going to need, the last two input blocks of each channel
+			inBuffer_Time_dobleSize.assign(numberOfChannels * 2 * inputSize, 0.0f);
+
+			//Prepare the FFT of the double size input buffer
+			FFTPlan.Setup(2 * inputSize);
+
+			//Preparing the frequency-domain delay lines, one after the other in one aligned buffer
+			storageInputFFT_slotLength = CalculateAlignedLength(IR_Frequency_Block_Size);
+			storageInputFFT_buffer.assign(numberOfChannels * IR_NumOfSubfilters * storageInputFFT_slotLength, 0.0f);
+			storageInputFFT_head.assign(numberOfChannels, 0);
+
+			//Prepare the buffers used to multiply and accumulate the spectra of all the subfilters
+			productInputFFT.reserve(IR_NumOfSubfilters);
+			productIR.reserve(IR_NumOfSubfilters);
+			batchInput.reserve(numberOfChannels);
+			batchOutput.reserve(numberOfChannels);
+			FFTPlan.SetupBatch(numberOfChannels);
+
+			setupDone = true;
+			SET_RESULT(RESULT_OK, "Multichannel UPC convolver successfully set");
+		}
+	}//Setup
+
+	//Clear the buffers prepared by the Setup method, without allocating memory
+	void CUPCEnvironmentMultichannel::ResetBuffers()
+	{
+		if (!setupDone) { return; }
+		std::fill(inBuffer_Time_dobleSize.begin(), inBuffer_Time_dobleSize.end(), 0.0f);
+		std::fill(storageInputFFT_buffer.begin(), storageInputFFT_buffer.end(), 0.0f);
+		std::fill(storageInputFFT_head.begin(), storageInputFFT_head.end(), 0);
+	}
+
+	void CUPCEnvironmentMultichannel::ProcessUPConvolution_withoutIFFT(int channel, const CMonoBuffer<float>& inBuffer_Time, const TImpulseResponse_Partitioned & leftIR, const TImpulseResponse_Partitioned & rightIR, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency, int numberOfSilencedFrames)
+	{
+		ASSERT(setupDone, RESULT_ERROR_NOTINITIALIZED, "The multichannel UPC convolver has not been set up", "");
+		ASSERT(channel >= 0 && channel < numberOfChannels, RESULT_ERROR_OUTOFRANGE, "Attempt to convolve a channel that has not been set up in the multichannel UPC convolver", "");
+		ASSERT(inBuffer_Time.size() == (size_t)inputSize, RESULT_ERROR_BADSIZE, "Bad input size, don't match with the size setting up in the setup method", "");
+		ASSERT(outLeftBuffer_Frequency.size() == (size_t)IR_Frequency_Block_Size && outRightBuffer_Frequency.size() == (size_t)IR_Frequency_Block_Size, RESULT_ERROR_BADSIZE, "Bad output size, don't match with the size setting up in the setup method", "");
+
+		if (setupDone && channel >= 0 && channel < numberOfChannels && inBuffer_Time.size() == (size_t)inputSize &&
+			outLeftBuffer_Frequency.size() == (size_t)IR_Frequency_Block_Size && outRightBuffer_Frequency.size() == (size_t)IR_Frequency_Block_Size)	//Just in case error handler is off
+		{
+			//Step 1, 2, 3 - Extend the input signal to double length and store its FFT in the delay line of this channel
+			ProcessInputFFT(channel, inBuffer_Time);
+
+			//Step 4, 5 - Multiplications and sums of both ears, with the same input FFTs, directly over the output buffers
+			ProcessMultiplyAccumulate(channel, leftIR, rightIR, outLeftBuffer_Frequency, outRightBuffer_Frequency, numberOfSilencedFrames);
+		}
+	}//ProcessUPConvolution_withoutIFFT
+
+	void CUPCEnvironmentMultichannel::ProcessUPConvolution_withoutIFFT(const std::vector<const CMonoBuffer<float>*>& inBuffers_Time, const std::vector<const TImpulseResponse_Partitioned*>& leftIRs, const std::vector<const TImpulseResponse_Partitioned*>& rightIRs, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency, int numberOfSilencedFrames)
+	{
+		ASSERT(setupDone, RESULT_ERROR_NOTINITIALIZED, "The multichannel UPC convolver has not been set up", "");
+		ASSERT(inBuffers_Time.size() == (size_t)numberOfChannels && leftIRs.size() == (size_t)numberOfChannels && rightIRs.size() == (size_t)numberOfChannels, RESULT_ERROR_BADSIZE, "The number of inputs and impulse responses has to be the number of channels setting up in the setup method", "");
+		ASSERT(outLeftBuffer_Frequency.size() == (size_t)IR_Frequency_Block_Size && outRightBuffer_Frequency.size() == (size_t)IR_Frequency_Block_Size, RESULT_ERROR_BADSIZE, "Bad output size, don't match with the size setting up in the setup method", "");
+
+		if (setupDone && inBuffers_Time.size() == (size_t)numberOfChannels && leftIRs.size() == (size_t)numberOfChannels && rightIRs.size() == (size_t)numberOfChannels &&
+			outLeftBuffer_Frequency.size() == (size_t)IR_Frequency_Block_Size && outRightBuffer_Frequency.size() == (size_t)IR_Frequency_Block_Size)	//Just in case error handler is off
+		{
+			//Step 1, 2, 3 - Extend the input signals to double length and store their FFTs, all of them calculated at once, in the delay line of each channel
+			if (!ProcessBatchInputFFT(inBuffers_Time)) { return; }
+
+			//Step 4, 5 - Multiplications and sums of both ears, with the same input FFTs, directly over the output buffers
+			for (int channel = 0; channel < numberOfChannels; channel++)
+			{
+				ProcessMultiplyAccumulate(channel, *leftIRs[channel], *rightIRs[channel], outLeftBuffer_Frequency, outRightBuffer_Frequency, numberOfSilencedFrames);
+			}
+		}
+	}//ProcessUPConvolution_withoutIFFT
+
+	void CUPCEnvironmentMultichannel::ProcessUPConvolution_withoutIFFT(const std::vector<const CMonoBuffer<float>*>& inBuffers_Time, const std::vector<const TImpulseResponse_Partitioned*>& leftIRs, const std::vector<const TImpulseResponse_Partitioned*>& rightIRs, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency,
+		const std::vector<const TImpulseResponse_Partitioned*>& secondLeftIRs, const std::vector<const TImpulseResponse_Partitioned*>& secondRightIRs, std::vector<float>& secondOutLeftBuffer_Frequency, std::vector<float>& secondOutRightBuffer_Frequency, int numberOfSilencedFrames)
+	{
+		ASSERT(setupDone, RESULT_ERROR_NOTINITIALIZED, "The multichannel UPC convolver has not been set up", "");
+		ASSERT(inBuffers_Time.size() == (size_t)numberOfChannels && leftIRs.size() == (size_t)numberOfChannels && rightIRs.size() == (size_t)numberOfChannels && secondLeftIRs.size() == (size_t)numberOfChannels && secondRightIRs.size() == (size_t)numberOfChannels, RESULT_ERROR_BADSIZE, "The number of inputs and impulse responses has to be the number of channels setting up in the setup method", "");
+		ASSERT(outLeftBuffer_Frequency.size() == (size_t)IR_Frequency_Block_Size && outRightBuffer_Frequency.size() == (size_t)IR_Frequency_Block_Size && secondOutLeftBuffer_Frequency.size() == (size_t)IR_Frequency_Block_Size && secondOutRightBuffer_Frequency.size() == (size_t)IR_Frequency_Block_Size, RESULT_ERROR_BADSIZE, "Bad output size, don't match with the size setting up in the setup method", "");
+
+		if (setupDone && inBuffers_Time.size() == (size_t)numberOfChannels && leftIRs.size() == (size_t)numberOfChannels && rightIRs.size() == (size_t)numberOfChannels && secondLeftIRs.size() == (size_t)numberOfChannels && secondRightIRs.size() == (size_t)numberOfChannels &&
+			outLeftBuffer_Frequency.size() == (size_t)IR_Frequency_Block_Size && outRightBuffer_Frequency.size() == (size_t)IR_Frequency_Block_Size &&
+			secondOutLeftBuffer_Frequency.size() == (size_t)IR_Frequency_Block_Size && secondOutRightBuffer_Frequency.size() == (size_t)IR_Frequency_Block_Size)	//Just in case error handler is off
+		{
+			//Step 1, 2, 3 - The FFTs of the inputs are calculated once for both sets of impulse responses
+			if (!ProcessBatchInputFFT(inBuffers_Time)) { return; }
+
+			//Step 4, 5 - Multiplications and sums of both ears and both sets, with the same input FFTs, before the delay lines are moved
+			for (int channel = 0; channel < numberOfChannels; channel++)
+			{
+				SelectInputFFTs(channel, numberOfSilencedFrames);
+				ProcessMultiplyAccumulate(*leftIRs[channel], outLeftBuffer_Frequency);
+				ProcessMultiplyAccumulate(*rightIRs[channel], outRightBuffer_Frequency);
+				ProcessMultiplyAccumulate(*secondLeftIRs[channel], secondOutLeftBuffer_Frequency);
+				ProcessMultiplyAccumulate(*secondRightIRs[channel], secondOutRightBuffer_Frequency);
+				ProcessAdvanceInputFFT(channel);
+			}
+		}
+	}//ProcessUPConvolution_withoutIFFT
+
+	int CUPCEnvironmentMultichannel::GetNumberOfChannels() const
+	{
+		return numberOfChannels;
+	}
+
+	/////////////////////
+	// Private Methods //
+	/////////////////////
+
+	//Extend the input signal to double length with the previous block and calculate its FFT directly into the head slot of the delay line of its channel
+	void CUPCEnvironmentMultichannel::ProcessInputFFT(int channel, const CMonoBuffer<float>& inBuffer_Time)
+	{
+		const float* inBuffer_dobleSize = ProcessDoubleSizeInput(channel, inBuffer_Time);
+
+		float* inBuffer_Frequency = storageInputFFT_buffer.data() + (channel * IR_NumOfSubfilters + storageInputFFT_head[channel]) * storageInputFFT_slotLength;
+		FFTPlan.CalculateFFT_HalfSpectrum(inBuffer_dobleSize, 2 * inputSize, inBuffer_Frequency);
+	}
+
+	//The sizes of all the inputs are checked before any delay line is modified
+	bool CUPCEnvironmentMultichannel::ProcessBatchInputFFT(const std::vector<const CMonoBuffer<float>*>& inBuffers_Time)
+	{
+		for (int channel = 0; channel < numberOfChannels; channel++)
+		{
+			if (inBuffers_Time[channel]->size() != (size_t)inputSize) {
+				SET_RESULT(RESULT_ERROR_BADSIZE, "Bad input size, don't match with the size setting up in the setup method");
+				return false;
+			}
+		}
+
+		batchInput.clear();
+		batchOutput.clear();
+		for (int channel = 0; channel < numberOfChannels; channel++)
+		{
+			batchInput.push_back(ProcessDoubleSizeInput(channel, *inBuffers_Time[channel]));
+			batchOutput.push_back(storageInputFFT_buffer.data() + (channel * IR_NumOfSubfilters + storageInputFFT_head[channel]) * storageInputFFT_slotLength);
+		}
+		FFTPlan.CalculateFFT_HalfSpectrum(batchInput, 2 * inputSize, batchOutput);
+		return true;
+	}
+
+	//The first half keeps the previous input block and the second half the current one
+	float* CUPCEnvironmentMultichannel::ProcessDoubleSizeInput(int channel, const CMonoBuffer<float>& inBuffer_Time)
+	{
+		float* dobleSize = inBuffer_Time_dobleSize.data() + channel * 2 * inputSize;
+		std::copy(dobleSize + inputSize, dobleSize + 2 * inputSize, dobleSize);
+		std::copy(inBuffer_Time.begin(), inBuffer_Time.end(), dobleSize + inputSize);
+		return dobleSize;
+	}
+
+	//Multiply the input FFTs of one channel by the subfilters of both ears and move the head of its delay line waiting for the next input block
+	void CUPCEnvironmentMultichannel::ProcessMultiplyAccumulate(int channel, const TImpulseResponse_Partitioned & leftIR, const TImpulseResponse_Partitioned & rightIR, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency, int numberOfSilencedFrames)
+	{
+		SelectInputFFTs(channel, numberOfSilencedFrames);
+		ProcessMultiplyAccumulate(leftIR, outLeftBuffer_Frequency);
+		ProcessMultiplyAccumulate(rightIR, outRightBuffer_Frequency);
+
+		ProcessAdvanceInputFFT(channel);
+	}
+
+	//The FFT i blocks older than the current one is multiplied by the subfilter i, so the silenced frames are the newest FFTs
+	void CUPCEnvironmentMultichannel::SelectInputFFTs(int channel, int numberOfSilencedFrames)
+	{
+		productInputFFT.clear();
+		for (int i = std::max(numberOfSilencedFrames, 0); i < IR_NumOfSubfilters; i++) {
+			productInputFFT.push_back(GetInputFFT(channel, i));
+		}
+	}
+
+	//Get the FFT of the input block of one channel that is delay blocks older than the current one
+	const float* CUPCEnvironmentMultichannel::GetInputFFT(int channel, int delay) const
+	{
+		int slot = storageInputFFT_head[channel] + delay;
+		if (slot >= IR_NumOfSubfilters) { slot -= IR_NumOfSubfilters; }
+		return storageInputFFT_buffer.data() + (channel * IR_NumOfSubfilters + slot) * storageInputFFT_slotLength;
+	}
+
+	//Multiply the input FFTs already in productInputFFT by the matching subfilters of one ear, in one pass. The subfilters after the first IR_NumOfSubfilters are ignored
+	void CUPCEnvironmentMultichannel::ProcessMultiplyAccumulate(const TImpulseResponse_Partitioned & IR, std::vector<float>& outBuffer_Frequency)
+	{
+		ASSERT(IR.size() >= (size_t)IR_NumOfSubfilters, RESULT_ERROR_BADSIZE, "The impulse response has less subfilters than the ones setting up in the setup method", "");
+		if ((IR.size() < (size_t)IR_NumOfSubfilters) || (productInputFFT.size() == 0)) { return; }	//Just in case error handler is off
+
+		int firstSubfilter = IR_NumOfSubfilters - productInputFFT.size();
+		productIR.clear();
+		for (int i = firstSubfilter; i < IR_NumOfSubfilters; i++) {
+			if (IR[i].size() != (size_t)IR_Frequency_Block_Size) {
+				SET_RESULT(RESULT_ERROR_BADSIZE, "Bad subfilter size, don't match with the size setting up in the setup method");
+				return;
+			}
+			productIR.push_back(IR[i].data());
+		}
+		Common::CFprocessor::ProcessComplexMultiplyAccumulate(productInputFFT, productIR, outBuffer_Frequency);
+	}
+
+	//Move the head of the delay line of one channel one slot back, so the older FFTs are read going forward through the buffer
+	void CUPCEnvironmentMultichannel::ProcessAdvanceInputFFT(int channel)
+	{
+		if (storageInputFFT_head[channel] == 0) {
+			storageInputFFT_head[channel] = IR_NumOfSubfilters - 1;
+		}
+		else {
+			storageInputFFT_head[channel]--;
+		}
+	}
+}//end namespace Common
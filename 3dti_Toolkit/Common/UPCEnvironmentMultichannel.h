@@ -0,0 +1,164 @@
+/**
+* \class CUPCEnvironmentMultichannel
+*
+* \brief Declaration of CUPCEnvironmentMultichannel class interface.
+* \date	October 2026
+*
+* \authors 3DI-DIANA Research Group (University of Malaga), in alphabetical order: M. Cuevas-Rodriguez, C. Garre,  D. Gonzalez-Toledo, E.J. de la Rubia-Cuestas, L. Molina-Tanco ||
+* Coordinated by , A. Reyes-Lecuona (University of Malaga) and L.Picinali (Imperial College London) ||
+* \b Contact: areyes@uma.es and l.picinali@imperial.ac.uk
+*
+* \b Contributions: (additional authors/contributors can be added here)
+*
+* \b Project: 3DTI (3D-games for TUNing and lEarnINg about hearing aids) ||
+* \b Website: http://3d-tune-in.eu/
+*
+* \b Copyright: University of Malaga and Imperial College London - 2018
+*
+* \b Licence: This copy of 3dti_AudioToolkit is licensed to you under the terms described in the 3DTI_AUDIOTOOLKIT_LICENSE file included in this distribution.
+*
+* \b Acknowledgement: This project has received funding from the European Union's Horizon 2020 research and innovation programme under grant agreement No 644051
+*/
+
+#ifndef _CUPCENVIRONMENTMULTICHANNEL_H_
+#define _CUPCENVIRONMENTMULTICHANNEL_H_
+
+#include <vector>
+#include <Common/Fprocessor.h>
+#include <Common/FFTPlan.h>
+#include <Common/Buffer.h>
+#include <Common/AlignedAllocator.h>
+#include <Common/AIR.h>
+
+namespace Common {
+
+	/** \details This class implements the Uniformly Partitioned Convolution Algorithm (UPC algorithm) of several input channels, for example the b-format channels
+	*	of the reverb path, with the impulse responses of both ears.
+	*	The FFT of each input block is calculated only once per channel and kept in a frequency-domain delay line shared by both ears. The products of every channel
+	*	are accumulated in the same two output spectra, one for each ear, so all the channels are mixed in the frequency domain before doing one IFFT per ear.
+	*/
+	class CUPCEnvironmentMultichannel
+	{
+
+	public:
+
+		/** \brief Default constructor
+		*   \eh Nothing is reported to the error handler.
+		*/
+		CUPCEnvironmentMultichannel();
+
+		/** \brief Initialize the class and allocate memory.
+		*	\param [in] _inputSize size of the input signal buffer (B size)
+		*	\param [in] _IR_Frequency_Block_Size size of the FTT Impulse Response blocks, this number is 2*B + 2 (half spectrum of an FFT of 2*B points)
+		*	\param [in] _IR_Block_Number number of blocks in which is divided the the impluse response
+		*	\param [in] _numberOfChannels number of input channels, each one with its own delay line
+		*   \eh On success, RESULT_OK is reported to the error handler.
+		*       On error, an error code is reported to the error handler.
+		*/
+		void Setup(int _inputSize, int _IR_Frequency_Block_Size, int _IR_Block_Number, int _numberOfChannels);
+
+		/** \brief Clear the input blocks and the delay lines of all the channels, without allocating memory
+		*   \details The output is the same as after calling the Setup method with the same parameters
+		*   \eh Nothing is reported to the error handler.
+		*/
+		void ResetBuffers();
+
+		/** \brief Make the Uniformed Partitioned Convolution of one input channel with the impulse responses of both ears, adding the spectra of the outputs to the buffers of the caller
+		*   \details This method has to be called once per block for each channel. The output buffers are not cleared, so the caller can accumulate all the channels in them.
+		*   \details *Wefers, F. (2015). Partitioned convolution algorithms for real-time auralization (Vol. 20). Logos Verlag Berlin GmbH.
+		*	\param [in] channel input channel, from 0 to the number of channels - 1
+		*	\param [in] inBuffer_Time input signal buffer of B size
+		*	\param [in] leftIR left ear impulse response of this channel, partitioned in _IR_Block_Number blocks or more, only the first _IR_Block_Number are used. Each block with a size of IR_Frequency_Block_Size = 2*B + 2
+		*	\param [in] rightIR right ear impulse response of this channel, partitioned in the same way
+		*	\param [in,out] outLeftBuffer_Frequency half spectrum of the left ear output, of 2*B + 2 size. After the IFFT is done only the last B samples are significant
+		*	\param [in,out] outRightBuffer_Frequency half spectrum of the right ear output, of 2*B + 2 size
+		*   \param [in] numberOfSilencedFrames number of initial partitions that are not convolved
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void ProcessUPConvolution_withoutIFFT(int channel, const CMonoBuffer<float>& inBuffer_Time, const TImpulseResponse_Partitioned & leftIR, const TImpulseResponse_Partitioned & rightIR, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency, int numberOfSilencedFrames = 0);
+
+		/** \brief Make the Uniformed Partitioned Convolution of all the input channels with their impulse responses of both ears, adding the spectra of the outputs to the buffers of the caller
+		*   \details The FFTs of all the channels are calculated at once, with the batched FFT. The result is the same as calling the previous method for each channel.
+		*	\param [in] inBuffers_Time input signal buffer of B size of each channel, one for each channel set in the Setup method
+		*	\param [in] leftIRs left ear impulse response of each channel, partitioned in _IR_Block_Number blocks or more
+		*	\param [in] rightIRs right ear impulse response of each channel, partitioned in the same way
+		*	\param [in,out] outLeftBuffer_Frequency half spectrum of the left ear output, of 2*B + 2 size. After the IFFT is done only the last B samples are significant
+		*	\param [in,out] outRightBuffer_Frequency half spectrum of the right ear output, of 2*B + 2 size
+		*   \param [in] numberOfSilencedFrames number of initial partitions that are not convolved, in all the channels
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void ProcessUPConvolution_withoutIFFT(const std::vector<const CMonoBuffer<float>*>& inBuffers_Time, const std::vector<const TImpulseResponse_Partitioned*>& leftIRs, const std::vector<const TImpulseResponse_Partitioned*>& rightIRs, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency, int numberOfSilencedFrames = 0);
+
+		/** \brief Make the Uniformed Partitioned Convolution of all the input channels with two sets of impulse responses of both ears, adding the spectra of the outputs of each set to its own buffers
+		*   \details The FFTs of the inputs are calculated only once and multiplied by both sets, for example to crossfade the outputs of the impulse responses in use with the ones replacing them.
+		*	The result of each set is the same as calling the previous method with it.
+		*	\param [in] inBuffers_Time input signal buffer of B size of each channel, one for each channel set in the Setup method
+		*	\param [in] leftIRs left ear impulse response of each channel, partitioned in _IR_Block_Number blocks or more
+		*	\param [in] rightIRs right ear impulse response of each channel, partitioned in the same way
+		*	\param [in,out] outLeftBuffer_Frequency half spectrum of the left ear output with leftIRs, of 2*B + 2 size
+		*	\param [in,out] outRightBuffer_Frequency half spectrum of the right ear output with rightIRs, of 2*B + 2 size
+		*	\param [in] secondLeftIRs left ear impulse response of each channel of the second set, partitioned in the same way
+		*	\param [in] secondRightIRs right ear impulse response of each channel of the second set, partitioned in the same way
+		*	\param [in,out] secondOutLeftBuffer_Frequency half spectrum of the left ear output with secondLeftIRs, of 2*B + 2 size
+		*	\param [in,out] secondOutRightBuffer_Frequency half spectrum of the right ear output with secondRightIRs, of 2*B + 2 size
+		*   \param [in] numberOfSilencedFrames number of initial partitions that are not convolved, in all the channels and both sets
+		*   \eh On error, an error code is reported to the error handler.
+		*/
+		void ProcessUPConvolution_withoutIFFT(const std::vector<const CMonoBuffer<float>*>& inBuffers_Time, const std::vector<const TImpulseResponse_Partitioned*>& leftIRs, const std::vector<const TImpulseResponse_Partitioned*>& rightIRs, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency,
+			const std::vector<const TImpulseResponse_Partitioned*>& secondLeftIRs, const std::vector<const TImpulseResponse_Partitioned*>& secondRightIRs, std::vector<float>& secondOutLeftBuffer_Frequency, std::vector<float>& secondOutRightBuffer_Frequency, int numberOfSilencedFrames = 0);
+
+		/** \brief Get the number of input channels
+		*	\retval numberOfChannels number of channels set in the Setup method
+		*   \eh Nothing is reported to the error handler.
+		*/
+		int GetNumberOfChannels() const;
+
+	private:
+		///////////////
+		// ATTRIBUTES
+		///////////////
+		int inputSize;								//Size of the inputs buffer
+		int IR_Frequency_Block_Size;				//Size of the subfilters
+		int IR_NumOfSubfilters;						//Number of blocks in which is divided the IR
+		int numberOfChannels;						//Number of input channels
+		bool setupDone;
+
+		std::vector<float> inBuffer_Time_dobleSize;			//For each channel, the previous input block followed by the current one
+		CAlignedVector<float> storageInputFFT_buffer;		//Frequency-domain delay lines, IR_NumOfSubfilters slots for each channel, one after the other
+		int storageInputFFT_slotLength;						//Distance between two slots of the delay lines, rounded up to keep every slot aligned
+		std::vector<int> storageInputFFT_head;				//For each channel, slot with the FFT of the current input. The FFT i blocks older is in the slot (head + i) % number of subfilters
+		Common::CFFTPlan FFTPlan;							//FFT tables of 2*B points, calculated once in the setup method
+		std::vector<const float*> productInputFFT;			//Input FFTs multiplied in the current block
+		std::vector<const float*> productIR;				//Subfilters multiplied in the current block
+		std::vector<const float*> batchInput;				//Double size input of each channel, transformed at once by the batched FFT
+		std::vector<float*> batchOutput;					//Head slot of the delay line of each channel, where the batched FFT writes
+
+		///////////////
+		// METHODS
+		///////////////
+		//Extend the input signal of one channel to double length and calculate its FFT directly into the head slot of its delay line
+		void ProcessInputFFT(int channel, const CMonoBuffer<float>& inBuffer_Time);
+
+		//Check the inputs of all the channels and calculate their FFTs at once into the head slots of their delay lines
+		bool ProcessBatchInputFFT(const std::vector<const CMonoBuffer<float>*>& inBuffers_Time);
+
+		//Get the FFT of the input signal of one channel that is delay blocks older than the current one
+		const float* GetInputFFT(int channel, int delay) const;
+
+		//Multiply and accumulate the input FFTs of one channel, already calculated, by the subfilters of both ears
+		void ProcessMultiplyAccumulate(int channel, const TImpulseResponse_Partitioned & leftIR, const TImpulseResponse_Partitioned & rightIR, std::vector<float>& outLeftBuffer_Frequency, std::vector<float>& outRightBuffer_Frequency, int numberOfSilencedFrames);
+
+		//Select the input FFTs of one channel that are multiplied in the current block, from the first not silenced one
+		void SelectInputFFTs(int channel, int numberOfSilencedFrames);
+
+		//Extend the input signal of one channel to double length, returning where it is stored
+		float* ProcessDoubleSizeInput(int channel, const CMonoBuffer<float>& inBuffer_Time);
+
+		//Multiply the input FFTs of one channel by the subfilters of one ear, from the first not silenced one, adding the products to the output
+		void ProcessMultiplyAccumulate(const TImpulseResponse_Partitioned & IR, std::vector<float>& outBuffer_Frequency);
+
+		//Move the head of the delay line of one channel waiting for the next input block
+		void ProcessAdvanceInputFFT(int channel);
+	};
+}//end namespace Common
+#endif